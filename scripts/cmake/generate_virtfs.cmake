@@ -27,6 +27,11 @@ endif()
 file(GLOB CHUNK_FILES "${MILLENNIUM_BASE}/src/typescript/sdk/build/chunks/*")
 set(HEADER_CONTENT "/**\n * Auto-generated by Millennium during CMake configuration - do not edit manually :)\n */\n")
 set(HEADER_CONTENT "${HEADER_CONTENT}#pragma once\n\n")
+if(MILLENNIUM_EMBED_ASSETS)
+    set(HEADER_CONTENT "${HEADER_CONTENT}inline constexpr bool INTERNAL_FTP_EMBEDDED = true;\n\n")
+else()
+    set(HEADER_CONTENT "${HEADER_CONTENT}inline constexpr bool INTERNAL_FTP_EMBEDDED = false;\n\n")
+endif()
 set(RC_CONTENT "// Auto-generated resource file\n#include <windows.h>\n\n")
 
 if(MILLENNIUM_EMBED_ASSETS)
@@ -30,9 +30,9 @@
 
 #include "head/css_parser.h"
 
+#include <algorithm>
 #include <fstream>
 #include <format>
-#include <regex>
 #include <sstream>
 
 std::string head::css_parser::trim(const std::string& str)
@@ -168,74 +168,156 @@ json head::css_parser::generate_color_metadata(const std::map<std::string, std::
 
     return result;
 }
-std::string head::css_parser::extract_root_block(const std::string& fileContent)
+namespace
 {
-    std::regex rootRegex(R"(:root\s*\{([\s\S]*)\})", std::regex::ECMAScript);
-    std::smatch match;
-    if (std::regex_search(fileContent, match, rootRegex)) return match[1].str();
-    return "";
+constexpr std::string_view WHITESPACE = " \t\n\r\f";
+
+std::string_view trim_view(std::string_view str)
+{
+    const size_t start = str.find_first_not_of(WHITESPACE);
+    if (start == std::string_view::npos) return {};
+    return str.substr(start, str.find_last_not_of(WHITESPACE) - start + 1);
+}
+
+bool is_blank(std::string_view str)
+{
+    return str.find_first_not_of(WHITESPACE) == std::string_view::npos;
+}
+
+bool is_ident_char(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
 }
 
-void head::css_parser::parse_properties(const std::string& block, std::map<std::string, std::string>& properties,
-                                        std::map<std::string, std::pair<std::string, std::string>>& propertyMap)
+/** true if one of the selectors in a rule prelude is exactly :root */
+bool is_root_prelude(std::string_view prelude)
 {
-    std::istringstream ss(block);
-    std::string line;
-    std::string lastComment;
-    bool inComment = false;
-
-    while (std::getline(ss, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
-
-        if (line.rfind("/*", 0) == 0) {
-            lastComment.clear();
-            inComment = true;
+    while (!prelude.empty()) {
+        const size_t comma = prelude.find(',');
+        if (trim_view(prelude.substr(0, comma)) == ":root") return true;
+        if (comma == std::string_view::npos) break;
+        prelude.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+/** the text after the first "@tag <whitespace>" in a doc comment, up to the next '*' */
+std::string comment_tag(std::string_view comment, std::string_view tag)
+{
+    for (size_t pos = comment.find(tag); pos != std::string_view::npos; pos = comment.find(tag, pos + 1)) {
+        size_t value = pos + tag.size();
+        if (value >= comment.size() || WHITESPACE.find(comment[value]) == std::string_view::npos) continue;
+
+        value = comment.find_first_not_of(WHITESPACE, value);
+        if (value == std::string_view::npos || comment[value] == '*') continue;
+
+        return std::string(trim_view(comment.substr(value, comment.find('*', value) - value)));
+    }
+    return {};
+}
+} // namespace
+
+void head::css_parser::parse_root_properties(std::string_view css, std::map<std::string, std::string>& properties,
+                                             std::map<std::string, std::pair<std::string, std::string>>& propertyMap)
+{
+    const size_t n = css.size();
+
+    size_t statement = 0; // start of the current prelude/declaration
+    int depth = 0;
+    int parens = 0;
+    bool in_root = false;
+    std::string_view doc_comment;
+
+    const auto take_declaration = [&](std::string_view decl)
+    {
+        const size_t colon = decl.find(':');
+        if (colon == std::string_view::npos) return;
+
+        const std::string_view name = trim_view(decl.substr(0, colon));
+        const std::string_view value = trim_view(decl.substr(colon + 1));
+        if (name.empty() || value.empty() || !std::all_of(name.begin(), name.end(), is_ident_char)) return;
+
+        std::string name_str(name);
+        properties[name_str] = std::string(value);
+
+        std::string title, description;
+        if (!doc_comment.empty()) {
+            title = comment_tag(doc_comment, "@name");
+            description = comment_tag(doc_comment, "@description");
+            doc_comment = {};
         }
+        propertyMap[std::move(name_str)] = { std::move(title), std::move(description) };
+    };
 
-        if (inComment) {
-            lastComment += line + "\n";
-            if (line.find("*/") != std::string::npos) inComment = false;
+    for (size_t i = 0; i < n;) {
+        const char c = css[i];
+
+        if (c == '/' && i + 1 < n && css[i + 1] == '*') {
+            const size_t close = css.find("*/", i + 2);
+            const size_t end = close == std::string_view::npos ? n : close + 2;
+
+            /** a comment that opens a statement documents it, and isn't part of its text */
+            if (parens == 0 && is_blank(css.substr(statement, i - statement))) {
+                if (in_root && depth == 1) doc_comment = css.substr(i, end - i);
+                statement = end;
+            }
+            i = end;
             continue;
         }
 
-        std::regex propRegex(R"(([\w-]+)\s*:\s*([^;]+);)");
-        std::smatch match;
-        if (std::regex_match(line, match, propRegex)) {
-            std::string propName = match[1].str();
-            std::string propValue = trim(match[2].str());
-            properties[propName] = propValue;
-
-            std::string name, description;
-            if (!lastComment.empty()) {
-                std::regex nameRegex(R"(@name\s+([^\*]+))");
-                std::regex descRegex(R"(@description\s+([^\*]+))");
-                std::smatch nameMatch, descMatch;
-                if (std::regex_search(lastComment, nameMatch, nameRegex)) name = trim(nameMatch[1].str());
-                if (std::regex_search(lastComment, descMatch, descRegex)) description = trim(descMatch[1].str());
-                lastComment.clear();
+        if (c == '"' || c == '\'') {
+            ++i;
+            while (i < n && css[i] != c && css[i] != '\n') {
+                i += (css[i] == '\\') ? 2 : 1;
             }
+            ++i;
+            continue;
+        }
 
-            propertyMap[propName] = { name, description };
+        if (c == '(') {
+            ++parens;
+        } else if (c == ')') {
+            if (parens > 0) --parens;
+        } else if (parens == 0) {
+            if (c == '{') {
+                if (depth == 0) in_root = is_root_prelude(css.substr(statement, i - statement));
+                ++depth;
+                statement = i + 1;
+            } else if (c == '}') {
+                if (in_root && depth == 1) take_declaration(css.substr(statement, i - statement));
+                if (depth > 0 && --depth == 0) in_root = false;
+                statement = i + 1;
+            } else if (c == ';') {
+                if (in_root && depth == 1) take_declaration(css.substr(statement, i - statement));
+                statement = i + 1;
+            }
         }
+        ++i;
     }
+
+    /** a :root block cut off by the end of the file still counts */
+    if (in_root && depth == 1 && statement < n) take_declaration(css.substr(statement));
 }
 
 nlohmann::json head::css_parser::parse_root_colors(const std::string& filePath)
 {
-    std::ifstream file(filePath);
+    std::ifstream file(filePath, std::ios::binary);
     if (!file.is_open()) return nlohmann::json::array();
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
-
-    std::string rootBlock = extract_root_block(content);
-    if (rootBlock.empty()) return nlohmann::json::array();
+    std::string content;
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    if (size > 0) {
+        content.resize(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+        file.read(content.data(), size);
+        content.resize(static_cast<size_t>(file.gcount()));
+    }
 
     std::map<std::string, std::string> properties;
     std::map<std::string, std::pair<std::string, std::string>> propertyMap;
-    parse_properties(rootBlock, properties, propertyMap);
+    parse_root_properties(content, properties, propertyMap);
+    if (properties.empty()) return nlohmann::json::array();
 
     return generate_color_metadata(properties, propertyMap);
 }
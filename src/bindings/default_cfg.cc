@@ -68,7 +68,8 @@ json head::get_default_config()
         { "themes", {
             { "activeTheme", "default" },
             { "allowedStyles", true },
-            { "allowedScripts", true }
+            { "allowedScripts", true },
+            { "bundleStylesheets", false }
         } },
         { "notifications", {
             { "showNotifications", true },
@@ -530,7 +530,8 @@ builtin_payload head::millennium_backend::Core_GetAllPluginMetrics(const builtin
             { "name",        name                },
             { "rss_bytes",   metrics.rss_bytes   },
             { "heap_bytes",  metrics.heap_bytes   },
-            { "cpu_percent", metrics.cpu_percent  }
+            { "cpu_percent", metrics.cpu_percent  },
+            { "requests",    metrics.requests     }
         });
     }
     return result;
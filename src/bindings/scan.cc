@@ -30,8 +30,10 @@
 
 #include <fstream>
 #include "head/scan.h"
+#include "head/theme_cache.h"
 #include "mep/crash_event_bus.h"
 
+#include "millennium/environment.h"
 #include "millennium/logger.h"
 #include "millennium/filesystem.h"
 
@@ -97,8 +99,16 @@ bool head::Themes::IsValid(const std::string& theme_native_name)
 
     if (!std::filesystem::is_regular_file(file_path)) return false;
 
-    std::ifstream file(file_path);
-    return nlohmann::json::accept(file);
+    return MetadataCache().skin(file_path).has_value();
+}
+
+/**
+ * Parsed skin.json/RootColors metadata shared by every theme lookup, persisted in the config directory.
+ */
+head::theme_metadata_cache& head::Themes::MetadataCache()
+{
+    static theme_metadata_cache cache(std::filesystem::path(platform::environment::get("MILLENNIUM__CONFIG_PATH")) / "theme-cache.json");
+    return cache;
 }
 
 /**
@@ -128,20 +138,21 @@ nlohmann::ordered_json head::Themes::FindAllThemes()
             auto skinJsonPath = dir.path() / "skin.json";
             if (!std::filesystem::exists(skinJsonPath)) continue;
 
-            std::ifstream file(skinJsonPath);
-            if (!file.is_open()) continue;
-
-            nlohmann::ordered_json skinData;
-            if (!(file >> skinData)) continue; /** invalid json from stream */
+            auto skinData = MetadataCache().skin(skinJsonPath);
+            if (!skinData) continue; /** missing or invalid json */
 
             themes.push_back({
                 { "native", dir.path().filename().string() },
-                { "data",   std::move(skinData)            }
+                { "data",   std::move(*skinData)           }
             });
         }
     } catch (const std::filesystem::filesystem_error& e) {
         logger.log("Filesystem error: " + std::string(e.what()));
     }
 
+    if (!MetadataCache().save()) {
+        logger.warn("Failed to write the theme metadata cache.");
+    }
+
     return themes;
 }
@@ -0,0 +1,225 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "head/theme_cache.h"
+#include "head/css_parser.h"
+
+#include <fstream>
+
+namespace
+{
+/** bump when the cached representation changes, older cache files are then ignored */
+constexpr int CACHE_VERSION = 1;
+
+uint64_t fnv1a_64(std::string_view data)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const unsigned char c : data) {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::optional<std::string> read_file(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    std::string content;
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    if (size > 0) {
+        content.resize(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+        file.read(content.data(), size);
+        content.resize(static_cast<size_t>(file.gcount()));
+    }
+    return content;
+}
+} // namespace
+
+head::theme_metadata_cache::theme_metadata_cache(std::filesystem::path cache_file) : m_cache_file(std::move(cache_file))
+{
+    load();
+}
+
+void head::theme_metadata_cache::load()
+{
+    const auto content = read_file(m_cache_file);
+    if (!content) return;
+
+    const auto data = nlohmann::ordered_json::parse(*content, nullptr, /*allow_exceptions=*/false);
+    if (!data.is_object() || data.value("version", 0) != CACHE_VERSION || !data.contains("entries") || !data["entries"].is_object()) return;
+
+    for (const auto& [key, cached] : data["entries"].items()) {
+        if (!cached.is_object()) continue;
+
+        entry e;
+        e.print.size = cached.value("size", std::uintmax_t{ 0 });
+        e.print.mtime = cached.value("mtime", int64_t{ 0 });
+        e.print.hash = cached.value("hash", uint64_t{ 0 });
+        e.value = cached.value("value", nlohmann::ordered_json());
+        m_entries.emplace(key, std::move(e));
+    }
+}
+
+template <typename parse_fn> nlohmann::ordered_json head::theme_metadata_cache::lookup(const std::filesystem::path& path, const char* kind, parse_fn&& parse)
+{
+    const std::string key = std::string(kind) + ":" + path.generic_string();
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return nullptr;
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return nullptr;
+    const int64_t mtime_ticks = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->second.print.size == size && it->second.print.mtime == mtime_ticks) {
+        ++m_hits;
+        return it->second.value;
+    }
+    lock.unlock();
+
+    const auto content = read_file(path);
+    if (!content) return nullptr;
+
+    const uint64_t hash = fnv1a_64(*content);
+
+    lock.lock();
+    it = m_entries.find(key);
+    if (it != m_entries.end() && it->second.print.size == content->size() && it->second.print.hash == hash) {
+        /** touched but not changed */
+        it->second.print.mtime = mtime_ticks;
+        m_dirty = true;
+        ++m_hits;
+        return it->second.value;
+    }
+    ++m_misses;
+    lock.unlock();
+
+    nlohmann::ordered_json value = parse(*content);
+
+    lock.lock();
+    m_entries[key] = entry{
+        fingerprint{ content->size(), mtime_ticks, hash },
+        value
+    };
+    m_dirty = true;
+    return value;
+}
+
+std::optional<nlohmann::ordered_json> head::theme_metadata_cache::skin(const std::filesystem::path& skin_path)
+{
+    auto value = lookup(skin_path, "skin", [](const std::string& content)
+    {
+        return nlohmann::ordered_json::parse(content, nullptr, /*allow_exceptions=*/false);
+    });
+
+    /** parse() without exceptions yields a discarded value for invalid json, which is cached as null */
+    if (value.is_null() || value.is_discarded()) return std::nullopt;
+    return value;
+}
+
+nlohmann::json head::theme_metadata_cache::root_colors(const std::filesystem::path& css_path)
+{
+    const auto value = lookup(css_path, "colors", [](const std::string& content)
+    {
+        std::map<std::string, std::string> properties;
+        std::map<std::string, std::pair<std::string, std::string>> property_map;
+        css_parser::parse_root_properties(content, properties, property_map);
+        return nlohmann::ordered_json(css_parser::generate_color_metadata(properties, property_map));
+    });
+
+    if (!value.is_array()) return nlohmann::json::array();
+    return nlohmann::json(value);
+}
+
+bool head::theme_metadata_cache::save()
+{
+    nlohmann::ordered_json entries = nlohmann::ordered_json::object();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_dirty) return true;
+
+        for (const auto& [key, e] : m_entries) {
+            /** drop entries for files that have since been deleted */
+            std::error_code ec;
+            if (!std::filesystem::exists(key.substr(key.find(':') + 1), ec)) continue;
+
+            entries[key] = {
+                { "size",  e.print.size  },
+                { "mtime", e.print.mtime },
+                { "hash",  e.print.hash  },
+                { "value", e.value.is_discarded() ? nlohmann::ordered_json() : e.value },
+            };
+        }
+        m_dirty = false;
+    }
+
+    const nlohmann::ordered_json data = {
+        { "version", CACHE_VERSION      },
+        { "entries", std::move(entries) },
+    };
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_cache_file.parent_path(), ec);
+
+    const auto temp_file = std::filesystem::path(m_cache_file).concat(".tmp");
+    {
+        std::ofstream file(temp_file, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        /** @name / @description are copied out of theme css as-is, which needn't be valid utf-8 */
+        file << data.dump(-1, ' ', false, nlohmann::ordered_json::error_handler_t::replace);
+        if (file.fail()) return false;
+    }
+
+    std::filesystem::rename(temp_file, m_cache_file, ec);
+    if (ec) {
+        std::filesystem::remove(temp_file, ec);
+        return false;
+    }
+    return true;
+}
+
+std::size_t head::theme_metadata_cache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+std::size_t head::theme_metadata_cache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
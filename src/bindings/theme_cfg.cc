@@ -166,19 +166,17 @@ nlohmann::ordered_json head::theme_config_store::get_active_theme()
     std::string active = CONFIG.get({ "themes", "activeTheme" }).get<std::string>();
     std::filesystem::path path = themes_path / active / "skin.json";
 
-    try {
-        std::ifstream file(path);
-        nlohmann::ordered_json data;
-        file >> data;
-        return {
-            { "native", active },
-            { "data",   data   }
-        };
-    } catch (...) {
+    auto data = head::Themes::MetadataCache().skin(path);
+    if (!data) {
         return {
             { "failed", true }
         };
     }
+
+    return {
+        { "native", active         },
+        { "data",   std::move(*data) }
+    };
 }
 
 void head::theme_config_store::setup_theme_hooks()
@@ -186,6 +184,9 @@ void head::theme_config_store::setup_theme_hooks()
     theme_data = get_active_theme();
     active_theme_name = CONFIG.get({ "themes", "activeTheme" }).get<std::string>();
 
+    const auto bundle = CONFIG.get({ "themes", "bundleStylesheets" }, false);
+    m_theme_webkit_mgr->set_stylesheet_bundling(bundle.is_boolean() && bundle.get<bool>());
+
     setup_conditionals();
     start_webkit_hook(theme_data, active_theme_name);
     setup_colors();
@@ -227,7 +228,7 @@ void head::theme_config_store::setup_colors()
         std::string rootFile = theme["data"]["RootColors"].get<std::string>();
         const auto colorsPath = platform::get_millennium_path() / "themes" / nativeName / rootFile;
 
-        colors[nativeName] = head::css_parser::parse_root_colors(colorsPath.generic_string());
+        colors[nativeName] = head::Themes::MetadataCache().root_colors(colorsPath);
 
         if (CONFIG.get({ "themes", "themeColors" }, nullptr).is_null()) CONFIG.set({ "themes", "themeColors" }, nlohmann::json::object(), /*skipPropagation=*/true);
 
@@ -263,6 +264,9 @@ void head::theme_config_store::setup_colors()
         }
     }
 
+    if (!head::Themes::MetadataCache().save()) {
+        logger.warn("Failed to write the theme metadata cache.");
+    }
     CONFIG.save_to_disk();
 }
 
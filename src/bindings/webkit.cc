@@ -125,7 +125,7 @@ std::vector<head::theme_webkit_mgr::webkit_item> head::theme_webkit_mgr::parse_c
 
 unsigned long long head::theme_webkit_mgr::add_browser_hook(const std::string& path, const std::string& regex, network_hook_ctl::TagTypes type)
 {
-    unsigned long long hook_id = m_network_hook_ctl->add_hook({ path, std::regex(regex), type });
+    unsigned long long hook_id = m_network_hook_ctl->add_hook({ path, std::make_shared<const std::regex>(regex), type, regex });
     m_registered_hooks.push_back(hook_id);
     return hook_id;
 }
@@ -140,6 +140,11 @@ bool head::theme_webkit_mgr::remove_browser_hook(unsigned long long hookId)
     return false;
 }
 
+void head::theme_webkit_mgr::set_stylesheet_bundling(bool enabled)
+{
+    m_network_hook_ctl->set_stylesheet_bundling(enabled);
+}
+
 void head::theme_webkit_mgr::add_conditional_data(const nlohmann::json& data, const std::string& theme_name)
 {
     try {
@@ -200,7 +200,7 @@ bool backend_manager::spawn_plugin(plugin_manager::plugin_t& plugin)
 
 bool backend_manager::destroy_plugin(const std::string& pluginName, bool isShuttingDown)
 {
-    std::unique_ptr<PluginProcess> process;
+    std::shared_ptr<PluginProcess> process;
 
     {
         std::lock_guard<std::mutex> lock(m_processes_mutex);
@@ -250,9 +250,42 @@ bool backend_manager::destroy_all_plugins(bool isShuttingDown)
 
 nlohmann::json backend_manager::evaluate(const std::string& pluginName, const nlohmann::json& script)
 {
-    std::lock_guard<std::mutex> lock(m_processes_mutex);
-    auto it = m_processes.find(pluginName);
-    if (it == m_processes.end()) {
+    std::shared_ptr<PluginProcess> process;
+    {
+        /* not held across the call, a slow plugin mustn't hold up calls into every other one */
+        std::lock_guard<std::mutex> lock(m_processes_mutex);
+        auto it = m_processes.find(pluginName);
+        if (it != m_processes.end()) process = it->second;
+    }
+
+    if (!process) {
+        return {
+            { "success", false                               },
+            { "error",   "plugin not running: " + pluginName }
+        };
+    }
+
+    try {
+        return process->call(plugin_ipc::parent_method::EVALUATE, script);
+    } catch (const std::exception& e) {
+        return {
+            { "success", false                 },
+            { "error",   std::string(e.what()) }
+        };
+    }
+}
+
+nlohmann::json backend_manager::evaluate_packed(const std::string& pluginName, const std::vector<uint8_t>& packed_script)
+{
+    std::shared_ptr<PluginProcess> process;
+    {
+        /* not held across the call, a slow plugin mustn't hold up calls into every other one */
+        std::lock_guard<std::mutex> lock(m_processes_mutex);
+        auto it = m_processes.find(pluginName);
+        if (it != m_processes.end()) process = it->second;
+    }
+
+    if (!process) {
         return {
             { "success", false                               },
             { "error",   "plugin not running: " + pluginName }
@@ -260,7 +293,7 @@ nlohmann::json backend_manager::evaluate(const std::string& pluginName, const nl
     }
 
     try {
-        return it->second->call(plugin_ipc::parent_method::EVALUATE, script);
+        return process->call_packed(plugin_ipc::parent_method::EVALUATE, packed_script);
     } catch (const std::exception& e) {
         return {
             { "success", false                 },
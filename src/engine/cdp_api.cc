@@ -29,6 +29,7 @@
  */
 
 #include "millennium/cdp_api.h"
+#include "millennium/cdp_envelope.h"
 #include "millennium/logger.h"
 #include "millennium/thread_pool.h"
 #include <condition_variable>
@@ -44,7 +45,7 @@ cdp_client::cdp_client(send_fn sender) : m_sender(std::move(sender)), m_callback
     m_incoming_worker = std::thread([this]()
     {
         while (!m_shutdown.load(std::memory_order_acquire)) {
-            std::string payload;
+            cdp_frame frame;
             {
                 std::unique_lock<std::mutex> lock(m_incoming_mutex);
                 /** wait for incoming messages or shutdown signal */
@@ -54,18 +55,18 @@ cdp_client::cdp_client(send_fn sender) : m_sender(std::move(sender)), m_callback
                 });
 
                 if (!m_incoming_queue.empty()) {
-                    payload = std::move(m_incoming_queue.front());
+                    frame = std::move(m_incoming_queue.front());
                     m_incoming_queue.pop_front();
                     m_incoming_space_cv.notify_one(); /** signal space available for backpressure */
                 }
             }
 
-            if (payload.empty()) {
+            if (frame.data.empty()) {
                 continue;
             }
 
             try {
-                this->process_message(payload);
+                this->process_message(frame.data);
             } catch (const std::exception& e) {
                 invoke_error_handler("Processing incoming message", e);
             } catch (...) {
@@ -75,14 +76,14 @@ cdp_client::cdp_client(send_fn sender) : m_sender(std::move(sender)), m_callback
         }
 
         /** process remaining messages on shutdown */
-        std::deque<std::string> remaining;
+        std::deque<cdp_frame> remaining;
         {
             std::lock_guard<std::mutex> lock(m_incoming_mutex);
             remaining.swap(m_incoming_queue);
         }
-        for (auto& p : remaining) {
+        for (auto& f : remaining) {
             try {
-                this->process_message(p);
+                this->process_message(f.data);
             } catch (const std::exception& e) {
                 LOG_ERROR(std::string("cdp_client: Exception processing remaining message: ") + e.what());
             } catch (...) {
@@ -124,18 +125,17 @@ void cdp_client::shutdown()
     if (m_cleanup_thread.joinable()) m_cleanup_thread.join();
     if (m_callback_pool) m_callback_pool->shutdown();
 
-    /** fail all pending requests */
-    std::unique_lock<std::mutex> lock(m_requests_mutex);
-    for (auto& [id, req] : m_pending_requests) {
-        if (!req->completed.exchange(true, std::memory_order_acq_rel)) {
-            try {
-                req->promise.set_exception(std::make_exception_ptr(std::runtime_error("CDPClient shutdown")));
-            } catch (...) {
-                LOG_ERROR("Failed to set exception on pending request during shutdown");
-            }
+    /** fail all pending requests. settle outside the shard lock, batch/chain callbacks may call back into the client */
+    for (auto& shard : m_request_shards) {
+        std::unordered_map<int, async_request> requests;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            requests.swap(shard.requests);
+        }
+        for (auto& [id, req] : requests) {
+            req.reject(std::make_exception_ptr(std::runtime_error("CDPClient shutdown")));
         }
     }
-    m_pending_requests.clear();
     /** clear all event callbacks */
     {
         std::unique_lock<std::shared_mutex> events_lock(m_events_mutex);
@@ -172,12 +172,160 @@ std::future<json> cdp_client::send(const std::string& method, const json& params
 
 std::future<json> cdp_client::send_host(const std::string& method, const json& params, std::optional<std::string> sessionId, std::chrono::milliseconds timeout)
 {
-    int id = m_next_id.fetch_add(1, std::memory_order_relaxed);
+    async_request pending;
+    pending.deadline = std::chrono::steady_clock::now() + timeout;
+    auto future = std::get<std::promise<json>>(pending.target).get_future();
+
+    int id = 0;
+    const std::string payload = prepare_request(method, params, sessionId, std::move(pending), id);
+    if (!payload.empty()) {
+        write_requests(payload, { id });
+    }
+    return future;
+}
+
+void cdp_client::send_host_async(const std::string& method, const json& params, std::optional<std::string> sessionId, response_callback on_response,
+                                 std::chrono::milliseconds timeout)
+{
+    async_request pending{ .target = settle_callback(std::move(on_response)), .deadline = std::chrono::steady_clock::now() + timeout };
+
+    int id = 0;
+    const std::string payload = prepare_request(method, params, sessionId, std::move(pending), id);
+    if (!payload.empty()) {
+        write_requests(payload, { id });
+    }
+}
+
+std::future<std::vector<json>> cdp_client::send_batch(const std::vector<command>& commands, std::chrono::milliseconds timeout)
+{
+    struct batch_state
+    {
+        std::mutex mutex;
+        std::vector<json> results;
+        size_t remaining;
+        bool settled = false;
+        std::promise<std::vector<json>> promise;
+    };
+
+    auto batch = std::make_shared<batch_state>();
+    batch->results.resize(commands.size());
+    batch->remaining = commands.size();
+    auto future = batch->promise.get_future();
+
+    if (commands.empty()) {
+        batch->promise.set_value({});
+        return future;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const std::string session_id = m_shared_js_session_id;
+
+    std::string payload;
+    std::vector<int> ids;
+    ids.reserve(commands.size());
+
+    for (size_t i = 0; i < commands.size(); ++i) {
+        async_request pending{ .target = settle_callback([batch, i](json result, std::exception_ptr error)
+        {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (batch->settled) return;
+
+            if (error) {
+                batch->settled = true;
+                batch->promise.set_exception(error);
+                return;
+            }
+
+            batch->results[i] = std::move(result);
+            if (--batch->remaining == 0) {
+                batch->settled = true;
+                batch->promise.set_value(std::move(batch->results));
+            }
+        }), .deadline = deadline };
+
+        int id = 0;
+        std::string message = prepare_request(commands[i].method, commands[i].params, session_id, std::move(pending), id);
+        if (message.empty()) {
+            break; /** shut down, the request above already failed the batch */
+        }
+
+        /** the transport appends the delimiter after the last message, we only need the ones in between */
+        if (!payload.empty()) payload.push_back('\0');
+        payload += message;
+        ids.push_back(id);
+    }
+
+    if (!payload.empty()) {
+        write_requests(payload, ids);
+    }
+    return future;
+}
+
+struct cdp_client::chain_state
+{
+    std::vector<chain_step> steps;
+    size_t next_step = 0;
+    std::vector<json> results;
+    std::chrono::milliseconds timeout;
+    std::promise<std::vector<json>> promise;
+};
+
+std::future<std::vector<json>> cdp_client::send_chain(command first, std::vector<chain_step> steps, std::chrono::milliseconds timeout)
+{
+    auto chain = std::make_shared<chain_state>();
+    chain->steps = std::move(steps);
+    chain->results.reserve(chain->steps.size() + 1);
+    chain->timeout = timeout;
+
+    auto future = chain->promise.get_future();
+    advance_chain(std::move(chain), std::move(first));
+    return future;
+}
+
+/**
+ * Send the next command of a chain. Its completion builds and sends the following one,
+ * so the whole chain progresses from the message worker without any thread waiting on it.
+ */
+void cdp_client::advance_chain(std::shared_ptr<chain_state> chain, command next)
+{
+    async_request pending{ .target = settle_callback([this, chain](json result, std::exception_ptr error)
+    {
+        if (error) {
+            chain->promise.set_exception(error);
+            return;
+        }
+
+        chain->results.push_back(std::move(result));
+        if (chain->next_step == chain->steps.size()) {
+            chain->promise.set_value(std::move(chain->results));
+            return;
+        }
+
+        command following;
+        try {
+            following = chain->steps[chain->next_step++](chain->results.back());
+        } catch (...) {
+            chain->promise.set_exception(std::current_exception());
+            return;
+        }
+        advance_chain(chain, std::move(following));
+    }), .deadline = std::chrono::steady_clock::now() + chain->timeout };
+
+    int id = 0;
+    const std::string payload = prepare_request(next.method, next.params, m_shared_js_session_id, std::move(pending), id);
+    if (!payload.empty()) {
+        write_requests(payload, { id });
+    }
+}
+
+std::string cdp_client::prepare_request(const std::string& method, const json& params, const std::optional<std::string>& sessionId, async_request request, int& id)
+{
+    if (m_shutdown.load(std::memory_order_acquire)) {
+        request.reject(std::make_exception_ptr(std::runtime_error("Client shutdown")));
+        return {};
+    }
 
-    auto pending = std::make_shared<async_request>();
-    pending->timestamp = std::chrono::steady_clock::now();
-    pending->timeout = timeout;
-    auto future = pending->promise.get_future();
+    id = m_next_id.fetch_add(1, std::memory_order_relaxed);
 
     /** construct the underlying CDP message */
     json message = {
@@ -194,44 +342,71 @@ std::future<json> cdp_client::send_host(const std::string& method, const json& p
         message["sessionId"] = sessionId.value();
     }
 
-    std::string payload = message.dump();
+    const auto deadline = request.deadline;
 
-    if (m_shutdown.load(std::memory_order_acquire)) {
-        if (!pending->completed.exchange(true, std::memory_order_acq_rel)) {
-            try {
-                pending->promise.set_exception(std::make_exception_ptr(std::runtime_error("Client shutdown")));
-            } catch (...) {
-                LOG_ERROR("Failed to set exception on pending request due to client shutdown");
-            }
-        }
-        return future;
+    /** register req before sending it to avoid race conditions or deadlocking */
+    {
+        auto& shard = shard_for(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.requests.emplace(id, std::move(request));
     }
 
-    /** register req before sending it to avoid race conditions or deadlocking */
+    /** only wake the cleanup thread if this request now expires first */
     {
-        std::lock_guard<std::mutex> lock(m_requests_mutex);
-        m_pending_requests[id] = pending;
+        std::lock_guard<std::mutex> lock(m_cleanup_mutex);
+        m_deadlines.push({ deadline, id });
+        if (m_deadlines.top().id == id) {
+            m_cleanup_cv.notify_one();
+        }
     }
 
-    std::lock_guard<std::mutex> send_lock(m_send_mutex);
+    return message.dump();
+}
 
-    bool ok = m_sender(payload);
+void cdp_client::write_requests(const std::string& payload, const std::vector<int>& ids)
+{
+    bool ok;
+    {
+        std::lock_guard<std::mutex> send_lock(m_send_mutex);
+        ok = m_sender(payload);
+    }
 
-    if (!ok) {
-        /** remove from pending and fail the promise */
-        std::lock_guard<std::mutex> lock(m_requests_mutex);
-        m_pending_requests.erase(id);
+    if (ok) {
+        return;
+    }
 
-        if (!pending->completed.exchange(true, std::memory_order_acq_rel)) {
-            try {
-                pending->promise.set_exception(std::make_exception_ptr(std::runtime_error("Send failed")));
-            } catch (...) {
-                LOG_ERROR("Failed to set exception on pending request due to send failure");
-            }
+    /** remove from pending and fail the requests, unless a response or timeout already claimed them */
+    for (int id : ids) {
+        if (auto failed = take_pending_request(id)) {
+            failed->reject(std::make_exception_ptr(std::runtime_error("Send failed")));
         }
     }
+}
 
-    return future;
+void cdp_client::async_request::resolve(json result)
+{
+    try {
+        if (auto* promise = std::get_if<std::promise<json>>(&target)) {
+            promise->set_value(std::move(result));
+        } else if (auto& callback = std::get<settle_callback>(target)) {
+            callback(std::move(result), nullptr);
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to resolve pending request: {}", e.what());
+    }
+}
+
+void cdp_client::async_request::reject(std::exception_ptr error)
+{
+    try {
+        if (auto* promise = std::get_if<std::promise<json>>(&target)) {
+            promise->set_exception(error);
+        } else if (auto& callback = std::get<settle_callback>(target)) {
+            callback(json(), error);
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to reject pending request: {}", e.what());
+    }
 }
 
 /**
@@ -299,7 +474,7 @@ void cdp_client::off_all(const std::string& event)
 /**
  * Handle an incoming message from the CDP endpoint.
  */
-void cdp_client::handle_message(const std::string& payload)
+void cdp_client::handle_message(cdp_frame frame)
 {
     if (m_shutdown.load(std::memory_order_acquire)) {
         return;
@@ -316,16 +491,74 @@ void cdp_client::handle_message(const std::string& payload)
         return;
     }
 
-    m_incoming_queue.emplace_back(payload);
+    m_incoming_queue.emplace_back(std::move(frame));
     m_incoming_cv.notify_one();
 }
 
-void cdp_client::process_message(const std::string& payload)
+/**
+ * Parse and dispatch an incoming message.
+ * Only the top-level envelope is scanned up front; params/result are materialized
+ * only when a pending request or an event listener actually wants them.
+ */
+void cdp_client::process_message(std::string_view payload)
 {
     if (m_shutdown.load(std::memory_order_acquire)) {
         return;
     }
 
+    cdp_envelope envelope;
+    if (!cdp_scan_envelope(payload, envelope)) {
+        process_message_slow(payload);
+        return;
+    }
+
+    if (envelope.id.has_value()) {
+        auto pending = take_pending_request(*envelope.id);
+        if (!pending) {
+            LOG_ERROR("Received CDP response for unknown request ID: " + std::to_string(*envelope.id));
+            return;
+        }
+
+        json response = json::object();
+        try {
+            if (!envelope.error.empty()) {
+                response["error"] = json::parse(envelope.error);
+            } else if (!envelope.result.empty()) {
+                response["result"] = json::parse(envelope.result);
+            }
+            settle_request(*pending, std::move(response));
+        } catch (const json::parse_error& e) {
+            settle_request(*pending, json::object());
+            invoke_error_handler("JSON parse", e);
+        }
+    } else if (!envelope.method.empty()) {
+        auto callbacks = get_event_listeners(std::string(envelope.method));
+
+        /** nobody is listening, drop it before paying for the params dom */
+        if (callbacks.empty()) {
+            return;
+        }
+
+        json params;
+        try {
+            params = envelope.params.empty() ? json::object() : json::parse(envelope.params);
+        } catch (const json::parse_error& e) {
+            invoke_error_handler("JSON parse", e);
+            return;
+        }
+
+        if (!envelope.session_id.empty()) {
+            params["sessionId"] = std::string(envelope.session_id);
+        }
+        dispatch_event(callbacks, std::move(params));
+    }
+}
+
+/**
+ * Full DOM parse for messages the envelope scanner doesn't handle (malformed json, escaped method names).
+ */
+void cdp_client::process_message_slow(std::string_view payload)
+{
     json message;
     try {
         message = json::parse(payload);
@@ -340,135 +573,162 @@ void cdp_client::process_message(const std::string& payload)
 
     if (message.contains("id") && message["id"].is_number_integer()) {
         int id = message["id"].get<int>();
-        std::shared_ptr<async_request> pending;
-
-        {
-            std::lock_guard<std::mutex> lock(m_requests_mutex);
-            auto it = m_pending_requests.find(id);
-            if (it != m_pending_requests.end()) {
-                pending = it->second;
-                m_pending_requests.erase(it);
-            }
-        }
+        auto pending = take_pending_request(id);
 
         if (pending) {
-            if (!pending->completed.exchange(true, std::memory_order_acq_rel)) {
-                try {
-                    if (message.contains("error")) {
-                        std::string error_msg = "CDP Error";
-                        if (message["error"].contains("message") && message["error"]["message"].is_string()) {
-                            error_msg = message["error"]["message"].get<std::string>();
-                        }
-                        pending->promise.set_exception(std::make_exception_ptr(std::runtime_error(error_msg)));
-                    } else if (message.contains("result")) {
-                        pending->promise.set_value(message["result"]);
-                    } else {
-                        pending->promise.set_exception(std::make_exception_ptr(std::runtime_error("Invalid CDP response")));
-                    }
-                } catch (...) {
-                    LOG_ERROR("Failed to set value/exception on pending request");
-                }
-            }
+            settle_request(*pending, std::move(message));
         } else {
             LOG_ERROR("Received CDP response for unknown request ID: " + std::to_string(id));
         }
     } else if (message.contains("method") && message["method"].is_string()) {
-        std::string method = message["method"].get<std::string>();
+        auto callbacks = get_event_listeners(message["method"].get<std::string>());
+        if (callbacks.empty()) {
+            return;
+        }
 
-        json params = message.contains("params") ? message["params"] : json::object();
+        json params = message.contains("params") ? std::move(message["params"]) : json::object();
         if (message.contains("sessionId") && message["sessionId"].is_string()) {
             params["sessionId"] = message["sessionId"].get<std::string>();
         }
+        dispatch_event(callbacks, std::move(params));
+    }
+}
 
-        std::vector<std::shared_ptr<event_callback>> callbacks;
-        {
-            std::shared_lock<std::shared_mutex> lock(m_events_mutex);
-            auto it = m_event_callbacks.find(method);
-            if (it != m_event_callbacks.end()) {
-                for (const auto& listener : it->second) {
-                    callbacks.push_back(listener.callback);
-                }
-            }
+std::optional<cdp_client::async_request> cdp_client::take_pending_request(int id)
+{
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.requests.find(id);
+    if (it == shard.requests.end()) {
+        return std::nullopt;
+    }
+
+    auto pending = std::move(it->second);
+    shard.requests.erase(it);
+    return pending;
+}
+
+/**
+ * Resolve or reject a pending request from a response object holding "result" or "error".
+ */
+void cdp_client::settle_request(async_request& pending, json response)
+{
+    if (response.contains("error")) {
+        std::string error_msg = "CDP Error";
+        if (response["error"].contains("message") && response["error"]["message"].is_string()) {
+            error_msg = response["error"]["message"].get<std::string>();
         }
+        pending.reject(std::make_exception_ptr(std::runtime_error(error_msg)));
+    } else if (response.contains("result")) {
+        pending.resolve(std::move(response["result"]));
+    } else {
+        pending.reject(std::make_exception_ptr(std::runtime_error("Invalid CDP response")));
+    }
+}
 
-        for (const auto& callback : callbacks) {
-            if (m_callback_pool) {
-                m_callback_pool->enqueue([this, callback, params]()
-                {
-                    try {
-                        (*callback)(params);
-                    } catch (const std::exception& e) {
-                        try {
-                            invoke_error_handler("Event callback", e);
-                        } catch (...) {
-                            LOG_ERROR("Failed to invoke error handler for event callback exception");
-                        }
-                    } catch (...) {
-                        try {
-                            invoke_error_handler("Event callback", std::runtime_error("Unknown exception"));
-                        } catch (...) {
-                            LOG_ERROR("Failed to invoke error handler for event callback exception");
-                        }
-                    }
-                });
-            }
+std::vector<std::shared_ptr<cdp_client::event_callback>> cdp_client::get_event_listeners(const std::string& method)
+{
+    std::vector<std::shared_ptr<event_callback>> callbacks;
+
+    std::shared_lock<std::shared_mutex> lock(m_events_mutex);
+    auto it = m_event_callbacks.find(method);
+    if (it != m_event_callbacks.end()) {
+        for (const auto& listener : it->second) {
+            callbacks.push_back(listener.callback);
         }
     }
+    return callbacks;
+}
+
+/**
+ * Hand an event to each listener on the callback pool.
+ * The params are shared between listeners rather than copied per callback.
+ */
+void cdp_client::dispatch_event(const std::vector<std::shared_ptr<event_callback>>& callbacks, json params)
+{
+    if (!m_callback_pool) {
+        return;
+    }
+
+    auto shared_params = std::make_shared<const json>(std::move(params));
+
+    for (const auto& callback : callbacks) {
+        m_callback_pool->enqueue([this, callback, shared_params]()
+        {
+            try {
+                (*callback)(*shared_params);
+            } catch (const std::exception& e) {
+                try {
+                    invoke_error_handler("Event callback", e);
+                } catch (...) {
+                    LOG_ERROR("Failed to invoke error handler for event callback exception");
+                }
+            } catch (...) {
+                try {
+                    invoke_error_handler("Event callback", std::runtime_error("Unknown exception"));
+                } catch (...) {
+                    LOG_ERROR("Failed to invoke error handler for event callback exception");
+                }
+            }
+        });
+    }
 }
 
 /**
  * Cleanup loop running in a separate thread.
+ * Sleeps until the earliest pending deadline (or until a sooner one is registered),
+ * so requests time out on schedule instead of on a polling tick.
  */
 void cdp_client::cleanup_loop()
 {
     while (!m_shutdown.load(std::memory_order_acquire)) {
+        std::vector<int> expired;
         {
             std::unique_lock<std::mutex> lock(m_cleanup_mutex);
-            m_cleanup_cv.wait_for(lock, std::chrono::seconds(1), [this]
-            {
-                return m_shutdown.load(std::memory_order_acquire);
-            });
+            if (m_deadlines.empty()) {
+                m_cleanup_cv.wait(lock, [this]
+                {
+                    return m_shutdown.load(std::memory_order_acquire) || !m_deadlines.empty();
+                });
+            } else {
+                const auto next = m_deadlines.top().deadline;
+                m_cleanup_cv.wait_until(lock, next, [this, next]
+                {
+                    return m_shutdown.load(std::memory_order_acquire) || m_deadlines.top().deadline < next;
+                });
+            }
+
+            if (m_shutdown.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            while (!m_deadlines.empty() && m_deadlines.top().deadline <= now) {
+                expired.push_back(m_deadlines.top().id);
+                m_deadlines.pop();
+            }
         }
 
-        if (!m_shutdown.load(std::memory_order_acquire)) {
-            cleanup_stale_requests();
+        if (!expired.empty()) {
+            cleanup_stale_requests(expired);
         }
     }
 }
 
 /**
- * Cleanup stale requests that have timed out.
- * This method is called periodically by the cleanup thread.
- * It checks for requests that have exceeded their timeout and
- * sets an exception on their promises.
+ * Fail requests whose deadline has passed.
+ * Ids that were already answered (or failed to send) are no longer in their shard and are skipped.
  */
-void cdp_client::cleanup_stale_requests()
+void cdp_client::cleanup_stale_requests(const std::vector<int>& expired)
 {
-    auto now = std::chrono::steady_clock::now();
-    std::vector<std::pair<int, std::shared_ptr<async_request>>> to_timeout;
-
-    {
-        std::lock_guard<std::mutex> lock(m_requests_mutex);
-        for (auto it = m_pending_requests.begin(); it != m_pending_requests.end();) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second->timestamp);
-
-            if (elapsed > it->second->timeout) {
-                to_timeout.push_back(*it);
-                it = m_pending_requests.erase(it);
-            } else {
-                ++it;
-            }
+    for (int id : expired) {
+        auto pending = take_pending_request(id);
+        if (!pending) {
+            continue;
         }
-    }
 
-    for (auto& [id, pending] : to_timeout) {
-        if (!pending->completed.exchange(true, std::memory_order_acq_rel)) {
-            try {
-                pending->promise.set_exception(std::make_exception_ptr(std::runtime_error("Request timeout")));
-            } catch (...) {
-                LOG_ERROR("Failed to set exception on pending request due to timeout");
-            }
-        }
+        pending->reject(std::make_exception_ptr(std::runtime_error("Request timeout")));
     }
 }
 
@@ -67,12 +67,14 @@ static bool pipe_send(HANDLE hWrite, const std::string& payload)
 
 static void pipe_read_loop(HANDLE hRead, std::shared_ptr<cdp_client> cdp)
 {
-    std::string buffer;
-    char chunk[4096];
+    cdp_frame_reader reader;
+    cdp_frame frame;
 
     while (cdp->is_active()) {
+        std::span<char> region = reader.prepare();
+
         DWORD bytesRead = 0;
-        if (!ReadFile(hRead, chunk, sizeof(chunk), &bytesRead, nullptr)) {
+        if (!ReadFile(hRead, region.data(), static_cast<DWORD>(region.size()), &bytesRead, nullptr)) {
             DWORD err = GetLastError();
             if (err == ERROR_BROKEN_PIPE) {
                 logger.log("CDP pipe closed by remote end.");
@@ -88,16 +90,12 @@ static void pipe_read_loop(HANDLE hRead, std::shared_ptr<cdp_client> cdp)
             continue;
         }
 
-        buffer.append(chunk, bytesRead);
+        reader.commit(bytesRead);
 
         /** extract null-terminated messages */
-        size_t pos;
-        while ((pos = buffer.find('\0')) != std::string::npos) {
-            std::string message = buffer.substr(0, pos);
-            buffer.erase(0, pos + 1);
-
-            if (!message.empty()) {
-                cdp->handle_message(message);
+        while (reader.next_frame(frame)) {
+            if (!frame.data.empty()) {
+                cdp->handle_message(std::move(frame));
             }
         }
     }
@@ -210,8 +208,8 @@ static bool pipe_send(int fd, const std::string& payload)
 
 static void pipe_read_loop(int data_fd, int cancel_fd, int pipe_change_fd, std::shared_ptr<cdp_client> cdp)
 {
-    std::string buffer;
-    char chunk[4096];
+    cdp_frame_reader reader;
+    cdp_frame frame;
 
     struct pollfd pfds[3] = {
         { data_fd,        POLLIN, 0 },
@@ -248,7 +246,8 @@ static void pipe_read_loop(int data_fd, int cancel_fd, int pipe_change_fd, std::
 
         if (!(pfds[0].revents & POLLIN)) continue;
 
-        ssize_t n = read(data_fd, chunk, sizeof(chunk));
+        std::span<char> region = reader.prepare();
+        ssize_t n = read(data_fd, region.data(), region.size());
         if (n < 0) {
             LOG_ERROR("CDP pipe read failed (errno {})", errno);
             break;
@@ -258,14 +257,11 @@ static void pipe_read_loop(int data_fd, int cancel_fd, int pipe_change_fd, std::
             break;
         }
 
-        buffer.append(chunk, static_cast<size_t>(n));
+        reader.commit(static_cast<size_t>(n));
 
-        size_t pos;
-        while ((pos = buffer.find('\0')) != std::string::npos) {
-            std::string message = buffer.substr(0, pos);
-            buffer.erase(0, pos + 1);
-            if (!message.empty()) {
-                cdp->handle_message(message);
+        while (reader.next_frame(frame)) {
+            if (!frame.data.empty()) {
+                cdp->handle_message(std::move(frame));
             }
         }
     }
@@ -0,0 +1,229 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/cdp_envelope.h"
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void skip_space(std::string_view s, size_t& pos)
+{
+    while (pos < s.size() && is_space(s[pos])) {
+        ++pos;
+    }
+}
+
+/**
+ * skip a json string starting at the opening quote, leaving pos one past the closing quote.
+ * memchr does the heavy lifting, so long string values (base64 bodies etc) are skipped quickly.
+ */
+bool skip_string(std::string_view s, size_t& pos, bool* has_escape = nullptr)
+{
+    size_t cur = pos + 1;
+
+    while (cur < s.size()) {
+        const void* hit = std::memchr(s.data() + cur, '"', s.size() - cur);
+        if (!hit) {
+            return false;
+        }
+
+        const size_t quote = static_cast<size_t>(static_cast<const char*>(hit) - s.data());
+
+        /** a quote is escaped if it's preceded by an odd number of backslashes */
+        size_t backslashes = 0;
+        while (quote - backslashes > pos + 1 && s[quote - backslashes - 1] == '\\') {
+            ++backslashes;
+        }
+
+        if (has_escape && std::memchr(s.data() + cur, '\\', quote - cur)) {
+            *has_escape = true;
+        }
+
+        cur = quote + 1;
+        if (backslashes % 2 == 0) {
+            pos = cur;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** skip an object or array, tracking nesting and stepping over strings so brackets inside them are ignored */
+bool skip_container(std::string_view s, size_t& pos)
+{
+    int depth = 0;
+
+    while (pos < s.size()) {
+        switch (s[pos]) {
+            case '"':
+                if (!skip_string(s, pos)) return false;
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) {
+                    ++pos;
+                    return true;
+                }
+                break;
+            default:
+                break;
+        }
+        ++pos;
+    }
+    return false;
+}
+
+bool skip_value(std::string_view s, size_t& pos)
+{
+    if (pos >= s.size()) {
+        return false;
+    }
+
+    switch (s[pos]) {
+        case '"':
+            return skip_string(s, pos);
+        case '{':
+        case '[':
+            return skip_container(s, pos);
+        default:
+        {
+            /** number, true, false, null */
+            const size_t start = pos;
+            while (pos < s.size() && s[pos] != ',' && s[pos] != '}' && s[pos] != ']' && !is_space(s[pos])) {
+                ++pos;
+            }
+            return pos > start;
+        }
+    }
+}
+
+/** unquoted contents of a string value, or nullopt when it isn't a plain (escape-free) string */
+std::optional<std::string_view> plain_string(std::string_view value)
+{
+    if (value.size() < 2 || value.front() != '"' || value.back() != '"') {
+        return std::nullopt;
+    }
+
+    const std::string_view inner = value.substr(1, value.size() - 2);
+    if (inner.find('\\') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    return inner;
+}
+} // namespace
+
+bool cdp_scan_envelope(std::string_view payload, cdp_envelope& out)
+{
+    out = {};
+    size_t pos = 0;
+
+    skip_space(payload, pos);
+    if (pos >= payload.size() || payload[pos] != '{') {
+        return false;
+    }
+    ++pos;
+
+    skip_space(payload, pos);
+    if (pos < payload.size() && payload[pos] == '}') {
+        return true;
+    }
+
+    while (pos < payload.size()) {
+        skip_space(payload, pos);
+        if (pos >= payload.size() || payload[pos] != '"') {
+            return false;
+        }
+
+        const size_t key_start = pos;
+        bool key_escaped = false;
+        if (!skip_string(payload, pos, &key_escaped)) {
+            return false;
+        }
+        const std::string_view key = payload.substr(key_start + 1, pos - key_start - 2);
+
+        skip_space(payload, pos);
+        if (pos >= payload.size() || payload[pos] != ':') {
+            return false;
+        }
+        ++pos;
+        skip_space(payload, pos);
+
+        const size_t value_start = pos;
+        if (!skip_value(payload, pos)) {
+            return false;
+        }
+        const std::string_view value = payload.substr(value_start, pos - value_start);
+
+        if (key_escaped) {
+            /** none of the keys we care about are ever escaped, don't try to interpret it */
+        } else if (key == "id") {
+            int id = 0;
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), id);
+            if (ec == std::errc() && end == value.data() + value.size()) {
+                out.id = id;
+            }
+        } else if (key == "method" || key == "sessionId") {
+            const auto str = plain_string(value);
+            if (!str.has_value()) {
+                return false;
+            }
+            (key == "method" ? out.method : out.session_id) = *str;
+        } else if (key == "params") {
+            out.params = value;
+        } else if (key == "result") {
+            out.result = value;
+        } else if (key == "error") {
+            out.error = value;
+        }
+
+        skip_space(payload, pos);
+        if (pos >= payload.size()) {
+            return false;
+        }
+        if (payload[pos] == '}') {
+            return true;
+        }
+        if (payload[pos] != ',') {
+            return false;
+        }
+        ++pos;
+    }
+    return false;
+}
@@ -0,0 +1,183 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/cdp_event_batcher.h"
+#include <algorithm>
+
+cdp_event_batcher::cdp_event_batcher(send_fn sender, options opts) : m_sender(std::move(sender)), m_options(std::move(opts))
+{
+    m_worker = std::thread([this] { run(); });
+}
+
+cdp_event_batcher::~cdp_event_batcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+
+    if (m_worker.joinable()) m_worker.join();
+}
+
+void cdp_event_batcher::push(std::string_view method, const json& params, const std::vector<target>& targets)
+{
+    if (targets.empty()) return;
+
+    const json event_data = {
+        { "method", method },
+        { "params", params }
+    };
+    const auto event = std::make_shared<const std::string>(event_data.dump());
+    const auto now = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& dest : targets) {
+            auto& queue = m_queues[{ dest.session_id, dest.ctx_id }];
+            if (queue.events.empty()) queue.first_queued = now;
+            queue.dest = dest;
+            queue.events.push_back(event);
+            queue.bytes += event->size();
+
+            /** drop oldest, but always keep the newest event even if it alone is over the byte budget */
+            while (queue.events.size() > m_options.max_queued_events || (queue.bytes > m_options.max_queued_bytes && queue.events.size() > 1)) {
+                queue.bytes -= queue.events.front()->size();
+                queue.events.pop_front();
+                ++queue.dropped;
+                ++m_dropped;
+            }
+        }
+    }
+    m_cv.notify_one();
+}
+
+void cdp_event_batcher::forget(int ctx_id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::erase_if(m_queues, [ctx_id](const auto& entry) { return entry.first.second == ctx_id; });
+}
+
+size_t cdp_event_batcher::dropped() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
+
+std::string cdp_event_batcher::build_expression(const std::vector<std::shared_ptr<const std::string>>& events)
+{
+    static constexpr std::string_view prefix = "(e=>{for(const d of e)window.__millennium_cdp_event__(d)})([";
+    static constexpr std::string_view suffix = "])";
+
+    size_t size = prefix.size() + suffix.size() + events.size();
+    for (const auto& event : events)
+        size += event->size();
+
+    std::string expression;
+    expression.reserve(size);
+    expression.append(prefix);
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (i) expression.push_back(',');
+        expression.append(*events[i]);
+    }
+    expression.append(suffix);
+    return expression;
+}
+
+void cdp_event_batcher::run()
+{
+    struct pending_flush
+    {
+        std::pair<std::string, int> key;
+        target dest;
+        std::vector<std::shared_ptr<const std::string>> events;
+        size_t dropped;
+    };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stop) {
+        const auto now = std::chrono::steady_clock::now();
+        auto next_wake = std::chrono::steady_clock::time_point::max();
+        std::vector<pending_flush> flushes;
+
+        for (auto it = m_queues.begin(); it != m_queues.end();) {
+            auto& queue = it->second;
+            const bool busy = queue.in_flight.valid() && queue.in_flight.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+
+            if (queue.events.empty()) {
+                /** nothing left to send or wait on */
+                if (!busy) {
+                    it = m_queues.erase(it);
+                    continue;
+                }
+            } else if (busy) {
+                /** the page hasn't caught up with the last batch yet, keep accumulating */
+                next_wake = std::min(next_wake, now + m_options.window);
+            } else if (queue.first_queued + m_options.window > now) {
+                next_wake = std::min(next_wake, queue.first_queued + m_options.window);
+            } else {
+                flushes.push_back({ it->first, queue.dest, { std::make_move_iterator(queue.events.begin()), std::make_move_iterator(queue.events.end()) }, queue.dropped });
+                queue.events.clear();
+                queue.bytes = 0;
+                queue.dropped = 0;
+            }
+            ++it;
+        }
+
+        if (!flushes.empty()) {
+            lock.unlock();
+            for (auto& flush : flushes) {
+                if (flush.dropped && m_options.on_overflow) m_options.on_overflow(flush.dest, flush.dropped);
+
+                std::future<json> sent;
+                try {
+                    sent = m_sender(flush.dest, build_expression(flush.events));
+                } catch (...) {
+                    /** transport is gone, the batch is lost either way */
+                }
+
+                lock.lock();
+                auto it = m_queues.find(flush.key);
+                if (it != m_queues.end()) it->second.in_flight = std::move(sent);
+                lock.unlock();
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (next_wake == std::chrono::steady_clock::time_point::max()) {
+            m_cv.wait(lock);
+        } else {
+            m_cv.wait_until(lock, next_wake);
+        }
+    }
+}
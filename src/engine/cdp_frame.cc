@@ -0,0 +1,108 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/cdp_frame.h"
+#include <algorithm>
+#include <cstring>
+
+cdp_frame_reader::cdp_frame_reader(size_t slab_size) : m_slab_size(std::max(slab_size, min_read_size))
+{
+}
+
+/**
+ * Reserve space for the next transport read.
+ * Only the partial message at the tail of the buffer is ever moved; complete frames stay
+ * where they are so queued views into the old slab remain valid.
+ */
+std::span<char> cdp_frame_reader::prepare(size_t min_free)
+{
+    const bool exclusive = m_slab && m_slab.use_count() == 1;
+
+    /** nothing buffered and nobody looking at the slab, start over at the front */
+    if (exclusive && m_head == m_tail) {
+        m_head = m_scan = m_tail = 0;
+    }
+
+    if (m_slab && m_capacity - m_tail >= min_free) {
+        return { m_slab.get() + m_tail, m_capacity - m_tail };
+    }
+
+    const size_t partial = m_tail - m_head;
+    const size_t needed = partial + min_free;
+
+    if (exclusive && needed <= m_capacity) {
+        std::memmove(m_slab.get(), m_slab.get() + m_head, partial);
+    } else {
+        /** grow geometrically while a single large message is being assembled, keeps big replies amortized O(n) */
+        size_t capacity = std::max(m_slab_size, needed);
+        if (partial >= m_capacity / 2) {
+            capacity = std::max(capacity, m_capacity * 2);
+        }
+
+        auto slab = std::make_shared_for_overwrite<char[]>(capacity);
+        if (partial > 0) {
+            std::memcpy(slab.get(), m_slab.get() + m_head, partial);
+        }
+        m_slab = std::move(slab);
+        m_capacity = capacity;
+    }
+
+    m_scan -= m_head;
+    m_tail = partial;
+    m_head = 0;
+    return { m_slab.get() + m_tail, m_capacity - m_tail };
+}
+
+void cdp_frame_reader::commit(size_t n)
+{
+    m_tail = std::min(m_tail + n, m_capacity);
+}
+
+bool cdp_frame_reader::next_frame(cdp_frame& out)
+{
+    if (m_scan >= m_tail) {
+        return false;
+    }
+
+    const char* base = m_slab.get();
+    const void* delim = std::memchr(base + m_scan, '\0', m_tail - m_scan);
+
+    if (!delim) {
+        m_scan = m_tail;
+        return false;
+    }
+
+    const size_t end = static_cast<size_t>(static_cast<const char*>(delim) - base);
+    out.slab = m_slab;
+    out.data = std::string_view(base + m_head, end - m_head);
+
+    m_head = m_scan = end + 1;
+    return true;
+}
@@ -31,6 +31,7 @@
 #include "millennium/child_process.h"
 #include "millennium/logger.h"
 #include "millennium/plugin_ipc.h"
+#include "millennium/thread_pool.h"
 #include "mep/crash_event_bus.h"
 
 #include <cstring>
@@ -113,8 +114,9 @@ static PluginProcess::process_metrics read_proc_metrics(HANDLE hProcess)
 }
 #endif
 
-PluginProcess::PluginProcess(const std::string& plugin_name, const std::string& socket_path, plugin_ipc::socket_fd client_fd, pid_type pid, request_handler handler)
-    : m_plugin_name(plugin_name), m_socket_path(socket_path), m_client_fd(client_fd), m_pid(pid), m_request_handler(std::move(handler))
+PluginProcess::PluginProcess(const std::string& plugin_name, plugin_ipc::socket_fd client_fd, pid_type pid, request_handler handler)
+    : m_plugin_name(plugin_name), m_client_fd(client_fd), m_pid(pid), m_request_handler(std::move(handler)),
+      m_request_pool(std::make_unique<thread_pool>(MAX_INFLIGHT_REQUESTS, MAX_QUEUED_REQUESTS))
 {
     m_reader_thread = std::thread(&PluginProcess::reader_thread_fn, this);
 }
@@ -129,16 +131,22 @@ PluginProcess::~PluginProcess()
 #else
         ::shutdown(m_client_fd, SHUT_RDWR);
 #endif
-        plugin_ipc::close_fd(m_client_fd);
-        m_client_fd = plugin_ipc::INVALID_FD;
     }
 
     if (m_reader_thread.joinable()) {
         m_reader_thread.join();
     }
 
-    /* clean up the socket file so we don't leak temp entries */
-    ::unlink(m_socket_path.c_str());
+    /* requests still running finish against the dead socket, queued ones are dropped with the child */
+    m_request_pool->shutdown();
+
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        if (m_client_fd != plugin_ipc::INVALID_FD) {
+            plugin_ipc::close_fd(m_client_fd);
+            m_client_fd = plugin_ipc::INVALID_FD;
+        }
+    }
 
     /* make sure the child is actually gone */
     if (is_alive()) {
@@ -182,6 +190,11 @@ bool PluginProcess::send_frame(const nlohmann::json& msg)
 }
 
 nlohmann::json PluginProcess::call(const std::string& method, const nlohmann::json& params, std::chrono::milliseconds timeout)
+{
+    return call_packed(method, nlohmann::json::to_msgpack(params), timeout);
+}
+
+nlohmann::json PluginProcess::call_packed(std::string_view method, const std::vector<uint8_t>& packed_params, std::chrono::milliseconds timeout)
 {
     int id = m_next_id.fetch_add(1);
 
@@ -193,14 +206,17 @@ nlohmann::json PluginProcess::call(const std::string& method, const nlohmann::js
         m_pending[id] = entry;
     }
 
-    nlohmann::json req = {
-        { "type",   plugin_ipc::TYPE_REQUEST },
-        { "id",     id                       },
-        { "method", method                   },
-        { "params", params                   }
-    };
+    /** the envelope is packed around the params bytes directly, there's no request document to copy params into */
+    thread_local std::vector<uint8_t> frame;
+    plugin_ipc::pack_request(frame, id, method, packed_params);
+
+    bool sent;
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        sent = plugin_ipc::write_frame(m_client_fd, frame);
+    }
 
-    if (!send_frame(req)) {
+    if (!sent) {
         std::lock_guard<std::mutex> lock(m_pending_mutex);
         m_pending.erase(id);
         throw std::runtime_error("failed to send RPC to child: " + m_plugin_name);
@@ -348,6 +364,12 @@ PluginProcess::process_metrics PluginProcess::get_metrics()
     }
 #endif
 
+    m.requests.in_flight = m_requests_in_flight.load(std::memory_order_relaxed);
+    m.requests.queued = m_requests_queued.load(std::memory_order_relaxed);
+    m.requests.peak_queued = m_requests_peak_queued.load(std::memory_order_relaxed);
+    m.requests.completed = m_requests_completed.load(std::memory_order_relaxed);
+    m.requests.rejected = m_requests_rejected.load(std::memory_order_relaxed);
+
     /* Lua heap from the child process */
     try {
         auto result = call(plugin_ipc::parent_method::GET_METRICS, nullptr, std::chrono::seconds(2));
@@ -371,6 +393,73 @@ void PluginProcess::handle_child_notification(const std::string& method, const n
     }
 }
 
+void PluginProcess::dispatch_child_request(int id, std::string method, nlohmann::json params)
+{
+    const size_t depth = m_requests_queued.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = m_requests_peak_queued.load(std::memory_order_relaxed);
+    while (depth > peak && !m_requests_peak_queued.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+    }
+
+    const bool queued = m_request_pool->try_enqueue([this, id, method = std::move(method), params = std::move(params)]
+    {
+        m_requests_queued.fetch_sub(1, std::memory_order_relaxed);
+        m_requests_in_flight.fetch_add(1, std::memory_order_relaxed);
+
+        handle_child_request(id, method, params);
+
+        m_requests_in_flight.fetch_sub(1, std::memory_order_relaxed);
+        m_requests_completed.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    if (!queued) {
+        m_requests_queued.fetch_sub(1, std::memory_order_relaxed);
+        m_requests_rejected.fetch_add(1, std::memory_order_relaxed);
+
+        nlohmann::json resp = {
+            { "type",  plugin_ipc::TYPE_RESPONSE                         },
+            { "id",    id                                                },
+            { "error", "too many pending requests from " + m_plugin_name }
+        };
+        send_frame(resp);
+    }
+}
+
+void PluginProcess::handle_child_request(int id, const std::string& method, const nlohmann::json& params)
+{
+    request_handler handler;
+    {
+        std::lock_guard<std::mutex> lock(m_handler_mutex);
+        handler = m_request_handler;
+    }
+
+    if (handler) {
+        try {
+            nlohmann::json result = handler(m_plugin_name, method, params);
+
+            nlohmann::json resp = {
+                { "type",   plugin_ipc::TYPE_RESPONSE },
+                { "id",     id                        },
+                { "result", result                    }
+            };
+            send_frame(resp);
+        } catch (const std::exception& e) {
+            nlohmann::json resp = {
+                { "type",  plugin_ipc::TYPE_RESPONSE },
+                { "id",    id                        },
+                { "error", std::string(e.what())     }
+            };
+            send_frame(resp);
+        }
+    } else {
+        nlohmann::json resp = {
+            { "type",  plugin_ipc::TYPE_RESPONSE },
+            { "id",    id                        },
+            { "error", "no handler registered"   }
+        };
+        send_frame(resp);
+    }
+}
+
 void PluginProcess::reader_thread_fn()
 {
     while (m_running.load()) {
@@ -404,44 +493,10 @@ void PluginProcess::reader_thread_fn()
             }
 
         } else if (type == plugin_ipc::TYPE_REQUEST) {
-            int id = msg.value("id", -1);
-            std::string method = msg.value("method", "");
-            nlohmann::json params = msg.value("params", nlohmann::json::object());
-
-            request_handler handler;
-            {
-                std::lock_guard<std::mutex> lock(m_handler_mutex);
-                handler = m_request_handler;
-            }
-
-            if (handler) {
-                try {
-                    nlohmann::json result = handler(m_plugin_name, method, params);
-
-                    nlohmann::json resp = {
-                        { "type",   plugin_ipc::TYPE_RESPONSE },
-                        { "id",     id                        },
-                        { "result", result                    }
-                    };
-                    send_frame(resp);
-                } catch (const std::exception& e) {
-                    nlohmann::json resp = {
-                        { "type",  plugin_ipc::TYPE_RESPONSE },
-                        { "id",    id                        },
-                        { "error", std::string(e.what())     }
-                    };
-                    send_frame(resp);
-                }
-            } else {
-                nlohmann::json resp = {
-                    { "type",  plugin_ipc::TYPE_RESPONSE },
-                    { "id",    id                        },
-                    { "error", "no handler registered"   }
-                };
-                send_frame(resp);
-            }
+            dispatch_child_request(msg.value("id", -1), msg.value("method", ""), msg.value("params", nlohmann::json::object()));
 
         } else if (type == plugin_ipc::TYPE_NOTIFY) {
+            /* only log lines, which are cheap and must stay in order, so they're handled right here */
             std::string method = msg.value("method", "");
             nlohmann::json params = msg.value("params", nlohmann::json(nullptr));
             handle_child_notification(method, params);
@@ -642,6 +697,7 @@ std::unique_ptr<PluginProcess> spawn_plugin_process(const std::string& plugin_na
         if (ready <= 0) {
             LOG_ERROR("[spawn] accept() timed out waiting for plugin '{}' to connect", plugin_name);
             plugin_ipc::close_fd(server_fd);
+            ::unlink(socket_path.c_str());
 #ifdef _WIN32
             TerminateProcess(hProcess, 1);
             CloseHandle(hProcess);
@@ -662,6 +718,11 @@ plugin_ipc::socket_fd client_fd = static_cast<plugin_ipc::socket_fd>(::accept(se
 if (client_fd >= 0) ::fcntl(client_fd, F_SETFD, FD_CLOEXEC);
 #endif
     plugin_ipc::close_fd(server_fd);
+    /**
+     * nothing else connects to it, so the socket file goes now rather than with the process.
+     * ~PluginProcess can run late (whoever held the last reference), by which point a respawn may own this path.
+     */
+    ::unlink(socket_path.c_str());
 
 #ifdef _WIN32
     if (client_fd == INVALID_SOCKET) {
@@ -680,7 +741,7 @@ if (client_fd >= 0) ::fcntl(client_fd, F_SETFD, FD_CLOEXEC);
         return nullptr;
     }
 
-    auto process = std::make_unique<PluginProcess>(plugin_name, socket_path, client_fd, child_pid, std::move(handler));
+    auto process = std::make_unique<PluginProcess>(plugin_name, client_fd, child_pid, std::move(handler));
 
 #ifdef _WIN32
     process->m_process_handle = hProcess;
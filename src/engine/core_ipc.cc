@@ -187,6 +187,25 @@ ordered_json ipc_main::call_server_method(const json& call)
     return responseMessage;
 }
 
+bool ipc_main::try_call_server_method(const ffi_fast_path::call& call, std::string& response)
+{
+    /** core methods are dispatched on a json document anyway, nothing to gain there */
+    if (call.ipc_id != ipc_method::CALL_SERVER_METHOD || call.plugin == "core") {
+        return false;
+    }
+
+    const auto shared_backend_mgr = m_backend_manager.lock();
+    if (!shared_backend_mgr) {
+        return false;
+    }
+
+    thread_local std::vector<uint8_t> packed_script;
+    ffi_fast_path::pack_evaluate_params(call, packed_script);
+
+    ffi_fast_path::write_response(response, call.plugin, shared_backend_mgr->evaluate_packed(call.plugin, packed_script));
+    return true;
+}
+
 /**
  * Handles the event when the frontend is loaded by notifying the plugin backend via RPC.
  *
@@ -322,8 +341,8 @@ ordered_json ipc_main::call_frontend_method(const json& call)
         const double dur = std::chrono::duration<double, std::milli>(t1 - t0).count();
         json result_json = eval_result.to_json(pluginName);
 
-        mep::ffi_recorder::instance().record(
-            { pluginName, methodName, "be_to_fe", call["data"].dump(), result_json.dump(), dur, std::chrono::system_clock::now(), call["data"].value("caller", std::string{}) });
+        mep::ffi_recorder::instance().record(mep::ffi_call_sample{ pluginName, methodName, "be_to_fe", call["data"].dump(), result_json.dump(), dur,
+                                                                   std::chrono::system_clock::now(), call["data"].value("caller", std::string{}) });
     }
 
     return eval_result.to_json(pluginName);
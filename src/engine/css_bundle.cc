@@ -0,0 +1,436 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/css_bundle.h"
+#include "millennium/url_parser.h"
+
+#include <cctype>
+#include <fstream>
+
+namespace
+{
+bool is_ident_char(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+bool starts_with_ci(std::string_view css, size_t pos, std::string_view word)
+{
+    if (css.size() - pos < word.size()) return false;
+    for (size_t i = 0; i < word.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(css[pos + i])) != word[i]) return false;
+    }
+    return true;
+}
+
+/** index past the string literal starting at pos. like the browser, an unescaped newline ends a bad string */
+size_t skip_string(std::string_view css, size_t pos)
+{
+    const char quote = css[pos++];
+    while (pos < css.size()) {
+        const char c = css[pos];
+        if (c == '\\') {
+            pos += 2;
+        } else if (c == quote) {
+            return pos + 1;
+        } else if (c == '\n') {
+            return pos;
+        } else {
+            ++pos;
+        }
+    }
+    return css.size();
+}
+
+/** index past the comment starting at pos, npos if it never closes */
+size_t skip_comment(std::string_view css, size_t pos)
+{
+    const size_t end = css.find("*/", pos + 2);
+    return end == std::string_view::npos ? end : end + 2;
+}
+
+/** absolute urls, fragments, data: uris and root-relative paths are left alone */
+bool is_absolute_reference(std::string_view ref)
+{
+    if (ref.empty() || ref[0] == '#' || ref[0] == '/') return true;
+    if (!std::isalpha(static_cast<unsigned char>(ref[0]))) return false;
+
+    for (const char c : ref) {
+        if (c == ':') return true;
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '+' && c != '-' && c != '.') return false;
+    }
+    return false;
+}
+
+/** resolve a reference made from a stylesheet in dir (relative to the bundle root) into an absolute url */
+std::string resolve_reference(std::string_view ref, std::string_view dir, std::string_view base_url)
+{
+    if (is_absolute_reference(ref)) return std::string(ref);
+
+    const size_t suffix_pos = ref.find_first_of("?#");
+    const std::string_view suffix = suffix_pos == std::string_view::npos ? std::string_view{} : ref.substr(suffix_pos);
+    std::string_view path = ref.substr(0, suffix_pos);
+
+    std::vector<std::string_view> segments;
+    const std::string encoded_dir = utils::url::plat_encode_url(std::string(dir));
+
+    auto push_segments = [&segments](std::string_view part)
+    {
+        while (!part.empty()) {
+            const size_t slash = part.find('/');
+            const std::string_view segment = part.substr(0, slash);
+
+            if (segment == "..") {
+                if (!segments.empty()) segments.pop_back();
+            } else if (!segment.empty() && segment != ".") {
+                segments.push_back(segment);
+            }
+
+            if (slash == std::string_view::npos) break;
+            part.remove_prefix(slash + 1);
+        }
+    };
+    push_segments(encoded_dir);
+    push_segments(path);
+
+    std::string resolved(base_url);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (i) resolved += '/';
+        resolved += segments[i];
+    }
+    if (!path.empty() && path.back() == '/') resolved += '/';
+    resolved += suffix;
+    return resolved;
+}
+
+/** copy url(...) starting at pos with its reference resolved, returns the index just past the reference */
+size_t rewrite_url_token(std::string_view css, size_t pos, std::string_view dir, std::string_view base_url, std::string& out)
+{
+    out.append(css.substr(pos, 4)); /** "url(" in whatever case the sheet used */
+    pos += 4;
+
+    while (pos < css.size() && is_space(css[pos])) {
+        out += css[pos++];
+    }
+    if (pos >= css.size()) return pos;
+
+    if (css[pos] == '"' || css[pos] == '\'') {
+        const size_t end = skip_string(css, pos);
+        if (end - pos < 2 || css[end - 1] != css[pos]) {
+            out.append(css.substr(pos, end - pos));
+            return end;
+        }
+        out += css[pos];
+        out += resolve_reference(css.substr(pos + 1, end - pos - 2), dir, base_url);
+        out += css[pos];
+        return end;
+    }
+
+    size_t end = pos;
+    while (end < css.size() && css[end] != ')' && !is_space(css[end])) {
+        ++end;
+    }
+    out += resolve_reference(css.substr(pos, end - pos), dir, base_url);
+    return end;
+}
+
+/**
+ * copy css with every url() reference resolved. returns the number of blocks left open at the end, and sets
+ * open_comment if the sheet ends inside a comment, so the caller can close them before the next sheet starts.
+ */
+size_t rewrite_references(std::string_view css, std::string_view dir, std::string_view base_url, std::string& out, bool& open_comment)
+{
+    size_t depth = 0;
+    size_t pos = 0;
+    open_comment = false;
+
+    while (pos < css.size()) {
+        const char c = css[pos];
+
+        if (c == '/' && pos + 1 < css.size() && css[pos + 1] == '*') {
+            const size_t end = skip_comment(css, pos);
+            if (end == std::string_view::npos) {
+                out.append(css.substr(pos));
+                open_comment = true;
+                break;
+            }
+            out.append(css.substr(pos, end - pos));
+            pos = end;
+        } else if (c == '"' || c == '\'') {
+            const size_t end = skip_string(css, pos);
+            out.append(css.substr(pos, end - pos));
+            pos = end;
+        } else if ((c == 'u' || c == 'U') && starts_with_ci(css, pos, "url(") && (pos == 0 || !is_ident_char(css[pos - 1]))) {
+            pos = rewrite_url_token(css, pos, dir, base_url, out);
+        } else {
+            if (c == '{') {
+                ++depth;
+            } else if (c == '}' && depth > 0) {
+                --depth;
+            } else if (c == '\\' && pos + 1 < css.size()) {
+                out += css[pos++];
+            }
+            out += css[pos++];
+        }
+    }
+    return depth;
+}
+
+/** index just past the at-rule statement starting at pos (its terminating ';', or the end of the sheet) */
+size_t statement_end(std::string_view css, size_t pos)
+{
+    while (pos < css.size()) {
+        const char c = css[pos];
+        if (c == '"' || c == '\'') {
+            pos = skip_string(css, pos);
+        } else if (c == '/' && pos + 1 < css.size() && css[pos + 1] == '*') {
+            pos = skip_comment(css, pos);
+            if (pos == std::string_view::npos) return css.size();
+        } else if (c == ';') {
+            return pos + 1;
+        } else if (c == '{') {
+            return pos; /** malformed, leave the block to the body */
+        } else {
+            ++pos;
+        }
+    }
+    return css.size();
+}
+
+bool is_import_at(std::string_view css, size_t pos)
+{
+    return starts_with_ci(css, pos, "@import") && (pos + 7 >= css.size() || !is_ident_char(css[pos + 7]));
+}
+
+/** copy an @import statement with its reference resolved, whether it's written as url() or as a plain string */
+void rewrite_import(std::string_view statement, std::string_view dir, std::string_view base_url, std::string& out)
+{
+    size_t pos = std::string_view("@import").size();
+    out.append(statement.substr(0, pos));
+    while (pos < statement.size() && is_space(statement[pos])) {
+        out += statement[pos++];
+    }
+
+    if (pos < statement.size() && (statement[pos] == '"' || statement[pos] == '\'')) {
+        const size_t end = skip_string(statement, pos);
+        if (end - pos >= 2 && statement[end - 1] == statement[pos]) {
+            out += statement[pos];
+            out += resolve_reference(statement.substr(pos + 1, end - pos - 2), dir, base_url);
+            out += statement[pos];
+            pos = end;
+        }
+    }
+
+    bool open_comment = false;
+    rewrite_references(statement.substr(pos), dir, base_url, out, open_comment);
+    if (out.empty() || out.back() != ';') out += ';';
+    out += '\n';
+}
+} // namespace
+
+bool css_has_import(std::string_view css)
+{
+    size_t pos = 0;
+    while (pos < css.size()) {
+        if (is_space(css[pos])) {
+            ++pos;
+        } else if (css.compare(pos, 2, "/*") == 0) {
+            pos = skip_comment(css, pos);
+        } else if (starts_with_ci(css, pos, "@charset")) {
+            pos = statement_end(css, pos);
+        } else {
+            return is_import_at(css, pos);
+        }
+    }
+    return false;
+}
+
+std::string css_concatenate(const std::vector<css_bundle_source>& sources, std::string_view base_url)
+{
+    std::string imports;
+    std::string body;
+
+    for (const auto& source : sources) {
+        const std::string_view css = source.css;
+        const std::string dir = std::filesystem::path(source.path).parent_path().generic_string();
+
+        /** a comment marker makes it obvious in devtools which file a rule came from */
+        if (source.path.find("*/") == std::string::npos) {
+            body += "/* " + source.path + " */\n";
+        }
+
+        /**
+         * @charset and @import are only valid before any other rule, pull them out of the sheet's prelude.
+         * only the first sheet's imports can go in front, a later sheet's would jump ahead of every sheet before it.
+         */
+        const bool hoist_imports = &source == &sources.front();
+        size_t pos = 0;
+        while (pos < css.size()) {
+            if (is_space(css[pos])) {
+                ++pos;
+            } else if (css.compare(pos, 2, "/*") == 0) {
+                const size_t end = skip_comment(css, pos);
+                if (end == std::string_view::npos) break; /** closed along with the body below */
+                body.append(css.substr(pos, end - pos));
+                body += '\n';
+                pos = end;
+            } else if (starts_with_ci(css, pos, "@charset")) {
+                pos = statement_end(css, pos);
+            } else if (hoist_imports && is_import_at(css, pos)) {
+                const size_t end = statement_end(css, pos);
+                rewrite_import(css.substr(pos, end - pos), dir, base_url, imports);
+                pos = end;
+            } else {
+                break;
+            }
+        }
+
+        bool open_comment = false;
+        const size_t open_blocks = rewrite_references(css.substr(pos), dir, base_url, body, open_comment);
+
+        /** the end of a sheet closes whatever it left open, the next sheet mustn't end up inside it */
+        if (open_comment) body += "*/";
+        body.append(open_blocks, '}');
+        if (!body.empty() && body.back() != '\n') body += '\n';
+    }
+
+    return imports + body;
+}
+
+css_bundler::css_bundler(std::filesystem::path root, std::string base_url, encoder encode)
+    : m_root(std::move(root)), m_base_url(std::move(base_url)), m_encode(std::move(encode))
+{
+}
+
+std::string css_bundler::add(const std::vector<std::string>& paths)
+{
+    /** fnv-1a over the ordered paths, so the same set in the same order always gets the same name */
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto& path : paths) {
+        for (const unsigned char c : path) {
+            hash = (hash ^ c) * 0x100000001b3ull;
+        }
+        hash = (hash ^ 0xff) * 0x100000001b3ull;
+    }
+
+    static constexpr char hex[] = "0123456789abcdef";
+    std::string name(16, '0');
+    for (size_t i = 0; i < name.size(); ++i) {
+        name[name.size() - 1 - i] = hex[(hash >> (i * 4)) & 0xf];
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_bundles.find(name);
+    if (it != m_bundles.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return name;
+    }
+
+    if (m_lru.size() >= m_bundle_limit) {
+        m_bundles.erase(m_lru.back().name);
+        m_lru.pop_back();
+    }
+    m_lru.push_front({ name, paths, {}, nullptr });
+    m_bundles[name] = m_lru.begin();
+    return name;
+}
+
+std::shared_ptr<const vfs_response> css_bundler::find(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_bundles.find(name);
+    if (it == m_bundles.end()) return nullptr;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    bundle& entry = *it->second;
+
+    std::vector<std::optional<vfs_file_stamp>> stamps;
+    stamps.reserve(entry.paths.size());
+    for (const auto& path : entry.paths) {
+        stamps.push_back(vfs_file_stamp::of(m_root / path));
+    }
+
+    if (entry.response && stamps == entry.stamps) {
+        return entry.response;
+    }
+
+    /** a missing file is left out, just like its own <link> would have failed to load */
+    std::vector<css_bundle_source> sources;
+    sources.reserve(entry.paths.size());
+    for (size_t i = 0; i < entry.paths.size(); ++i) {
+        if (!stamps[i]) continue;
+
+        std::ifstream file(m_root / entry.paths[i], std::ios::binary);
+        if (!file.is_open()) continue;
+        sources.push_back({ entry.paths[i], std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()) });
+    }
+
+    entry.response = m_encode(css_concatenate(sources, m_base_url));
+    entry.stamps = std::move(stamps);
+    return entry.response;
+}
+
+std::vector<std::vector<std::string>> css_bundler::split(const std::vector<std::string>& paths)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<std::vector<std::string>> runs;
+    for (const auto& path : paths) {
+        const auto stamp = vfs_file_stamp::of(m_root / path);
+
+        auto it = m_imports.find(path);
+        if (it == m_imports.end() || it->second.first != stamp) {
+            bool has_import = false;
+            if (stamp) {
+                std::ifstream file(m_root / path, std::ios::binary);
+                has_import = file.is_open() && css_has_import(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+            }
+            it = m_imports.insert_or_assign(path, std::make_pair(stamp, has_import)).first;
+        }
+
+        if (runs.empty() || it->second.second) runs.emplace_back();
+        runs.back().push_back(path);
+    }
+    return runs;
+}
+
+void css_bundler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bundles.clear();
+    m_lru.clear();
+    m_imports.clear();
+}
@@ -31,15 +31,34 @@
 #include "millennium/ffi_binder.h"
 #include "millennium/logger.h"
 #include "millennium/core_ipc.h"
+#include "millennium/ffi_fast_path.h"
 #include "mep/ffi_recorder.h"
 #include "mep/sdk_ready_bus.h"
 #include "mep/console_capture.h"
 
+#include <algorithm>
 #include <chrono>
 
 ffi_binder::ffi_binder(std::shared_ptr<cdp_client> client, std::shared_ptr<plugin_manager> plugin_manager, std::shared_ptr<ipc_main> ipc_main)
     : m_client(client), m_plugin_manager(std::move(plugin_manager)), m_ipc_main(std::move(ipc_main))
 {
+    auto send_batch = [client](const cdp_event_batcher::target& dest, const std::string& expression)
+    {
+        json eval_params = {
+            { "contextId",  dest.ctx_id },
+            { "expression", expression  }
+        };
+        return client->send_host("Runtime.evaluate", eval_params, dest.session_id);
+    };
+
+    cdp_event_batcher::options batch_options;
+    batch_options.on_overflow = [](const cdp_event_batcher::target& dest, size_t dropped)
+    {
+        logger.warn("ffi_binder: context {} is falling behind on cdp events, dropped {}", dest.ctx_id, dropped);
+    };
+
+    m_event_batcher = std::make_unique<cdp_event_batcher>(std::move(send_batch), std::move(batch_options));
+    m_ffi_pool = std::make_unique<thread_pool>(FFI_POOL_THREADS, FFI_POOL_MAX_QUEUED);
 }
 
 void ffi_binder::init()
@@ -62,6 +81,10 @@ void ffi_binder::init()
 
 ffi_binder::~ffi_binder()
 {
+    /* first, so no plugin call is left running against a half-destroyed binder (queued ones are dropped) */
+    m_stopping.store(true, std::memory_order_release);
+    m_ffi_pool->shutdown();
+
     std::unique_lock<std::mutex> lock(m_ctx_mutex);
     for (const auto& [event, token] : m_event_sub_tokens) {
         m_client->off(token);
@@ -86,17 +109,24 @@ void ffi_binder::register_isolated_ctx(const std::string& plugin_name, int isola
 }
 
 void ffi_binder::callback_into_js(const json params, const int request_id, ordered_json result)
+{
+    this->callback_into_js_raw(params, request_id, result.dump());
+}
+
+void ffi_binder::callback_into_js_raw(const json& params, const int request_id, std::string_view result_json)
 {
     json eval_params = {
         { "contextId", params["executionContextId"] },
-        { "expression", std::format("window.{}.__handleResponse({}, {})", ffi_constants::frontend_binding_name, request_id, result.dump()) }
+        { "expression", std::format("window.{}.__handleResponse({}, {})", ffi_constants::frontend_binding_name, request_id, result_json) }
     };
 
-    auto eval_result = m_client->send_host("Runtime.evaluate", eval_params, params["sessionId"].get<std::string>()).get();
-    if (eval_result.contains("exceptionDetails")) {
-        LOG_ERROR("ffi_binder: failed to evaluate callback: {}", eval_result["exceptionDetails"].dump());
-        return;
-    }
+    /** nothing to wait for, the page either evaluates the reply or is already gone */
+    m_client->send_host_async("Runtime.evaluate", eval_params, params["sessionId"].get<std::string>(), [](json response, std::exception_ptr error)
+    {
+        if (!error && response.contains("exceptionDetails")) {
+            LOG_ERROR("ffi_binder: failed to evaluate callback: {}", response["exceptionDetails"].dump());
+        }
+    });
 }
 
 bool ffi_binder::is_valid_request(const json& params)
@@ -317,37 +347,59 @@ void ffi_binder::cdp_proxy_call(const std::string& plugin_name, int callback_id,
         return;
     }
 
-    auto deliver = [&](const json& value, bool is_error)
+    std::weak_ptr<ffi_binder> weak_self = weak_from_this();
+    m_client->send_host_async(method, params, target_session, [weak_self, plugin_name, callback_id, session_id, main_ctx_id](json result, std::exception_ptr error)
     {
-        int main_ctx = main_ctx_id;
-        std::string main_sess = session_id;
-        {
-            std::lock_guard<std::mutex> lock(m_ctx_mutex);
-            auto it = m_plugin_ctxs.find(plugin_name);
-            if (it != m_plugin_ctxs.end() && it->second.main_ctx_id != -1) {
-                main_ctx = it->second.main_ctx_id;
-                main_sess = it->second.main_session_id;
-            }
+        auto self = weak_self.lock();
+        if (!self) return;
+
+        if (!error) {
+            self->cdp_proxy_relay(plugin_name, callback_id, result, false, session_id, main_ctx_id);
+            return;
         }
-        const char* js_fn = is_error ? ffi_constants::millennium_cdp_reject : ffi_constants::millennium_cdp_resolve;
-        json eval_params = {
-            { "contextId", main_ctx },
-            { "expression", std::format("{}({}, {})", js_fn, callback_id, value.dump()) }
-        };
-        m_client->send_host("Runtime.evaluate", eval_params, main_sess);
-    };
 
-    try {
-        auto result = m_client->send_host(method, params, target_session).get();
-        deliver(result, false);
-    } catch (const std::exception& e) {
-        deliver(json(std::string(e.what())), true);
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            self->cdp_proxy_relay(plugin_name, callback_id, json(std::string(e.what())), true, session_id, main_ctx_id);
+        }
+    });
+}
+
+void ffi_binder::cdp_proxy_relay(const std::string& plugin_name, int callback_id, const json& result, bool is_error, const std::string& session_id, int main_ctx_id)
+{
+    int main_ctx = main_ctx_id;
+    std::string main_sess = session_id;
+    {
+        std::lock_guard<std::mutex> lock(m_ctx_mutex);
+        auto it = m_plugin_ctxs.find(plugin_name);
+        if (it != m_plugin_ctxs.end() && it->second.main_ctx_id != -1) {
+            main_ctx = it->second.main_ctx_id;
+            main_sess = it->second.main_session_id;
+        }
     }
+    const char* js_fn = is_error ? ffi_constants::millennium_cdp_reject : ffi_constants::millennium_cdp_resolve;
+    json eval_params = {
+        { "contextId", main_ctx },
+        { "expression", std::format("{}({}, {})", js_fn, callback_id, result.dump()) }
+    };
+    m_client->send_host_async("Runtime.evaluate", eval_params, main_sess, [plugin_name](json response, std::exception_ptr error)
+    {
+        if (error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                LOG_ERROR("ffi_binder: failed to relay cdp result to '{}': {}", plugin_name, e.what());
+            }
+        } else if (response.contains("exceptionDetails")) {
+            LOG_ERROR("ffi_binder: failed to relay cdp result to '{}': {}", plugin_name, response["exceptionDetails"].dump());
+        }
+    });
 }
 
 void ffi_binder::cdp_event_dispatch(const std::string& method, const json& params)
 {
-    std::vector<std::pair<int, std::string>> targets; // { main_ctx_id, session_id }
+    std::vector<cdp_event_batcher::target> targets;
     {
         std::lock_guard<std::mutex> lock(m_ctx_mutex);
         auto it = m_event_subs.find(method);
@@ -355,24 +407,19 @@ void ffi_binder::cdp_event_dispatch(const std::string& method, const json& param
 
         for (const auto& plugin_name : it->second) {
             auto ctx_it = m_plugin_ctxs.find(plugin_name);
-            if (ctx_it != m_plugin_ctxs.end() && ctx_it->second.main_ctx_id != -1) {
-                targets.emplace_back(ctx_it->second.main_ctx_id, ctx_it->second.main_session_id);
-            }
+            if (ctx_it == m_plugin_ctxs.end() || ctx_it->second.main_ctx_id == -1) continue;
+
+            /** the sdk fans each event out to every plugin in the window, so a context only needs it once */
+            const auto& ctx = ctx_it->second;
+            const bool seen = std::any_of(targets.begin(), targets.end(), [&](const cdp_event_batcher::target& t)
+            {
+                return t.ctx_id == ctx.main_ctx_id && t.session_id == ctx.main_session_id;
+            });
+            if (!seen) targets.push_back({ ctx.main_ctx_id, ctx.main_session_id });
         }
     }
 
-    const json event_data = {
-        { "method", method },
-        { "params", params }
-    };
-
-    for (const auto& [ctx_id, session_id] : targets) {
-        json eval_params = {
-            { "contextId", ctx_id },
-            { "expression", std::format("window.__millennium_cdp_event__({})", event_data.dump()) }
-        };
-        m_client->send_host("Runtime.evaluate", eval_params, session_id);
-    }
+    m_event_batcher->push(method, params, targets);
 }
 
 void ffi_binder::sdk_ready_hdlr(const json& params)
@@ -453,6 +500,55 @@ void ffi_binder::binding_call_hdlr(const json& params)
         return;
     }
 
+    /**
+     * plugin calls can take arbitrarily long, keep them off the cdp client's event pool.
+     * the task must not own a ref to us, if it dropped the last one ~ffi_binder would run on a pool worker and join itself.
+     * the destructor drains the pool before anything else goes away, so a raw this is safe.
+     */
+    const bool queued = m_ffi_pool->try_enqueue([this, params]
+    {
+        if (!m_stopping.load(std::memory_order_acquire)) this->ffi_call_hdlr(params);
+    });
+
+    if (!queued) {
+        try {
+            const auto payload = json::parse(params["payload"].get<std::string>());
+            if (payload.contains("call_id") && payload["call_id"].is_number()) {
+                const ordered_json busy = {
+                    { "success",    false                                                      },
+                    { "returnJson", "Millennium is handling too many plugin calls, try again." }
+                };
+                this->callback_into_js(params, payload["call_id"], busy);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("ffi_binder: dropped binding call, ffi queue is full and the payload is unreadable: {}", e.what());
+        }
+    }
+}
+
+void ffi_binder::ffi_call_hdlr(const json& params)
+{
+    /** plain backend calls with scalar arguments skip the json dom entirely, see ffi_fast_path */
+    thread_local ffi_fast_path::call fast_call;
+    thread_local std::string fast_response;
+    thread_local std::string fast_args;
+
+    const auto& raw_payload = params["payload"];
+    if (raw_payload.is_string() && ffi_fast_path::parse(raw_payload.get_ref<const std::string&>(), fast_call)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        if (m_ipc_main->try_call_server_method(fast_call, fast_response)) {
+            const auto t1 = std::chrono::steady_clock::now();
+            const double dur = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+            ffi_fast_path::write_arguments_json(fast_call, fast_args);
+            mep::ffi_recorder::instance().record(mep::ffi_call_sample{ fast_call.plugin, fast_call.method, "fe_to_be", fast_args, fast_response, dur,
+                                                                       std::chrono::system_clock::now(), fast_call.caller });
+
+            this->callback_into_js_raw(params, fast_call.call_id, fast_response);
+            return;
+        }
+    }
+
     json payload;
 
     try {
@@ -475,17 +571,12 @@ void ffi_binder::binding_call_hdlr(const json& params)
             std::string method = payload.value("data", json::object()).value("methodName", std::string{});
 
             if (!plugin.empty() && msg_id != ipc_main::ipc_method::FRONT_END_LOADED) {
-                mep::ffi_recorder::instance().record({ plugin, method, "fe_to_be", payload.value("data", json::object()).dump(), result.dump(), dur,
-                                                       std::chrono::system_clock::now(), payload.value("caller", std::string{}) });
+                mep::ffi_recorder::instance().record(mep::ffi_call_sample{ plugin, method, "fe_to_be", payload.value("data", json::object()).dump(), result.dump(),
+                                                                           dur, std::chrono::system_clock::now(), payload.value("caller", std::string{}) });
             }
         }
 
-        try {
-            this->callback_into_js(params, request_id, result);
-        } catch (const std::exception& e) {
-            throw; /** not fatal, the host likely died before we could respond */
-        }
-
+        this->callback_into_js(params, request_id, result);
     } catch (const std::exception& e) {
         const ordered_json callback_params = {
             { "success",    false    },
@@ -570,6 +661,7 @@ void ffi_binder::execution_ctx_destroyed_hdlr(const json& params)
 
     /* rem from reverse lookup so the ID can't be dirty matched later */
     m_ctx_to_plugin.erase(dead_ctx_id);
+    m_event_batcher->forget(dead_ctx_id);
 
     for (auto& [name, ctx] : m_plugin_ctxs) {
         if (ctx.main_ctx_id == dead_ctx_id) {
@@ -0,0 +1,496 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/ffi_fast_path.h"
+#include "millennium/msgpack_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace ffi_fast_path
+{
+namespace
+{
+/** more arguments than this isn't a "common shape", and keeps the sorting and duplicate checks trivially cheap */
+constexpr size_t MAX_ARGUMENTS = 32;
+
+enum seen_bit : unsigned
+{
+    SEEN_ID = 1 << 0,
+    SEEN_CALL_ID = 1 << 1,
+    SEEN_CALLER = 1 << 2,
+    SEEN_DATA = 1 << 3,
+    SEEN_PLUGIN = 1 << 4,
+    SEEN_METHOD = 1 << 5,
+    SEEN_ARGUMENTS = 1 << 6,
+};
+
+enum class field
+{
+    none,
+    skip,
+    id,
+    call_id,
+    caller,
+    data,
+    plugin,
+    method,
+    arguments,
+};
+
+bool to_int(const scalar& value, int& out)
+{
+    if (const auto* i = std::get_if<int64_t>(&value)) {
+        if (*i < std::numeric_limits<int>::min() || *i > std::numeric_limits<int>::max()) return false;
+        out = static_cast<int>(*i);
+        return true;
+    }
+    if (const auto* u = std::get_if<uint64_t>(&value)) {
+        if (*u > static_cast<uint64_t>(std::numeric_limits<int>::max())) return false;
+        out = static_cast<int>(*u);
+        return true;
+    }
+    return false;
+}
+
+bool to_string(scalar& value, std::string& out)
+{
+    auto* s = std::get_if<std::string>(&value);
+    if (!s) return false;
+    out = std::move(*s);
+    return true;
+}
+
+/**
+ * sax handler for the binding payload. depth 1 is the payload object, 2 is data and 3 is argumentList.
+ * unknown payload fields are skipped (the generic path ignores them too), anything unexpected below that aborts.
+ */
+struct payload_handler
+{
+    call& out;
+    int depth = 0;
+    int skip_depth = 0;
+    unsigned seen = 0;
+    field pending = field::none;
+
+    bool mark(field f, unsigned bit)
+    {
+        if (seen & bit) return false; /** duplicate key, leave the last-one-wins semantics to the dom parser */
+        seen |= bit;
+        pending = f;
+        return true;
+    }
+
+    bool put(scalar value)
+    {
+        if (skip_depth) return true;
+
+        const field f = pending;
+        pending = field::none;
+
+        switch (depth) {
+            case 1:
+                switch (f) {
+                    case field::id:
+                        return to_int(value, out.ipc_id);
+                    case field::call_id:
+                        return to_int(value, out.call_id);
+                    case field::caller:
+                        return to_string(value, out.caller);
+                    case field::data:
+                        return false;
+                    default:
+                        return true;
+                }
+            case 2:
+                switch (f) {
+                    case field::plugin:
+                        return to_string(value, out.plugin);
+                    case field::method:
+                        return to_string(value, out.method);
+                    default:
+                        return false;
+                }
+            case 3:
+                if (out.args.size() >= MAX_ARGUMENTS) return false;
+                out.args.push_back(std::move(value));
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool start_container(bool is_object)
+    {
+        if (skip_depth) {
+            ++skip_depth;
+            return true;
+        }
+
+        const field f = pending;
+        pending = field::none;
+
+        switch (depth) {
+            case 0:
+                if (!is_object) return false;
+                depth = 1;
+                return true;
+            case 1:
+                if (f == field::data && is_object) {
+                    depth = 2;
+                    return true;
+                }
+                if (f == field::skip) {
+                    skip_depth = 1;
+                    return true;
+                }
+                return false;
+            case 2:
+                if (f != field::arguments) return false;
+                out.has_arguments = true;
+                out.named_arguments = is_object;
+                depth = 3;
+                return true;
+            default:
+                return false; /** nested arguments, the generic path handles those */
+        }
+    }
+
+    bool end_container()
+    {
+        if (skip_depth) {
+            --skip_depth;
+            return true;
+        }
+        --depth;
+        return true;
+    }
+
+    bool null() { return put(std::monostate{}); }
+    bool boolean(bool value) { return put(value); }
+    bool number_integer(int64_t value) { return put(value); }
+    bool number_unsigned(uint64_t value) { return put(value); }
+    bool number_float(double value, const std::string&) { return put(value); }
+    bool string(std::string& value) { return put(std::move(value)); }
+    bool binary(nlohmann::json::binary_t&) { return false; }
+
+    bool start_object(size_t) { return start_container(true); }
+    bool start_array(size_t) { return start_container(false); }
+    bool end_object() { return end_container(); }
+    bool end_array() { return end_container(); }
+
+    bool key(std::string& name)
+    {
+        if (skip_depth) return true;
+
+        switch (depth) {
+            case 1:
+                if (name == "id") return mark(field::id, SEEN_ID);
+                if (name == "call_id") return mark(field::call_id, SEEN_CALL_ID);
+                if (name == "caller") return mark(field::caller, SEEN_CALLER);
+                if (name == "data") return mark(field::data, SEEN_DATA);
+                pending = field::skip;
+                return true;
+            case 2:
+                if (name == "pluginName") return mark(field::plugin, SEEN_PLUGIN);
+                if (name == "methodName") return mark(field::method, SEEN_METHOD);
+                if (name == "argumentList") return mark(field::arguments, SEEN_ARGUMENTS);
+                return false; /** data is forwarded to the child as-is, so unknown fields can't be dropped */
+            case 3:
+                if (out.arg_names.size() >= MAX_ARGUMENTS) return false;
+                out.arg_names.push_back(std::move(name));
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&)
+    {
+        return false;
+    }
+};
+
+/** argument indices in the order a json object would hold them (sorted by key), or as given for arrays */
+size_t argument_order(const call& c, std::array<uint8_t, MAX_ARGUMENTS>& order)
+{
+    const size_t n = c.args.size();
+    std::iota(order.begin(), order.begin() + n, uint8_t{ 0 });
+    if (c.named_arguments) {
+        std::sort(order.begin(), order.begin() + n, [&c](uint8_t a, uint8_t b) { return c.arg_names[a] < c.arg_names[b]; });
+    }
+    return n;
+}
+
+void append_escaped(std::string& out, std::string_view value)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    out += '"';
+    size_t run = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        const auto c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(value.data() + run, i - run);
+        run = i + 1;
+
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+                break;
+        }
+    }
+    out.append(value.data() + run, value.size() - run);
+    out += '"';
+}
+
+template <typename T> void append_number(std::string& out, T value)
+{
+    char buf[32];
+    const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, end);
+}
+
+/** shortest round-trip form, keeping a fraction so it reads back as a float. like nlohmann, non-finite values are null */
+void append_double(std::string& out, double value)
+{
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+
+    const size_t start = out.size();
+    append_number(out, value);
+    if (out.find_first_of(".e", start) == std::string::npos) out += ".0";
+}
+
+void append_scalar(std::string& out, const scalar& value)
+{
+    std::visit([&out](const auto& v)
+    {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>)
+            out += "null";
+        else if constexpr (std::is_same_v<T, bool>)
+            out += v ? "true" : "false";
+        else if constexpr (std::is_same_v<T, double>)
+            append_double(out, v);
+        else if constexpr (std::is_same_v<T, std::string>)
+            append_escaped(out, v);
+        else
+            append_number(out, v);
+    }, value);
+}
+
+void pack_scalar(std::vector<uint8_t>& out, const scalar& value)
+{
+    std::visit([&out](const auto& v)
+    {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>)
+            msgpack_writer::write_nil(out);
+        else if constexpr (std::is_same_v<T, bool>)
+            msgpack_writer::write_bool(out, v);
+        else if constexpr (std::is_same_v<T, int64_t>)
+            msgpack_writer::write_int(out, v);
+        else if constexpr (std::is_same_v<T, uint64_t>)
+            msgpack_writer::write_uint(out, v);
+        else if constexpr (std::is_same_v<T, double>)
+            msgpack_writer::write_double(out, v);
+        else
+            msgpack_writer::write_str(out, v);
+    }, value);
+}
+} // namespace
+
+void call::clear()
+{
+    ipc_id = -1;
+    call_id = -1;
+    caller.clear();
+    plugin.clear();
+    method.clear();
+    has_arguments = false;
+    named_arguments = false;
+    arg_names.clear();
+    args.clear();
+}
+
+bool parse(std::string_view payload, call& out)
+{
+    out.clear();
+
+    payload_handler handler{ out };
+    if (!nlohmann::json::sax_parse(payload.begin(), payload.end(), &handler)) {
+        return false;
+    }
+
+    constexpr unsigned required = SEEN_ID | SEEN_CALL_ID | SEEN_DATA | SEEN_PLUGIN | SEEN_METHOD;
+    if ((handler.seen & required) != required) {
+        return false;
+    }
+
+    if (out.named_arguments) {
+        for (size_t i = 1; i < out.arg_names.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (out.arg_names[i] == out.arg_names[j]) return false;
+            }
+        }
+    }
+    return true;
+}
+
+void pack_evaluate_params(const call& c, std::vector<uint8_t>& out)
+{
+    out.clear();
+    msgpack_writer::write_map_header(out, c.has_arguments ? 3 : 2);
+
+    if (c.has_arguments) {
+        std::array<uint8_t, MAX_ARGUMENTS> order;
+        const size_t n = argument_order(c, order);
+
+        msgpack_writer::write_str(out, "argumentList");
+        if (c.named_arguments) {
+            msgpack_writer::write_map_header(out, static_cast<uint32_t>(n));
+        } else {
+            msgpack_writer::write_array_header(out, static_cast<uint32_t>(n));
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            if (c.named_arguments) msgpack_writer::write_str(out, c.arg_names[order[i]]);
+            pack_scalar(out, c.args[order[i]]);
+        }
+    }
+
+    msgpack_writer::write_str(out, "methodName");
+    msgpack_writer::write_str(out, c.method);
+    msgpack_writer::write_str(out, "pluginName");
+    msgpack_writer::write_str(out, c.plugin);
+}
+
+void write_arguments_json(const call& c, std::string& out)
+{
+    out.clear();
+    out += '{';
+
+    if (c.has_arguments) {
+        std::array<uint8_t, MAX_ARGUMENTS> order;
+        const size_t n = argument_order(c, order);
+
+        out += c.named_arguments ? "\"argumentList\":{" : "\"argumentList\":[";
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0) out += ',';
+            if (c.named_arguments) {
+                append_escaped(out, c.arg_names[order[i]]);
+                out += ':';
+            }
+            append_scalar(out, c.args[order[i]]);
+        }
+        out += c.named_arguments ? "}," : "],";
+    }
+
+    out += "\"methodName\":";
+    append_escaped(out, c.method);
+    out += ",\"pluginName\":";
+    append_escaped(out, c.plugin);
+    out += '}';
+}
+
+void write_response(std::string& out, std::string_view plugin, const nlohmann::json& child_result)
+{
+    out.clear();
+
+    const auto success = child_result.is_object() ? child_result.find("success") : child_result.end();
+    const bool ok = success != child_result.end() && success->is_boolean() && success->get<bool>();
+
+    out += ok ? "{\"success\":true,\"pluginName\":" : "{\"success\":false,\"pluginName\":";
+    append_escaped(out, plugin);
+    out += ",\"returnJson\":";
+
+    if (!ok) {
+        const auto error = child_result.is_object() ? child_result.find("error") : child_result.end();
+        append_escaped(out, error != child_result.end() && error->is_string() ? error->get_ref<const std::string&>() : "unknown error from child process");
+        out += '}';
+        return;
+    }
+
+    const auto value = child_result.find("value");
+    if (value == child_result.end() || value->is_null()) {
+        out += "null";
+    } else if (value->is_string()) {
+        /** lua backends return tables as json text, which is handed back as a value rather than a string */
+        const auto& text = value->get_ref<const std::string&>();
+        auto parsed = nlohmann::ordered_json::parse(text, nullptr, false);
+        if (!parsed.is_discarded()) {
+            out += parsed.dump();
+        } else {
+            append_escaped(out, text);
+        }
+    } else if (value->is_boolean()) {
+        out += value->get<bool>() ? "true" : "false";
+    } else if (value->is_number_float()) {
+        append_double(out, value->get<double>());
+    } else if (value->is_number_integer()) {
+        append_number(out, value->get<int64_t>());
+    } else {
+        out += "null";
+    }
+    out += '}';
+}
+} // namespace ffi_fast_path
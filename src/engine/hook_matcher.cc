@@ -0,0 +1,85 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/http_hooks.h"
+#include <algorithm>
+
+network_hook_ctl::hook_matcher::hook_matcher(std::vector<hook_item> hooks) : m_hooks(std::move(hooks))
+{
+    std::unordered_map<std::string, size_t> group_by_source;
+
+    for (size_t i = 0; i < m_hooks.size(); ++i) {
+        const std::string& source = m_hooks[i].hook.pattern_source;
+
+        /** hooks registered without their source text can't be proven equal to anything else */
+        if (source.empty()) {
+            m_groups.push_back({ m_hooks[i].hook.url_pattern.get(), { i } });
+            continue;
+        }
+
+        auto [it, inserted] = group_by_source.try_emplace(source, m_groups.size());
+        if (inserted) {
+            m_groups.push_back({ m_hooks[i].hook.url_pattern.get(), { i } });
+        } else {
+            m_groups[it->second].members.push_back(i);
+        }
+    }
+}
+
+std::shared_ptr<const std::vector<size_t>> network_hook_ctl::hook_matcher::match(const std::string& url) const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        auto it = m_cache.find(url);
+        if (it != m_cache.end()) {
+            return it->second;
+        }
+    }
+
+    auto matched = std::make_shared<std::vector<size_t>>();
+    for (const auto& group : m_groups) {
+        if (std::regex_match(url, *group.pattern)) {
+            matched->insert(matched->end(), group.members.begin(), group.members.end());
+        }
+    }
+    std::sort(matched->begin(), matched->end());
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    if (m_cache.size() >= m_cache_limit) {
+        m_cache.clear();
+    }
+    m_cache.emplace(url, matched);
+    return matched;
+}
+
+bool network_hook_ctl::hook_matcher::any_match(const std::string& url) const
+{
+    return !match(url)->empty();
+}
@@ -0,0 +1,134 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/html_inject.h"
+#include "millennium/base64.h"
+
+namespace
+{
+constexpr std::string_view k_head_close = "</head>";
+
+/** decode this much of the document at a time while looking for </head> (must be a multiple of 4) */
+constexpr size_t k_decode_block = 4096;
+
+/** decode a block of canonical base64 onto out. '=' padding is only accepted at the very end of the document */
+bool decode_block(std::string_view block, bool is_last, std::string& out)
+{
+    const size_t consumed = base64::decode_append(block, out);
+    if (consumed == block.size()) {
+        return true;
+    }
+
+    const size_t padding = block.size() - consumed;
+    return is_last && padding <= 2 && padding == 4 - consumed % 4 && block.substr(consumed) == std::string_view("==", padding);
+}
+} // namespace
+
+size_t html_find_head_close(std::string_view html)
+{
+    /** string_view::find scans for '<' with memchr, which glibc/msvcrt vectorize */
+    return html.find(k_head_close);
+}
+
+std::optional<std::string> html_inject_head(std::string_view html, std::string_view content)
+{
+    const size_t head = html_find_head_close(html);
+    if (head == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    std::string out;
+    out.reserve(html.size() + content.size());
+    out.append(html.substr(0, head));
+    out.append(content);
+    out.append(html.substr(head));
+    return out;
+}
+
+std::optional<std::string> html_inject_head_base64(std::string_view encoded, std::string_view content, html_inject_failure* failure)
+{
+    auto fail = [failure](html_inject_failure why) -> std::optional<std::string>
+    {
+        if (failure) *failure = why;
+        return std::nullopt;
+    };
+
+    if (encoded.empty()) {
+        return fail(html_inject_failure::no_head);
+    }
+    if (encoded.size() % 4 != 0) {
+        return fail(html_inject_failure::bad_encoding);
+    }
+
+    /** decode block by block until </head> shows up, so the body after it is never decoded */
+    std::string prefix;
+    size_t head = std::string_view::npos;
+
+    for (size_t offset = 0; offset < encoded.size() && head == std::string_view::npos; offset += k_decode_block) {
+        const std::string_view block = encoded.substr(offset, k_decode_block);
+        const size_t search_from = prefix.size() >= k_head_close.size() ? prefix.size() - k_head_close.size() + 1 : 0;
+
+        if (!decode_block(block, offset + block.size() == encoded.size(), prefix)) {
+            return fail(html_inject_failure::bad_encoding);
+        }
+
+        head = std::string_view(prefix).find(k_head_close, search_from);
+    }
+
+    if (head == std::string_view::npos) {
+        return fail(html_inject_failure::no_head);
+    }
+
+    /**
+     * the original encoding can be reused for every whole triple before the splice point, and for every
+     * triple after it as long as the injected bytes keep the triple boundaries where they were.
+     * "</head>" itself is longer than a triple, so the suffix always starts inside the decoded prefix.
+     */
+    const size_t copy_prefix_bytes = head / 3 * 3;
+    const size_t copy_suffix_from = (head + 2) / 3 * 3;
+
+    std::string middle;
+    middle.reserve(content.size() + 6);
+    middle.append(prefix, copy_prefix_bytes, head - copy_prefix_bytes);
+    middle.append(content);
+
+    /** whitespace in front of </head> is harmless and keeps the suffix triple-aligned */
+    middle.append((3 - content.size() % 3) % 3, '\n');
+    middle.append(prefix, head, copy_suffix_from - head);
+
+    const size_t suffix_encoded_from = copy_suffix_from / 3 * 4;
+
+    std::string out;
+    out.reserve(copy_prefix_bytes / 3 * 4 + (middle.size() + 2) / 3 * 4 + (encoded.size() - suffix_encoded_from));
+    out.append(encoded.substr(0, copy_prefix_bytes / 3 * 4));
+    base64::encode_append(middle, out);
+    out.append(encoded.substr(suffix_encoded_from));
+    return out;
+}
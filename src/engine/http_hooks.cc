@@ -33,6 +33,7 @@
 #include "millennium/auth.h"
 #include "millennium/core_ipc.h"
 #include "millennium/encoding.h"
+#include "millennium/html_inject.h"
 #include "millennium/logger.h"
 #include "millennium/mime_types.h"
 #include "millennium/url_parser.h"
@@ -61,18 +62,20 @@ void network_hook_ctl::register_virtual_resource(const std::string& url, std::fu
 {
     std::unique_lock lock(m_virtual_res_mtx);
     m_virtual_resources[url] = std::move(producer);
+    m_vfs_cache.invalidate(url);
 }
 
 void network_hook_ctl::unregister_virtual_resource(const std::string& url)
 {
     std::unique_lock lock(m_virtual_res_mtx);
     m_virtual_resources.erase(url);
+    m_vfs_cache.invalidate(url);
 }
 
-std::vector<network_hook_ctl::hook_item> network_hook_ctl::get_hook_list() const
+std::shared_ptr<const network_hook_ctl::hook_matcher> network_hook_ctl::get_hook_matcher() const
 {
     std::shared_lock<std::shared_mutex> lock(m_hook_list_mtx);
-    return m_hook_list_ptr ? *m_hook_list_ptr : std::vector<hook_item>();
+    return m_hook_matcher;
 }
 
 unsigned long long network_hook_ctl::add_hook(const hook_t& hook)
@@ -80,9 +83,10 @@ unsigned long long network_hook_ctl::add_hook(const hook_t& hook)
     std::unique_lock<std::shared_mutex> lock(m_hook_list_mtx);
     hook_item item{ hook, g_hookedModuleId.fetch_add(1) };
 
-    if (m_hook_list_ptr) {
-        m_hook_list_ptr->push_back(item);
-    }
+    /** requests in flight keep matching against the snapshot they already hold */
+    std::vector<hook_item> hooks = m_hook_matcher->hooks();
+    hooks.push_back(item);
+    m_hook_matcher = std::make_shared<const hook_matcher>(std::move(hooks));
 
     return item.id;
 }
@@ -90,15 +94,19 @@ unsigned long long network_hook_ctl::add_hook(const hook_t& hook)
 bool network_hook_ctl::remove_hook(unsigned long long moduleId)
 {
     std::unique_lock<std::shared_mutex> lock(m_hook_list_mtx);
-    if (!m_hook_list_ptr) return false;
 
-    size_t originalSize = m_hook_list_ptr->size();
-    auto newEnd = std::remove_if(m_hook_list_ptr->begin(), m_hook_list_ptr->end(), [moduleId](const hook_item& hook)
+    std::vector<hook_item> hooks = m_hook_matcher->hooks();
+    size_t originalSize = hooks.size();
+    auto newEnd = std::remove_if(hooks.begin(), hooks.end(), [moduleId](const hook_item& hook)
     {
         return hook.id == moduleId;
     });
-    m_hook_list_ptr->erase(newEnd, m_hook_list_ptr->end());
-    return m_hook_list_ptr->size() < originalSize;
+    hooks.erase(newEnd, hooks.end());
+
+    if (hooks.size() == originalSize) return false;
+
+    m_hook_matcher = std::make_shared<const hook_matcher>(std::move(hooks));
+    return true;
 }
 
 bool network_hook_ctl::is_vfs_request(const nlohmann::basic_json<>& message)
@@ -132,83 +140,126 @@ std::filesystem::path network_hook_ctl::path_from_url(const std::string& request
     return utils::url::get_path_from_url(requestUrl);
 }
 
+static std::shared_ptr<const vfs_response> make_vfs_response(std::string encodedBody, mime::file_type fileType)
+{
+    std::vector<std::pair<std::string, std::string>> defaultHeaders = {
+        { "Access-Control-Allow-Origin", "*"                                 },
+        { "Content-Type",                mime::get_mime_str(fileType).data() }
+    };
+
+    return std::make_shared<const vfs_response>(vfs_response{ std::move(encodedBody), make_headers(defaultHeaders) });
+}
+
 void network_hook_ctl::vfs_request_handler(const nlohmann::basic_json<>& message)
 {
-    std::string fileContent;
-    mime::file_type fileType = mime::file_type::UNKNOWN;
+    std::shared_ptr<const vfs_response> response;
 
     http_code responseCode = http_code::OK;
     std::string responseMessage = "OK millennium";
 
     const std::string strRequestFile = message["request"]["url"];
 
+    /** Handle compiled theme stylesheet bundles */
+    const std::string bundlePrefix = std::string(m_themes_url) + m_bundle_prefix;
+    if (strRequestFile.starts_with(bundlePrefix)) {
+        std::string name = strRequestFile.substr(bundlePrefix.size());
+        name = name.substr(0, name.find('?'));
+        if (name.ends_with(".css")) {
+            response = m_css_bundler->find(name.substr(0, name.size() - 4));
+        }
+    }
+
     /** Handle packed plugin virtual resources */
-    {
+    if (!response) {
         std::shared_lock lock(m_virtual_res_mtx);
         auto it = m_virtual_resources.find(strRequestFile);
         if (it != m_virtual_resources.end()) {
-            try {
-                fileType = mime::file_type::JS;
-                fileContent = Base64Encode(it->second());
-            } catch (const std::exception& ex) {
-                LOG_ERROR("virtual resource '{}' producer threw: {}", strRequestFile, ex.what());
-            } catch (...) {
-                LOG_ERROR("virtual resource '{}' producer threw unknown exception", strRequestFile);
+            /** cached until the resource is re-registered or removed */
+            response = m_vfs_cache.find(strRequestFile, {});
+            if (!response) {
+                try {
+                    std::string content = it->second();
+                    if (!content.empty()) {
+                        response = make_vfs_response(Base64Encode(content), mime::file_type::JS);
+                        m_vfs_cache.store(strRequestFile, {}, response);
+                    }
+                } catch (const std::exception& ex) {
+                    LOG_ERROR("virtual resource '{}' producer threw: {}", strRequestFile, ex.what());
+                } catch (...) {
+                    LOG_ERROR("virtual resource '{}' producer threw unknown exception", strRequestFile);
+                }
             }
         }
     }
 
     /** Handle internal virtual FS request (pull virtfs from memory) */
-    if (fileContent.empty()) {
+    if (!response) {
         auto it = INTERNAL_FTP_CALL_DATA.find(strRequestFile);
         if (it != INTERNAL_FTP_CALL_DATA.end()) {
-            fileType = mime::file_type::JS;
-            fileContent = Base64Encode(it->second());
+            /** embedded assets never change, dev builds read them from disk and expect a rebuild to show up */
+            if (INTERNAL_FTP_EMBEDDED) {
+                response = m_vfs_cache.find(strRequestFile, {});
+            }
+            if (!response) {
+                std::string content = it->second();
+                if (!content.empty()) {
+                    response = make_vfs_response(Base64Encode(content), mime::file_type::JS);
+                    if (INTERNAL_FTP_EMBEDDED) m_vfs_cache.store(strRequestFile, {}, response);
+                }
+            }
         }
     }
 
     /** Handle normal disk request */
-    if (fileContent.empty()) {
+    if (!response) {
         std::filesystem::path localFilePath = this->path_from_url(strRequestFile);
-        std::ifstream localFileStream(localFilePath);
 
-        bool bFailedRead = !localFileStream.is_open();
-        if (bFailedRead) {
-            responseCode = http_code::NOT_FOUND;
-            responseMessage = "millennium couldn't read " + localFilePath.string();
+        /** a matching mtime and size means the file hasn't changed since we last encoded it */
+        const std::optional<vfs_file_stamp> stamp = vfs_file_stamp::of(localFilePath);
+        if (stamp) {
+            response = m_vfs_cache.find(localFilePath.string(), *stamp);
         }
 
-        fileType = mime::get_file_type(localFilePath.string());
-        if (fileType == mime::file_type::UNKNOWN) {
-            const std::filesystem::path requestPath = this->path_from_url(strRequestFile);
-            fileType = mime::get_file_type(requestPath);
-        }
+        if (!response) {
+            std::ifstream localFileStream(localFilePath);
+            std::string fileContent;
 
-        if (is_bin_file(fileType)) {
-            try {
-                fileContent = Base64Encode(platform::read_file_bytes(localFilePath.string()));
-            } catch (const std::exception& error) {
-                LOG_ERROR("Failed to read file bytes from disk: {}", error.what());
-                bFailedRead = true; /** force fail even if the file exists. */
+            bool bFailedRead = !localFileStream.is_open();
+            if (bFailedRead) {
+                responseCode = http_code::NOT_FOUND;
+                responseMessage = "millennium couldn't read " + localFilePath.string();
             }
-        } else {
-            fileContent = Base64Encode(std::string(std::istreambuf_iterator<char>(localFileStream), std::istreambuf_iterator<char>()));
-        }
-    }
 
-    std::vector<std::pair<std::string, std::string>> defaultHeaders = {
-        { "Access-Control-Allow-Origin", "*"                                 },
-        { "Content-Type",                mime::get_mime_str(fileType).data() }
-    };
+            mime::file_type fileType = mime::get_file_type(localFilePath.string());
+            if (fileType == mime::file_type::UNKNOWN) {
+                const std::filesystem::path requestPath = this->path_from_url(strRequestFile);
+                fileType = mime::get_file_type(requestPath);
+            }
 
-    json headers = make_headers(defaultHeaders);
+            if (is_bin_file(fileType)) {
+                try {
+                    fileContent = Base64Encode(platform::read_file_bytes(localFilePath.string()));
+                } catch (const std::exception& error) {
+                    LOG_ERROR("Failed to read file bytes from disk: {}", error.what());
+                    bFailedRead = true; /** force fail even if the file exists. */
+                }
+            } else {
+                fileContent = Base64Encode(std::string(std::istreambuf_iterator<char>(localFileStream), std::istreambuf_iterator<char>()));
+            }
+
+            response = make_vfs_response(std::move(fileContent), fileType);
+            if (!bFailedRead && stamp) {
+                m_vfs_cache.store(localFilePath.string(), *stamp, response);
+            }
+        }
+    }
 
     const json params = {
         { "responseCode",    responseCode         },
         { "requestId",       message["requestId"] },
-        { "responseHeaders", headers              },
+        { "responseHeaders", response->headers    },
         { "responsePhrase",  responseMessage      },
-        { "body",            fileContent          }
+        { "body",            response->body       }
     };
 
     m_cdp->send_host("Fetch.fulfillRequest", params);
@@ -253,28 +304,47 @@ void network_hook_ctl::mime_doc_request_handler(const nlohmann::basic_json<>& me
         return;
     }
 
-    auto response = m_cdp->send_host("Fetch.getResponseBody", params).get();
+    const auto response = m_cdp->send_host("Fetch.getResponseBody", params).get();
 
-    std::string responseBody = response.value("body", std::string{});
-    const bool isBase64 = response.value("base64Encoded", false);
-    const std::string decodedBody = isBase64 ? Base64Decode(responseBody) : responseBody;
+    const auto body = response.find("body");
+    if (requestUrl.empty() || body == response.end() || !body->is_string() || body->get_ref<const std::string&>().empty()) {
+        m_cdp->send_host("Fetch.continueResponse", params);
+        return;
+    }
+
+    /** splice straight into the encoded body when we can, only the bytes around </head> get decoded and re-encoded */
+    const std::string& responseBody = body->get_ref<const std::string&>();
+    const std::string injectedContent = hooks.preloads() + hooks.css() + hooks.scripts();
+
+    std::optional<std::string> patchedBody;
+    html_inject_failure failure = html_inject_failure::no_head;
+    if (response.value("base64Encoded", false)) {
+        patchedBody = html_inject_head_base64(responseBody, injectedContent, &failure);
+    } else if (auto patched = html_inject_head(responseBody, injectedContent)) {
+        patchedBody = Base64Encode(*patched);
+    }
 
-    if (requestUrl.empty() || decodedBody.empty()) {
+    if (!patchedBody) {
+        if (failure == html_inject_failure::bad_encoding) {
+            logger.warn("Failed to decode the base64 response body of {}, leaving it unpatched.", requestUrl);
+        } else {
+            logger.warn("Failed to find </head> in document.");
+        }
         m_cdp->send_host("Fetch.continueResponse", params);
         return;
     }
 
-    const std::string patchedContent = inject_into_document_head(decodedBody, hooks.preloads() + hooks.css() + hooks.scripts());
     const std::string responseMessage = message.value("responseStatusText", std::string{ "OK" });
     nlohmann::json responseHeaders = message.value("responseHeaders", nlohmann::json::array());
 
-    const json fullfillParams = {
+    json fullfillParams = {
         { "requestId",       requestId                                        },
         { "responseCode",    statusCode                                       },
         { "responseHeaders", responseHeaders                                  },
-        { "responsePhrase",  responseMessage.empty() ? "OK" : responseMessage },
-        { "body",            Base64Encode(patchedContent)                     }
+        { "responsePhrase",  responseMessage.empty() ? "OK" : responseMessage }
     };
+    /** moved in separately, an initializer list would copy the whole document */
+    fullfillParams["body"] = std::move(*patchedBody);
 
     m_cdp->send_host("Fetch.fulfillRequest", fullfillParams);
 }
@@ -282,25 +352,40 @@ void network_hook_ctl::mime_doc_request_handler(const nlohmann::basic_json<>& me
 network_hook_ctl::processed_hooks network_hook_ctl::apply_user_webkit_hooks(const target_url& target) const
 {
     processed_hooks result;
-    auto hookList = get_hook_list();
+    const auto matcher = get_hook_matcher();
+    const auto& hookList = matcher->hooks();
     bool anyHookMatched = false;
     bool safe_for_js = target.is_safe_for_js();
 
-    for (const auto& hook : hookList) {
-        if (!std::regex_match(target.raw_url(), hook.hook.url_pattern)) continue;
-        
+    const bool bundle = m_bundle_stylesheets.load(std::memory_order_relaxed);
+    std::vector<std::string> stylesheets;
+
+    for (size_t index : *matcher->match(target.raw_url())) {
+        const auto& hook = hookList[index];
+
         if (hook.hook.type == TagTypes::JAVASCRIPT && !safe_for_js) {
             continue;
         }
 
         anyHookMatched = true;
 
-        if (hook.hook.type == TagTypes::STYLESHEET)
+        if (hook.hook.type == TagTypes::STYLESHEET && bundle)
+            stylesheets.push_back(hook.hook.path);
+        else if (hook.hook.type == TagTypes::STYLESHEET)
             result.add_stylesheet(m_themes_url + utils::url::plat_encode_url(hook.hook.path));
         else if (hook.hook.type == TagTypes::JAVASCRIPT)
             result.add_script_module(m_themes_url + utils::url::plat_encode_url(hook.hook.path));
     }
 
+    /** a lone stylesheet gains nothing from a bundle, keep its own url */
+    for (const auto& run : m_css_bundler->split(stylesheets)) {
+        if (run.size() == 1) {
+            result.add_stylesheet(m_themes_url + utils::url::plat_encode_url(run.front()));
+        } else {
+            result.add_stylesheet(std::format("{}{}{}.css", m_themes_url, m_bundle_prefix, m_css_bundler->add(run)));
+        }
+    }
+
     if (anyHookMatched && m_dynamic_css_provider) {
         const auto [rootColors, sliderCss] = m_dynamic_css_provider();
         if (!rootColors.empty()) result.add_inline_style("RootColors", rootColors);
@@ -310,19 +395,14 @@ network_hook_ctl::processed_hooks network_hook_ctl::apply_user_webkit_hooks(cons
     return result;
 }
 
-std::string network_hook_ctl::inject_into_document_head(const std::string& original, const std::string& content) const
+void network_hook_ctl::set_dynamic_css_provider(std::function<std::pair<std::string, std::string>()> provider)
 {
-    const size_t headPos = original.find("</head>");
-    if (headPos == std::string::npos) {
-        logger.warn("Failed to find </head> in document.");
-        return original;
-    }
-    return original.substr(0, headPos) + content + original.substr(headPos);
+    m_dynamic_css_provider = std::move(provider);
 }
 
-void network_hook_ctl::set_dynamic_css_provider(std::function<std::pair<std::string, std::string>()> provider)
+void network_hook_ctl::set_stylesheet_bundling(bool enabled)
 {
-    m_dynamic_css_provider = std::move(provider);
+    m_bundle_stylesheets.store(enabled, std::memory_order_relaxed);
 }
 
 void network_hook_ctl::init()
@@ -399,8 +479,12 @@ void network_hook_ctl::shutdown()
 
 network_hook_ctl::network_hook_ctl(std::shared_ptr<plugin_manager> plugin_manager)
     : m_plugin_manager(std::move(plugin_manager)), m_thread_pool(std::make_unique<thread_pool>(std::thread::hardware_concurrency())),
-      m_hook_list_ptr(std::make_shared<std::vector<hook_item>>())
+      m_hook_matcher(std::make_shared<const hook_matcher>())
 {
+    m_css_bundler = std::make_unique<css_bundler>(platform::get_millennium_path() / "themes", m_themes_url, [](std::string css)
+    {
+        return make_vfs_response(Base64Encode(css), mime::file_type::CSS);
+    });
 }
 
 network_hook_ctl::~network_hook_ctl()
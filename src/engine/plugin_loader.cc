@@ -43,6 +43,7 @@
 #include "millennium/backend_init.h"
 #include "millennium/backend_mgr.h"
 #include "millennium/environment.h"
+#include "millennium/http_engine.h"
 #include "millennium/http_hooks.h"
 #include "millennium/star_parser.h"
 #include "millennium/logger.h"
@@ -59,7 +60,6 @@
 
 #include "head/entry_point.h"
 
-#include <curl/curl.h>
 #include <format>
 
 namespace
@@ -367,25 +367,18 @@ void plugin_loader::inject_frontend_shims(bool reload_frontend)
     /**
      * add the initial binding for the shared js context.
      * the rest is handled by the ffi_binder.
+     * these don't depend on each other's results, so they go out as a single batch (one round trip).
      */
     const auto insert_ipc = std::make_shared<std::function<void()>>([self, cdp]()
     {
-        cdp->send("Runtime.enable").get();
-
-        const json add_binding_params = {
-            { "name", ffi_constants::binding_name }
-        };
-        cdp->send("Runtime.addBinding", add_binding_params).get();
-
-        const json add_extension_binding_params = {
-            { "name", ffi_constants::extension_binding_name }
-        };
-        cdp->send("Runtime.addBinding", add_extension_binding_params).get();
-
-        const json add_cdp_proxy_params = {
-            { "name", ffi_constants::cdp_proxy_binding_name }
-        };
-        cdp->send("Runtime.addBinding", add_cdp_proxy_params).get();
+        cdp->send_batch({
+                            { "Runtime.enable" },
+                            { "Runtime.addBinding", { { "name", ffi_constants::binding_name } } },
+                            { "Runtime.addBinding", { { "name", ffi_constants::extension_binding_name } } },
+                            { "Runtime.addBinding", { { "name", ffi_constants::cdp_proxy_binding_name } } },
+                            { "Page.enable" },
+        })
+            .get();
 
         logger.log("Frontend notifier finished!");
     });
@@ -398,30 +391,46 @@ void plugin_loader::inject_frontend_shims(bool reload_frontend)
      */
     const auto create_isolated_worlds = std::make_shared<std::function<void()>>([self, cdp]()
     {
-        const std::string isolated_ctx_script = get_cdp_isolated_ctx_script();
+        const auto isolated_ctx_script = std::make_shared<const std::string>(get_cdp_isolated_ctx_script());
         const std::string shared_js_session = cdp->get_shared_js_session_id();
 
-        if (isolated_ctx_script.empty()) return;
+        if (isolated_ctx_script->empty()) return;
 
+        /**
+         * each plugin's getFrameTree -> createIsolatedWorld -> evaluate runs as a chain on the cdp worker,
+         * and all chains are in flight at once, so this costs three round trips regardless of plugin count.
+         */
         const auto plugins = self->m_plugin_manager->get_enabled_plugins();
-        for (const auto& plugin : plugins) {
-            try {
-                auto frame_result = cdp->send("Page.getFrameTree").get();
-                const std::string frame_id = frame_result["frameTree"]["frame"]["id"].get<std::string>();
+        std::vector<std::future<std::vector<json>>> chains;
+        chains.reserve(plugins.size());
 
-                const json create_world_params = {
-                    { "frameId", frame_id },
-                    { "worldName", std::format("millennium-{}", plugin.plugin_name) },
-                    { "grantUniversalAccess", false }
-                };
-                auto world_result = cdp->send("Page.createIsolatedWorld", create_world_params).get();
-                const int ctx_id = world_result["executionContextId"].get<int>();
+        for (const auto& plugin : plugins) {
+            const std::string world_name = std::format("millennium-{}", plugin.plugin_name);
+
+            chains.push_back(cdp->send_chain({ "Page.getFrameTree" }, {
+                [world_name](const json& frame_result) -> cdp_client::command
+                {
+                    return { "Page.createIsolatedWorld", {
+                        { "frameId", frame_result["frameTree"]["frame"]["id"].get<std::string>() },
+                        { "worldName", world_name },
+                        { "grantUniversalAccess", false }
+                    } };
+                },
+                [isolated_ctx_script](const json& world_result) -> cdp_client::command
+                {
+                    return { "Runtime.evaluate", {
+                        { "expression", *isolated_ctx_script },
+                        { "contextId", world_result["executionContextId"].get<int>() }
+                    } };
+                },
+            }));
+        }
 
-                const json eval_params = {
-                    { "expression", isolated_ctx_script },
-                    { "contextId",  ctx_id              }
-                };
-                cdp->send("Runtime.evaluate", eval_params).get();
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            const auto& plugin = plugins[i];
+            try {
+                const auto results = chains[i].get();
+                const int ctx_id = results[1]["executionContextId"].get<int>();
 
                 if (self->m_ffi_binder) {
                     self->m_ffi_binder->register_isolated_ctx(plugin.plugin_name, ctx_id, shared_js_session);
@@ -476,8 +485,7 @@ void plugin_loader::inject_frontend_shims(bool reload_frontend)
      */
     const auto insert_millennium = std::make_shared<std::function<void()>>([self, cdp]()
     {
-        cdp->send("Page.enable").get();
-
+        /** Page.enable already went out with the insert_ipc batch */
         if (!self->document_script_id.empty()) {
             const json params = {
                 { "identifier", self->document_script_id }
@@ -792,147 +800,53 @@ void plugin_loader::setup_child_request_handler()
         }
 
         if (method == plugin_ipc::child_method::HTTP_REQUEST) {
-            const std::string url = params.value("url", "");
-            const std::string http_method = params.value("method", "GET");
-            const std::string data = params.value("data", "");
-            const long timeout = params.value("timeout", 30L);
-            const bool follow_redirects = params.value("follow_redirects", true);
-            const bool verify_ssl = params.value("verify_ssl", true);
-            const std::string user_agent = params.value("user_agent", "Millennium/1.0");
-            const std::string proxy = params.value("proxy", "");
-
-            CURL* curl = curl_easy_init();
-            if (!curl) {
-                return {
-                    { "error", "failed to initialize curl" }
-                };
-            }
-
             static constexpr size_t MAX_RESPONSE_BODY = 64u * 1024u * 1024u; /* 64 MB */
 
-            struct body_ctx
-            {
-                std::string data;
-                bool exceeded;
-            };
-            body_ctx body{ {}, false };
-            nlohmann::json response_headers = nlohmann::json::object();
-
-            auto write_cb = +[](char* ptr, size_t size, size_t nmemb, void* ud) -> size_t
-            {
-                auto* ctx = static_cast<body_ctx*>(ud);
-                size_t bytes = size * nmemb;
-                if (ctx->data.size() + bytes > MAX_RESPONSE_BODY) {
-                    ctx->exceeded = true;
-                    return 0; /* abort transfer */
-                }
-                ctx->data.append(ptr, bytes);
-                return bytes;
-            };
-
-            struct header_ctx
-            {
-                nlohmann::json* headers;
-            };
-            header_ctx hctx{ &response_headers };
-
-            auto header_cb = +[](char* buf, size_t size, size_t nitems, void* ud) -> size_t
-            {
-                size_t len = size * nitems;
-                auto* ctx = static_cast<header_ctx*>(ud);
-                std::string line(buf, len);
-                while (!line.empty() && (line.back() == '\r' || line.back() == '\n'))
-                    line.pop_back();
-                auto colon = line.find(':');
-                if (colon != std::string::npos && !line.empty()) {
-                    std::string key = line.substr(0, colon);
-                    std::string val = line.substr(colon + 1);
-                    while (!val.empty() && val.front() == ' ')
-                        val.erase(val.begin());
-                    (*ctx->headers)[key] = val;
-                }
-                return len;
-            };
+            http_engine::request req;
+            req.url = params.value("url", "");
+            req.method = params.value("method", "GET");
+            req.body = params.value("data", "");
+            req.timeout_seconds = params.value("timeout", 30L);
+            req.follow_redirects = params.value("follow_redirects", true);
+            req.verify_ssl = params.value("verify_ssl", true);
+            req.user_agent = params.value("user_agent", "Millennium/1.0");
+            req.proxy = params.value("proxy", "");
+            req.max_body_bytes = MAX_RESPONSE_BODY;
 
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
-            curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_cb);
-            curl_easy_setopt(curl, CURLOPT_HEADERDATA, &hctx);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.c_str());
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, follow_redirects ? 1L : 0L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, verify_ssl ? 1L : 0L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, verify_ssl ? 2L : 0L);
-            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-
-            struct curl_slist* req_headers = nullptr;
             if (params.contains("headers") && params["headers"].is_object()) {
                 for (auto& [k, v] : params["headers"].items()) {
-                    req_headers = curl_slist_append(req_headers, (k + ": " + v.get<std::string>()).c_str());
-                }
-                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, req_headers);
-            }
-
-            if (http_method == "POST") {
-                curl_easy_setopt(curl, CURLOPT_POST, 1L);
-                if (!data.empty()) {
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(data.size()));
-                }
-            } else if (http_method == "PUT" || http_method == "PATCH" || http_method == "DELETE" || http_method == "OPTIONS") {
-                curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, http_method.c_str());
-                if (!data.empty()) {
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(data.size()));
+                    req.headers.push_back(k + ": " + v.get<std::string>());
                 }
-            } else if (http_method == "HEAD") {
-                curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
             }
 
             if (params.contains("auth") && params["auth"].is_object()) {
-                std::string auth_str = params["auth"].value("user", "") + ":" + params["auth"].value("pass", "");
-                curl_easy_setopt(curl, CURLOPT_USERPWD, auth_str.c_str());
-                curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
-            }
-
-            if (!proxy.empty()) {
-                curl_easy_setopt(curl, CURLOPT_PROXY, proxy.c_str());
+                req.userpwd = params["auth"].value("user", "") + ":" + params["auth"].value("pass", "");
             }
 
-            CURLcode res = curl_easy_perform(curl);
-            long status_code = 0;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
-
-            curl_slist_free_all(req_headers);
-            curl_easy_cleanup(curl);
+            /** goes through the shared engine, so repeated calls reuse its pooled connections */
+            http_engine::response res = http_engine::instance().perform(std::move(req));
 
-            if (body.exceeded) {
+            if (res.body_exceeded) {
                 return {
                     { "error", "response body exceeded 64 MB limit" }
                 };
             }
 
-            if (res != CURLE_OK) {
+            if (!res.ok()) {
                 return {
-                    { "error", curl_easy_strerror(res) }
+                    { "error", res.error() }
                 };
             }
 
             return {
-                { "body",    body.data        },
-                { "status",  status_code      },
-                { "headers", response_headers }
+                { "body",    std::move(res.body)    },
+                { "status",  res.status             },
+                { "headers", std::move(res.headers) }
             };
         }
 
         if (method == plugin_ipc::child_method::HTTP_DOWNLOAD) {
-            const std::string url = params.value("url", "");
             const std::string dest = params.value("path", "");
-            const long timeout = params.value("timeout", 0L); /* 0 = no timeout for downloads */
-            const bool follow_redirects = params.value("follow_redirects", true);
-            const bool verify_ssl = params.value("verify_ssl", true);
-            const std::string user_agent = params.value("user_agent", "Millennium/1.0");
 
             if (dest.empty()) {
                 return {
@@ -947,68 +861,37 @@ void plugin_loader::setup_child_request_handler()
                 };
             }
 
-            CURL* curl = curl_easy_init();
-            if (!curl) {
-                fclose(fp);
-                return {
-                    { "error", "failed to initialize curl" }
-                };
-            }
-
-            struct dl_ctx
+            http_engine::request req;
+            req.url = params.value("url", "");
+            req.timeout_seconds = params.value("timeout", 0L); /* 0 = no timeout for downloads */
+            req.follow_redirects = params.value("follow_redirects", true);
+            req.verify_ssl = params.value("verify_ssl", true);
+            req.user_agent = params.value("user_agent", "Millennium/1.0");
+            req.sink = [fp](const char* data, size_t size)
             {
-                FILE* fp;
-                size_t written;
+                return fwrite(data, 1, size, fp) == size;
             };
-            dl_ctx ctx{ fp, 0 };
 
-            auto write_cb = +[](char* ptr, size_t size, size_t nmemb, void* ud) -> size_t
-            {
-                auto* c = static_cast<dl_ctx*>(ud);
-                size_t bytes = fwrite(ptr, size, nmemb, c->fp);
-                c->written += bytes * size;
-                return bytes;
-            };
-
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.c_str());
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, follow_redirects ? 1L : 0L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, verify_ssl ? 1L : 0L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, verify_ssl ? 2L : 0L);
-            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-            if (timeout > 0) {
-                curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
-            }
-
-            struct curl_slist* req_headers = nullptr;
             if (params.contains("headers") && params["headers"].is_object()) {
                 for (auto& [k, v] : params["headers"].items()) {
-                    req_headers = curl_slist_append(req_headers, (k + ": " + v.get<std::string>()).c_str());
+                    req.headers.push_back(k + ": " + v.get<std::string>());
                 }
-                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, req_headers);
             }
 
-            CURLcode res = curl_easy_perform(curl);
-            long status_code = 0;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
-
-            curl_slist_free_all(req_headers);
-            curl_easy_cleanup(curl);
+            const http_engine::response res = http_engine::instance().perform(std::move(req));
             fclose(fp);
 
-            if (res != CURLE_OK) {
+            if (!res.ok()) {
                 std::filesystem::remove(dest);
                 return {
-                    { "error", curl_easy_strerror(res) }
+                    { "error", res.error() }
                 };
             }
 
             return {
-                { "success",       true        },
-                { "status",        status_code },
-                { "bytes_written", ctx.written }
+                { "success",       true         },
+                { "status",        res.status   },
+                { "bytes_written", res.received }
             };
         }
 
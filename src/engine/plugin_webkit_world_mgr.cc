@@ -77,7 +77,7 @@ void webkit_world_mgr::initialize()
 
 bool webkit_world_mgr::is_valid_target_url(const std::string& url) const
 {
-    return target_url(url).allows_webkit_injection(m_network_hook_ctl->get_hook_list());
+    return target_url(url).allows_webkit_injection(*m_network_hook_ctl->get_hook_matcher());
 }
 
 void webkit_world_mgr::attach_to_target(const std::string& target_id, const std::string& url)
@@ -32,7 +32,6 @@
 #include "millennium/logger.h"
 #include <algorithm>
 #include <cstring>
-#include <fstream>
 #include <stdexcept>
 #include <vector>
 
@@ -43,7 +42,11 @@
 #include <windows.h>
 #include <bcrypt.h>
 #else
+#include <fcntl.h>
 #include <openssl/evp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 static constexpr uint8_t STAR_MAGIC[4] = { 'S', 'T', 'A', 'R' };
@@ -84,22 +87,6 @@ static constexpr size_t STAR_ENTRY_SIZE = 256;
 static constexpr uint32_t MAX_SHIM_SIZE = 4u * 1024u * 1024u;            // 4 MB
 static constexpr uint64_t MAX_SECTION_SIZE = 256ull * 1024ull * 1024ull; // 256 MB
 
-struct star_section_t
-{
-    uint8_t id;
-    uint8_t encode_flags; /* COMPRESSED=0x80, OBFUSCATED=0x40 */
-    uint32_t meta_flags;  /* DEFERRED=0x01, REQUIRED=0x02 */
-    uint64_t offset;      /* bytes from star_start */
-    uint64_t length;      /* encoded on-disk byte count */
-    uint32_t crc32;
-};
-
-struct star_sub_entry_t
-{
-    std::string name;
-    std::vector<uint8_t> data;
-};
-
 static uint32_t read_u32_le(const uint8_t* p)
 {
     return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
@@ -116,12 +103,6 @@ static uint64_t read_u64_le(const uint8_t* p)
            (static_cast<uint64_t>(p[4]) << 32) | (static_cast<uint64_t>(p[5]) << 40) | (static_cast<uint64_t>(p[6]) << 48) | (static_cast<uint64_t>(p[7]) << 56);
 }
 
-static void star_xor_decode(std::vector<uint8_t>& data)
-{
-    for (size_t i = 0; i < data.size(); ++i)
-        data[i] ^= STAR_XOR_KEY ^ static_cast<uint8_t>(i & 0xFF);
-}
-
 static uint32_t fnv1a_step(uint32_t hash, uint8_t byte)
 {
     return (hash ^ static_cast<uint32_t>(byte)) * 0x01000193u;
@@ -199,208 +180,157 @@ static uint32_t fnv1a_u32(uint32_t state, uint32_t value)
     return state;
 }
 
-static std::vector<uint8_t> star_strip_parity(const std::vector<uint8_t>& woven)
+/**
+ * strip the parity trailers from a woven section, undoing the xor obfuscation in the same pass.
+ * the parity checks run over the de-obfuscated bytes, exactly as the writer computed them.
+ */
+static std::string star_strip_parity(const uint8_t* woven, size_t size, bool obfuscated)
 {
-    if (woven.empty()) return {};
+    if (size == 0) return {};
+
+    auto byte_at = [&](size_t i) -> uint8_t
+    {
+        return obfuscated ? static_cast<uint8_t>(woven[i] ^ STAR_XOR_KEY ^ static_cast<uint8_t>(i & 0xFF)) : woven[i];
+    };
 
-    std::vector<uint8_t> out;
-    out.reserve(woven.size());
+    std::string out(size, '\0');
+    char* op = out.data();
 
     uint32_t rolling = STAR_PARITY_SEED;
     uint32_t expected_idx = 0;
     size_t pos = 0;
 
-    while (pos < woven.size()) {
-        if (woven.size() - pos < 12) throw std::runtime_error("truncated parity stream at block " + std::to_string(expected_idx));
+    while (pos < size) {
+        if (size - pos < 12) throw std::runtime_error("truncated parity stream at block " + std::to_string(expected_idx));
 
-        size_t data_end = std::min(pos + STAR_STRIDE, woven.size() - 12);
-
-        const uint8_t* pb = woven.data() + data_end;
-        uint32_t stored_xor = read_u32_le(pb);
-        uint32_t stored_roll = read_u32_le(pb + 4);
-        uint32_t stored_index = read_u32_le(pb + 8);
+        const size_t data_end = std::min(pos + STAR_STRIDE, size - 12);
 
         uint32_t xor_check = 0;
-        for (size_t i = pos; i < data_end; ++i)
-            xor_check ^= static_cast<uint32_t>(woven[i]);
+        for (size_t i = pos; i < data_end; ++i) {
+            const uint8_t b = byte_at(i);
+            xor_check ^= static_cast<uint32_t>(b);
+            *op++ = static_cast<char>(b);
+        }
 
-        uint32_t expected_roll = fnv1a_u32(rolling, xor_check);
+        uint8_t pb[12];
+        for (size_t i = 0; i < 12; ++i)
+            pb[i] = byte_at(data_end + i);
+
+        const uint32_t stored_xor = read_u32_le(pb);
+        const uint32_t stored_roll = read_u32_le(pb + 4);
+        const uint32_t stored_index = read_u32_le(pb + 8);
+        const uint32_t expected_roll = fnv1a_u32(rolling, xor_check);
 
         if (stored_xor != xor_check) throw std::runtime_error("parity xor mismatch at block " + std::to_string(expected_idx));
         if (stored_roll != expected_roll) throw std::runtime_error("parity chain broken at block " + std::to_string(expected_idx));
         if (stored_index != expected_idx) throw std::runtime_error("parity block reordered at block " + std::to_string(expected_idx));
 
-        out.insert(out.end(), woven.begin() + pos, woven.begin() + data_end);
         rolling = expected_roll;
         ++expected_idx;
         pos = data_end + 12;
     }
 
+    out.resize(static_cast<size_t>(op - out.data()));
     return out;
 }
 
-static std::vector<uint8_t> star_decode_section(const std::vector<uint8_t>& file_data, size_t star_start, const star_section_t& sec)
+/** read-only mapping of a whole file. the file and mapping handles are closed as soon as the view exists */
+struct star_archive::mapping
 {
-    if (sec.encode_flags == 0) {
-        /* raw section, no encoding; return bytes directly */
-        if (star_start > file_data.size() || static_cast<size_t>(sec.offset) > file_data.size() - star_start) {
-            throw std::runtime_error(std::format("section 0x{:02x} out of bounds", static_cast<uint32_t>(sec.id)));
-        }
-        const size_t abs_start = star_start + static_cast<size_t>(sec.offset);
-        if (static_cast<size_t>(sec.length) > file_data.size() - abs_start) {
-            throw std::runtime_error(std::format("section 0x{:02x} out of bounds", static_cast<uint32_t>(sec.id)));
-        }
-        return std::vector<uint8_t>(file_data.begin() + abs_start, file_data.begin() + abs_start + static_cast<size_t>(sec.length));
-    }
+    const uint8_t* data = nullptr;
+    size_t size = 0;
 
-    if (static_cast<size_t>(sec.offset) > file_data.size() - star_start) throw std::runtime_error(std::format("section 0x{:02x} offset overflow", static_cast<uint32_t>(sec.id)));
-    const size_t abs_start = star_start + static_cast<size_t>(sec.offset);
-    if (static_cast<size_t>(sec.length) > file_data.size() - abs_start)
-        throw std::runtime_error(std::format("section 0x{:02x} extends beyond file", static_cast<uint32_t>(sec.id)));
-
-    std::vector<uint8_t> blob(file_data.begin() + abs_start, file_data.begin() + abs_start + static_cast<size_t>(sec.length));
-
-    if (sec.encode_flags & FLAG_OBFUSCATED) star_xor_decode(blob);
-
-    auto stripped = star_strip_parity(blob);
-
-    if (sec.encode_flags & FLAG_COMPRESSED) return star_decompress(stripped.data(), stripped.size());
-
-    return stripped;
-}
-
-static std::vector<star_sub_entry_t> star_parse_sub_entries(const std::vector<uint8_t>& data)
-{
-    if (data.size() < 4) throw std::runtime_error("sub-entry table too short");
-
-    uint32_t count = read_u32_le(data.data());
-    std::vector<star_sub_entry_t> entries;
-    entries.reserve(count);
-    size_t pos = 4;
-
-    for (uint32_t i = 0; i < count; ++i) {
-        if (pos + 6 > data.size()) throw std::runtime_error("sub-entry " + std::to_string(i) + " header truncated");
-
-        uint16_t name_len = read_u16_le(data.data() + pos);
-        uint32_t data_len = read_u32_le(data.data() + pos + 2);
-        pos += 6;
-
-        if (static_cast<size_t>(name_len) > data.size() - pos) throw std::runtime_error("sub-entry " + std::to_string(i) + " data truncated");
-        const size_t after_name = pos + name_len;
-        if (static_cast<size_t>(data_len) > data.size() - after_name) throw std::runtime_error("sub-entry " + std::to_string(i) + " data truncated");
-
-        std::string name(data.begin() + pos, data.begin() + pos + name_len);
-        std::vector<uint8_t> entry_data(data.begin() + pos + name_len, data.begin() + pos + name_len + data_len);
-        entries.push_back({ std::move(name), std::move(entry_data) });
-        pos += name_len + data_len;
+    ~mapping()
+    {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+#else
+        if (data) munmap(const_cast<uint8_t*>(data), size);
+#endif
     }
 
-    return entries;
-}
-
-static std::string bytes_to_string(const std::vector<uint8_t>& data)
-{
-    return std::string(data.begin(), data.end());
-}
-
-static std::string extract_primary_entry(const std::vector<star_sub_entry_t>& entries, const std::string& preferred_name)
-{
-    for (const auto& e : entries)
-        if (e.name == preferred_name) return bytes_to_string(e.data);
-    for (const auto& e : entries)
-        if (!e.name.empty() && e.name.back() != '/') return bytes_to_string(e.data);
-    return {};
-}
+    static std::unique_ptr<mapping> open(const std::filesystem::path& path)
+    {
+        auto map = std::make_unique<mapping>();
+#ifdef _WIN32
+        /** share delete so plugin updates can still replace the file while it's mapped */
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 || static_cast<uint64_t>(file_size.QuadPart) > SIZE_MAX) {
+            CloseHandle(file);
+            return nullptr;
+        }
 
-static bool star_is_trusted(const uint8_t* star_hdr, size_t star_start, const std::vector<star_section_t>& sections, const std::vector<uint8_t>& data)
-{
-    const uint8_t star_flags = star_hdr[7];
-    if (!(star_flags & STAR_FLAG_SIGNED)) return false;
+        HANDLE section = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!section) return nullptr;
 
-    constexpr size_t SIG_LEN = 64;
+        map->data = static_cast<const uint8_t*>(MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(section);
+        if (!map->data) return nullptr;
 
-    // Content sections must not be deferred in a signed file — deferred data falls
-    // outside the signed region and could be swapped without invalidating the signature.
-    for (const auto& s : sections) {
-        if (s.id != SEC_ASSETS && (s.meta_flags & META_FLAG_DEFERRED)) return false;
-    }
+        map->size = static_cast<size_t>(file_size.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return nullptr;
 
-    // Compute the signed boundary the same way the Rust signer does: end of the last
-    // non-deferred section (offsets are relative to star_start).
-    uint64_t max_eager_end = 0;
-    for (const auto& s : sections) {
-        if (!(s.meta_flags & META_FLAG_DEFERRED)) {
-            const uint64_t end = s.offset + s.length;
-            if (end > max_eager_end) max_eager_end = end;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || static_cast<uint64_t>(st.st_size) > SIZE_MAX) {
+            close(fd);
+            return nullptr;
         }
-    }
 
-    const size_t sig_start = star_start + static_cast<size_t>(max_eager_end);
-    if (data.size() < sig_start + SIG_LEN) return false;
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) return nullptr;
 
-    const uint8_t* signature = data.data() + sig_start;
-    return verify_ed25519_signature(data.data(), sig_start, signature, STARLIGHT_PUBLIC_KEY);
-}
-
-/**
- * helper: open a .star, read only the non-deferred sections + signature into a bounded buffer.
- * this prevents crafted large files from causing OOM when loading plugins.
- */
-struct star_bounded_t
-{
-    size_t star_start;
-    std::vector<star_section_t> sections;
-    std::vector<uint8_t> file_data;
+        map->data = static_cast<const uint8_t*>(view);
+        map->size = static_cast<size_t>(st.st_size);
+#endif
+        return map;
+    }
 };
 
-static std::optional<star_bounded_t> star_load_bounded(const std::filesystem::path& path)
-{
-    std::ifstream f(path, std::ios::binary);
-    if (!f) return std::nullopt;
-
-    f.seekg(0, std::ios::end);
-    const size_t file_size = static_cast<size_t>(f.tellg());
-    f.seekg(0, std::ios::beg);
+star_archive::~star_archive() = default;
 
-    if (file_size < 8) return std::nullopt;
+std::unique_ptr<star_archive> star_archive::open(const std::filesystem::path& path)
+{
+    auto map = mapping::open(path);
+    if (!map) return nullptr;
 
-    uint8_t prefix[4];
-    if (!f.read(reinterpret_cast<char*>(prefix), 4)) return std::nullopt;
+    const uint8_t* data = map->data;
+    const size_t file_size = map->size;
+    if (file_size < 8) return nullptr;
 
     size_t star_start = 0;
-    if (std::memcmp(prefix, STAR_MAGIC, 4) != 0) {
-        const uint32_t shim_len = read_u32_le(prefix);
-        if (shim_len > MAX_SHIM_SIZE || 4 + static_cast<size_t>(shim_len) > file_size) return std::nullopt;
+    if (std::memcmp(data, STAR_MAGIC, 4) != 0) {
+        const uint32_t shim_len = read_u32_le(data);
+        if (shim_len > MAX_SHIM_SIZE || 4 + static_cast<size_t>(shim_len) > file_size) return nullptr;
         star_start = 4 + static_cast<size_t>(shim_len);
-        f.seekg(static_cast<std::streamoff>(star_start));
-    } else {
-        f.seekg(0);
     }
 
-    if (star_start + STAR_HEADER_SIZE > file_size) return std::nullopt;
+    if (star_start + STAR_HEADER_SIZE > file_size) return nullptr;
 
-    uint8_t hdr[STAR_HEADER_SIZE];
-    if (!f.read(reinterpret_cast<char*>(hdr), STAR_HEADER_SIZE)) return std::nullopt;
-    if (std::memcmp(hdr, STAR_MAGIC, 4) != 0) return std::nullopt;
-    if (hdr[4] != FORMAT_VERSION) return std::nullopt;
+    const uint8_t* hdr = data + star_start;
+    if (std::memcmp(hdr, STAR_MAGIC, 4) != 0) return nullptr;
+    if (hdr[4] != FORMAT_VERSION) return nullptr;
 
     const uint8_t section_count = hdr[6];
     static constexpr uint8_t MAX_SECTIONS = 32;
-    if (section_count > MAX_SECTIONS) return std::nullopt;
+    if (section_count > MAX_SECTIONS) return nullptr;
 
     const size_t table_bytes = static_cast<size_t>(section_count) * STAR_ENTRY_SIZE;
-    if (star_start + STAR_HEADER_SIZE + table_bytes > file_size) return std::nullopt;
+    if (star_start + STAR_HEADER_SIZE + table_bytes > file_size) return nullptr;
 
-    std::vector<uint8_t> tbl(table_bytes);
-    if (!f.read(reinterpret_cast<char*>(tbl.data()), table_bytes)) return std::nullopt;
-
-    std::vector<star_section_t> sections;
-    sections.reserve(section_count);
+    std::unique_ptr<star_archive> archive(new star_archive());
+    archive->m_sections.reserve(section_count);
     uint64_t max_eager_end = 0;
 
     for (uint8_t i = 0; i < section_count; ++i) {
-        const uint8_t* e = tbl.data() + i * STAR_ENTRY_SIZE;
-        star_section_t s;
+        const uint8_t* e = hdr + STAR_HEADER_SIZE + i * STAR_ENTRY_SIZE;
+        section_entry s;
         s.id = e[0];
         s.encode_flags = e[1];
         s.meta_flags = read_u32_le(e + 4);
@@ -411,76 +341,206 @@ static std::optional<star_bounded_t> star_load_bounded(const std::filesystem::pa
         /* unknown required section -> fuck off */
         if ((s.meta_flags & META_FLAG_REQUIRED) && s.id != SEC_METADATA && s.id != SEC_BACKEND && s.id != SEC_FRONTEND && s.id != SEC_WEBKIT && s.id != SEC_ASSETS) {
             LOG_ERROR("star: {} contains required unknown section 0x{:02x}", path.string(), s.id);
-            return std::nullopt;
+            return nullptr;
         }
 
-        sections.push_back(s);
+        archive->m_sections.push_back(s);
 
         if (!(s.meta_flags & META_FLAG_DEFERRED)) {
             if (s.length > MAX_SECTION_SIZE) {
                 LOG_ERROR("star: {} section 0x{:02x} exceeds 256 MB size limit", path.string(), s.id);
-                return std::nullopt;
+                return nullptr;
             }
             const uint64_t end = s.offset + s.length;
             if (end > max_eager_end) max_eager_end = end;
         }
     }
 
-    /* read only the non-deferred portion plus the trailing signature slot. */
-    const size_t read_limit = std::min(file_size, star_start + static_cast<size_t>(max_eager_end) + 64u);
-    f.seekg(0, std::ios::beg);
-    std::vector<uint8_t> file_data(read_limit);
-    if (!f.read(reinterpret_cast<char*>(file_data.data()), static_cast<std::streamsize>(read_limit))) return std::nullopt;
+    /* verify shim integrity if shim prefix is present. */
+    if (star_start > 0) {
+        const uint32_t stored_hash = read_u32_le(hdr + 8);
+        const uint32_t computed = fnv1a_hash_bytes(data + 4, star_start - 4);
+
+        if (computed != stored_hash) {
+            LOG_ERROR("star: {} shim integrity check failed (stored {:08x}, computed {:08x})", path.string(), stored_hash, computed);
+            return nullptr;
+        }
+    }
 
-    return star_bounded_t{ star_start, std::move(sections), std::move(file_data) };
+    /**
+     * signed files carry an ed25519 signature right after the last non-deferred section, covering everything before it.
+     * content sections must not be deferred in a signed file, deferred data falls outside the signed region and could
+     * be swapped without invalidating the signature.
+     */
+    constexpr size_t SIG_LEN = 64;
+    const bool all_content_eager = std::none_of(archive->m_sections.begin(), archive->m_sections.end(), [](const section_entry& s)
+    {
+        return s.id != SEC_ASSETS && (s.meta_flags & META_FLAG_DEFERRED);
+    });
+
+    if ((hdr[7] & STAR_FLAG_SIGNED) && all_content_eager && max_eager_end <= file_size - star_start && file_size - star_start - max_eager_end >= SIG_LEN) {
+        archive->m_signature_offset = star_start + static_cast<size_t>(max_eager_end);
+    }
+
+    archive->m_path = path;
+    archive->m_data = data;
+    archive->m_size = file_size;
+    archive->m_star_start = star_start;
+    archive->m_mapping = std::move(map);
+    return archive;
 }
 
-std::optional<plugin_manager::plugin_t> parse_star_file(const std::filesystem::path& star_path)
+bool star_archive::is_trusted() const
 {
-    auto loaded = star_load_bounded(star_path);
-    if (!loaded) {
-        LOG_ERROR("star: {} failed bounded load", star_path.string());
-        return std::nullopt;
+    std::call_once(m_trust_once, [this]
+    {
+        if (m_signature_offset != 0) {
+            m_trusted = verify_ed25519_signature(m_data, m_signature_offset, m_data + m_signature_offset, STARLIGHT_PUBLIC_KEY);
+        }
+    });
+    return m_trusted;
+}
+
+const star_archive::section_entry* star_archive::find_section(star_section id) const
+{
+    for (const auto& s : m_sections)
+        if (s.id == static_cast<uint8_t>(id)) return &s;
+    return nullptr;
+}
+
+bool star_archive::has_section(star_section id) const
+{
+    return find_section(id) != nullptr;
+}
+
+std::string_view star_archive::section(star_section id) const
+{
+    const section_entry* sec = find_section(id);
+    return sec ? decode_section(*sec) : std::string_view{};
+}
+
+std::string_view star_archive::decode_section(const section_entry& sec) const
+{
+    const size_t available = m_size - m_star_start;
+    if (sec.offset > available || sec.length > available - sec.offset) {
+        throw std::runtime_error(std::format("section 0x{:02x} extends beyond file", static_cast<uint32_t>(sec.id)));
     }
 
-    const size_t star_start = loaded->star_start;
-    auto& file_data = loaded->file_data;
-    auto& sections = loaded->sections;
+    const uint8_t* blob = m_data + m_star_start + static_cast<size_t>(sec.offset);
+    const size_t length = static_cast<size_t>(sec.length);
 
-    if (file_data.size() < star_start + STAR_HEADER_SIZE) return std::nullopt;
-    const uint8_t* star_hdr = file_data.data() + star_start;
+    /* raw section, no encoding; hand out the mapped bytes directly */
+    if (sec.encode_flags == 0) return { reinterpret_cast<const char*>(blob), length };
 
-    const bool is_trusted = star_is_trusted(star_hdr, star_start, sections, file_data);
+    std::lock_guard<std::mutex> lock(m_decode_mutex);
 
-    /* verify shim integrity if shim prefix is present. */
-    if (star_start > 0) {
-        const uint32_t stored_hash = read_u32_le(star_hdr + 8);
-        const uint32_t shim_len = read_u32_le(file_data.data());
-        const uint32_t computed = fnv1a_hash_bytes(file_data.data() + 4, shim_len);
+    auto it = m_decoded.find(sec.id);
+    if (it == m_decoded.end()) {
+        std::string decoded = star_strip_parity(blob, length, sec.encode_flags & FLAG_OBFUSCATED);
+        if (sec.encode_flags & FLAG_COMPRESSED) decoded = star_decompress(reinterpret_cast<const uint8_t*>(decoded.data()), decoded.size());
+        it = m_decoded.emplace(sec.id, std::move(decoded)).first;
+    }
+    return it->second;
+}
 
-        if (computed != stored_hash) {
-            LOG_ERROR("star: {} shim integrity check failed (stored {:08x}, computed {:08x})", star_path.string(), stored_hash, computed);
-            return std::nullopt;
-        }
+std::vector<star_entry_view> star_archive::entries(star_section id) const
+{
+    const std::string_view data = section(id);
+    if (data.size() < 4) throw std::runtime_error("sub-entry table too short");
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    const uint32_t count = read_u32_le(bytes);
+
+    std::vector<star_entry_view> entries;
+    entries.reserve(std::min<size_t>(count, data.size() / 6));
+    size_t pos = 4;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + 6 > data.size()) throw std::runtime_error("sub-entry " + std::to_string(i) + " header truncated");
+
+        const uint16_t name_len = read_u16_le(bytes + pos);
+        const uint32_t data_len = read_u32_le(bytes + pos + 2);
+        pos += 6;
+
+        if (static_cast<size_t>(name_len) > data.size() - pos) throw std::runtime_error("sub-entry " + std::to_string(i) + " data truncated");
+        const size_t after_name = pos + name_len;
+        if (static_cast<size_t>(data_len) > data.size() - after_name) throw std::runtime_error("sub-entry " + std::to_string(i) + " data truncated");
+
+        entries.push_back({ data.substr(pos, name_len), data.substr(after_name, data_len) });
+        pos = after_name + data_len;
     }
 
-    auto find_section = [&](uint8_t id) -> const star_section_t*
-    {
-        for (auto& s : sections)
-            if (s.id == id) return &s;
-        return nullptr;
-    };
+    return entries;
+}
+
+std::unordered_map<std::string, AssetEntry> star_archive::asset_index() const
+{
+    std::unordered_map<std::string, AssetEntry> result;
+
+    /* assets section must be raw (encode_flags == 0) */
+    const section_entry* sec = find_section(star_section::assets);
+    if (!sec || sec->encode_flags != 0 || sec->length == 0) return result;
+
+    const size_t available = m_size - m_star_start;
+    if (sec->offset > available || sec->length > available - sec->offset || sec->length < 4) return result;
+
+    const size_t assets_start = m_star_start + static_cast<size_t>(sec->offset);
+    const size_t assets_end = assets_start + static_cast<size_t>(sec->length);
+
+    const uint32_t count = read_u32_le(m_data + assets_start);
+    if (count > 65536) return result;
+
+    /* walk sub-entry headers in place; asset bodies are never touched */
+    size_t pos = assets_start + 4;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (assets_end - pos < 6) break;
+
+        const uint16_t name_len = read_u16_le(m_data + pos);
+        const uint32_t data_len = read_u32_le(m_data + pos + 2);
+        pos += 6;
+
+        if (assets_end - pos < static_cast<size_t>(name_len)) break;
+        std::string name(reinterpret_cast<const char*>(m_data + pos), name_len);
+        pos += name_len;
+
+        if (assets_end - pos < static_cast<size_t>(data_len)) break;
+
+        /* first 4 bytes of the compressed block = uncompressed size (lz4 prepend) */
+        const size_t uncompressed_length = data_len >= 4 ? static_cast<size_t>(read_u32_le(m_data + pos)) : 0;
+
+        result[std::move(name)] = AssetEntry{ pos, static_cast<size_t>(data_len), uncompressed_length };
+        pos += data_len;
+    }
 
-    const star_section_t* meta_sec = find_section(SEC_METADATA);
-    if (!meta_sec) {
+    return result;
+}
+
+static std::string extract_primary_entry(const std::vector<star_entry_view>& entries, std::string_view preferred_name)
+{
+    for (const auto& e : entries)
+        if (e.name == preferred_name) return std::string(e.data);
+    for (const auto& e : entries)
+        if (!e.name.empty() && e.name.back() != '/') return std::string(e.data);
+    return {};
+}
+
+std::optional<plugin_manager::plugin_t> parse_star_file(const std::filesystem::path& star_path)
+{
+    const auto archive = star_archive::open(star_path);
+    if (!archive) {
+        LOG_ERROR("star: {} could not be opened", star_path.string());
+        return std::nullopt;
+    }
+
+    if (!archive->has_section(star_section::metadata)) {
         LOG_ERROR("star: {} has no metadata section", star_path.string());
         return std::nullopt;
     }
 
     nlohmann::json metadata;
     try {
-        auto raw = star_decode_section(file_data, star_start, *meta_sec);
-        metadata = nlohmann::json::from_msgpack(raw, /* strict */ true, /* allow_exceptions */ false);
+        const std::string_view raw = archive->section(star_section::metadata);
+        metadata = nlohmann::json::from_msgpack(raw.begin(), raw.end(), /* strict */ true, /* allow_exceptions */ false);
     } catch (const std::exception& ex) {
         LOG_ERROR("star: {} metadata decode failed: {}", star_path.string(), ex.what());
         return std::nullopt;
@@ -494,9 +554,10 @@ std::optional<plugin_manager::plugin_t> parse_star_file(const std::filesystem::p
     const std::string plugin_id = metadata["id"].get<std::string>();
     const std::string plugin_name = metadata["name"].get<std::string>();
 
-    bool has_backend = find_section(SEC_BACKEND) != nullptr;
-    bool has_frontend_js = find_section(SEC_FRONTEND) != nullptr;
-    bool has_webkit_js = find_section(SEC_WEBKIT) != nullptr;
+    bool has_backend = archive->has_section(star_section::backend);
+    bool has_frontend_js = archive->has_section(star_section::frontend);
+    bool has_webkit_js = archive->has_section(star_section::webkit);
+    const bool is_trusted = archive->is_trusted();
 
     nlohmann::json plugin_json = {
         { "name", plugin_id },
@@ -529,125 +590,22 @@ std::optional<plugin_manager::plugin_t> parse_star_file(const std::filesystem::p
 
 std::string star_read_javascript(const std::filesystem::path& star_path, star_js_section section)
 {
-    auto loaded = star_load_bounded(star_path);
-    if (!loaded) return {};
-
-    const uint8_t target_id = (section == star_js_section::frontend) ? SEC_FRONTEND : SEC_WEBKIT;
-
-    for (const auto& sec : loaded->sections) {
-        if (sec.id != target_id) continue;
-        try {
-            auto decoded = star_decode_section(loaded->file_data, loaded->star_start, sec);
-            auto entries = star_parse_sub_entries(decoded);
-            return extract_primary_entry(entries, "bundle.js");
-        } catch (const std::exception& ex) {
-            LOG_ERROR("star: {} js extract failed: {}", star_path.string(), ex.what());
-        }
-        break;
+    const auto archive = star_archive::open(star_path);
+    if (!archive) return {};
+
+    const star_section target = (section == star_js_section::frontend) ? star_section::frontend : star_section::webkit;
+    if (!archive->has_section(target)) return {};
+
+    try {
+        return extract_primary_entry(archive->entries(target), "bundle.js");
+    } catch (const std::exception& ex) {
+        LOG_ERROR("star: {} js extract failed: {}", star_path.string(), ex.what());
     }
     return {};
 }
 
 std::unordered_map<std::string, AssetEntry> star_read_asset_index(const std::filesystem::path& star_path)
 {
-    std::unordered_map<std::string, AssetEntry> result;
-
-    std::ifstream f(star_path, std::ios::binary);
-    if (!f) return result;
-
-    f.seekg(0, std::ios::end);
-    const size_t file_size = static_cast<size_t>(f.tellg());
-    f.seekg(0, std::ios::beg);
-
-    if (file_size < 8) return result;
-
-    uint8_t prefix[4];
-    if (!f.read(reinterpret_cast<char*>(prefix), 4)) return result;
-
-    size_t star_start = 0;
-    if (std::memcmp(prefix, STAR_MAGIC, 4) != 0) {
-        const uint32_t shim_len = read_u32_le(prefix);
-        if (shim_len > MAX_SHIM_SIZE || 4 + static_cast<size_t>(shim_len) > file_size) return result;
-        star_start = 4 + static_cast<size_t>(shim_len);
-        f.seekg(static_cast<std::streamoff>(star_start));
-    } else {
-        f.seekg(0);
-    }
-
-    if (star_start + STAR_HEADER_SIZE > file_size) return result;
-    uint8_t hdr[STAR_HEADER_SIZE];
-    if (!f.read(reinterpret_cast<char*>(hdr), STAR_HEADER_SIZE)) return result;
-    if (std::memcmp(hdr, STAR_MAGIC, 4) != 0) return result;
-    if (hdr[4] != FORMAT_VERSION) return result;
-
-    const uint8_t section_count = hdr[6];
-    if (section_count > 32) return result;
-
-    const size_t table_bytes = static_cast<size_t>(section_count) * STAR_ENTRY_SIZE;
-    if (star_start + STAR_HEADER_SIZE + table_bytes > file_size) return result;
-
-    std::vector<uint8_t> tbl(table_bytes);
-    if (!f.read(reinterpret_cast<char*>(tbl.data()), table_bytes)) return result;
-
-    /* find assets section */
-    const uint8_t* asset_entry_raw = nullptr;
-    for (uint8_t i = 0; i < section_count; ++i) {
-        const uint8_t* e = tbl.data() + i * STAR_ENTRY_SIZE;
-        if (e[0] == SEC_ASSETS) {
-            asset_entry_raw = e;
-            break;
-        }
-    }
-    if (!asset_entry_raw) return result;
-
-    const uint8_t asset_encode_flags = asset_entry_raw[1];
-    const uint64_t asset_offset = read_u64_le(asset_entry_raw + 8);
-    const uint64_t asset_length = read_u64_le(asset_entry_raw + 16);
-
-    /* assets section must be raw (encode_flags == 0) */
-    if (asset_encode_flags != 0) return result;
-    if (asset_length == 0) return result;
-
-    if (static_cast<size_t>(asset_offset) > file_size - star_start) return result;
-    const size_t assets_abs_start = star_start + static_cast<size_t>(asset_offset);
-    if (static_cast<size_t>(asset_length) > file_size - assets_abs_start) return result;
-    if (assets_abs_start + 4 > file_size) return result;
-
-    f.seekg(static_cast<std::streamoff>(assets_abs_start));
-
-    uint8_t count_buf[4];
-    if (!f.read(reinterpret_cast<char*>(count_buf), 4)) return result;
-    const uint32_t count = read_u32_le(count_buf);
-    if (count > 65536) return result;
-
-    /* walk sub-entry headers; read only header bytes, skip data bodies */
-    for (uint32_t i = 0; i < count; ++i) {
-        uint8_t sub_hdr[6];
-        if (!f.read(reinterpret_cast<char*>(sub_hdr), 6)) break;
-
-        const uint16_t name_len = read_u16_le(sub_hdr);
-        const uint32_t data_len = read_u32_le(sub_hdr + 2);
-
-        /* read name */
-        std::string name(name_len, '\0');
-        if (!f.read(name.data(), name_len)) break;
-
-        const size_t data_offset = static_cast<size_t>(f.tellg());
-
-        /* first 4 bytes of the compressed block = uncompressed size (lz4 prepend) */
-        size_t uncompressed_length = 0;
-        if (data_len >= 4) {
-            uint8_t sz_buf[4];
-            if (f.read(reinterpret_cast<char*>(sz_buf), 4)) {
-                uncompressed_length = static_cast<size_t>(read_u32_le(sz_buf));
-                f.seekg(static_cast<std::streamoff>(data_len - 4), std::ios::cur);
-            }
-        } else if (data_len > 0) {
-            f.seekg(static_cast<std::streamoff>(data_len), std::ios::cur);
-        }
-
-        result[name] = AssetEntry{ data_offset, static_cast<size_t>(data_len), uncompressed_length };
-    }
-
-    return result;
+    const auto archive = star_archive::open(star_path);
+    return archive ? archive->asset_index() : std::unordered_map<std::string, AssetEntry>{};
 }
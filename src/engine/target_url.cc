@@ -101,6 +101,15 @@ bool target_url::allows_webkit_injection(const std::vector<network_hook_ctl::hoo
     if (is_steam_owned()) return true;
 
     return std::any_of(hooks.begin(), hooks.end(), [this](const auto& hook_item) {
-        return std::regex_match(m_raw_url, hook_item.hook.url_pattern);
+        return std::regex_match(m_raw_url, *hook_item.hook.url_pattern);
     });
 }
+
+bool target_url::allows_webkit_injection(const network_hook_ctl::hook_matcher& hooks) const {
+    if (!m_valid) return false;
+    if (!is_safe_for_js()) return false;
+    if (m_host == k_steam_loopback) return false;
+    if (is_steam_owned()) return true;
+
+    return hooks.any_match(m_raw_url);
+}
@@ -31,7 +31,7 @@
 #include "millennium/thread_pool.h"
 #include "millennium/logger.h"
 
-thread_pool::thread_pool(size_t num_threads) : stop(false), shutdown_called(false)
+thread_pool::thread_pool(size_t num_threads, size_t max_queued) : max_queued(max_queued), stop(false), shutdown_called(false)
 {
     for (size_t i = 0; i < num_threads; ++i) {
         workers.emplace_back([this]
@@ -111,3 +111,16 @@ void thread_pool::enqueue(std::function<void()> f)
     }
     condition.notify_one();
 }
+
+bool thread_pool::try_enqueue(std::function<void()> f)
+{
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (stop || (max_queued != 0 && tasks.size() >= max_queued)) {
+            return false;
+        }
+        tasks.emplace(std::move(f));
+    }
+    condition.notify_one();
+    return true;
+}
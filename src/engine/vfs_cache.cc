@@ -0,0 +1,124 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/vfs_cache.h"
+
+std::optional<vfs_file_stamp> vfs_file_stamp::of(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::is_regular_file(status)) {
+        return std::nullopt;
+    }
+
+    vfs_file_stamp stamp;
+    stamp.mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return std::nullopt;
+
+    stamp.size = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+
+    return stamp;
+}
+
+vfs_response_cache::vfs_response_cache(size_t byte_budget) : m_byte_budget(byte_budget)
+{
+}
+
+std::shared_ptr<const vfs_response> vfs_response_cache::find(const std::string& key, const vfs_file_stamp& stamp)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return nullptr;
+    }
+
+    /** the file changed on disk since it was cached */
+    if (it->second->stamp != stamp) {
+        erase(it->second);
+        return nullptr;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->response;
+}
+
+void vfs_response_cache::store(const std::string& key, const vfs_file_stamp& stamp, std::shared_ptr<const vfs_response> response)
+{
+    const size_t bytes = response->body.size();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (auto it = m_index.find(key); it != m_index.end()) {
+        erase(it->second);
+    }
+
+    /** don't let one huge file flush everything else */
+    if (bytes > m_byte_budget / 4) {
+        return;
+    }
+
+    while (!m_lru.empty() && m_bytes + bytes > m_byte_budget) {
+        erase(std::prev(m_lru.end()));
+    }
+
+    m_lru.push_front({ key, stamp, std::move(response) });
+    m_index[key] = m_lru.begin();
+    m_bytes += bytes;
+}
+
+void vfs_response_cache::invalidate(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto it = m_index.find(key); it != m_index.end()) {
+        erase(it->second);
+    }
+}
+
+void vfs_response_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+size_t vfs_response_cache::size_bytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+void vfs_response_cache::erase(std::list<entry>::iterator it)
+{
+    m_bytes -= it->response->body.size();
+    m_index.erase(it->key);
+    m_lru.erase(it);
+}
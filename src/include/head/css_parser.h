@@ -34,6 +34,7 @@
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace head
 {
@@ -58,8 +59,11 @@ color_type try_raw_parse(const std::string& color);
 
 nlohmann::json parse_root_colors(const std::string& filePath);
 
-std::string extract_root_block(const std::string& fileContent);
-void parse_properties(const std::string& block, std::map<std::string, std::string>& properties, std::map<std::string, std::pair<std::string, std::string>>& propertyMap);
+/**
+ * collect the declarations of every top-level :root rule in a single pass over the stylesheet,
+ * along with the @name/@description tags of the comment right before each declaration.
+ */
+void parse_root_properties(std::string_view css, std::map<std::string, std::string>& properties, std::map<std::string, std::pair<std::string, std::string>>& propertyMap);
 std::string trim(const std::string& str);
 
 json generate_color_metadata(const std::map<std::string, std::string>& properties, const std::map<std::string, std::pair<std::string, std::string>>& propertyMap);
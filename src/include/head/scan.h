@@ -29,6 +29,7 @@
  */
 
 #pragma once
+#include "head/theme_cache.h"
 #include "millennium/plugin_manager.h"
 #include "nlohmann/json.hpp"
 #include "nlohmann/json_fwd.hpp"
@@ -53,5 +54,8 @@ namespace Themes
 {
 bool IsValid(const std::string& theme_native_name);
 nlohmann::ordered_json FindAllThemes();
+
+/** cache of parsed theme metadata, keyed by file fingerprint */
+theme_metadata_cache& MetadataCache();
 } // namespace Themes
 } // namespace head
@@ -0,0 +1,98 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace head
+{
+/**
+ * parsed theme metadata (skin.json documents and RootColors color lists) persisted across sessions.
+ *
+ * the whole cache is one json file read once when the cache is created. an entry is reused as long as its
+ * file's size and mtime match; if only the mtime moved (a copy, a checkout) the file is hashed and the entry
+ * is kept when the content is unchanged. anything else is parsed again and written back on save().
+ */
+class theme_metadata_cache
+{
+  public:
+    explicit theme_metadata_cache(std::filesystem::path cache_file);
+
+    /** a theme's skin.json, nullopt if it's missing or isn't valid json */
+    std::optional<nlohmann::ordered_json> skin(const std::filesystem::path& skin_path);
+
+    /** color metadata of a RootColors stylesheet, as css_parser::parse_root_colors() returns it */
+    nlohmann::json root_colors(const std::filesystem::path& css_path);
+
+    /** write the cache back if anything changed. returns false if it couldn't be written */
+    bool save();
+
+    /** lookups answered without parsing, and ones that had to parse */
+    std::size_t hits() const;
+    std::size_t misses() const;
+
+  private:
+    struct fingerprint
+    {
+        std::uintmax_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+    };
+
+    struct entry
+    {
+        fingerprint print;
+        nlohmann::ordered_json value; // null when the file couldn't be parsed
+    };
+
+    /**
+     * the cached value for path if it's still current, otherwise parse(content) stored under the new fingerprint.
+     * a missing file yields null.
+     */
+    template <typename parse_fn> nlohmann::ordered_json lookup(const std::filesystem::path& path, const char* kind, parse_fn&& parse);
+
+    void load();
+
+    std::filesystem::path m_cache_file;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, entry> m_entries; // keyed by "<kind>:<path>"
+    bool m_dirty = false;
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+};
+} // namespace head
@@ -54,6 +54,7 @@ class theme_webkit_mgr
     void add_conditional_data(const nlohmann::json& data, const std::string& theme_name);
     unsigned long long add_browser_hook(const std::string& path, const std::string& regex = ".*", network_hook_ctl::TagTypes type = network_hook_ctl::STYLESHEET);
     bool remove_browser_hook(unsigned long long hookId);
+    void set_stylesheet_bundling(bool enabled);
     std::vector<webkit_item> parse_conditional_data(const nlohmann::json& conditional_patches, const std::string& theme_name);
 
   private:
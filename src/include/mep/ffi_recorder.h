@@ -30,11 +30,18 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -53,31 +60,193 @@ struct ffi_call_entry
     std::string caller; // e.g. "main.lua:42" — empty if unavailable
 };
 
+/**
+ * a call as handed to ffi_recorder::record(). nothing here is owned, the recorder copies what it keeps
+ * (payloads truncated to ffi_recorder::MAX_PAYLOAD_BYTES) before record() returns.
+ */
+struct ffi_call_sample
+{
+    std::string_view plugin;
+    std::string_view method;
+    std::string_view direction;
+    std::string_view args;
+    std::string_view result;
+    double duration_ms;
+    std::chrono::system_clock::time_point timestamp;
+    std::string_view caller;
+};
+
+/** call duration percentiles over a set of recorded calls */
+struct ffi_latency_stats
+{
+    std::size_t samples = 0;
+    double p50_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/** latency of one method in one direction, over every call since startup */
+struct ffi_method_latency
+{
+    std::string method;
+    std::string direction;
+    ffi_latency_stats stats;
+};
+
+/**
+ * log-linear latency histogram (hdr-style): each power of two of microseconds is split into 32 linear
+ * sub-buckets, so any recorded value is reported within ~3% using a few kb per histogram regardless of count.
+ */
+class latency_histogram
+{
+  public:
+    void record(double duration_ms);
+
+    std::size_t count() const
+    {
+        return m_count;
+    }
+
+    /** value at quantile q (0..1), nearest-rank, as the midpoint of the bucket it falls in */
+    double percentile(double q) const;
+    double max() const
+    {
+        return m_max_ms;
+    }
+
+  private:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned MAGNITUDES = 40; // 2^40 us, ~12 days
+
+    static std::size_t bucket_index(uint64_t micros);
+    static double bucket_midpoint_ms(std::size_t index);
+
+    std::array<uint32_t, SUB_BUCKETS * MAGNITUDES> m_buckets{};
+    std::size_t m_count = 0;
+    double m_max_ms = 0.0;
+};
+
+/**
+ * records ffi calls for the mep inspector (plugin.ffi).
+ *
+ * record() sits on every plugin call, so it only copies the call into a ring owned by the calling thread:
+ * names are interned to ids through a small per-thread cache, payloads are truncated into slots whose strings
+ * keep their capacity, and there's no shared lock. a background aggregator drains the rings into the recent-calls
+ * history and per-method latency histograms. queries drain first, so they see everything recorded before them.
+ *
+ * listeners still run inline in record(), but only once someone has subscribed.
+ */
 class ffi_recorder
 {
   public:
     using listener_fn = std::function<void(const ffi_call_entry&)>;
 
+    /** payloads past this are cut (and marked) when recorded */
+    static constexpr std::size_t MAX_PAYLOAD_BYTES = 2048;
+
     static ffi_recorder& instance();
+    ~ffi_recorder();
 
-    void record(ffi_call_entry entry);
+    void record(const ffi_call_sample& sample);
+    void record(const ffi_call_entry& entry);
 
     std::vector<ffi_call_entry> get_recent(const std::string& plugin, std::size_t max = 200) const;
 
+    /** latency percentiles over the calls still held in the history. an empty plugin name covers every plugin */
+    ffi_latency_stats get_latency(const std::string& plugin) const;
+
+    /** per-method latency of a plugin from the histograms, covering every call since startup */
+    std::vector<ffi_method_latency> get_method_latency(const std::string& plugin) const;
+
+    /** calls lost because a thread's ring was full when it recorded */
+    std::size_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
     int add_listener(const std::string& plugin, listener_fn fn);
     void remove_listener(int id);
 
   private:
-    ffi_recorder() = default;
+    ffi_recorder();
 
     static constexpr std::size_t RING_SIZE = 512;
+    static constexpr std::size_t THREAD_RING_SIZE = 256;
+    static constexpr std::chrono::milliseconds AGGREGATE_INTERVAL{ 100 };
+
+    /** a recorded call with its names interned */
+    struct slot
+    {
+        uint32_t plugin;
+        uint32_t method;
+        uint32_t direction;
+        uint32_t caller;
+        double duration_ms;
+        std::chrono::system_clock::time_point timestamp;
+        std::string args;
+        std::string result;
+    };
+
+    /** single producer (its thread), single consumer (whoever holds m_aggregate_mutex) */
+    struct thread_ring
+    {
+        std::array<slot, THREAD_RING_SIZE> slots;
+        std::atomic<std::size_t> head{ 0 }; // next slot the producer writes
+        std::atomic<std::size_t> tail{ 0 }; // next slot the consumer reads
+        std::atomic<bool> retired{ false }; // producer thread exited
+    };
+
+    struct histogram_key
+    {
+        uint32_t plugin;
+        uint32_t method;
+        uint32_t direction;
+
+        bool operator==(const histogram_key&) const = default;
+    };
+
+    struct histogram_key_hash
+    {
+        std::size_t operator()(const histogram_key& key) const
+        {
+            return (static_cast<std::size_t>(key.plugin) * 0x9E3779B1u) ^ (static_cast<std::size_t>(key.method) << 7) ^ key.direction;
+        }
+    };
+
+    thread_ring& local_ring();
+    uint32_t intern(std::string_view name);
+    void wake_aggregator();
+
+    /** move everything the rings hold into the history and histograms. caller holds m_aggregate_mutex */
+    void drain_locked() const;
+    void aggregate_loop();
+
+    /** interned names, append only */
+    mutable std::shared_mutex m_intern_mutex;
+    std::unordered_map<std::string, uint32_t> m_intern_ids;
+    std::vector<std::string> m_intern_names;
+
+    mutable std::mutex m_rings_mutex;
+    mutable std::vector<std::shared_ptr<thread_ring>> m_rings;
+    std::atomic<std::size_t> m_dropped{ 0 };
+
+    /** history and histograms, only touched with m_aggregate_mutex held */
+    mutable std::mutex m_aggregate_mutex;
+    mutable std::vector<std::shared_ptr<thread_ring>> m_drain_snapshot;
+    mutable std::vector<ffi_call_entry> m_ring;
+    mutable std::size_t m_write_pos = 0;
+    mutable std::unordered_map<histogram_key, latency_histogram, histogram_key_hash> m_histograms;
 
-    mutable std::mutex m_ring_mutex;
-    std::vector<ffi_call_entry> m_ring;
-    std::size_t m_write_pos = 0;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake_cv;
+    bool m_stop = false;
+    std::thread m_aggregator;
 
     std::mutex m_listener_mutex;
     std::unordered_map<int, std::pair<std::string, listener_fn>> m_listeners;
     std::atomic<int> m_id_counter{ 0 };
+    std::atomic<std::size_t> m_listener_count{ 0 };
 };
 } // namespace mep
@@ -31,11 +31,13 @@
 #pragma once
 
 #include "mep_message.h"
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mep
 {
@@ -48,8 +50,16 @@ class router
     response_t dispatch(const request_t& request, const std::shared_ptr<client_context>& ctx) const;
 
   private:
-    mutable std::mutex m_mutex;
-    std::unordered_map<std::string, handler_fn> m_handlers;
+    using handler_table = std::unordered_map<std::string, handler_fn>;
+
+    /**
+     * dispatch() reads the current table without taking a lock. registering copies the table and publishes the copy;
+     * superseded tables stay alive with the router since a dispatch may still be reading one. handlers are only
+     * registered at startup, so that's a few dozen small maps.
+     */
+    std::mutex m_register_mutex;
+    std::vector<std::unique_ptr<const handler_table>> m_tables;
+    std::atomic<const handler_table*> m_handlers{ nullptr };
 };
 
 } // namespace mep
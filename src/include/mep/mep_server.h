@@ -34,10 +34,15 @@
 #include <atomic>
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+class thread_pool;
+
 namespace mep
 {
 
@@ -55,6 +60,21 @@ static constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/millennium-mep.sock";
 
 static constexpr std::size_t MAX_MESSAGE_SIZE = 4u * 1024u * 1024u;
 
+/** a client whose unsent output grows past this is evicted instead of buffering without bound */
+static constexpr std::size_t MAX_OUTBOUND_BYTES = 16u * 1024u * 1024u;
+
+/** requests read from one client but not handled yet; past this the server stops reading from it until it catches up */
+static constexpr std::size_t MAX_PENDING_REQUESTS = 64;
+
+/**
+ * mep socket server.
+ *
+ * a single reactor thread (epoll on linux, kqueue on macos, WSAPoll on windows) accepts clients and reads their
+ * frames. requests are handled on a small worker pool, one at a time per client so each client still sees its
+ * responses in order. everything sent to a client (responses and subscription events from any thread) goes
+ * through its outbound buffer: it's written straight away when the socket has room, otherwise coalesced and
+ * flushed by the reactor once the socket is writable.
+ */
 class server
 {
   public:
@@ -69,17 +89,43 @@ class server
     using socket_t = int;
 
   private:
-    void accept_loop();
-    void handle_client(socket_t client_fd);
+    struct connection;
+    class poller;
 
-    bool read_frame(socket_t fd, std::vector<uint8_t>& out) const;
-    bool write_frame(socket_t fd, const std::vector<uint8_t>& data) const;
+    static constexpr std::size_t WORKER_THREADS = 4;
+
+    void reactor_loop();
+    void accept_clients();
+    void read_client(const std::shared_ptr<connection>& conn);
+    void flush_client(const std::shared_ptr<connection>& conn);
+    void update_interest(const std::shared_ptr<connection>& conn);
+    void close_client(const std::shared_ptr<connection>& conn);
+
+    /** queue a frame read from conn, starting a worker on it if none is running */
+    void queue_request(const std::shared_ptr<connection>& conn, std::vector<uint8_t> payload);
+    /** worker side: handle conn's next queued request, then hand the rest back to the pool */
+    void run_next_request(const std::shared_ptr<connection>& conn);
+    void handle_request(const std::shared_ptr<connection>& conn, const std::vector<uint8_t>& payload);
+
+    /** append a frame to conn's outbound buffer. false if the client is gone or was just evicted */
+    bool send_to(const std::shared_ptr<connection>& conn, const std::vector<uint8_t>& payload);
+    /** have the reactor look at conn again (interest changes, eviction), callable from any thread */
+    void mark_dirty(const std::shared_ptr<connection>& conn);
 
     router& m_router;
     std::string m_socket_path;
     socket_t m_server_fd = -1;
     std::atomic<bool> m_running{ false };
-    std::thread m_accept_thread;
+    std::thread m_reactor_thread;
+
+    std::unique_ptr<poller> m_poller;
+    std::unique_ptr<thread_pool> m_workers;
+
+    /** reactor thread only */
+    std::unordered_map<socket_t, std::shared_ptr<connection>> m_clients;
+
+    std::mutex m_dirty_mutex;
+    std::vector<std::weak_ptr<connection>> m_dirty;
 };
 
 } // namespace mep
@@ -57,6 +57,8 @@ class backend_manager
 
     /** rpc evaluate a lua function in the child process. */
     json evaluate(const std::string& pluginName, const json& script);
+    /** same as evaluate(), with the script already msgpack encoded. */
+    json evaluate_packed(const std::string& pluginName, const std::vector<uint8_t>& packed_script);
 
     /** rpc notify child that frontend loaded. */
     void notify_frontend_loaded(const std::string& pluginName);
@@ -71,7 +73,8 @@ class backend_manager
     std::unordered_map<std::string, PluginProcess::process_metrics> get_all_plugin_metrics();
 
   private:
-    std::unordered_map<std::string, std::unique_ptr<PluginProcess>> m_processes;
+    /** shared so a call into one plugin can run without holding m_processes_mutex */
+    std::unordered_map<std::string, std::shared_ptr<PluginProcess>> m_processes;
     std::mutex m_processes_mutex;
 
     PluginProcess::request_handler m_child_request_handler;
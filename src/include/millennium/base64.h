@@ -0,0 +1,69 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * standard (rfc 4648) base64 with padding.
+ *
+ * cdp moves every response body we fulfil or relay as base64, so this sits on the hot path of each themed
+ * page load. bulk work runs on avx2/ssse3 (x86) or neon (arm64) when the cpu has it, picked once at runtime,
+ * with a scalar fallback for everything else and for the tail of each buffer.
+ */
+namespace base64
+{
+/** encoded length of n bytes, padding included */
+constexpr size_t encoded_size(size_t n)
+{
+    return (n + 2) / 3 * 4;
+}
+
+/** append the padded encoding of in to out */
+void encode_append(std::string_view in, std::string& out);
+std::string encode(std::string_view in);
+
+/**
+ * append the decoding of in to out, stopping at the first character outside the alphabet ('=' padding included).
+ * returns how many characters of in were consumed.
+ */
+size_t decode_append(std::string_view in, std::string& out);
+std::string decode(std::string_view in);
+
+/** name of the implementation selected for this cpu: "avx2", "ssse3", "neon" or "scalar" */
+const char* backend();
+
+/** implementations this cpu can run, best first, and a way to force one (for tests and benchmarks) */
+std::vector<std::string_view> available_backends();
+bool select_backend(std::string_view name);
+} // namespace base64
@@ -29,11 +29,16 @@
  */
 
 #pragma once
+#include "millennium/cdp_frame.h"
 #include "millennium/thread_pool.h"
 #include "millennium/types.h"
 #include <nlohmann/json.hpp>
+#include <array>
 #include <functional>
+#include <optional>
+#include <queue>
 #include <unordered_map>
+#include <variant>
 #include <shared_mutex>
 #include <future>
 #include <atomic>
@@ -58,6 +63,19 @@ class cdp_client : public std::enable_shared_from_this<cdp_client>
     using event_callback = std::function<void(const json&)>;
     using error_callback = std::function<void(const std::string&, const std::exception&)>;
 
+    /** a single command for send_batch()/send_chain() */
+    struct command
+    {
+        std::string method;
+        json params = json::object();
+    };
+
+    /** builds the next command of a chain from the previous command's result */
+    using chain_step = std::function<command(const json& previous_result)>;
+
+    /** completion for send_host_async(), exactly one of result/error is meaningful */
+    using response_callback = std::function<void(json result, std::exception_ptr error)>;
+
     explicit cdp_client(send_fn sender);
     ~cdp_client();
 
@@ -79,6 +97,27 @@ class cdp_client : public std::enable_shared_from_this<cdp_client>
     std::future<json> send_host(const std::string& method, const json& params = json::object(), std::optional<std::string> sessionId = std::nullopt,
                                 std::chrono::milliseconds timeout = std::chrono::seconds(30));
 
+    /**
+     * like send_host(), but hands the response to on_response instead of a future, so nothing has to block on it.
+     * on_response runs on the message worker (or inline if the client is shut down), keep it cheap.
+     */
+    void send_host_async(const std::string& method, const json& params, std::optional<std::string> sessionId, response_callback on_response,
+                         std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+    /**
+     * send several commands to the shared js context in a single transport write.
+     * chromium handles commands in order, so later commands see the side effects of earlier ones.
+     * the future resolves to every result in request order, or fails with the first error.
+     */
+    std::future<std::vector<json>> send_batch(const std::vector<command>& commands, std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+    /**
+     * send a sequence of dependent commands to the shared js context without blocking a thread per hop.
+     * each step is built from the previous result as soon as it arrives (on the message worker, so keep steps cheap).
+     * the future resolves to every result in order, or fails with the first error.
+     */
+    std::future<std::vector<json>> send_chain(command first, std::vector<chain_step> steps, std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
     /**
      * subscribe to cdp events by method name.
      * callbacks run on a thread pool, so they won't block message processing.
@@ -100,10 +139,11 @@ class cdp_client : public std::enable_shared_from_this<cdp_client>
     void set_error_handler(error_callback handler);
 
     /**
-     * called by websocket layer when messages arrive.
+     * called by the pipe transport when a complete frame arrives.
+     * the frame is queued as-is (no copy of the payload).
      * blocks if the incoming queue is full (backpressure).
      */
-    void handle_message(const std::string& payload);
+    void handle_message(cdp_frame frame);
 
     /** gracefully shut down all threads and fail pending requests */
     void shutdown();
@@ -144,22 +184,51 @@ class cdp_client : public std::enable_shared_from_this<cdp_client>
     std::condition_variable m_session_cv;
     std::string m_shared_js_session_id;
 
-    /** tracks a cdp command we sent and are waiting for a response to */
+    /** completion hook used by async sends, batches and chains instead of a per-request future */
+    using settle_callback = response_callback;
+
+    /**
+     * tracks a cdp command we sent and are waiting for a response to.
+     * whoever removes it from its shard owns it, so it can only ever be completed once.
+     */
     struct async_request
     {
-        std::promise<json> promise;
-        std::chrono::steady_clock::time_point timestamp;
-        std::chrono::milliseconds timeout;
-        std::atomic<bool> completed{ false }; // prevents double-completing promises
+        std::variant<std::promise<json>, settle_callback> target;
+        std::chrono::steady_clock::time_point deadline;
+
+        void resolve(json result);
+        void reject(std::exception_ptr error);
     };
 
     send_fn m_sender;
     std::atomic<int> m_next_id{ 1 }; // cdp message ids increment per request
     std::atomic<bool> m_shutdown{ false };
 
-    /** pending requests waiting for responses */
-    std::mutex m_requests_mutex;
-    std::unordered_map<int, std::shared_ptr<async_request>> m_pending_requests;
+    /** pending requests waiting for responses, sharded by id so concurrent senders and the reader rarely share a lock */
+    struct request_shard
+    {
+        std::mutex mutex;
+        std::unordered_map<int, async_request> requests;
+    };
+    static constexpr size_t m_request_shard_count = 16;
+    std::array<request_shard, m_request_shard_count> m_request_shards;
+
+    request_shard& shard_for(int id)
+    {
+        return m_request_shards[static_cast<unsigned>(id) % m_request_shard_count];
+    }
+
+    /** request deadlines, earliest first. entries whose request already settled are skipped when they expire */
+    struct request_deadline
+    {
+        std::chrono::steady_clock::time_point deadline;
+        int id;
+
+        bool operator>(const request_deadline& other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
 
     /** event subscriptions (e.g., "Page.frameNavigated"). multiple listeners per event */
     struct event_listener
@@ -180,13 +249,14 @@ class cdp_client : public std::enable_shared_from_this<cdp_client>
     /** prevents concurrent sends on the transport */
     std::mutex m_send_mutex;
 
-    /** background thread that times out stale requests */
+    /** background thread that times out stale requests, sleeping until the nearest deadline */
     std::mutex m_cleanup_mutex;
     std::condition_variable m_cleanup_cv;
+    std::priority_queue<request_deadline, std::vector<request_deadline>, std::greater<>> m_deadlines;
     std::thread m_cleanup_thread;
 
     /** incoming message queue with backpressure to prevent dropping messages */
-    std::deque<std::string> m_incoming_queue;
+    std::deque<cdp_frame> m_incoming_queue;
     std::mutex m_incoming_mutex;
     std::condition_variable m_incoming_cv;       // wakes worker when messages arrive
     std::condition_variable m_incoming_space_cv; // wakes handle_message() when space opens up
@@ -196,13 +266,33 @@ class cdp_client : public std::enable_shared_from_this<cdp_client>
     /** thread pool for running event callbacks without blocking message processing */
     std::shared_ptr<thread_pool> m_callback_pool;
 
-    /** runs in m_cleanup_thread, periodically times out old requests */
+    /**
+     * serialize a command under a fresh id and register its request.
+     * returns an empty payload if the client is shut down (the request is rejected straight away).
+     */
+    std::string prepare_request(const std::string& method, const json& params, const std::optional<std::string>& sessionId, async_request request, int& id);
+
+    /** write one or more prepared payloads in a single transport write, failing their requests if it doesn't go through */
+    void write_requests(const std::string& payload, const std::vector<int>& ids);
+
+    struct chain_state;
+    void advance_chain(std::shared_ptr<chain_state> chain, command next);
+
+    /** runs in m_cleanup_thread, times out requests as their deadlines pass */
     void cleanup_loop();
-    void cleanup_stale_requests();
+    void cleanup_stale_requests(const std::vector<int>& expired);
 
     /** safely invoke the error handler if set */
     void invoke_error_handler(const std::string& context, const std::exception& e);
 
     /** parse and dispatch incoming cdp messages (runs in m_incoming_worker) */
-    void process_message(const std::string& payload);
+    void process_message(std::string_view payload);
+    void process_message_slow(std::string_view payload);
+
+    /** remove and return the pending request for a response id, if any */
+    std::optional<async_request> take_pending_request(int id);
+    void settle_request(async_request& pending, json response);
+
+    std::vector<std::shared_ptr<event_callback>> get_event_listeners(const std::string& method);
+    void dispatch_event(const std::vector<std::shared_ptr<event_callback>>& callbacks, json params);
 };
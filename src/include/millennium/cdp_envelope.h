@@ -0,0 +1,59 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#include <optional>
+#include <string_view>
+
+/**
+ * top-level fields of a cdp message, located without building a json dom.
+ *
+ * method/session_id are the unquoted string contents, params/result/error are the raw
+ * json text of those members. everything is a view into the scanned payload, so
+ * nothing here outlives the frame it came from.
+ */
+struct cdp_envelope
+{
+    std::optional<int> id;
+    std::string_view method;
+    std::string_view session_id;
+    std::string_view params;
+    std::string_view result;
+    std::string_view error;
+};
+
+/**
+ * pre-scan a cdp message, only looking at top-level keys and skipping over nested values.
+ *
+ * this does not validate nested json; whatever gets materialized later goes through json::parse.
+ * returns false when the payload isn't a well-formed object at the top level, or when method/sessionId
+ * contain escape sequences, in which case the caller should fall back to a full parse.
+ */
+bool cdp_scan_envelope(std::string_view payload, cdp_envelope& out);
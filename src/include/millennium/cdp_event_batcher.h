@@ -0,0 +1,120 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#include "millennium/types.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * coalesces cdp events bound for plugin frontends.
+ *
+ * every subscribed event used to become its own Runtime.evaluate per plugin, which turns chatty domains
+ * (Network.dataReceived, Page.screencastFrame, ...) into an evaluate storm. here each event is serialized once
+ * and queued for every execution context that wants it. a context's queue goes out as a single evaluate one
+ * frame window after its first event, and never while the previous evaluate to that context is still pending.
+ * contexts that fall behind lose their oldest events first.
+ */
+class cdp_event_batcher
+{
+  public:
+    struct target
+    {
+        int ctx_id;
+        std::string session_id;
+    };
+
+    /** deliver one batch expression to a context. the returned future settles once the page has evaluated it */
+    using send_fn = std::function<std::future<json>(const target& dest, const std::string& expression)>;
+    /** told how many events a context lost since its last flush */
+    using overflow_fn = std::function<void(const target& dest, size_t dropped)>;
+
+    struct options
+    {
+        std::chrono::milliseconds window{ 16 };
+        size_t max_queued_events = 512;
+        size_t max_queued_bytes = 8u * 1024u * 1024u;
+        overflow_fn on_overflow;
+    };
+
+    explicit cdp_event_batcher(send_fn sender, options opts);
+    explicit cdp_event_batcher(send_fn sender) : cdp_event_batcher(std::move(sender), options{}) {}
+    ~cdp_event_batcher();
+
+    cdp_event_batcher(const cdp_event_batcher&) = delete;
+    cdp_event_batcher& operator=(const cdp_event_batcher&) = delete;
+
+    /** queue an event for each target. targets sharing a context should be deduplicated by the caller */
+    void push(std::string_view method, const json& params, const std::vector<target>& targets);
+
+    /** drop everything queued for a context that no longer exists */
+    void forget(int ctx_id);
+
+    /** events dropped so far because a context couldn't keep up */
+    size_t dropped() const;
+
+    /** the expression that delivers a batch through the sdk's per-event hook, in order */
+    static std::string build_expression(const std::vector<std::shared_ptr<const std::string>>& events);
+
+  private:
+    struct context_queue
+    {
+        target dest;
+        std::deque<std::shared_ptr<const std::string>> events;
+        size_t bytes = 0;
+        size_t dropped = 0;
+        std::chrono::steady_clock::time_point first_queued;
+        std::future<json> in_flight;
+    };
+
+    send_fn m_sender;
+    options m_options;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<std::pair<std::string, int>, context_queue> m_queues; // { session, ctx } -> pending events
+    size_t m_dropped = 0;
+    bool m_stop = false;
+    std::thread m_worker;
+
+    void run();
+};
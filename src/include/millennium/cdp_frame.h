@@ -0,0 +1,88 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+/**
+ * a single NUL-delimited cdp message.
+ *
+ * the payload is a view into a refcounted slab owned by the pipe reader, so a frame
+ * can be queued and handed to another thread without copying the message body.
+ */
+struct cdp_frame
+{
+    std::shared_ptr<const char[]> slab;
+    std::string_view data;
+};
+
+/**
+ * framing layer for the cdp pipe transport.
+ *
+ * the transport reads straight into prepare(), then drains complete frames with next_frame().
+ * delimiters are found with memchr (vectorized by every libc we ship against) and the scan
+ * resumes where it left off, so a multi-megabyte message arriving in small reads is only
+ * scanned once. frames alias the slab they were read into; when a slab is still referenced
+ * by queued frames, only the trailing partial message is copied into a fresh slab.
+ */
+class cdp_frame_reader
+{
+  public:
+    static constexpr size_t default_slab_size = 64 * 1024;
+    static constexpr size_t min_read_size = 16 * 1024;
+
+    explicit cdp_frame_reader(size_t slab_size = default_slab_size);
+
+    /** get a writable region of at least min_free bytes at the tail of the buffer */
+    std::span<char> prepare(size_t min_free = min_read_size);
+
+    /** mark n bytes of the region returned by prepare() as filled */
+    void commit(size_t n);
+
+    /** pop the next complete frame. returns false when only a partial message is buffered */
+    bool next_frame(cdp_frame& out);
+
+    /** bytes buffered that don't yet form a complete frame */
+    size_t pending() const
+    {
+        return m_tail - m_head;
+    }
+
+  private:
+    size_t m_slab_size;
+    std::shared_ptr<char[]> m_slab;
+    size_t m_capacity = 0;
+    size_t m_head = 0; /** start of the first unconsumed byte */
+    size_t m_scan = 0; /** bytes before this offset are known to contain no delimiter */
+    size_t m_tail = 0; /** end of committed data */
+};
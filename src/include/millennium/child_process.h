@@ -36,12 +36,16 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -49,17 +53,26 @@
 #include <sys/types.h>
 #endif
 
+class thread_pool;
+
 /**
  * wraps/interfaces a child process running a plugin's Lua backend.
  *
  * Each plugin gets its own OS process talking over a unix socket (on windows too as unix sockets are support in w10+).
  * A reader thread demuxes incoming frames: responses get matched to their pending call(), requests
- * from the child (like "call_frontend_method") get dispatched to the handler.
+ * from the child (like "call_frontend_method") get queued for the plugin's request workers.
  * Writes are mutex-protected so any thread can safely send to the child.
+ *
+ * Child requests are answered out of order by id, so one slow http_request can't hold up the
+ * responses to other requests or to our own call()s.
  */
 class PluginProcess
 {
   public:
+    /** child requests handled at once per plugin, and how many more may wait before new ones are refused */
+    static constexpr size_t MAX_INFLIGHT_REQUESTS = 4;
+    static constexpr size_t MAX_QUEUED_REQUESTS = 256;
+
     using request_handler = std::function<nlohmann::json(const std::string& plugin_name, const std::string& method, const nlohmann::json& params)>;
 
 #ifdef _WIN32
@@ -68,10 +81,12 @@ class PluginProcess
     using pid_type = pid_t;
 #endif
 
-    PluginProcess(const std::string& plugin_name, const std::string& socket_path, plugin_ipc::socket_fd client_fd, pid_type pid, request_handler handler = nullptr);
+    PluginProcess(const std::string& plugin_name, plugin_ipc::socket_fd client_fd, pid_type pid, request_handler handler = nullptr);
     ~PluginProcess();
 
     nlohmann::json call(const std::string& method, const nlohmann::json& params = nullptr, std::chrono::milliseconds timeout = std::chrono::seconds(30));
+    /** same as call(), for params that are already msgpack encoded (see ffi_fast_path) */
+    nlohmann::json call_packed(std::string_view method, const std::vector<uint8_t>& packed_params, std::chrono::milliseconds timeout = std::chrono::seconds(30));
     void notify_child(const std::string& method, const nlohmann::json& params = nullptr);
     void set_request_handler(request_handler handler);
     void shutdown();
@@ -85,11 +100,23 @@ class PluginProcess
         return m_plugin_name;
     }
 
+    struct request_queue_metrics
+    {
+        size_t in_flight = 0;
+        size_t queued = 0;
+        size_t peak_queued = 0;
+        uint64_t completed = 0;
+        uint64_t rejected = 0; // refused because the queue was full
+        size_t max_in_flight = MAX_INFLIGHT_REQUESTS;
+        size_t max_queued = MAX_QUEUED_REQUESTS;
+    };
+
     struct process_metrics
     {
         size_t rss_bytes = 0;
         size_t heap_bytes = 0;
         double cpu_percent = 0.0;
+        request_queue_metrics requests;
     };
 
     process_metrics get_metrics();
@@ -103,9 +130,10 @@ class PluginProcess
     bool send_frame(const nlohmann::json& msg);
 
     void handle_child_notification(const std::string& method, const nlohmann::json& params);
+    void dispatch_child_request(int id, std::string method, nlohmann::json params);
+    void handle_child_request(int id, const std::string& method, const nlohmann::json& params);
 
     std::string m_plugin_name;
-    std::string m_socket_path;
     plugin_ipc::socket_fd m_client_fd;
     pid_type m_pid;
 
@@ -129,6 +157,13 @@ class PluginProcess
     request_handler m_request_handler;
     std::mutex m_handler_mutex;
 
+    std::unique_ptr<thread_pool> m_request_pool;
+    std::atomic<size_t> m_requests_in_flight{ 0 };
+    std::atomic<size_t> m_requests_queued{ 0 };
+    std::atomic<size_t> m_requests_peak_queued{ 0 };
+    std::atomic<uint64_t> m_requests_completed{ 0 };
+    std::atomic<uint64_t> m_requests_rejected{ 0 };
+
     std::string m_crash_dump_dir;
 
     /* cpu tracking state — need two snapshots to compute delta */
@@ -142,6 +177,19 @@ class PluginProcess
 #endif
 };
 
+template <typename json_t> void to_json(json_t& j, const PluginProcess::request_queue_metrics& m)
+{
+    j = {
+        { "in_flight",     m.in_flight     },
+        { "queued",        m.queued        },
+        { "peak_queued",   m.peak_queued   },
+        { "completed",     m.completed     },
+        { "rejected",      m.rejected      },
+        { "max_in_flight", m.max_in_flight },
+        { "max_queued",    m.max_queued    }
+    };
+}
+
 /** Fork off a plugin child process and return a connected PluginProcess, or nullptr if something went wrong. */
 std::unique_ptr<PluginProcess> spawn_plugin_process(const std::string& plugin_name, const std::string& exe_path, const std::string& socket_path, const nlohmann::json& init_params,
                                                     PluginProcess::request_handler handler = nullptr);
@@ -32,9 +32,13 @@
 #include "nlohmann/json.hpp"
 #include "millennium/singleton.h"
 #include "millennium/types.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <initializer_list>
 #include <mutex>
+#include <thread>
 
 class config_manager : public singleton<config_manager>
 {
@@ -46,8 +50,19 @@ class config_manager : public singleton<config_manager>
     void unregister_listener(listener listener);
 
     void load_from_disk();
+
+    /** write the current config now. skipped if nothing changed since the last write */
     void save_to_disk();
 
+    /** write any change still waiting out its save window. called on shutdown */
+    void flush();
+
+    /** changes that were folded into an already scheduled save instead of writing the file again */
+    std::size_t saves_coalesced() const
+    {
+        return _saves_coalesced.load(std::memory_order_relaxed);
+    }
+
     void set_default_config(const std::string& key, const json& value);
 
     json set_all(const json& newConfig, bool skipPropagation = false);
@@ -62,10 +77,29 @@ class config_manager : public singleton<config_manager>
     ~config_manager();
 
   private:
+    /** how long after a change the file is written, so bursts of set() calls cost one write */
+    static constexpr std::chrono::milliseconds SAVE_DELAY{ 500 };
+
     void notify_listeners(const std::string& key, const json& old_value, const json& new_value);
 
+    /** note a change and make sure a save is scheduled. caller holds _mutex */
+    void schedule_save();
+    void save_loop();
+
     std::recursive_mutex _mutex;
     std::mutex _save_mutex;
+    /** bumped on every change under _mutex, and the last one written under _save_mutex */
+    uint64_t _generation = 1;
+    uint64_t _written_generation = 0;
+
+    std::mutex _pending_mutex;
+    std::condition_variable _pending_cv;
+    bool _save_pending = false;
+    bool _stop_saving = false;
+    std::chrono::steady_clock::time_point _save_deadline;
+    std::atomic<std::size_t> _saves_coalesced{ 0 };
+    std::thread _save_thread;
+
     json _data;
     json _defaults;
     std::vector<listener> _listeners;
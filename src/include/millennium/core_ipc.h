@@ -34,6 +34,7 @@
 #include "millennium/cdp_api.h"
 #include "millennium/logger.h"
 #include "millennium/config.h"
+#include "millennium/ffi_fast_path.h"
 #include "millennium/types.h"
 
 #include <variant>
@@ -107,6 +108,12 @@ class ipc_main
     const std::string compile_javascript_expression(std::string plugin, std::string methodName, std::vector<javascript_parameter> fnParams);
     ordered_json process_message(json payload);
 
+    /**
+     * answer a plugin backend call decoded by ffi_fast_path, writing the reply json into response.
+     * returns false without doing anything if the call needs the generic process_message() path.
+     */
+    bool try_call_server_method(const ffi_fast_path::call& call, std::string& response);
+
     std::shared_ptr<cdp_client> get_cdp_client() const
     {
         return m_cdp;
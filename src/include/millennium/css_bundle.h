@@ -0,0 +1,115 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#include "millennium/vfs_cache.h"
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** one stylesheet going into a bundle, path is relative to the bundle root */
+struct css_bundle_source
+{
+    std::string path;
+    std::string css;
+};
+
+/**
+ * concatenate stylesheets into one, keeping their cascade order.
+ *
+ * relative url() and @import references are resolved against each sheet's own location under base_url, so they
+ * still point at the same files once served from elsewhere. @charset rules are dropped, and the first sheet's
+ * @import rules stay at the top. a later sheet's @import rules are left where they are, where the browser ignores
+ * them; hoisting them would put what they import ahead of the sheets before it, so css_bundler::split starts a new
+ * bundle at any such sheet instead.
+ */
+std::string css_concatenate(const std::vector<css_bundle_source>& sources, std::string_view base_url);
+
+/** whether a stylesheet starts with @import rules, which only take effect at the top of a stylesheet */
+bool css_has_import(std::string_view css);
+
+/**
+ * serves sets of theme stylesheets as single virtual stylesheets.
+ *
+ * add() names a bundle after the stylesheets it holds, so a different hook set or condition set gets a different
+ * bundle. find() builds it on first use and keeps the encoded response until one of its files changes on disk.
+ */
+class css_bundler
+{
+  public:
+    using encoder = std::function<std::shared_ptr<const vfs_response>(std::string css)>;
+
+    css_bundler(std::filesystem::path root, std::string base_url, encoder encode);
+
+    /** name of the bundle made of these stylesheets (paths relative to root, in cascade order) */
+    std::string add(const std::vector<std::string>& paths);
+
+    /**
+     * split stylesheets (in cascade order) into runs that can each be bundled. a sheet with @import rules starts a
+     * new run, so its imports stay at the top of a stylesheet and still come after every sheet before it.
+     */
+    std::vector<std::vector<std::string>> split(const std::vector<std::string>& paths);
+
+    /** the response for a bundle, rebuilt if any of its files changed. nullptr for unknown names */
+    std::shared_ptr<const vfs_response> find(const std::string& name);
+
+    void clear();
+
+  private:
+    struct bundle
+    {
+        std::string name;
+        std::vector<std::string> paths;
+        std::vector<std::optional<vfs_file_stamp>> stamps;
+        std::shared_ptr<const vfs_response> response;
+    };
+
+    /** bundles only change with the hook list, past this the least recently used one goes */
+    static constexpr size_t m_bundle_limit = 64;
+
+    const std::filesystem::path m_root;
+    const std::string m_base_url;
+    const encoder m_encode;
+
+    std::mutex m_mutex;
+    std::list<bundle> m_lru; // most recently used first
+    std::unordered_map<std::string, std::list<bundle>::iterator> m_bundles;
+    /** whether each stylesheet starts with @import, as of the stamp it was read at */
+    std::unordered_map<std::string, std::pair<std::optional<vfs_file_stamp>, bool>> m_imports;
+};
@@ -29,106 +29,27 @@
  */
 
 #pragma once
+#include "millennium/base64.h"
 #include <string>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <random>
 
-// https://stackoverflow.com/questions/180947/base64-decode-snippet-in-c
-
-static const std::string base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                                        "abcdefghijklmnopqrstuvwxyz"
-                                        "0123456789+/";
-
-static inline bool is_base64(unsigned char c)
-{
-    return (isalnum(c) || (c == '+') || (c == '/'));
-}
-
+/** thin wrappers kept for existing callers, the simd codec lives in millennium/base64.h */
 inline std::string Base64Decode(const std::string& in)
 {
-    std::string out;
-    std::vector<int> T(256, -1);
-    for (int i = 0; i < 64; i++)
-        T["ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i]] = i;
-
-    int val = 0, valb = -8;
-    for (unsigned char c : in) {
-        if (T[c] == -1) break;
-        val = (val << 6) + T[c];
-        valb += 6;
-        if (valb >= 0) {
-            out.push_back(char((val >> valb) & 0xFF));
-            valb -= 8;
-        }
-    }
-    return out;
+    return base64::decode(in);
 }
 
 inline std::string Base64Encode(const std::vector<char>& data)
 {
-    std::string encoded;
-    size_t i = 0;
-    size_t dataSize = data.size();
-    unsigned char char_array_3[3];
-    unsigned char char_array_4[4];
-
-    for (size_t j = 0; j < dataSize; j++) {
-        char_array_3[i++] = data[j];
-
-        if (i == 3) {
-            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-            char_array_4[3] = char_array_3[2] & 0x3f;
-
-            for (i = 0; i < 4; i++) {
-                encoded += base64_chars[char_array_4[i]];
-            }
-            i = 0;
-        }
-    }
-
-    if (i) {
-        for (size_t j = i; j < 3; j++) {
-            char_array_3[j] = '\0';
-        }
-
-        char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-        char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-        char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-        char_array_4[3] = char_array_3[2] & 0x3f;
-
-        for (size_t j = 0; j < i + 1; j++) {
-            encoded += base64_chars[char_array_4[j]];
-        }
-
-        while (i++ < 3) {
-            encoded += '=';
-        }
-    }
-
-    return encoded;
+    return base64::encode(std::string_view(data.data(), data.size()));
 }
 
 inline std::string Base64Encode(const std::string& in)
 {
-    std::string out;
-
-    int val = 0, valb = -6;
-    for (unsigned char c : in) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            out.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
-    }
-    if (valb > -6) out.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[((val << 8) >> (valb + 8)) & 0x3F]);
-    while (out.size() % 4)
-        out.push_back('=');
-    return out;
+    return base64::encode(in);
 }
 
 inline std::string GenerateUUID()
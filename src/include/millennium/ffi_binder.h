@@ -31,6 +31,9 @@
 #pragma once
 #include "millennium/core_ipc.h"
 #include "millennium/cdp_api.h"
+#include "millennium/cdp_event_batcher.h"
+#include "millennium/thread_pool.h"
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
@@ -108,12 +111,24 @@ class ffi_binder : public std::enable_shared_from_this<ffi_binder>
     std::vector<int> m_internal_tokens;                                            // tokens for our own internal listeners
     std::mutex m_ctx_mutex;
 
+    /** coalesces subscribed cdp events into one evaluate per context per frame */
+    std::unique_ptr<cdp_event_batcher> m_event_batcher;
+
+    /** runs frontend -> backend plugin calls, separate from the cdp client's event pool so slow plugins can't stall it */
+    static constexpr size_t FFI_POOL_THREADS = 4;
+    static constexpr size_t FFI_POOL_MAX_QUEUED = 256;
+    std::unique_ptr<thread_pool> m_ffi_pool;
+    std::atomic<bool> m_stopping{ false };
+
     void callback_into_js(const json params, const int request_id, ordered_json result);
+    /** same as callback_into_js(), with the result already serialized */
+    void callback_into_js_raw(const json& params, const int request_id, std::string_view result_json);
 
     /**
      * event handlers for Runtime.bindingCalled events
      */
     void binding_call_hdlr(const json& params);
+    void ffi_call_hdlr(const json& params);
     void extension_route_hdlr(const json& params);
     void cdp_proxy_hdlr(const json& params);
     void sdk_ready_hdlr(const json& params);
@@ -123,7 +138,7 @@ class ffi_binder : public std::enable_shared_from_this<ffi_binder>
 
     void cdp_proxy_call(const std::string& plugin_name, int callback_id, const std::string& method, const json& params, const std::string& session_id, int main_ctx_id,
                         const std::optional<std::string>& target_session);
-    void cdp_proxy_relay(const std::string& plugin_name, int callback_id, const json& result, bool is_error, const std::string& session_id);
+    void cdp_proxy_relay(const std::string& plugin_name, int callback_id, const json& result, bool is_error, const std::string& session_id, int main_ctx_id);
     void cdp_event_dispatch(const std::string& method, const json& params);
 
     bool is_valid_request(const json& params);
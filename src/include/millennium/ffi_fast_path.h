@@ -0,0 +1,90 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+/**
+ * typed fast path for frontend -> backend plugin calls.
+ *
+ * nearly every call the sdk makes is a flat `callServerMethod` with a handful of scalar arguments, but the
+ * generic path parses the binding payload into a json dom, copies it into a request document, re-encodes it
+ * to msgpack for the child and builds another dom for the reply before dumping it.
+ *
+ * this decodes the payload with a sax handler straight into a reusable typed struct, packs the child's params
+ * from it directly, and writes the reply text without an intermediate document. anything outside the common
+ * shape (nested arguments, core calls, unknown fields) is rejected by parse() and takes the generic path.
+ */
+namespace ffi_fast_path
+{
+using scalar = std::variant<std::monostate, bool, int64_t, uint64_t, double, std::string>;
+
+struct call
+{
+    int ipc_id = -1;
+    int call_id = -1;
+    std::string caller;
+    std::string plugin;
+    std::string method;
+
+    /** argumentList is optional, and either an object (named) or an array (positional) of scalars */
+    bool has_arguments = false;
+    bool named_arguments = false;
+    std::vector<std::string> arg_names;
+    std::vector<scalar> args;
+
+    /** reset for reuse, keeping the buffers' capacity */
+    void clear();
+};
+
+/**
+ * decode a binding payload ({ id, call_id, caller, data: { pluginName, methodName, argumentList } }) into out.
+ * returns false if the payload doesn't fit the fast path, in which case out is unspecified.
+ */
+bool parse(std::string_view payload, call& out);
+
+/** msgpack encode the evaluate params for the child, equivalent to to_msgpack() of the payload's data object */
+void pack_evaluate_params(const call& c, std::vector<uint8_t>& out);
+
+/** the payload's data object as json text, equivalent to data.dump() (used for the ffi recorder) */
+void write_arguments_json(const call& c, std::string& out);
+
+/**
+ * write the frontend reply for a child's evaluate result, equivalent to what ipc_main::call_server_method()
+ * returns for it, dumped.
+ */
+void write_response(std::string& out, std::string_view plugin, const nlohmann::json& child_result);
+} // namespace ffi_fast_path
@@ -0,0 +1,60 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+
+/** offset of the first "</head>" in an html document, or npos if there isn't one */
+size_t html_find_head_close(std::string_view html);
+
+/** copy of html with content spliced in front of </head>, or nullopt if the document has no </head> */
+std::optional<std::string> html_inject_head(std::string_view html, std::string_view content);
+
+/** why html_inject_head_base64() left a document alone */
+enum class html_inject_failure
+{
+    no_head,
+    bad_encoding,
+};
+
+/**
+ * same as html_inject_head(), but for a base64 encoded document (as returned by Fetch.getResponseBody),
+ * producing the patched document base64 encoded again.
+ *
+ * only the prefix up to </head> is decoded, and only the injected bytes (plus at most a few original bytes
+ * around the splice point) are encoded. everything else is copied through in its original encoding,
+ * so a large store page is never held decoded in full or pushed through the encoder a second time.
+ * content may be padded with trailing newlines to keep the copied encoding aligned.
+ *
+ * returns nullopt if the input isn't canonical base64 or the document has no </head>, and says which in failure.
+ */
+std::optional<std::string> html_inject_head_base64(std::string_view encoded, std::string_view content, html_inject_failure* failure = nullptr);
@@ -37,14 +37,6 @@
 
 #define MILLENNIUM_USERAGENT "Millennium/" MILLENNIUM_VERSION
 
-struct DownloadData
-{
-    FILE* fp;
-    size_t downloaded;
-    std::function<void(size_t, size_t)> progressCallback;
-    size_t totalSize;
-};
-
 class HttpError : public std::runtime_error
 {
   public:
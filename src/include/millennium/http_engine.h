@@ -0,0 +1,153 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * process-wide http client built on one curl multi handle.
+ *
+ * every transfer runs on a single event loop thread, so connections, dns lookups and tls sessions are cached
+ * once and reused by everyone: a plugin polling an api keeps its keep-alive (or http/2) connection instead of
+ * paying for a new tcp and tls handshake per call. connections per host are capped so a burst of requests
+ * queues on the engine instead of opening a socket each.
+ */
+class http_engine
+{
+  public:
+    struct limits
+    {
+        long max_host_connections = 6;
+        long max_total_connections = 32;
+        long max_cached_connections = 32;
+    };
+
+    struct request
+    {
+        std::string url;
+        std::string method = "GET"; // GET, POST, PUT, PATCH, DELETE, OPTIONS or HEAD
+        std::string body;
+        std::vector<std::string> headers; // "Name: value"
+        std::string user_agent;
+        std::string userpwd;          // basic auth, "user:pass"
+        std::string proxy;
+        std::string proxy_userpwd;
+        long timeout_seconds = 30;    // 0 for none
+        bool follow_redirects = true;
+        bool verify_ssl = true;
+
+        /** fail the transfer once the buffered body grows past this many bytes, 0 for no limit */
+        std::size_t max_body_bytes = 0;
+
+        /**
+         * stream the body here instead of buffering it in the response. returns false to abort the transfer.
+         * runs on the engine thread, like progress.
+         */
+        std::function<bool(const char* data, std::size_t size)> sink;
+        std::function<void(std::size_t received, std::size_t total)> progress;
+    };
+
+    struct response
+    {
+        CURLcode result = CURLE_OK;
+        long status = 0;
+        std::string body;
+        nlohmann::json headers = nlohmann::json::object(); // last value wins for repeated names
+        std::size_t received = 0;                          // body bytes, including those handed to a sink
+        std::size_t content_length = 0;                    // as announced by the server, 0 if unknown
+        bool body_exceeded = false;                        // hit request::max_body_bytes
+
+        bool ok() const
+        {
+            return result == CURLE_OK && !body_exceeded;
+        }
+
+        /** what went wrong, for ok() == false */
+        std::string error() const;
+    };
+
+    using completion = std::function<void(response)>;
+
+    /** the engine plugin requests and updater traffic share. created on first use and never destroyed */
+    static http_engine& instance();
+
+    http_engine();
+    explicit http_engine(limits limits);
+    ~http_engine();
+
+    http_engine(const http_engine&) = delete;
+    http_engine& operator=(const http_engine&) = delete;
+
+    /** queue a transfer. on_done runs on the engine thread, keep it cheap */
+    void submit(request req, completion on_done);
+
+    /** queue a transfer and get its response through a future */
+    std::future<response> submit(request req);
+
+    /** run a transfer and wait for it. never call this from a completion, it would wait on its own thread */
+    response perform(request req);
+
+    /** abort everything in flight (completing it with CURLE_ABORTED_BY_CALLBACK) and stop the event loop */
+    void shutdown();
+
+  private:
+    struct transfer;
+
+    void event_loop();
+    /** configure and add a transfer to the multi handle. on failure it's completed (and freed) right away */
+    bool start_transfer(transfer* t);
+    void finish_transfer(transfer* t, CURLcode result);
+
+    static size_t on_body(char* data, size_t size, size_t count, void* userdata);
+    static size_t on_header(char* data, size_t size, size_t count, void* userdata);
+
+    CURLM* m_multi = nullptr;
+    CURLSH* m_share = nullptr;
+
+    std::mutex m_queue_mutex;
+    std::deque<transfer*> m_queue;
+    bool m_stopped = false;
+
+    std::atomic<bool> m_stop{ false };
+    std::thread m_thread;
+};
@@ -32,8 +32,10 @@
 
 #include "millennium/fwd_decl.h"
 #include "millennium/cdp_api.h"
+#include "millennium/css_bundle.h"
 #include "millennium/plugin_manager.h"
 #include "millennium/thread_pool.h"
+#include "millennium/vfs_cache.h"
 
 #include <atomic>
 #include <filesystem>
@@ -41,6 +43,7 @@
 #include <utility>
 #include <format>
 #include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <regex>
 #include <shared_mutex>
@@ -76,8 +79,11 @@ class network_hook_ctl
     struct hook_t
     {
         std::string path;
-        std::regex url_pattern;
+        /** compiled once and shared by every hook list snapshot the hook ends up in */
+        std::shared_ptr<const std::regex> url_pattern;
         TagTypes type;
+        /** source text of url_pattern. hooks with the same source share one regex evaluation per url */
+        std::string pattern_source = {};
     };
 
     struct hook_item
@@ -86,13 +92,55 @@ class network_hook_ctl
         unsigned long long id;
     };
 
+    /**
+     * immutable snapshot of the hook list, rebuilt on add_hook()/remove_hook().
+     *
+     * hooks are grouped by pattern so each distinct regex runs once per url, and the matching
+     * hook indices are cached per url, so navigating back to the same steam pages skips regex
+     * matching entirely. a new snapshot starts with an empty cache, so results never go stale.
+     */
+    class hook_matcher
+    {
+      public:
+        explicit hook_matcher(std::vector<hook_item> hooks = {});
+
+        /** indices into hooks() of every hook whose pattern fully matches url, in hook order */
+        std::shared_ptr<const std::vector<size_t>> match(const std::string& url) const;
+        bool any_match(const std::string& url) const;
+
+        const std::vector<hook_item>& hooks() const
+        {
+            return m_hooks;
+        }
+
+      private:
+        struct pattern_group
+        {
+            const std::regex* pattern;
+            std::vector<size_t> members;
+        };
+
+        std::vector<hook_item> m_hooks;
+        std::vector<pattern_group> m_groups;
+
+        static constexpr size_t m_cache_limit = 256;
+        mutable std::mutex m_cache_mutex;
+        mutable std::unordered_map<std::string, std::shared_ptr<const std::vector<size_t>>> m_cache;
+    };
+
     void init();
     unsigned long long add_hook(const hook_t& hook);
     bool remove_hook(unsigned long long hookId);
-    std::vector<hook_item> get_hook_list() const;
+    std::shared_ptr<const hook_matcher> get_hook_matcher() const;
 
     void set_dynamic_css_provider(std::function<std::pair<std::string, std::string>()> provider);
 
+    /**
+     * serve every stylesheet hook matching a document as one compiled bundle instead of one <link> each,
+     * so the document costs a single Fetch.requestPaused round trip for its theme css.
+     */
+    void set_stylesheet_bundling(bool enabled);
+
     void register_virtual_resource(const std::string& url, std::function<std::string()> producer);
     void unregister_virtual_resource(const std::string& url);
 
@@ -150,13 +198,21 @@ class network_hook_ctl
     mutable std::shared_mutex m_virtual_res_mtx;
     std::unordered_map<std::string, std::function<std::string()>> m_virtual_resources;
 
+    /** encoded responses for virtual fetches, keyed by url (in-memory resources) or local path (disk files) */
+    vfs_response_cache m_vfs_cache;
+
+    std::atomic<bool> m_bundle_stylesheets{ false };
+    std::unique_ptr<css_bundler> m_css_bundler;
+
     std::atomic<bool> m_shutdown{ false };
     mutable std::shared_mutex m_hook_list_mtx;
     std::unique_ptr<thread_pool> m_thread_pool;
-    std::shared_ptr<std::vector<hook_item>> m_hook_list_ptr;
+    std::shared_ptr<const hook_matcher> m_hook_matcher;
 
     const char* m_ftp_url = "https://millennium.ftp/";
     const char* m_themes_url = "https://millennium.host/v1/themes/";
+    /** compiled stylesheet bundles live under the themes url, as <prefix><name>.css */
+    const char* m_bundle_prefix = "~bundle/";
 
     /** Maintain backwards compatibility for themes that explicitly rely on this url */
     const char* m_legacy_hook_url = "https://pseudo.millennium.app/";
@@ -171,5 +227,4 @@ class network_hook_ctl
     void mime_doc_request_handler(const nlohmann::basic_json<>& message);
     std::filesystem::path path_from_url(const std::string& requestUrl);
     processed_hooks apply_user_webkit_hooks(const target_url& target) const;
-    std::string inject_into_document_head(const std::string& original, const std::string& content) const;
 };
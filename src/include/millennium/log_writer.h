@@ -0,0 +1,163 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * asynchronous output for the loggers.
+ *
+ * producers push finished lines onto a lock-free multi-producer queue and return; a single writer thread drains it,
+ * concatenates everything bound for the same sink and hands each sink one write (and one flush) per batch.
+ * so a chatty plugin costs its caller a string move instead of a console write and an fsync-ish flush per line.
+ *
+ * the queue is bounded: past MAX_QUEUED lines, new ones are dropped and counted until the writer catches up,
+ * which then notes on stdout how many went missing.
+ */
+class log_writer
+{
+  public:
+    using sink_id = uint32_t;
+
+    /** the process' stdout, always open */
+    static constexpr sink_id STDOUT_SINK = 0;
+    static constexpr std::size_t MAX_QUEUED = 16384;
+
+    /** created on first use and never destroyed, so logging stays safe during static destruction */
+    static log_writer& instance();
+
+    log_writer(const log_writer&) = delete;
+    log_writer& operator=(const log_writer&) = delete;
+
+    /** open a file sink for appending. the writer opens it before it handles any line written to it */
+    sink_id open_file(const std::string& path);
+
+    /** close a file sink after everything already queued for it has been written */
+    void close(sink_id sink);
+
+    void write(sink_id sink, std::string text);
+
+    /** block until everything queued before this call is written out */
+    void flush();
+
+    /**
+     * flush() for the crash handler: no allocation and no locks on the calling thread, and it gives up after timeout
+     * (the writer thread may be the one that crashed). only the first call does anything. returns whether it finished.
+     */
+    bool flush_for_crash(std::chrono::milliseconds timeout);
+
+    /** drain the queue, stop the writer thread and write synchronously from then on */
+    void shutdown();
+
+    std::size_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    log_writer();
+    ~log_writer() = default;
+
+    enum class record_kind : uint8_t
+    {
+        line,
+        open,
+        close,
+        flush,
+    };
+
+    struct record
+    {
+        std::atomic<record*> next{ nullptr };
+        record_kind kind = record_kind::line;
+        sink_id sink = STDOUT_SINK;
+        std::string text; // line, or path for open
+        std::atomic<bool>* done = nullptr; // flush
+    };
+
+    struct sink_state
+    {
+        std::FILE* file = nullptr;
+        std::string pending;
+    };
+
+    /** intrusive mpsc queue (vyukov). m_head is shared by producers, m_tail belongs to the consumer */
+    void push(record* r);
+    record* pop();
+
+    void writer_loop();
+
+    /** drain on the calling thread, once the writer thread is gone */
+    void drain_synchronously();
+
+    /** apply one record to the sinks, buffering lines. caller is the only consumer */
+    void consume(record* r);
+    void write_pending();
+    /** once the queue is drained, note any lines dropped since the last note on stdout */
+    void report_dropped();
+
+    std::atomic<record*> m_head;
+    record* m_tail;
+    record m_stub;
+
+    /** preallocated flush record for flush_for_crash(), never deleted */
+    record m_crash_flush;
+    std::atomic<bool> m_crash_flush_used{ false };
+    std::atomic<bool> m_crash_flushed{ false };
+
+    std::atomic<std::size_t> m_queued{ 0 };
+    std::atomic<std::size_t> m_dropped{ 0 };
+    std::atomic<sink_id> m_next_sink{ STDOUT_SINK + 1 };
+
+    /** consumer side: sinks by id, only touched by whoever is draining */
+    std::unordered_map<sink_id, sink_state> m_sinks;
+    std::size_t m_reported_dropped = 0;
+
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake_cv;
+    std::condition_variable m_flushed_cv;
+    std::atomic<bool> m_sleeping{ false };
+    bool m_stop = false;
+
+    /** after shutdown() producers drain the queue themselves, one at a time */
+    std::atomic<bool> m_synchronous{ false };
+    std::mutex m_sync_mutex;
+    std::thread m_thread;
+};
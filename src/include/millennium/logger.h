@@ -30,11 +30,13 @@
 
 #pragma once
 
+#include "millennium/log_writer.h"
 #include "millennium/singleton.h"
 
 #include <array>
 #include <atomic>
 #include <ctime>
+#include <deque>
 #include <format>
 #include <functional>
 #include <fstream>
@@ -104,9 +106,18 @@ class logger_base
         int line{ 0 };
     };
 
+    /** entries a logger keeps in memory for collect_logs(). MILLENNIUM_LOG_BUFFER_SIZE overrides it */
+    static constexpr std::size_t DEFAULT_BUFFER_CAPACITY = 2000;
+
   protected:
     std::mutex log_mutex;
-    std::vector<log_entry> logBuffer;
+    std::deque<log_entry> logBuffer;
+    std::size_t m_buffer_capacity;
+
+    logger_base();
+
+    /** keep an entry in logBuffer, dropping the oldest once it's full */
+    void buffer_entry(const log_entry& entry);
 
     std::string get_local_time(bool withHours = false);
     std::string get_local_date_str();
@@ -118,7 +129,7 @@ class logger_base
 class plugin_logger : public logger_base
 {
   private:
-    std::ofstream file;
+    log_writer::sink_id m_sink;
     std::string filename;
     std::string pluginName;
 
@@ -0,0 +1,169 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+/**
+ * append-only msgpack encoder for hot paths that already know their shape.
+ *
+ * nlohmann::json::to_msgpack needs a json document to walk; these write straight into a byte buffer so a
+ * message can be packed from typed values (or spliced together from already packed parts) with no dom at all.
+ * the encodings picked match nlohmann's to_msgpack byte for byte, so either side can be swapped for the other.
+ */
+namespace msgpack_writer
+{
+namespace detail
+{
+template <typename T> inline void put_be(std::vector<uint8_t>& out, T value)
+{
+    for (int shift = static_cast<int>(sizeof(T) * 8) - 8; shift >= 0; shift -= 8)
+        out.push_back(static_cast<uint8_t>((static_cast<uint64_t>(value) >> shift) & 0xFF));
+}
+} // namespace detail
+
+inline void write_nil(std::vector<uint8_t>& out)
+{
+    out.push_back(0xc0);
+}
+
+inline void write_bool(std::vector<uint8_t>& out, bool value)
+{
+    out.push_back(value ? 0xc3 : 0xc2);
+}
+
+inline void write_uint(std::vector<uint8_t>& out, uint64_t value)
+{
+    if (value < 0x80) {
+        out.push_back(static_cast<uint8_t>(value));
+    } else if (value <= UINT8_MAX) {
+        out.push_back(0xcc);
+        out.push_back(static_cast<uint8_t>(value));
+    } else if (value <= UINT16_MAX) {
+        out.push_back(0xcd);
+        detail::put_be(out, static_cast<uint16_t>(value));
+    } else if (value <= UINT32_MAX) {
+        out.push_back(0xce);
+        detail::put_be(out, static_cast<uint32_t>(value));
+    } else {
+        out.push_back(0xcf);
+        detail::put_be(out, value);
+    }
+}
+
+inline void write_int(std::vector<uint8_t>& out, int64_t value)
+{
+    if (value >= 0) {
+        write_uint(out, static_cast<uint64_t>(value));
+    } else if (value >= -32) {
+        out.push_back(static_cast<uint8_t>(value));
+    } else if (value >= INT8_MIN) {
+        out.push_back(0xd0);
+        out.push_back(static_cast<uint8_t>(value));
+    } else if (value >= INT16_MIN) {
+        out.push_back(0xd1);
+        detail::put_be(out, static_cast<uint16_t>(value));
+    } else if (value >= INT32_MIN) {
+        out.push_back(0xd2);
+        detail::put_be(out, static_cast<uint32_t>(value));
+    } else {
+        out.push_back(0xd3);
+        detail::put_be(out, static_cast<uint64_t>(value));
+    }
+}
+
+/** like nlohmann, doubles that survive a round trip through float are packed as float32 */
+inline void write_double(std::vector<uint8_t>& out, double value)
+{
+    if (value >= static_cast<double>(std::numeric_limits<float>::lowest()) && value <= static_cast<double>(std::numeric_limits<float>::max()) &&
+        static_cast<double>(static_cast<float>(value)) == value) {
+        const float narrow = static_cast<float>(value);
+        uint32_t bits;
+        std::memcpy(&bits, &narrow, sizeof(bits));
+        out.push_back(0xca);
+        detail::put_be(out, bits);
+        return;
+    }
+
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back(0xcb);
+    detail::put_be(out, bits);
+}
+
+inline void write_str(std::vector<uint8_t>& out, std::string_view value)
+{
+    const size_t n = value.size();
+    if (n < 32) {
+        out.push_back(static_cast<uint8_t>(0xa0 | n));
+    } else if (n <= UINT8_MAX) {
+        out.push_back(0xd9);
+        out.push_back(static_cast<uint8_t>(n));
+    } else if (n <= UINT16_MAX) {
+        out.push_back(0xda);
+        detail::put_be(out, static_cast<uint16_t>(n));
+    } else {
+        out.push_back(0xdb);
+        detail::put_be(out, static_cast<uint32_t>(n));
+    }
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+inline void write_array_header(std::vector<uint8_t>& out, uint32_t n)
+{
+    if (n < 16) {
+        out.push_back(static_cast<uint8_t>(0x90 | n));
+    } else if (n <= UINT16_MAX) {
+        out.push_back(0xdc);
+        detail::put_be(out, static_cast<uint16_t>(n));
+    } else {
+        out.push_back(0xdd);
+        detail::put_be(out, n);
+    }
+}
+
+inline void write_map_header(std::vector<uint8_t>& out, uint32_t n)
+{
+    if (n < 16) {
+        out.push_back(static_cast<uint8_t>(0x80 | n));
+    } else if (n <= UINT16_MAX) {
+        out.push_back(0xde);
+        detail::put_be(out, static_cast<uint16_t>(n));
+    } else {
+        out.push_back(0xdf);
+        detail::put_be(out, n);
+    }
+}
+} // namespace msgpack_writer
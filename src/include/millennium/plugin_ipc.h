@@ -40,6 +40,7 @@
 #include <winsock2.h>
 #endif
 
+#include "millennium/msgpack_writer.h"
 #include <nlohmann/json.hpp>
 
 #include <cstdint>
@@ -185,6 +186,24 @@ inline bool write_msg(socket_fd fd, const nlohmann::json& msg)
     return write_frame(fd, nlohmann::json::to_msgpack(msg));
 }
 
+/**
+ * pack a request envelope around params that are already msgpack encoded, so callers that pack their own params
+ * don't need to build a json document just to have it serialized again.
+ */
+inline void pack_request(std::vector<uint8_t>& out, int id, std::string_view method, const std::vector<uint8_t>& packed_params)
+{
+    out.clear();
+    msgpack_writer::write_map_header(out, 4);
+    msgpack_writer::write_str(out, "type");
+    msgpack_writer::write_str(out, TYPE_REQUEST);
+    msgpack_writer::write_str(out, "id");
+    msgpack_writer::write_int(out, id);
+    msgpack_writer::write_str(out, "method");
+    msgpack_writer::write_str(out, method);
+    msgpack_writer::write_str(out, "params");
+    out.insert(out.end(), packed_params.begin(), packed_params.end());
+}
+
 inline void close_fd(socket_fd fd)
 {
 #ifdef _WIN32
@@ -0,0 +1,61 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * decoder for the lz blocks .star files use for compressed sections and assets.
+ *
+ * a block is a little endian u32 with the decompressed size followed by lz4-style sequences (token, literals,
+ * 2 byte offset, match length). plugin bundles and assets go through here on every load, so the decoder copies
+ * in 8/16 byte strides into a buffer with a little slack at the end and only falls back to exact copies where
+ * the input runs out.
+ */
+
+/** hard cap on the decompressed size a block may declare */
+inline constexpr uint32_t STAR_DECOMPRESS_MAX = 64u * 1024u * 1024u;
+
+/** size the block declares in its header. throws std::runtime_error if the header is missing or over the cap */
+uint32_t star_decompressed_size(const uint8_t* src, size_t src_len);
+
+/**
+ * decompress a block into out, replacing its contents. out keeps its capacity between calls, so hot callers
+ * should hand in the same string every time. throws std::runtime_error on malformed input (out is left empty).
+ */
+void star_decompress_into(const uint8_t* src, size_t src_len, std::string& out);
+
+std::string star_decompress(const uint8_t* src, size_t src_len);
+
+/** release a reused buffer once a one-off large block has left it holding more than a few MB */
+void star_decompress_trim(std::string& buffer);
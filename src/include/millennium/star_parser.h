@@ -30,10 +30,15 @@
 
 #pragma once
 #include "millennium/plugin_manager.h"
+#include "millennium/star_decompress.h"
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 enum class star_js_section
 {
@@ -48,76 +53,96 @@ struct AssetEntry
     size_t uncompressed_length;
 };
 
-std::optional<plugin_manager::plugin_t> parse_star_file(const std::filesystem::path& star_path);
-std::string star_read_javascript(const std::filesystem::path& star_path, star_js_section section);
+enum class star_section : uint8_t
+{
+    metadata = 0x01,
+    backend = 0x02,
+    frontend = 0x03,
+    webkit = 0x04,
+    assets = 0x05
+};
 
-std::unordered_map<std::string, AssetEntry> star_read_asset_index(const std::filesystem::path& star_path);
+/** a named file packed inside a section, pointing into memory owned by its star_archive */
+struct star_entry_view
+{
+    std::string_view name;
+    std::string_view data;
+};
 
-inline std::vector<uint8_t> star_decompress(const uint8_t* src, size_t src_len)
+/**
+ * read-only, memory mapped view of a .star file.
+ *
+ * open() checks the header, shim hash and signature once. sections are decoded the first time they're asked for:
+ * raw sections are handed out straight from the mapping, encoded ones are decoded in a single pass (xor, parity and
+ * decompression) into one buffer owned by the archive. nothing is read from disk that isn't touched, so deferred
+ * sections and large asset blobs cost nothing until used. views stay valid for the lifetime of the archive.
+ */
+class star_archive
 {
-    if (src_len < 4) throw std::runtime_error("star_decompress: input too short");
-
-    const uint32_t orig_size = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8) | (static_cast<uint32_t>(src[2]) << 16) | (static_cast<uint32_t>(src[3]) << 24);
-
-    static constexpr uint32_t STAR_DECOMPRESS_MAX = 64u * 1024u * 1024u;
-    if (orig_size > STAR_DECOMPRESS_MAX) throw std::runtime_error("star_decompress: decompressed size exceeds 64 MB limit");
-
-    std::vector<uint8_t> out(orig_size);
-
-    const uint8_t* ip = src + 4;
-    const uint8_t* ip_end = src + src_len;
-    uint8_t* op = out.data();
-    uint8_t* const op_end = out.data() + orig_size;
-
-    while (ip < ip_end) {
-        const uint8_t token = *ip++;
-
-        size_t lit_len = static_cast<size_t>(token >> 4);
-        if (lit_len == 15) {
-            const size_t max_lit_len = static_cast<size_t>(op_end - op);
-            while (ip < ip_end) {
-                const uint8_t b = *ip++;
-                lit_len += b;
-
-                /** bail if accumulator exceeds output buffer size, preventing 32bit size_t overflow. */
-                if (lit_len > max_lit_len) throw std::runtime_error("star_decompress: literal overflow");
-                if (b != 255) break;
-            }
-        }
-        if (op + lit_len > op_end || ip + lit_len > ip_end) throw std::runtime_error("star_decompress: literal overflow");
-        std::memcpy(op, ip, lit_len);
-        op += lit_len;
-        ip += lit_len;
-
-        if (ip >= ip_end) break;
-
-        if (ip + 2 > ip_end) throw std::runtime_error("star_decompress: truncated match offset");
-        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
-        ip += 2;
-        if (offset == 0) throw std::runtime_error("star_decompress: zero match offset");
-
-        size_t match_len = static_cast<size_t>(token & 0xFu) + 4u;
-        if ((token & 0xFu) == 15u) {
-            const size_t max_match_len = static_cast<size_t>(op_end - op);
-            while (ip < ip_end) {
-                const uint8_t b = *ip++;
-                match_len += b;
-
-                /** same guard as above */
-                if (match_len > max_match_len) throw std::runtime_error("star_decompress: match overflow");
-                if (b != 255) break;
-            }
-        }
-        if (op + match_len > op_end) throw std::runtime_error("star_decompress: match overflow");
-
-        const uint8_t* match_src = op - offset;
-        if (match_src < out.data()) throw std::runtime_error("star_decompress: invalid match offset");
-
-        for (size_t i = 0; i < match_len; ++i)
-            op[i] = match_src[i];
-        op += match_len;
+  public:
+    /** map and validate a .star file. returns nullptr if it isn't a loadable archive */
+    static std::unique_ptr<star_archive> open(const std::filesystem::path& path);
+    ~star_archive();
+
+    star_archive(const star_archive&) = delete;
+    star_archive& operator=(const star_archive&) = delete;
+
+    const std::filesystem::path& path() const
+    {
+        return m_path;
     }
 
-    out.resize(static_cast<size_t>(op - out.data()));
-    return out;
-}
+    /**
+     * signed by starlight and the signature covers every non-deferred section.
+     * verified on the first call and cached, so opening an archive just to read from it never pays for the signature check.
+     */
+    bool is_trusted() const;
+
+    bool has_section(star_section id) const;
+
+    /** decoded contents of a section, empty if it isn't present. throws std::runtime_error if the section is corrupt */
+    std::string_view section(star_section id) const;
+
+    /** the entry table packed inside a section. throws std::runtime_error if it's malformed */
+    std::vector<star_entry_view> entries(star_section id) const;
+
+    /** where each asset lives in the file, so the plugin backend can read them itself */
+    std::unordered_map<std::string, AssetEntry> asset_index() const;
+
+  private:
+    struct mapping;
+    struct section_entry
+    {
+        uint8_t id;
+        uint8_t encode_flags; /* COMPRESSED=0x80, OBFUSCATED=0x40 */
+        uint32_t meta_flags;  /* DEFERRED=0x01, REQUIRED=0x02 */
+        uint64_t offset;      /* bytes from star_start */
+        uint64_t length;      /* encoded on-disk byte count */
+        uint32_t crc32;
+    };
+
+    star_archive() = default;
+
+    const section_entry* find_section(star_section id) const;
+    std::string_view decode_section(const section_entry& sec) const;
+
+    std::filesystem::path m_path;
+    std::unique_ptr<mapping> m_mapping;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_star_start = 0;
+    std::vector<section_entry> m_sections;
+    /** where the signature starts (it covers every byte before it), 0 if the file isn't signed in a way we accept */
+    size_t m_signature_offset = 0;
+
+    mutable std::once_flag m_trust_once;
+    mutable bool m_trusted = false;
+
+    mutable std::mutex m_decode_mutex;
+    mutable std::unordered_map<uint8_t, std::string> m_decoded;
+};
+
+std::optional<plugin_manager::plugin_t> parse_star_file(const std::filesystem::path& star_path);
+std::string star_read_javascript(const std::filesystem::path& star_path, star_js_section section);
+
+std::unordered_map<std::string, AssetEntry> star_read_asset_index(const std::filesystem::path& star_path);
@@ -17,6 +17,7 @@ public:
     bool is_safe_for_js() const;
     bool is_steam_owned() const;
     bool allows_webkit_injection(const std::vector<network_hook_ctl::hook_item>& hooks) const;
+    bool allows_webkit_injection(const network_hook_ctl::hook_matcher& hooks) const;
 
     static bool is_domain_match(std::string_view host, std::string_view domain);
 
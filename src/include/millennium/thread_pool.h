@@ -38,10 +38,14 @@
 class thread_pool
 {
   public:
-    thread_pool(size_t numThreads = 4);
+    /** max_queued bounds try_enqueue(), 0 means unbounded */
+    thread_pool(size_t numThreads = 4, size_t max_queued = 0);
     ~thread_pool();
 
     void enqueue(std::function<void()> f);
+
+    /** queue f unless max_queued tasks are already waiting (or the pool is stopped). returns whether it was queued */
+    bool try_enqueue(std::function<void()> f);
     void shutdown();
 
   private:
@@ -49,6 +53,7 @@ class thread_pool
     std::queue<std::function<void()>> tasks;
     std::mutex queueMutex;
     std::condition_variable condition;
+    size_t max_queued;
     bool stop = false;
     std::atomic<bool> shutdown_called{ false };
 };
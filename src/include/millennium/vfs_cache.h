@@ -0,0 +1,100 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * identifies one version of a file on disk. a changed mtime or size means the cached body is stale.
+ * in-memory resources use the default stamp, so they stay valid until explicitly invalidated.
+ */
+struct vfs_file_stamp
+{
+    std::filesystem::file_time_type mtime{};
+    std::uintmax_t size = 0;
+
+    bool operator==(const vfs_file_stamp&) const = default;
+
+    /** stat a file, nullopt if it doesn't exist or isn't a regular file */
+    static std::optional<vfs_file_stamp> of(const std::filesystem::path& path);
+};
+
+/** a ready-to-send Fetch.fulfillRequest body and its response headers */
+struct vfs_response
+{
+    std::string body; // already base64 encoded
+    nlohmann::json headers;
+};
+
+/**
+ * size-bounded lru cache of encoded virtual file responses.
+ *
+ * themes and plugins request the same css/js/images on every window open, so this saves
+ * the disk read and base64 pass for everything that hasn't changed since the last request.
+ */
+class vfs_response_cache
+{
+  public:
+    explicit vfs_response_cache(size_t byte_budget = 64 * 1024 * 1024);
+
+    /** the cached response for key, or nullptr if there is none or it was cached from a different stamp */
+    std::shared_ptr<const vfs_response> find(const std::string& key, const vfs_file_stamp& stamp);
+    void store(const std::string& key, const vfs_file_stamp& stamp, std::shared_ptr<const vfs_response> response);
+
+    void invalidate(const std::string& key);
+    void clear();
+
+    size_t size_bytes() const;
+
+  private:
+    struct entry
+    {
+        std::string key;
+        vfs_file_stamp stamp;
+        std::shared_ptr<const vfs_response> response;
+    };
+
+    void erase(std::list<entry>::iterator it);
+
+    const size_t m_byte_budget;
+    size_t m_bytes = 0;
+
+    mutable std::mutex m_mutex;
+    std::list<entry> m_lru; // most recently used first
+    std::unordered_map<std::string, std::list<entry>::iterator> m_index;
+};
@@ -47,6 +47,7 @@ struct crash_handler_ctx
     void (*write_shm_fields)(crash_ipc_region* shm); /* extra SHM fields, null = none */
     void (*fallback_write)(EXCEPTION_POINTERS* ep);  /* in-process fallback */
     bool terminate_after_crash;                      /* TerminateProcess vs EXCEPTION_CONTINUE_SEARCH */
+    void (*flush_logs)();                            /* push out buffered logs before the report, null = none */
 };
 
 /* ctx must outlive the process (static global) */
@@ -61,6 +62,7 @@ struct crash_handler_signal_ctx
     const crash_report_info* info;
     std::string (*make_crash_dir)();
     bool chain_to_previous;
+    void (*flush_logs)(); /* push out buffered logs before the report (in the crashing process), null = none */
 };
 
 void crash_handler_core_install_signals(crash_handler_signal_ctx* ctx, const int* signals, int num_signals);
@@ -120,28 +120,54 @@ static json lua_to_json(lua_State* L, int idx)
     }
 }
 
-static int config_get(lua_State* L)
+/*
+ * result pushers for the config calls. they run inline for a blocking call, or when the
+ * response arrives for a coroutine that yielded on it (see rpc_client::call_lua).
+ */
+static int push_config_value(lua_State* L, const json& result)
 {
-    const char* key = luaL_checkstring(L, 1);
+    if (result.contains("error")) {
+        lua_pushnil(L);
+        lua_pushstring(L, result["error"].get<std::string>().c_str());
+        return 2;
+    }
 
-    try {
-        json result = g_rpc->call(plugin_ipc::child_method::CONFIG_GET, {
-                                                                            { "key", key }
-        });
+    push_json_value(L, result.value("value", json(nullptr)));
+    return 1;
+}
 
-        if (result.contains("error")) {
-            lua_pushnil(L);
-            lua_pushstring(L, result["error"].get<std::string>().c_str());
-            return 2;
-        }
+static int push_config_ack(lua_State* L, const json& result)
+{
+    if (result.contains("error")) {
+        lua_pushboolean(L, 0);
+        lua_pushstring(L, result["error"].get<std::string>().c_str());
+        return 2;
+    }
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
 
-        push_json_value(L, result.value("value", json(nullptr)));
-        return 1;
-    } catch (const std::exception& e) {
+static int push_config_all(lua_State* L, const json& result)
+{
+    if (result.contains("error")) {
         lua_pushnil(L);
-        lua_pushstring(L, e.what());
+        lua_pushstring(L, result["error"].get<std::string>().c_str());
         return 2;
     }
+
+    push_json_value(L, result.value("config", json::object()));
+    return 1;
+}
+
+static int config_get(lua_State* L)
+{
+    const char* key = luaL_checkstring(L, 1);
+
+    const json params = {
+        { "key", key }
+    };
+    return g_rpc->call_lua(L, plugin_ipc::child_method::CONFIG_GET, params, push_config_value);
 }
 
 static int config_set(lua_State* L)
@@ -150,69 +176,26 @@ static int config_set(lua_State* L)
     luaL_checkany(L, 2);
     json value = lua_to_json(L, 2);
 
-    try {
-        json result = g_rpc->call(plugin_ipc::child_method::CONFIG_SET, {
-                                                                            { "key",   key   },
-                                                                            { "value", value }
-        });
-
-        if (result.contains("error")) {
-            lua_pushboolean(L, 0);
-            lua_pushstring(L, result["error"].get<std::string>().c_str());
-            return 2;
-        }
-
-        lua_pushboolean(L, 1);
-        return 1;
-    } catch (const std::exception& e) {
-        lua_pushboolean(L, 0);
-        lua_pushstring(L, e.what());
-        return 2;
-    }
+    const json params = {
+        { "key",   key   },
+        { "value", value }
+    };
+    return g_rpc->call_lua(L, plugin_ipc::child_method::CONFIG_SET, params, push_config_ack);
 }
 
 static int config_delete(lua_State* L)
 {
     const char* key = luaL_checkstring(L, 1);
 
-    try {
-        json result = g_rpc->call(plugin_ipc::child_method::CONFIG_DELETE, {
-                                                                               { "key", key }
-        });
-
-        if (result.contains("error")) {
-            lua_pushboolean(L, 0);
-            lua_pushstring(L, result["error"].get<std::string>().c_str());
-            return 2;
-        }
-
-        lua_pushboolean(L, 1);
-        return 1;
-    } catch (const std::exception& e) {
-        lua_pushboolean(L, 0);
-        lua_pushstring(L, e.what());
-        return 2;
-    }
+    const json params = {
+        { "key", key }
+    };
+    return g_rpc->call_lua(L, plugin_ipc::child_method::CONFIG_DELETE, params, push_config_ack);
 }
 
 static int config_get_all(lua_State* L)
 {
-    try {
-        json result = g_rpc->call(plugin_ipc::child_method::CONFIG_GET_ALL);
-
-        if (result.contains("error")) {
-            lua_pushnil(L);
-            lua_pushstring(L, result["error"].get<std::string>().c_str());
-            return 2;
-        }
-
-        push_json_value(L, result.value("config", json::object()));
-        return 1;
-    } catch (const std::exception& e) {
-        lua_pushnil(L);
-        lua_pushstring(L, e.what());
-        return 2;
-    }
+    return g_rpc->call_lua(L, plugin_ipc::child_method::CONFIG_GET_ALL, nullptr, push_config_all);
 }
 
 /* config.on_change([key,] callback) -> unsubscribe() */
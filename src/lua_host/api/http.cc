@@ -34,9 +34,75 @@
 
 extern rpc_client* g_rpc;
 
+/**
+ * Converts an HTTP_REQUEST result into http.request()'s return values.
+ */
+static int push_http_response(lua_State* L, const nlohmann::json& result)
+{
+    if (result.contains("error")) {
+        lua_pushnil(L);
+        lua_pushstring(L, result["error"].get<std::string>().c_str());
+        return 2;
+    }
+
+    lua_newtable(L);
+
+    lua_pushstring(L, "body");
+    lua_pushstring(L, result.value("body", "").c_str());
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "status");
+    lua_pushinteger(L, result.value("status", 0));
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "headers");
+    lua_newtable(L);
+    if (result.contains("headers") && result["headers"].is_object()) {
+        for (auto& [key, val] : result["headers"].items()) {
+            lua_pushstring(L, key.c_str());
+            lua_pushstring(L, val.get<std::string>().c_str());
+            lua_settable(L, -3);
+        }
+    }
+    lua_settable(L, -3);
+
+    return 1;
+}
+
+/**
+ * Converts an HTTP_DOWNLOAD result into http.download()'s return values.
+ */
+static int push_download_response(lua_State* L, const nlohmann::json& result)
+{
+    if (result.contains("error")) {
+        lua_pushnil(L);
+        lua_pushstring(L, result["error"].get<std::string>().c_str());
+        return 2;
+    }
+
+    lua_newtable(L);
+
+    lua_pushstring(L, "success");
+    lua_pushboolean(L, result.value("success", false));
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "status");
+    lua_pushinteger(L, result.value("status", 0));
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "bytes_written");
+    lua_pushinteger(L, result.value("bytes_written", 0));
+    lua_settable(L, -3);
+
+    return 1;
+}
+
 /**
  * Builds an RPC params object from the Lua arguments and sends it to the parent
  * process which performs the actual curl request.
+ * Inside a coroutine started with millennium.start_coroutine() the coroutine is
+ * suspended until the response arrives, so other coroutines and frontend calls keep
+ * running. Anywhere else the call blocks.
  */
 static int Lua_HttpRequest(lua_State* L)
 {
@@ -127,42 +193,7 @@ static int Lua_HttpRequest(lua_State* L)
         lua_pop(L, 1);
     }
 
-    try {
-        nlohmann::json result = g_rpc->call(plugin_ipc::child_method::HTTP_REQUEST, params);
-
-        if (result.contains("error")) {
-            lua_pushnil(L);
-            lua_pushstring(L, result["error"].get<std::string>().c_str());
-            return 2;
-        }
-
-        lua_newtable(L);
-
-        lua_pushstring(L, "body");
-        lua_pushstring(L, result.value("body", "").c_str());
-        lua_settable(L, -3);
-
-        lua_pushstring(L, "status");
-        lua_pushinteger(L, result.value("status", 0));
-        lua_settable(L, -3);
-
-        lua_pushstring(L, "headers");
-        lua_newtable(L);
-        if (result.contains("headers") && result["headers"].is_object()) {
-            for (auto& [key, val] : result["headers"].items()) {
-                lua_pushstring(L, key.c_str());
-                lua_pushstring(L, val.get<std::string>().c_str());
-                lua_settable(L, -3);
-            }
-        }
-        lua_settable(L, -3);
-
-        return 1;
-    } catch (const std::exception& e) {
-        lua_pushnil(L);
-        lua_pushstring(L, e.what());
-        return 2;
-    }
+    return g_rpc->call_lua(L, plugin_ipc::child_method::HTTP_REQUEST, params, push_http_response);
 }
 
 static int Lua_HttpGet(lua_State* L)
@@ -281,7 +312,7 @@ static int Lua_HttpDelete(lua_State* L)
 
 /**
  * http.download(url, path [, opts])
- * Streams a file to disk via RPC. No body size limit.
+ * Streams a file to disk via RPC. No body size limit. Yields like http.request().
  * Returns { success, status, bytes_written } or nil, error.
  */
 static int Lua_HttpDownload(lua_State* L)
@@ -336,35 +367,7 @@ static int Lua_HttpDownload(lua_State* L)
         lua_pop(L, 1);
     }
 
-    try {
-        nlohmann::json result = g_rpc->call(plugin_ipc::child_method::HTTP_DOWNLOAD, params);
-
-        if (result.contains("error")) {
-            lua_pushnil(L);
-            lua_pushstring(L, result["error"].get<std::string>().c_str());
-            return 2;
-        }
-
-        lua_newtable(L);
-
-        lua_pushstring(L, "success");
-        lua_pushboolean(L, result.value("success", false));
-        lua_settable(L, -3);
-
-        lua_pushstring(L, "status");
-        lua_pushinteger(L, result.value("status", 0));
-        lua_settable(L, -3);
-
-        lua_pushstring(L, "bytes_written");
-        lua_pushinteger(L, result.value("bytes_written", 0));
-        lua_settable(L, -3);
-
-        return 1;
-    } catch (const std::exception& e) {
-        lua_pushnil(L);
-        lua_pushstring(L, e.what());
-        return 2;
-    }
+    return g_rpc->call_lua(L, plugin_ipc::child_method::HTTP_DOWNLOAD, params, push_download_response);
 }
 
 static const luaL_Reg httpFunctions[] = {
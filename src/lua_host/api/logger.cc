@@ -54,7 +54,7 @@ void log_runtime_error(const std::string& message)
         { "v2",           g_plugin_is_v2 },
         { "timestamp_us", now_us()       }
     };
-    g_rpc->notify(plugin_ipc::child_method::LOG, params);
+    g_rpc->notify(plugin_ipc::child_method::LOG, params, true);
 }
 
 static bool parse_lua_loc(const char* err, std::string& out_file, int& out_line)
@@ -113,7 +113,7 @@ void log_lua_error(const char* context, const char* lua_err)
         params["file"] = src_file;
         params["line"] = src_line;
     }
-    g_rpc->notify(plugin_ipc::child_method::LOG, params);
+    g_rpc->notify(plugin_ipc::child_method::LOG, params, true);
 }
 
 static void send_log(lua_State* L, const char* level, const char* message)
@@ -148,7 +148,8 @@ static void send_log(lua_State* L, const char* level, const char* message)
         { "line",         src_line       }
     };
 
-    g_rpc->notify(plugin_ipc::child_method::LOG, params);
+    /* errors go out right away, they're the lines that matter if the host dies before the next flush */
+    g_rpc->notify(plugin_ipc::child_method::LOG, params, std::strcmp(level, "error") == 0);
 }
 
 static int LuaLogInfo(lua_State* L)
@@ -84,6 +84,59 @@ static void push_json_to_lua(lua_State* L, const nlohmann::json& j, int depth =
     }
 }
 
+/**
+ * Converts a CALL_FRONTEND_METHOD result into call_frontend_method()'s return values.
+ */
+static int push_frontend_result(lua_State* L, const nlohmann::json& result)
+{
+    if (!result.value("success", false)) {
+        lua_pushnil(L);
+        std::string err;
+        if (result.contains("error") && result["error"].is_string()) {
+            err = result["error"].get<std::string>();
+        } else if (result.contains("returnJson") && result["returnJson"].is_string()) {
+            err = result["returnJson"].get<std::string>();
+        } else {
+            err = "unknown error";
+        }
+        lua_pushstring(L, err.c_str());
+        return 2;
+    }
+
+    nlohmann::json response = result.value("returnJson", nlohmann::json(nullptr));
+    std::string type = response.is_object() ? response.value("type", "") : "";
+
+    if (type == "undefined" || type == "null") {
+        lua_pushnil(L);
+        return 1;
+    }
+    if (type == "string") {
+        lua_pushstring(L, response["value"].get<std::string>().c_str());
+        return 1;
+    }
+    if (type == "boolean") {
+        lua_pushboolean(L, response["value"].get<bool>());
+        return 1;
+    }
+    if (type == "number") {
+        lua_pushnumber(L, response["value"].get<double>());
+        return 1;
+    }
+    if (type == "object") {
+        if (response.contains("value")) {
+            push_json_to_lua(L, response["value"]);
+            return 1;
+        }
+        lua_pushnil(L);
+        lua_pushstring(L, "object return value is not JSON-serializable");
+        return 2;
+    }
+
+    lua_pushnil(L);
+    lua_pushstring(L, ("unaccepted return type: " + type).c_str());
+    return 2;
+}
+
 static int RPC_CallFrontendMethod(lua_State* L)
 {
     const char* methodName = luaL_checkstring(L, 1);
@@ -111,79 +164,25 @@ static int RPC_CallFrontendMethod(lua_State* L)
         }
     }
 
-    try {
-        std::string caller;
-        lua_Debug ar;
-        if (lua_getstack(L, 1, &ar) && lua_getinfo(L, "Sl", &ar) && ar.currentline > 0) {
-            const char* src = ar.source ? ar.source : "?";
-            if (*src == '@') ++src;
-            std::string path(src);
-            const std::string prefix = g_backend_dir + "/";
-            if (!prefix.empty() && path.substr(0, prefix.size()) == prefix) path = path.substr(prefix.size());
-            caller = path + ":" + std::to_string(ar.currentline);
-        }
-
-        const json rpc_params = {
-            { "methodName",      methodName     },
-            { "params",          params         },
-            { "caller",          caller         },
-            { "return_by_value", g_plugin_is_v2 }
-        };
-
-        nlohmann::json result = g_rpc->call(plugin_ipc::child_method::CALL_FRONTEND_METHOD, rpc_params);
-
-        if (!result.value("success", false)) {
-            lua_pushnil(L);
-            std::string err;
-            if (result.contains("error") && result["error"].is_string()) {
-                err = result["error"].get<std::string>();
-            } else if (result.contains("returnJson") && result["returnJson"].is_string()) {
-                err = result["returnJson"].get<std::string>();
-            } else {
-                err = "unknown error";
-            }
-            lua_pushstring(L, err.c_str());
-            return 2;
-        }
-
-        const auto& response = result["returnJson"];
-        std::string type = response.is_object() ? response.value("type", "") : "";
-
-        if (type == "undefined" || type == "null") {
-            lua_pushnil(L);
-            return 1;
-        }
-        if (type == "string") {
-            lua_pushstring(L, response["value"].get<std::string>().c_str());
-            return 1;
-        }
-        if (type == "boolean") {
-            lua_pushboolean(L, response["value"].get<bool>());
-            return 1;
-        }
-        if (type == "number") {
-            lua_pushnumber(L, response["value"].get<double>());
-            return 1;
-        }
-        if (type == "object") {
-            if (response.contains("value")) {
-                push_json_to_lua(L, response["value"]);
-                return 1;
-            }
-            lua_pushnil(L);
-            lua_pushstring(L, "object return value is not JSON-serializable");
-            return 2;
-        }
+    std::string caller;
+    lua_Debug ar;
+    if (lua_getstack(L, 1, &ar) && lua_getinfo(L, "Sl", &ar) && ar.currentline > 0) {
+        const char* src = ar.source ? ar.source : "?";
+        if (*src == '@') ++src;
+        std::string path(src);
+        const std::string prefix = g_backend_dir + "/";
+        if (!prefix.empty() && path.substr(0, prefix.size()) == prefix) path = path.substr(prefix.size());
+        caller = path + ":" + std::to_string(ar.currentline);
+    }
 
-        lua_pushnil(L);
-        lua_pushstring(L, ("unaccepted return type: " + type).c_str());
-        return 2;
+    const json rpc_params = {
+        { "methodName",      methodName     },
+        { "params",          params         },
+        { "caller",          caller         },
+        { "return_by_value", g_plugin_is_v2 }
+    };
 
-    } catch (const std::exception& e) {
-        lua_pushnil(L);
-        lua_pushstring(L, e.what());
-        return 2;
-    }
+    return g_rpc->call_lua(L, plugin_ipc::child_method::CALL_FRONTEND_METHOD, rpc_params, push_frontend_result);
 }
 
 static int RPC_EmitReadyMessage(lua_State* L)
@@ -338,10 +337,48 @@ static int RPC_YieldReadable(lua_State* L)
         return luaL_error(L, "millennium.yield_readable() must be called from a coroutine, not the main thread");
     }
     lua_pop(L, 1);
-    g_rpc->watch_fd(fd, L);
+
+    /* raised outside the catch and from a plain buffer, luaL_error longjmps past any c++ cleanup */
+    char error[256] = {};
+    try {
+        g_rpc->watch_fd(fd, L);
+    } catch (const std::exception& e) {
+        snprintf(error, sizeof(error), "%s", e.what());
+    }
+    if (error[0] != '\0') {
+        return luaL_error(L, "millennium.yield_readable(): %s", error);
+    }
     return lua_yield(L, 0);
 }
 
+static int rpc_set_timer(lua_State* L, bool repeat)
+{
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    lua_Integer ms = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, ms >= 0, 2, "delay must not be negative");
+
+    lua_settop(L, 1);
+    uint64_t id = g_rpc->set_timer(L, std::chrono::milliseconds(ms), repeat);
+    lua_pushinteger(L, static_cast<lua_Integer>(id));
+    return 1;
+}
+
+static int RPC_SetTimeout(lua_State* L)
+{
+    return rpc_set_timer(L, false);
+}
+
+static int RPC_SetInterval(lua_State* L)
+{
+    return rpc_set_timer(L, true);
+}
+
+static int RPC_ClearTimer(lua_State* L)
+{
+    g_rpc->cancel_timer(static_cast<uint64_t>(luaL_checkinteger(L, 1)));
+    return 0;
+}
+
 static int assets_read(lua_State* L)
 {
     const char* path = luaL_checkstring(L, 1);
@@ -366,8 +403,10 @@ static int assets_read(lua_State* L)
             lua_pushnil(L);
             return 1;
         }
-        auto decompressed = star_decompress(compressed.data(), compressed.size());
-        lua_pushlstring(L, reinterpret_cast<const char*>(decompressed.data()), decompressed.size());
+        static thread_local std::string decompressed;
+        star_decompress_into(compressed.data(), compressed.size(), decompressed);
+        lua_pushlstring(L, decompressed.data(), decompressed.size());
+        star_decompress_trim(decompressed);
     } catch (const std::exception& e) {
         return luaL_error(L, "assets.read: decompress failed: %s", e.what());
     }
@@ -484,6 +523,9 @@ static const luaL_Reg millennium_lib[] = {
     { "cmp_version",           RPC_CompareVersion      },
     { "start_coroutine",       RPC_StartCoroutine      },
     { "yield_readable",        RPC_YieldReadable       },
+    { "set_timeout",           RPC_SetTimeout          },
+    { "set_interval",          RPC_SetInterval         },
+    { "clear_timer",           RPC_ClearTimer          },
     { NULL,                    NULL                    }
 };
 
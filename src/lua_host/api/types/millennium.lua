@@ -72,6 +72,22 @@ function millennium.steam_path() end
 ---@return string installPath Full path to Millennium installation directory
 function millennium.get_install_path() end
 
+---Run a function once after a delay. It runs in its own coroutine, so it can use utils.sleep and http without blocking the plugin.
+---@param callback function Function to run
+---@param milliseconds integer Delay in milliseconds
+---@return integer timerId ID for millennium.clear_timer
+function millennium.set_timeout(callback, milliseconds) end
+
+---Run a function every interval milliseconds, each time in a fresh coroutine.
+---@param callback function Function to run
+---@param milliseconds integer Interval in milliseconds
+---@return integer timerId ID for millennium.clear_timer
+function millennium.set_interval(callback, milliseconds) end
+
+---Cancel a timer from set_timeout or set_interval. Unknown or already fired IDs are ignored.
+---@param timerId integer ID returned from set_timeout or set_interval
+function millennium.clear_timer(timerId) end
+
 ---Call a JavaScript method on the frontend
 ---@param methodName string Name of the method to call on the frontend
 ---@param params? (string|number|boolean)[] Array of parameters (only string, number, boolean supported)
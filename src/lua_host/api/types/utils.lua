@@ -6,7 +6,9 @@ local utils = {}
 
 -- ============= Time/Sleep =============
 
----Pause execution for the specified number of milliseconds
+---Pause execution for the specified number of milliseconds.
+---Inside a coroutine started with millennium.start_coroutine() or a timer callback only that coroutine is paused,
+---anywhere else the whole plugin blocks.
 ---@param milliseconds integer Number of milliseconds to sleep
 function utils.sleep(milliseconds) end
 
@@ -28,6 +28,7 @@
  * SOFTWARE.
  */
 
+#include "rpc.h"
 #include <chrono>
 #include <lua.hpp>
 #include <thread>
@@ -40,9 +41,18 @@
 #include <fstream>
 #include <ctime>
 
+extern rpc_client* g_rpc;
+
+/**
+ * Inside a coroutine started with millennium.start_coroutine() (or a timer callback) only
+ * that coroutine sleeps. Anywhere else there's nothing to yield to, so the whole plugin blocks.
+ */
 int Lua_Sleep(lua_State* L)
 {
     int milliseconds = static_cast<int>(luaL_checkinteger(L, 1));
+    if (g_rpc && g_rpc->can_yield(L)) {
+        return g_rpc->sleep(L, std::chrono::milliseconds(std::max(milliseconds, 0)));
+    }
     std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
     return 0;
 }
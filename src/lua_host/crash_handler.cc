@@ -28,6 +28,7 @@
  * SOFTWARE.
  */
 #include "crash_handler.h"
+#include "rpc.h"
 #include "shared/crash_handler_core.h"
 #include "shared/crash_report.h"
 
@@ -42,6 +43,14 @@ static std::string s_crash_dump_dir;
 
 static crash_report_info s_info;
 
+extern rpc_client* g_rpc;
+
+/* logs still batched in the outbox are usually the ones explaining the crash */
+static void flush_pending_logs()
+{
+    if (g_rpc) g_rpc->flush_for_crash();
+}
+
 static std::string make_crash_dir()
 {
     std::error_code ec;
@@ -80,6 +89,7 @@ void install_crash_handler(const char* plugin_name, const char* backend_file, co
     s_signal_ctx.info = &s_info;
     s_signal_ctx.make_crash_dir = make_crash_dir;
     s_signal_ctx.chain_to_previous = false;
+    s_signal_ctx.flush_logs = flush_pending_logs;
 
     static const int signals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSYS };
     crash_handler_core_install_signals(&s_signal_ctx, signals, 6);
@@ -213,6 +223,7 @@ void install_crash_handler(const char* plugin_name, const char* backend_file, co
     s_ctx.write_shm_fields = plugin_write_shm_fields;
     s_ctx.fallback_write = plugin_fallback_write;
     s_ctx.terminate_after_crash = true;
+    s_ctx.flush_logs = flush_pending_logs;
 
     crash_handler_core_install(&s_ctx);
 }
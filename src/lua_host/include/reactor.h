@@ -0,0 +1,120 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "millennium/plugin_ipc.h"
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * readiness reactor for the lua host's event loop.
+ *
+ * fds stay registered across waits (epoll on linux, kqueue on macos, a persistent WSAPoll set on windows),
+ * so a wait costs the same no matter how many fds are watched and a ready fd maps straight back to its watcher.
+ * timers live in a min-heap next to it, and wait() sleeps no longer than the earliest one.
+ */
+class reactor
+{
+  public:
+    using native_fd = uintptr_t;
+    using clock = std::chrono::steady_clock;
+
+    struct fd_event
+    {
+        native_fd fd;
+        bool readable;
+        bool hangup;
+    };
+
+    reactor();
+    ~reactor();
+
+    reactor(const reactor&) = delete;
+    reactor& operator=(const reactor&) = delete;
+
+    enum class watch_status
+    {
+        watching,
+        /** the backend can't wait on this kind of fd (epoll and regular files), which are always readable anyway */
+        always_ready,
+        /** bad or closed fd, errno says why */
+        failed,
+    };
+
+    /**
+     * watch fd for readability. a one-shot watch reports once and then stays quiet until it's watched again,
+     * a persistent one keeps reporting for as long as the fd is readable.
+     */
+    watch_status watch(native_fd fd, bool once);
+
+    /**
+     * have wait() report id once due has passed. there is no cancel, callers drop ids they no longer care about
+     * when they come back (the same way cdp_client expires its request deadlines).
+     */
+    void schedule(uint64_t id, clock::time_point due);
+
+    /**
+     * block until a watched fd is ready, a timer is due, or timeout_ms passes (-1 waits for the other two).
+     * events and expired are cleared and refilled, returns false only if the backend fails.
+     */
+    bool wait(std::vector<fd_event>& events, std::vector<uint64_t>& expired, int timeout_ms = -1);
+
+  private:
+    struct timer
+    {
+        clock::time_point due;
+        uint64_t id;
+
+        bool operator>(const timer& other) const
+        {
+            return due > other.due;
+        }
+    };
+    std::priority_queue<timer, std::vector<timer>, std::greater<>> m_timers;
+
+    /** the timeout to hand the backend, shortened to the earliest timer */
+    int next_timeout(int timeout_ms) const;
+    void collect_expired(std::vector<uint64_t>& expired);
+
+#if defined(__linux__) || defined(__APPLE__)
+    int m_queue_fd = -1;
+#else
+    std::vector<plugin_ipc::poll_fd_t> m_pfds;
+    std::vector<bool> m_once;
+    std::unordered_map<native_fd, size_t> m_index;
+
+    void remove_at(size_t index);
+#endif
+};
@@ -31,8 +31,10 @@
 #pragma once
 
 #include "millennium/plugin_ipc.h"
+#include "reactor.h"
 #include <nlohmann/json.hpp>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <string>
@@ -45,12 +47,63 @@ class rpc_client
 {
   public:
     using request_handler = std::function<nlohmann::json(const std::string& method, const nlohmann::json& params)>;
+    /* gets the raw response frame, which carries either "result" or "error" */
+    using response_handler = std::function<void(nlohmann::json response)>;
+    /* pushes a call result onto a coroutine's stack, returns how many values it pushed */
+    using result_pusher = std::function<int(lua_State* co, const nlohmann::json& result)>;
 
     explicit rpc_client(plugin_ipc::socket_fd fd);
     ~rpc_client();
 
     nlohmann::json call(const std::string& method, const nlohmann::json& params = nullptr);
-    void notify(const std::string& method, const nlohmann::json& params = nullptr);
+    /**
+     * queued and written with the next batch, see flush().
+     * outside run() nothing would flush the batch for us, so it's written straight away there, as is anything urgent.
+     */
+    void notify(const std::string& method, const nlohmann::json& params = nullptr, bool urgent = false);
+
+    /**
+     * write every queued frame in one go. run() does this before it waits, call() before it sends,
+     * anything writing to the socket directly has to flush first to keep frames in order.
+     */
+    bool flush();
+
+    /* flush what's queued and close the socket, nothing is written after this (the destructor included) */
+    void close();
+
+    /**
+     * best-effort flush from the crash handler, so the logs leading up to a crash aren't lost with the process.
+     * gives up rather than wait if another thread is mid-write.
+     */
+    void flush_for_crash();
+
+    /**
+     * send a request without waiting for the response, it goes out with the next flush().
+     * on_response always runs from run(), never from inside call() or the caller, so it's free to resume lua.
+     * returns false if the request couldn't be sent (on_response is not called).
+     */
+    bool call_async(const std::string& method, const nlohmann::json& params, response_handler on_response);
+
+    /**
+     * whether L is a coroutine run() is currently driving, and so can be suspended by yield_call().
+     * coroutines resumed from lua (coroutine.resume/wrap) belong to their resumer and aren't ours to suspend.
+     */
+    bool can_yield(lua_State* L) const
+    {
+        return L != nullptr && L == m_running_coroutine && lua_isyieldable(L);
+    }
+
+    /**
+     * send a request and suspend L (which must pass can_yield()) until it's answered.
+     * the coroutine is resumed with push_result's values. transport errors are handed to push_result as { "error": message },
+     * and if push_result throws the coroutine gets nil + message instead.
+     * must be returned straight from the calling lua_CFunction: return g_rpc->yield_call(...);
+     */
+    int yield_call(lua_State* L, const std::string& method, const nlohmann::json& params, result_pusher push_result);
+
+    /** yield_call() when L can yield, otherwise a blocking call() with the same result handling */
+    int call_lua(lua_State* L, const std::string& method, const nlohmann::json& params, result_pusher push_result);
+
     void run(request_handler handler);
     bool connected() const
     {
@@ -59,20 +112,49 @@ class rpc_client
 
     /* async I/O support */
     void enqueue_coroutine(lua_State* co);
+    /* throws if fd can't be waited on (closed, not an fd) */
     void watch_fd(uintptr_t fd, lua_State* co);
 
+    /**
+     * suspend L (which must pass can_yield()) for delay without blocking the loop.
+     * must be returned straight from the calling lua_CFunction, like yield_call().
+     */
+    int sleep(lua_State* L, std::chrono::milliseconds delay);
+
+    /**
+     * pop the function on top of L's stack and run it in a fresh coroutine after delay, then every delay if repeat.
+     * returns an id for cancel_timer(). the coroutine can yield on us (sleep, http, ...) like any other.
+     */
+    uint64_t set_timer(lua_State* L, std::chrono::milliseconds delay, bool repeat);
+    void cancel_timer(uint64_t id);
+
   private:
     bool read_message(nlohmann::json& out);
     bool send_message(const nlohmann::json& msg);
+    void queue_message(const nlohmann::json& msg);
+    bool flush_locked();
     void respond(int id, const nlohmann::json& result);
     void respond_error(int id, const std::string& error);
-    void resume_coroutine(lua_State* co);
+    void resume_coroutine(lua_State* co, int nargs = 0);
+    /* a coroutine only we hold would be collected, so it stays in the registry until it's resumed */
+    void anchor_coroutine(lua_State* co);
+    void fire_timer(uint64_t id);
+    /* hands a response to its call_async() handler, returns false if nobody is waiting on that id */
+    bool complete_async(nlohmann::json& response);
 
     plugin_ipc::socket_fd m_fd;
     std::atomic<bool> m_connected{ true };
+    /* set while run() is driving the loop and flushing every turn */
+    std::atomic<bool> m_in_run{ false };
     std::atomic<int> m_next_id{ 1 };
     std::mutex m_write_mutex;
 
+    /* encoded frames waiting for the next flush() */
+    static constexpr size_t OUTBOX_FLUSH_BYTES = 64 * 1024;
+    static constexpr std::chrono::milliseconds OUTBOX_FLUSH_DELAY{ 20 };
+    std::vector<uint8_t> m_outbox;
+    std::chrono::steady_clock::time_point m_outbox_since;
+
     request_handler m_handler;
 
     /* responses received out-of-order (nested call() consumed them first) */
@@ -84,6 +166,31 @@ class rpc_client
     std::vector<lua_State*> m_pending_coroutines;
     /* fd -> coroutine blocked on that fd becoming readable */
     std::unordered_map<uintptr_t, lua_State*> m_fd_watches;
+    /* coroutines waiting on an always-readable fd, resumed after the next (non-blocking) wait so they can't starve the loop */
+    std::vector<lua_State*> m_next_turn_coroutines;
+
+    /* id -> handler for requests sent with call_async() */
+    std::unordered_map<int, response_handler> m_async_calls;
+    /* async responses read by a blocking call(), dispatched once control is back in run() */
+    std::vector<nlohmann::json> m_deferred_responses;
+    /* fds and timers the loop waits on, the IPC socket is watched for the lifetime of run() */
+    reactor m_reactor;
+
+    /* a sleeping coroutine, or a set_timer() callback parked on its home thread */
+    struct timer_entry
+    {
+        lua_State* sleeper;
+        lua_State* home;
+        int home_ref;
+        std::chrono::milliseconds interval;
+    };
+    std::unordered_map<uint64_t, timer_entry> m_timers;
+    uint64_t m_next_timer_id = 1;
+
+    /* coroutine -> registry ref keeping it alive while it waits on us */
+    std::unordered_map<lua_State*, int> m_anchors;
+    /* coroutine resume_coroutine() is running, nullptr while on the main thread */
+    lua_State* m_running_coroutine = nullptr;
 };
 
 void log_runtime_error(const std::string& message);
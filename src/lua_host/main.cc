@@ -93,9 +93,12 @@ static int lua_millennium_decompress(lua_State* L)
 {
     size_t src_len;
     const char* src = luaL_checklstring(L, 1, &src_len);
+    /** plugins call this for every bundled module they load, keep one output buffer around for all of them */
+    static thread_local std::string buffer;
     try {
-        auto out = star_decompress(reinterpret_cast<const uint8_t*>(src), src_len);
-        lua_pushlstring(L, reinterpret_cast<const char*>(out.data()), out.size());
+        star_decompress_into(reinterpret_cast<const uint8_t*>(src), src_len, buffer);
+        lua_pushlstring(L, buffer.data(), buffer.size());
+        star_decompress_trim(buffer);
         return 1;
     } catch (const std::exception& e) {
         return luaL_error(L, "MILLENNIUM_DECOMPRESS: %s", e.what());
@@ -464,13 +467,13 @@ int main(int argc, char* argv[])
     {
         if (!plugin_ipc::read_msg(fd, init_msg)) {
             fprintf(stderr, "[lua-host] failed to read init message\n");
-            plugin_ipc::close_fd(fd);
+            rpc.close();
             return 1;
         }
 
         if (init_msg.value("method", "") != plugin_ipc::parent_method::INIT) {
             fprintf(stderr, "[lua-host] expected init message, got something else\n");
-            plugin_ipc::close_fd(fd);
+            rpc.close();
             return 1;
         }
     }
@@ -499,7 +502,7 @@ int main(int argc, char* argv[])
             { "error", "failed to create Lua state" }
         };
         plugin_ipc::write_msg(fd, err_resp);
-        plugin_ipc::close_fd(fd);
+        rpc.close();
         return 1;
     }
 
@@ -550,9 +553,10 @@ int main(int argc, char* argv[])
                 { "id",    init_id                   },
                 { "error", err ? err : ctx           }
             };
+            rpc.flush(); /* logs from loading go out ahead of the reply */
             plugin_ipc::write_msg(fd, err_resp);
             lua_close(L);
-            plugin_ipc::close_fd(fd);
+            rpc.close();
             return 1;
         };
 
@@ -690,9 +694,10 @@ int main(int argc, char* argv[])
             { "id",    init_id                        },
             { "error", "main.lua must return a table" }
         };
+        rpc.flush();
         plugin_ipc::write_msg(fd, err_resp);
         lua_close(L);
-        plugin_ipc::close_fd(fd);
+        rpc.close();
         return 1;
     }
 
@@ -720,6 +725,7 @@ int main(int argc, char* argv[])
             { "id",     init_id                   },
             { "result", { { "ok", true } }        }
         };
+        rpc.flush();
         plugin_ipc::write_msg(fd, init_resp);
     }
 
@@ -767,9 +773,9 @@ int main(int argc, char* argv[])
        gets a chance to persist state. */
     handle_shutdown(L);
 
-    /* cleanup */
+    /* cleanup, __gc metamethods can still log so the socket outlives the state */
     lua_close(L);
-    plugin_ipc::close_fd(fd);
+    rpc.close();
     g_rpc = nullptr;
     g_L = nullptr;
 
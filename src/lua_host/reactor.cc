@@ -0,0 +1,234 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "reactor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <sys/event.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+/* how many ready fds one wait can report, the rest are picked up by the next one */
+static constexpr int MAX_EVENTS = 64;
+
+int reactor::next_timeout(int timeout_ms) const
+{
+    if (m_timers.empty()) {
+        return timeout_ms;
+    }
+
+    auto remaining = m_timers.top().due - clock::now();
+    /* round up so we don't wake a hair early and spin on a timer that isn't due yet */
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+    int until_timer = static_cast<int>(std::clamp<long long>(ms, 0, std::numeric_limits<int>::max()));
+
+    return timeout_ms < 0 ? until_timer : std::min(timeout_ms, until_timer);
+}
+
+void reactor::collect_expired(std::vector<uint64_t>& expired)
+{
+    const auto now = clock::now();
+    while (!m_timers.empty() && m_timers.top().due <= now) {
+        expired.push_back(m_timers.top().id);
+        m_timers.pop();
+    }
+}
+
+void reactor::schedule(uint64_t id, clock::time_point due)
+{
+    m_timers.push({ due, id });
+}
+
+#if defined(__linux__)
+
+reactor::reactor() : m_queue_fd(epoll_create1(EPOLL_CLOEXEC))
+{
+}
+
+reactor::~reactor()
+{
+    if (m_queue_fd >= 0) close(m_queue_fd);
+}
+
+reactor::watch_status reactor::watch(native_fd fd, bool once)
+{
+    epoll_event ev{};
+    ev.events = EPOLLIN | (once ? EPOLLONESHOT : 0u);
+    ev.data.u64 = fd;
+
+    int native = static_cast<int>(fd);
+    /* a fired one-shot watch is still registered (just disarmed), so re-arming it is a MOD */
+    int rc = epoll_ctl(m_queue_fd, EPOLL_CTL_ADD, native, &ev);
+    if (rc != 0 && errno == EEXIST) {
+        rc = epoll_ctl(m_queue_fd, EPOLL_CTL_MOD, native, &ev);
+    }
+
+    if (rc == 0) return watch_status::watching;
+    return errno == EPERM ? watch_status::always_ready : watch_status::failed;
+}
+
+bool reactor::wait(std::vector<fd_event>& events, std::vector<uint64_t>& expired, int timeout_ms)
+{
+    events.clear();
+    expired.clear();
+
+    epoll_event ready[MAX_EVENTS];
+    int n = epoll_wait(m_queue_fd, ready, MAX_EVENTS, next_timeout(timeout_ms));
+    if (n < 0) {
+        if (errno != EINTR) return false;
+        n = 0;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        events.push_back({ static_cast<native_fd>(ready[i].data.u64), (ready[i].events & EPOLLIN) != 0, (ready[i].events & (EPOLLHUP | EPOLLERR)) != 0 });
+    }
+    collect_expired(expired);
+    return true;
+}
+
+#elif defined(__APPLE__)
+
+reactor::reactor() : m_queue_fd(kqueue())
+{
+}
+
+reactor::~reactor()
+{
+    if (m_queue_fd >= 0) close(m_queue_fd);
+}
+
+reactor::watch_status reactor::watch(native_fd fd, bool once)
+{
+    struct kevent change;
+    EV_SET(&change, static_cast<uintptr_t>(fd), EVFILT_READ, EV_ADD | EV_ENABLE | (once ? EV_ONESHOT : 0), 0, 0, nullptr);
+    return kevent(m_queue_fd, &change, 1, nullptr, 0, nullptr) == 0 ? watch_status::watching : watch_status::failed;
+}
+
+bool reactor::wait(std::vector<fd_event>& events, std::vector<uint64_t>& expired, int timeout_ms)
+{
+    events.clear();
+    expired.clear();
+
+    int timeout = next_timeout(timeout_ms);
+    timespec ts{ timeout / 1000, static_cast<long>(timeout % 1000) * 1000000L };
+
+    struct kevent ready[MAX_EVENTS];
+    int n = kevent(m_queue_fd, nullptr, 0, ready, MAX_EVENTS, timeout < 0 ? nullptr : &ts);
+    if (n < 0) {
+        if (errno != EINTR) return false;
+        n = 0;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        bool error = (ready[i].flags & EV_ERROR) != 0;
+        events.push_back({ static_cast<native_fd>(ready[i].ident), !error, error || (ready[i].flags & EV_EOF) != 0 });
+    }
+    collect_expired(expired);
+    return true;
+}
+
+#else
+
+/* windows has no readiness queue (IOCP is completion based), so keep one WSAPoll set alive instead of rebuilding it each wait */
+reactor::reactor() = default;
+reactor::~reactor() = default;
+
+reactor::watch_status reactor::watch(native_fd fd, bool once)
+{
+    /* WSAPoll reports a bad socket as POLLNVAL on the next wait, which shows up as a hangup */
+    auto it = m_index.find(fd);
+    if (it != m_index.end()) {
+        m_once[it->second] = once;
+        return watch_status::watching;
+    }
+
+    plugin_ipc::poll_fd_t pfd{};
+    pfd.fd = static_cast<decltype(pfd.fd)>(fd);
+    pfd.events = POLLIN;
+
+    m_index[fd] = m_pfds.size();
+    m_pfds.push_back(pfd);
+    m_once.push_back(once);
+    return watch_status::watching;
+}
+
+void reactor::remove_at(size_t index)
+{
+    m_index.erase(static_cast<native_fd>(m_pfds[index].fd));
+
+    size_t last = m_pfds.size() - 1;
+    if (index != last) {
+        m_pfds[index] = m_pfds[last];
+        m_once[index] = m_once[last];
+        m_index[static_cast<native_fd>(m_pfds[index].fd)] = index;
+    }
+    m_pfds.pop_back();
+    m_once.pop_back();
+}
+
+bool reactor::wait(std::vector<fd_event>& events, std::vector<uint64_t>& expired, int timeout_ms)
+{
+    events.clear();
+    expired.clear();
+
+    int timeout = next_timeout(timeout_ms);
+    int n = 0;
+    if (!m_pfds.empty()) {
+        n = plugin_ipc::sys_poll(m_pfds.data(), static_cast<ULONG>(m_pfds.size()), timeout);
+        if (n < 0) return false;
+    } else if (timeout > 0) {
+        /* WSAPoll rejects an empty set */
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+    }
+
+    /* backwards, so dropping a fired one-shot entry doesn't move one we haven't looked at yet */
+    for (size_t i = m_pfds.size(); n > 0 && i-- > 0;) {
+        short revents = m_pfds[i].revents;
+        if (revents == 0) continue;
+        --n;
+
+        events.push_back({ static_cast<native_fd>(m_pfds[i].fd), (revents & POLLIN) != 0, (revents & (POLLHUP | POLLERR | POLLNVAL)) != 0 });
+        if (m_once[i]) remove_at(i);
+    }
+    collect_expired(expired);
+    return true;
+}
+
+#endif
@@ -31,8 +31,11 @@
 #include "rpc.h"
 #include "millennium/types.h"
 
+#include <cerrno>
+#include <cstring>
 #include <stdexcept>
 #include <thread>
+#include <utility>
 #include <vector>
 
 rpc_client::rpc_client(plugin_ipc::socket_fd fd) : m_fd(fd)
@@ -41,9 +44,31 @@ rpc_client::rpc_client(plugin_ipc::socket_fd fd) : m_fd(fd)
 
 rpc_client::~rpc_client()
 {
+    close();
+}
+
+void rpc_client::close()
+{
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    if (m_fd == plugin_ipc::INVALID_FD) {
+        return;
+    }
+
+    flush_locked();
+    plugin_ipc::close_fd(m_fd);
+    m_fd = plugin_ipc::INVALID_FD;
     m_connected.store(false);
 }
 
+void rpc_client::flush_for_crash()
+{
+    if (!m_write_mutex.try_lock()) {
+        return;
+    }
+    flush_locked();
+    m_write_mutex.unlock();
+}
+
 bool rpc_client::read_message(json& out)
 {
     if (!plugin_ipc::read_msg(m_fd, out)) {
@@ -53,14 +78,49 @@ bool rpc_client::read_message(json& out)
     return true;
 }
 
-bool rpc_client::send_message(const json& msg)
+void rpc_client::queue_message(const json& msg)
 {
+    std::vector<uint8_t> payload = json::to_msgpack(msg);
+    uint32_t len_le = plugin_ipc::to_le32(static_cast<uint32_t>(payload.size()));
+
     std::lock_guard<std::mutex> lock(m_write_mutex);
-    if (!plugin_ipc::write_msg(m_fd, msg)) {
-        m_connected.store(false);
+    if (m_outbox.empty()) {
+        m_outbox_since = std::chrono::steady_clock::now();
+    }
+    const auto* len_bytes = reinterpret_cast<const uint8_t*>(&len_le);
+    m_outbox.insert(m_outbox.end(), len_bytes, len_bytes + sizeof(len_le));
+    m_outbox.insert(m_outbox.end(), payload.begin(), payload.end());
+}
+
+bool rpc_client::flush_locked()
+{
+    if (m_fd == plugin_ipc::INVALID_FD) {
+        m_outbox.clear();
         return false;
     }
-    return true;
+    if (m_outbox.empty()) {
+        return m_connected.load();
+    }
+
+    bool ok = plugin_ipc::send_all(m_fd, m_outbox.data(), m_outbox.size());
+    m_outbox.clear();
+    if (!ok) {
+        m_connected.store(false);
+    }
+    return ok;
+}
+
+bool rpc_client::flush()
+{
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    return flush_locked();
+}
+
+bool rpc_client::send_message(const json& msg)
+{
+    /* anything queued goes out first, in the same write */
+    queue_message(msg);
+    return flush();
 }
 
 json rpc_client::call(const std::string& method, const json& params)
@@ -117,6 +177,11 @@ json rpc_client::call(const std::string& method, const json& params)
                 }
                 return msg.value("result", json(nullptr));
             }
+            /* answer to a call_async(), it's dispatched from run() once we're back there */
+            if (m_async_calls.count(resp_id)) {
+                m_deferred_responses.push_back(std::move(msg));
+                continue;
+            }
             /* response for an outer (stacked) call .stash it for that frame */
             m_stashed_responses[resp_id] = std::move(msg);
             continue;
@@ -145,14 +210,109 @@ json rpc_client::call(const std::string& method, const json& params)
     throw std::runtime_error("rpc_client: disconnected");
 }
 
-void rpc_client::notify(const std::string& method, const json& params)
+void rpc_client::notify(const std::string& method, const json& params, bool urgent)
 {
     json msg = {
         { "type",   plugin_ipc::TYPE_NOTIFY },
         { "method", method                  },
         { "params", params                  }
     };
-    send_message(msg);
+    queue_message(msg);
+
+    /* run() flushes every loop turn, past that this only bounds how long a busy script can sit on its logs */
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    if (urgent || !m_in_run.load() || m_outbox.size() >= OUTBOX_FLUSH_BYTES || std::chrono::steady_clock::now() - m_outbox_since >= OUTBOX_FLUSH_DELAY) {
+        flush_locked();
+    }
+}
+
+bool rpc_client::call_async(const std::string& method, const json& params, response_handler on_response)
+{
+    if (!m_connected.load()) {
+        return false;
+    }
+
+    int id = m_next_id.fetch_add(1);
+
+    json req = {
+        { "type",   plugin_ipc::TYPE_REQUEST },
+        { "id",     id                       },
+        { "method", method                   },
+        { "params", params                   }
+    };
+
+    /* batched with whatever else this loop turn sends, run() flushes before it waits */
+    m_async_calls[id] = std::move(on_response);
+    queue_message(req);
+    return true;
+}
+
+bool rpc_client::complete_async(json& response)
+{
+    auto it = m_async_calls.find(response.value("id", -1));
+    if (it == m_async_calls.end()) {
+        return false;
+    }
+
+    response_handler handler = std::move(it->second);
+    m_async_calls.erase(it);
+    handler(std::move(response));
+    return true;
+}
+
+/**
+ * run push_result, turning an exception into nil + message so it never unwinds through lua.
+ */
+static int push_call_result(lua_State* L, const rpc_client::result_pusher& push_result, const json& result)
+{
+    int top = lua_gettop(L);
+    try {
+        return push_result(L, result);
+    } catch (const std::exception& e) {
+        lua_settop(L, top);
+        lua_pushnil(L);
+        lua_pushstring(L, e.what());
+        return 2;
+    }
+}
+
+/* transport failures reach push_result the same way the parent reports errors, as { "error": ... } */
+static json error_result(const std::string& message)
+{
+    return {
+        { "error", message }
+    };
+}
+
+int rpc_client::yield_call(lua_State* L, const std::string& method, const json& params, result_pusher push_result)
+{
+    auto on_response = [this, L, push_result](json response)
+    {
+        json result = response.contains("error") ? error_result(response["error"].get<std::string>()) : response.value("result", json(nullptr));
+        resume_coroutine(L, push_call_result(L, push_result, result));
+    };
+
+    if (!call_async(method, params, std::move(on_response))) {
+        return push_call_result(L, push_result, error_result("rpc_client: not connected"));
+    }
+
+    anchor_coroutine(L);
+    return lua_yield(L, 0);
+}
+
+int rpc_client::call_lua(lua_State* L, const std::string& method, const json& params, result_pusher push_result)
+{
+    if (can_yield(L)) {
+        return yield_call(L, method, params, std::move(push_result));
+    }
+
+    json result;
+    try {
+        result = call(method, params);
+    } catch (const std::exception& e) {
+        result = error_result(e.what());
+    }
+    return push_call_result(L, push_result, result);
 }
 
 void rpc_client::respond(int id, const json& result)
@@ -177,22 +337,145 @@ void rpc_client::respond_error(int id, const std::string& error)
 
 void rpc_client::enqueue_coroutine(lua_State* co)
 {
+    anchor_coroutine(co);
     m_pending_coroutines.push_back(co);
 }
 
 void rpc_client::watch_fd(uintptr_t fd, lua_State* co)
 {
-    m_fd_watches[fd] = co;
+    switch (m_reactor.watch(fd, true)) {
+        case reactor::watch_status::failed:
+            throw std::runtime_error("can't wait on fd " + std::to_string(fd) + ": " + std::strerror(errno));
+
+        case reactor::watch_status::always_ready:
+            m_next_turn_coroutines.push_back(co);
+            break;
+
+        case reactor::watch_status::watching:
+        {
+            /* whoever was waiting on this fd before is never going to be woken, let it be collected */
+            auto it = m_fd_watches.find(fd);
+            if (it != m_fd_watches.end() && it->second != co) {
+                if (auto anchor = m_anchors.find(it->second); anchor != m_anchors.end()) {
+                    luaL_unref(co, LUA_REGISTRYINDEX, anchor->second);
+                    m_anchors.erase(anchor);
+                }
+            }
+            m_fd_watches[fd] = co;
+            break;
+        }
+    }
+    anchor_coroutine(co);
+}
+
+int rpc_client::sleep(lua_State* L, std::chrono::milliseconds delay)
+{
+    uint64_t id = m_next_timer_id++;
+    m_timers[id] = timer_entry{ L, nullptr, LUA_NOREF, std::chrono::milliseconds(0) };
+    m_reactor.schedule(id, reactor::clock::now() + delay);
+
+    anchor_coroutine(L);
+    return lua_yield(L, 0);
+}
+
+uint64_t rpc_client::set_timer(lua_State* L, std::chrono::milliseconds delay, bool repeat)
+{
+    /*
+     * the callback lives on a thread of its own that's never run, each firing spawns a fresh coroutine off it.
+     * that keeps the function alive without tying it to the (possibly short-lived) thread that set the timer.
+     */
+    lua_State* home = lua_newthread(L);
+    lua_pushvalue(L, -2);
+    lua_xmove(L, home, 1);
+    int home_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    lua_pop(L, 1);
+
+    /* a zero interval would fire on every turn of the loop and starve everything else */
+    auto interval = repeat ? std::max(delay, std::chrono::milliseconds(1)) : std::chrono::milliseconds(0);
+
+    uint64_t id = m_next_timer_id++;
+    m_timers[id] = timer_entry{ nullptr, home, home_ref, interval };
+    m_reactor.schedule(id, reactor::clock::now() + delay);
+    return id;
+}
+
+void rpc_client::cancel_timer(uint64_t id)
+{
+    auto it = m_timers.find(id);
+    /* sleeps aren't cancellable, the coroutine is waiting on them */
+    if (it == m_timers.end() || it->second.home == nullptr) {
+        return;
+    }
+
+    /* the heap entry stays behind and is skipped in fire_timer() once it comes due */
+    luaL_unref(it->second.home, LUA_REGISTRYINDEX, it->second.home_ref);
+    m_timers.erase(it);
 }
 
-void rpc_client::resume_coroutine(lua_State* co)
+void rpc_client::fire_timer(uint64_t id)
 {
-    int rc = lua_resume(co, 0);
+    auto it = m_timers.find(id);
+    if (it == m_timers.end()) {
+        return;
+    }
+
+    if (it->second.sleeper) {
+        lua_State* co = it->second.sleeper;
+        m_timers.erase(it);
+        resume_coroutine(co);
+        return;
+    }
+
+    timer_entry timer = it->second;
+    if (timer.interval.count() > 0) {
+        m_reactor.schedule(id, reactor::clock::now() + timer.interval);
+    } else {
+        m_timers.erase(it);
+    }
+
+    lua_State* co = lua_newthread(timer.home);
+    lua_pushvalue(timer.home, 1);
+    lua_xmove(timer.home, co, 1);
+    anchor_coroutine(co);
+    lua_pop(timer.home, 1);
+
+    /* a one-shot timer is done with its home thread, the coroutine no longer needs it either */
+    if (timer.interval.count() == 0) {
+        luaL_unref(timer.home, LUA_REGISTRYINDEX, timer.home_ref);
+    }
+
+    resume_coroutine(co);
+}
+
+void rpc_client::anchor_coroutine(lua_State* co)
+{
+    if (m_anchors.count(co)) {
+        return;
+    }
+    lua_pushthread(co);
+    m_anchors[co] = luaL_ref(co, LUA_REGISTRYINDEX);
+}
+
+void rpc_client::resume_coroutine(lua_State* co, int nargs)
+{
+    /* the old ref keeps it alive through the resume, if it waits on us again it takes a new one */
+    int anchor = LUA_NOREF;
+    if (auto it = m_anchors.find(co); it != m_anchors.end()) {
+        anchor = it->second;
+        m_anchors.erase(it);
+    }
+
+    lua_State* previous = m_running_coroutine;
+    m_running_coroutine = co;
+    int rc = lua_resume(co, nargs);
+    m_running_coroutine = previous;
+
     if (rc != LUA_OK && rc != LUA_YIELD) {
         const char* err = lua_tostring(co, -1);
         log_lua_error("coroutine error", err);
         lua_pop(co, 1);
     }
+    luaL_unref(co, LUA_REGISTRYINDEX, anchor);
 }
 
 void rpc_client::run(request_handler handler)
@@ -218,6 +501,17 @@ void rpc_client::run(request_handler handler)
         }
     };
 
+    auto drain_deferred_responses = [&]()
+    {
+        while (!m_deferred_responses.empty()) {
+            auto batch = std::move(m_deferred_responses);
+            m_deferred_responses.clear();
+            for (auto& response : batch) {
+                complete_async(response);
+            }
+        }
+    };
+
     auto drain_pending_coroutines = [&]()
     {
         while (!m_pending_coroutines.empty()) {
@@ -229,49 +523,58 @@ void rpc_client::run(request_handler handler)
         }
     };
 
+    const auto ipc_fd = static_cast<reactor::native_fd>(m_fd);
+    if (m_reactor.watch(ipc_fd, false) != reactor::watch_status::watching) {
+        fprintf(stderr, "[lua-host] failed to watch the IPC socket\n");
+        return;
+    }
+    m_in_run.store(true);
+
+    std::vector<reactor::fd_event> events;
+    std::vector<uint64_t> expired;
+
     while (m_connected.load()) {
-        drain_pending_coroutines();
+        /* either can produce more of the other, and both have to be empty before we block in poll */
+        while (!m_deferred_responses.empty() || !m_pending_coroutines.empty()) {
+            drain_deferred_responses();
+            drain_pending_coroutines();
+        }
 
-        /* build poll set: IPC fd first, then all plugin-watched fds */
-        std::vector<plugin_ipc::poll_fd_t> pfds;
-        pfds.reserve(1 + m_fd_watches.size());
+        /* everything this turn queued (logs, async requests) goes out as one write */
+        if (!flush()) break;
 
-        plugin_ipc::poll_fd_t ipc_pfd{};
-        ipc_pfd.fd = static_cast<decltype(ipc_pfd.fd)>(m_fd);
-        ipc_pfd.events = POLLIN;
-        pfds.push_back(ipc_pfd);
+        /* always-readable fds don't block the wait, they just get their turn after it like any other ready fd */
+        if (!m_reactor.wait(events, expired, m_next_turn_coroutines.empty() ? -1 : 0)) break;
 
-        for (const auto& [fd, co] : m_fd_watches) {
-            plugin_ipc::poll_fd_t pfd{};
-            pfd.fd = static_cast<decltype(pfd.fd)>(fd);
-            pfd.events = POLLIN;
-            pfds.push_back(pfd);
+        for (lua_State* co : std::exchange(m_next_turn_coroutines, {})) {
+            resume_coroutine(co);
         }
 
-#ifdef _WIN32
-        int ready = plugin_ipc::sys_poll(pfds.data(), static_cast<ULONG>(pfds.size()), -1);
-#else
-        int ready = plugin_ipc::sys_poll(pfds.data(), static_cast<nfds_t>(pfds.size()), -1);
-#endif
-        if (ready < 0) break;
-
-        /* resume any coroutines whose fd is now readable */
-        for (size_t i = 1; i < pfds.size(); ++i) {
-            if (pfds[i].revents & POLLIN) {
-                uintptr_t watched_fd = static_cast<uintptr_t>(pfds[i].fd);
-                auto it = m_fd_watches.find(watched_fd);
-                if (it != m_fd_watches.end()) {
-                    lua_State* co = it->second;
-                    m_fd_watches.erase(it);
-                    resume_coroutine(co);
-                }
+        for (uint64_t id : expired) {
+            fire_timer(id);
+        }
+
+        /* resume any coroutines whose fd is now readable (or closed, so they see the EOF instead of waiting forever) */
+        bool ipc_readable = false;
+        bool ipc_hangup = false;
+        for (const auto& ev : events) {
+            if (ev.fd == ipc_fd) {
+                ipc_readable = ev.readable;
+                ipc_hangup = ev.hangup;
+                continue;
+            }
+
+            auto it = m_fd_watches.find(ev.fd);
+            if (it != m_fd_watches.end()) {
+                lua_State* co = it->second;
+                m_fd_watches.erase(it);
+                resume_coroutine(co);
             }
         }
 
         /* handle IPC message if ready */
-        if (pfds[0].revents & (POLLHUP | POLLERR)) break;
-        if (!(pfds[0].revents & POLLIN)) {
-            drain_pending_coroutines();
+        if (ipc_hangup) break;
+        if (!ipc_readable) {
             continue;
         }
 
@@ -293,8 +596,16 @@ void rpc_client::run(request_handler handler)
             }
         } else if (type == plugin_ipc::TYPE_NOTIFY) {
             dispatch_notification(msg);
+        } else if (type == plugin_ipc::TYPE_RESPONSE) {
+            if (!complete_async(msg)) {
+                fprintf(stderr, "[lua-host] response for unknown request id=%d\n", msg.value("id", -1));
+            }
         }
         drain_deferred();
+        drain_deferred_responses();
         drain_pending_coroutines();
     }
+
+    m_in_run.store(false);
+    flush();
 }
@@ -30,37 +30,194 @@
 
 #include "mep/ffi_recorder.h"
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <optional>
+#include <tuple>
 
 namespace mep
 {
+namespace
+{
+constexpr std::string_view TRUNCATED_MARKER = "...";
+
+/** copy a payload into a slot, reusing the slot's buffer and cutting it at max_bytes */
+void assign_payload(std::string& dst, std::string_view src, std::size_t max_bytes)
+{
+    if (src.size() <= max_bytes) {
+        dst.assign(src);
+        return;
+    }
+    dst.assign(src.substr(0, max_bytes));
+    dst.append(TRUNCATED_MARKER);
+}
+
+/** per-thread lookaside for interned names, so the record path doesn't touch the shared table */
+struct intern_cache
+{
+    static constexpr std::size_t SIZE = 32;
+
+    std::array<std::string, SIZE> names;
+    std::array<uint32_t, SIZE> ids{};
+    std::size_t used = 0;
+    std::size_t next = 0;
+};
+} // namespace
+
+std::size_t latency_histogram::bucket_index(uint64_t micros)
+{
+    /** the first SUB_BUCKETS values are exact, past that every power of two is split into SUB_BUCKETS slots */
+    if (micros < SUB_BUCKETS) return static_cast<std::size_t>(micros);
+
+    const unsigned shift = static_cast<unsigned>(std::bit_width(micros)) - SUB_BUCKET_BITS - 1;
+    const std::size_t sub = static_cast<std::size_t>(micros >> shift) - SUB_BUCKETS;
+    return std::min<std::size_t>((shift + 1) * SUB_BUCKETS + sub, SUB_BUCKETS * MAGNITUDES - 1);
+}
+
+double latency_histogram::bucket_midpoint_ms(std::size_t index)
+{
+    if (index < SUB_BUCKETS) return static_cast<double>(index) / 1000.0;
+
+    const std::size_t shift = index / SUB_BUCKETS - 1;
+    const std::size_t sub = index % SUB_BUCKETS;
+    const double low = static_cast<double>(uint64_t{ SUB_BUCKETS + sub } << shift);
+    const double width = static_cast<double>(uint64_t{ 1 } << shift);
+    return (low + (width - 1.0) / 2.0) / 1000.0;
+}
+
+void latency_histogram::record(double duration_ms)
+{
+    const double micros = std::max(0.0, duration_ms * 1000.0);
+    ++m_buckets[bucket_index(static_cast<uint64_t>(std::min(micros, 1e15)))];
+    ++m_count;
+    m_max_ms = std::max(m_max_ms, duration_ms);
+}
+
+double latency_histogram::percentile(double q) const
+{
+    if (m_count == 0) return 0.0;
+
+    const auto rank = std::max<std::size_t>(static_cast<std::size_t>(std::ceil(q * static_cast<double>(m_count))), 1);
+    std::size_t seen = 0;
+    for (std::size_t i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) return std::min(bucket_midpoint_ms(i), m_max_ms);
+    }
+    return m_max_ms;
+}
+
 ffi_recorder& ffi_recorder::instance()
 {
     static ffi_recorder inst;
     return inst;
 }
 
-void ffi_recorder::record(ffi_call_entry entry)
+ffi_recorder::ffi_recorder() : m_aggregator([this] { aggregate_loop(); })
 {
+}
+
+ffi_recorder::~ffi_recorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_stop = true;
+    }
+    m_wake_cv.notify_all();
+    if (m_aggregator.joinable()) m_aggregator.join();
+}
+
+ffi_recorder::thread_ring& ffi_recorder::local_ring()
+{
+    /** the holder only flags the ring on thread exit, the registry keeps it alive until it's been drained */
+    struct holder
     {
-        std::lock_guard<std::mutex> lock(m_ring_mutex);
-        if (m_ring.size() < RING_SIZE) {
-            m_ring.push_back(entry);
-        } else {
-            m_ring[m_write_pos % RING_SIZE] = entry;
+        std::shared_ptr<thread_ring> ring;
+        ~holder()
+        {
+            if (ring) ring->retired.store(true, std::memory_order_release);
         }
-        ++m_write_pos;
+    };
+    thread_local holder local;
+
+    if (!local.ring) {
+        local.ring = std::make_shared<thread_ring>();
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        m_rings.push_back(local.ring);
+    }
+    return *local.ring;
+}
+
+uint32_t ffi_recorder::intern(std::string_view name)
+{
+    thread_local intern_cache cache;
+
+    for (std::size_t i = 0; i < cache.used; ++i) {
+        if (cache.names[i] == name) return cache.ids[i];
+    }
+
+    std::optional<uint32_t> id;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_intern_mutex);
+        if (auto it = m_intern_ids.find(std::string(name)); it != m_intern_ids.end()) id = it->second;
+    }
+    if (!id) {
+        std::unique_lock<std::shared_mutex> lock(m_intern_mutex);
+        auto [it, inserted] = m_intern_ids.try_emplace(std::string(name), static_cast<uint32_t>(m_intern_names.size()));
+        if (inserted) m_intern_names.emplace_back(name);
+        id = it->second;
+    }
+
+    const std::size_t pos = cache.used < intern_cache::SIZE ? cache.used++ : (cache.next++ % intern_cache::SIZE);
+    cache.names[pos].assign(name);
+    cache.ids[pos] = *id;
+    return *id;
+}
+
+void ffi_recorder::wake_aggregator()
+{
+    m_wake_cv.notify_one();
+}
+
+void ffi_recorder::record(const ffi_call_sample& sample)
+{
+    thread_ring& ring = local_ring();
+    const std::size_t head = ring.head.load(std::memory_order_relaxed);
+    const std::size_t pending = head - ring.tail.load(std::memory_order_acquire);
+
+    if (pending >= THREAD_RING_SIZE) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        slot& s = ring.slots[head % THREAD_RING_SIZE];
+        s.plugin = intern(sample.plugin);
+        s.method = intern(sample.method);
+        s.direction = intern(sample.direction);
+        s.caller = intern(sample.caller);
+        s.duration_ms = sample.duration_ms;
+        s.timestamp = sample.timestamp;
+        assign_payload(s.args, sample.args, MAX_PAYLOAD_BYTES);
+        assign_payload(s.result, sample.result, MAX_PAYLOAD_BYTES);
+        ring.head.store(head + 1, std::memory_order_release);
+
+        if (pending + 1 == THREAD_RING_SIZE / 2) wake_aggregator();
     }
 
+    if (m_listener_count.load(std::memory_order_acquire) == 0) return;
+
     std::vector<listener_fn> targets;
     {
         std::lock_guard<std::mutex> lock(m_listener_mutex);
         for (const auto& [id, pair] : m_listeners) {
-            if (pair.first == entry.plugin) {
+            if (pair.first == sample.plugin) {
                 targets.push_back(pair.second);
             }
         }
     }
+    if (targets.empty()) return;
 
+    const ffi_call_entry entry{
+        std::string(sample.plugin), std::string(sample.method), std::string(sample.direction), std::string(sample.args), std::string(sample.result),
+        sample.duration_ms,         sample.timestamp,           std::string(sample.caller),
+    };
     for (const auto& fn : targets) {
         try {
             fn(entry);
@@ -69,9 +226,80 @@ void ffi_recorder::record(ffi_call_entry entry)
     }
 }
 
+void ffi_recorder::record(const ffi_call_entry& entry)
+{
+    record(ffi_call_sample{ entry.plugin, entry.method, entry.direction, entry.args, entry.result, entry.duration_ms, entry.timestamp, entry.caller });
+}
+
+void ffi_recorder::drain_locked() const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        m_drain_snapshot.assign(m_rings.begin(), m_rings.end());
+    }
+
+    bool any_retired = false;
+    {
+        std::shared_lock<std::shared_mutex> names(m_intern_mutex);
+        for (const auto& ring : m_drain_snapshot) {
+            /** read retired first, so a retired ring is known to be empty once drained */
+            any_retired |= ring->retired.load(std::memory_order_acquire);
+
+            const std::size_t tail = ring->tail.load(std::memory_order_relaxed);
+            const std::size_t head = ring->head.load(std::memory_order_acquire);
+            for (std::size_t i = tail; i != head; ++i) {
+                const slot& s = ring->slots[i % THREAD_RING_SIZE];
+
+                if (m_ring.size() < RING_SIZE) m_ring.emplace_back();
+                ffi_call_entry& e = m_ring[m_write_pos % RING_SIZE];
+                ++m_write_pos;
+
+                e.plugin.assign(m_intern_names[s.plugin]);
+                e.method.assign(m_intern_names[s.method]);
+                e.direction.assign(m_intern_names[s.direction]);
+                e.caller.assign(m_intern_names[s.caller]);
+                e.args.assign(s.args);
+                e.result.assign(s.result);
+                e.duration_ms = s.duration_ms;
+                e.timestamp = s.timestamp;
+
+                m_histograms[histogram_key{ s.plugin, s.method, s.direction }].record(s.duration_ms);
+            }
+            ring->tail.store(head, std::memory_order_release);
+        }
+    }
+    m_drain_snapshot.clear();
+
+    if (any_retired) {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        std::erase_if(m_rings, [](const std::shared_ptr<thread_ring>& ring)
+        {
+            return ring->retired.load(std::memory_order_acquire) &&
+                   ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+        });
+    }
+}
+
+void ffi_recorder::aggregate_loop()
+{
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    while (!m_stop) {
+        m_wake_cv.wait_for(lock, AGGREGATE_INTERVAL);
+        if (m_stop) break;
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> aggregate(m_aggregate_mutex);
+            drain_locked();
+        }
+        lock.lock();
+    }
+}
+
 std::vector<ffi_call_entry> ffi_recorder::get_recent(const std::string& plugin, std::size_t max) const
 {
-    std::lock_guard<std::mutex> lock(m_ring_mutex);
+    std::lock_guard<std::mutex> lock(m_aggregate_mutex);
+    drain_locked();
 
     std::vector<ffi_call_entry> out;
     out.reserve(std::min(max, m_ring.size()));
@@ -91,11 +319,77 @@ std::vector<ffi_call_entry> ffi_recorder::get_recent(const std::string& plugin,
     return out;
 }
 
+ffi_latency_stats ffi_recorder::get_latency(const std::string& plugin) const
+{
+    std::vector<double> durations;
+    {
+        std::lock_guard<std::mutex> lock(m_aggregate_mutex);
+        drain_locked();
+
+        durations.reserve(m_ring.size());
+        for (const auto& e : m_ring) {
+            if (plugin.empty() || e.plugin == plugin) {
+                durations.push_back(e.duration_ms);
+            }
+        }
+    }
+
+    ffi_latency_stats stats;
+    stats.samples = durations.size();
+    if (durations.empty()) return stats;
+
+    /** nearest-rank percentile */
+    auto percentile = [&](double p)
+    {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(durations.size())));
+        const auto nth = durations.begin() + static_cast<std::ptrdiff_t>(std::max<std::size_t>(rank, 1) - 1);
+        std::nth_element(durations.begin(), nth, durations.end());
+        return *nth;
+    };
+
+    stats.p50_ms = percentile(0.50);
+    stats.p90_ms = percentile(0.90);
+    stats.p99_ms = percentile(0.99);
+    stats.max_ms = *std::max_element(durations.begin(), durations.end());
+    return stats;
+}
+
+std::vector<ffi_method_latency> ffi_recorder::get_method_latency(const std::string& plugin) const
+{
+    std::vector<ffi_method_latency> out;
+
+    std::lock_guard<std::mutex> lock(m_aggregate_mutex);
+    drain_locked();
+
+    std::shared_lock<std::shared_mutex> names(m_intern_mutex);
+    auto plugin_id = m_intern_ids.find(plugin);
+    if (plugin_id == m_intern_ids.end()) return out;
+
+    for (const auto& [key, histogram] : m_histograms) {
+        if (key.plugin != plugin_id->second) continue;
+
+        ffi_latency_stats stats;
+        stats.samples = histogram.count();
+        stats.p50_ms = histogram.percentile(0.50);
+        stats.p90_ms = histogram.percentile(0.90);
+        stats.p99_ms = histogram.percentile(0.99);
+        stats.max_ms = histogram.max();
+        out.push_back({ m_intern_names[key.method], m_intern_names[key.direction], stats });
+    }
+
+    std::sort(out.begin(), out.end(), [](const ffi_method_latency& a, const ffi_method_latency& b)
+    {
+        return std::tie(a.method, a.direction) < std::tie(b.method, b.direction);
+    });
+    return out;
+}
+
 int ffi_recorder::add_listener(const std::string& plugin, listener_fn fn)
 {
     int id = ++m_id_counter;
     std::lock_guard<std::mutex> lock(m_listener_mutex);
     m_listeners[id] = { plugin, std::move(fn) };
+    m_listener_count.store(m_listeners.size(), std::memory_order_release);
     return id;
 }
 
@@ -103,5 +397,6 @@ void ffi_recorder::remove_listener(int id)
 {
     std::lock_guard<std::mutex> lock(m_listener_mutex);
     m_listeners.erase(id);
+    m_listener_count.store(m_listeners.size(), std::memory_order_release);
 }
 } // namespace mep
@@ -94,6 +94,30 @@ const char* level_str(logger_base::log_level lv)
     }
 }
 
+json latency_to_json(const ffi_latency_stats& latency)
+{
+    return {
+        { "samples", latency.samples },
+        { "p50_ms",  latency.p50_ms  },
+        { "p90_ms",  latency.p90_ms  },
+        { "p99_ms",  latency.p99_ms  },
+        { "max_ms",  latency.max_ms  },
+    };
+}
+
+json method_latency_to_json(const std::vector<ffi_method_latency>& methods)
+{
+    json out = json::array();
+    for (const auto& m : methods) {
+        out.push_back({
+            { "method",    m.method                   },
+            { "direction", m.direction                },
+            { "latency",   latency_to_json(m.stats)   },
+        });
+    }
+    return out;
+}
+
 struct stream_sub_state
 {
     std::atomic<bool> cancelled{ false };
@@ -439,6 +463,7 @@ void register_mep_handlers(router& router, std::shared_ptr<plugin_loader> loader
                 { "rss_bytes",   metrics.rss_bytes   },
                 { "heap_bytes",  metrics.heap_bytes  },
                 { "cpu_percent", metrics.cpu_percent },
+                { "requests",    metrics.requests    },
             };
             return response_t::ok(req.id, params);
         }
@@ -452,11 +477,13 @@ void register_mep_handlers(router& router, std::shared_ptr<plugin_loader> loader
             size_t rss = 0;
             size_t heap = 0;
             double cpu = 0.0;
+            PluginProcess::request_queue_metrics requests;
             auto it = all_metrics.find(p.plugin_name);
             if (it != all_metrics.end()) {
                 rss = it->second.rss_bytes;
                 heap = it->second.heap_bytes;
                 cpu = it->second.cpu_percent;
+                requests = it->second.requests;
             }
 
             list.push_back({
@@ -464,6 +491,7 @@ void register_mep_handlers(router& router, std::shared_ptr<plugin_loader> loader
                 { "rss_bytes",   rss           },
                 { "heap_bytes",  heap          },
                 { "cpu_percent", cpu           },
+                { "requests",    requests      },
             });
         }
 
@@ -531,9 +559,28 @@ void register_mep_handlers(router& router, std::shared_ptr<plugin_loader> loader
         });
 
         listener_id_r->store(id);
+
+        const auto latency = recorder.get_latency(*name);
         const json params = {
-            { "subscription_id", sub_id  },
-            { "calls",           initial },
+            { "subscription_id", sub_id                                                        },
+            { "calls",           initial                                                       },
+            { "latency",         latency_to_json(latency)                                      },
+            { "methods",         method_latency_to_json(recorder.get_method_latency(*name)) },
+        };
+        return response_t::ok(req.id, params);
+    });
+
+    /** per-method latency histograms over every call since startup, without subscribing to the call stream */
+    router.register_handler("plugin.ffi.latency", [](const request_t& req, const std::shared_ptr<client_context>&)
+    {
+        auto name = require_string(req, "name");
+        if (!name) return response_t::err(req.id, "missing required param: name");
+
+        auto& recorder = ffi_recorder::instance();
+        const json params = {
+            { "latency", latency_to_json(recorder.get_latency(*name))                 },
+            { "methods", method_latency_to_json(recorder.get_method_latency(*name)) },
+            { "dropped", recorder.dropped()                                           },
         };
         return response_t::ok(req.id, params);
     });
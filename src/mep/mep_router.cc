@@ -35,16 +35,25 @@ namespace mep
 
 void router::register_handler(const std::string& method, handler_fn handler)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_handlers[method] = std::move(handler);
+    std::lock_guard<std::mutex> lock(m_register_mutex);
+
+    const handler_table* current = m_handlers.load(std::memory_order_acquire);
+    auto next = current ? std::make_unique<handler_table>(*current) : std::make_unique<handler_table>();
+    (*next)[method] = std::move(handler);
+
+    m_handlers.store(next.get(), std::memory_order_release);
+    m_tables.push_back(std::move(next));
 }
 
 response_t router::dispatch(const request_t& request, const std::shared_ptr<client_context>& ctx) const
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    const handler_table* handlers = m_handlers.load(std::memory_order_acquire);
+    if (!handlers) {
+        return response_t::err(request.id, "unknown method: " + request.method);
+    }
 
-    auto it = m_handlers.find(request.method);
-    if (it == m_handlers.end()) {
+    auto it = handlers->find(request.method);
+    if (it == handlers->end()) {
         return response_t::err(request.id, "unknown method: " + request.method);
     }
 
@@ -29,16 +29,22 @@
  */
 
 #include "mep/mep_server.h"
+#include "millennium/logger.h"
+#include "millennium/thread_pool.h"
 
 #ifdef _WIN32
 #include <winsock2.h>
+#include <ws2tcpip.h>
 #include <afunix.h>
 #pragma comment(lib, "ws2_32.lib")
 #else
 #if defined(__APPLE__)
 #include <sys/endian.h>
+#include <sys/event.h>
 #else
 #include <endian.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #endif
 #include <fcntl.h>
 #include <sys/socket.h>
@@ -46,9 +52,11 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -88,41 +96,38 @@ namespace
 
 using socket_t = server::socket_t;
 
-bool recv_all(socket_t fd, void* buf, std::size_t n)
+/** bytes pulled off a client socket per recv() */
+constexpr std::size_t READ_CHUNK = 64u * 1024u;
+
+/** outbound buffers that grew past this during a burst are given back once they drain */
+constexpr std::size_t OUTBOUND_KEEP_CAPACITY = 1u * 1024u * 1024u;
+
+/** the last socket call failed only because it would have blocked */
+bool would_block()
 {
-    std::size_t total = 0;
-    while (total < n) {
 #ifdef _WIN32
-        int r = ::recv(fd, static_cast<char*>(buf) + total, static_cast<int>(n - total), 0);
+    const int err = WSAGetLastError();
+    return err == WSAEWOULDBLOCK || err == WSAEINTR;
 #else
-        ssize_t r = ::recv(fd, static_cast<char*>(buf) + total, n - total, 0);
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
 #endif
-        if (r <= 0) return false;
-        total += static_cast<std::size_t>(r);
-    }
-    return true;
 }
 
-bool send_all(socket_t fd, const void* buf, std::size_t n)
+void set_noinherit([[maybe_unused]] socket_t fd)
 {
-    std::size_t total = 0;
-    while (total < n) {
 #ifdef _WIN32
-        int s = ::send(fd, static_cast<const char*>(buf) + total, static_cast<int>(n - total), 0);
 #else
-        ssize_t s = ::send(fd, static_cast<const char*>(buf) + total, n - total, MSG_NOSIGNAL);
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
 #endif
-        if (s <= 0) return false;
-        total += static_cast<std::size_t>(s);
-    }
-    return true;
 }
 
-void set_noinherit([[maybe_unused]] socket_t fd)
+void set_nonblocking(socket_t fd)
 {
 #ifdef _WIN32
+    u_long mode = 1;
+    ::ioctlsocket(fd, FIONBIO, &mode);
 #else
-    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
 #endif
 }
 
@@ -140,11 +145,17 @@ struct client_subscriptions
     std::mutex mutex;
     std::unordered_map<std::string, std::function<void()>> cancel_map;
     std::atomic<int> id_counter{ 0 };
+    bool closed = false;
 
     std::string subscribe(std::function<void()> cancel_fn, socket_t client_fd)
     {
         std::string id = "sub-" + std::to_string(client_fd) + "-" + std::to_string(++id_counter);
         std::lock_guard<std::mutex> lock(mutex);
+        /** the client went away while its subscribe request was being handled */
+        if (closed) {
+            cancel_fn();
+            return id;
+        }
         cancel_map[id] = std::move(cancel_fn);
         return id;
     }
@@ -162,6 +173,7 @@ struct client_subscriptions
     void cancel_all()
     {
         std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
         for (auto& [id, fn] : cancel_map)
             fn();
         cancel_map.clear();
@@ -170,6 +182,370 @@ struct client_subscriptions
 
 } // namespace
 
+/**
+ * readiness notification for the reactor. interest changes only ever come from the reactor thread,
+ * wake() can be called from anywhere to get a blocked wait() to return.
+ */
+class server::poller
+{
+  public:
+    enum : unsigned
+    {
+        READABLE = 1 << 0,
+        WRITABLE = 1 << 1,
+        CLOSED = 1 << 2,
+    };
+
+    struct event
+    {
+        socket_t fd;
+        unsigned flags;
+    };
+
+    poller();
+    ~poller();
+
+    poller(const poller&) = delete;
+    poller& operator=(const poller&) = delete;
+
+    void add(socket_t fd, unsigned interest);
+    void modify(socket_t fd, unsigned interest);
+    void remove(socket_t fd);
+
+    /** block until something is ready or wake() is called. false if polling itself failed */
+    bool wait(std::vector<event>& out);
+    void wake();
+
+  private:
+    static constexpr int MAX_EVENTS = 64;
+
+#if defined(_WIN32)
+    std::vector<WSAPOLLFD> m_fds;
+    socket_t m_wake_rx = -1;
+    socket_t m_wake_tx = -1;
+#elif defined(__APPLE__)
+    int m_kq = -1;
+#else
+    int m_epoll_fd = -1;
+    int m_wake_fd = -1;
+
+    static uint32_t to_epoll_events(unsigned interest)
+    {
+        return ((interest & READABLE) ? EPOLLIN : 0u) | ((interest & WRITABLE) ? EPOLLOUT : 0u);
+    }
+#endif
+};
+
+#if defined(_WIN32)
+
+/** windows has no eventfd or socketpair, so wake-ups go through a loopback tcp connection to ourselves */
+server::poller::poller()
+{
+    const socket_t listener = static_cast<socket_t>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (listener < 0) throw std::system_error(WSAGetLastError(), std::system_category(), "mep: wake socket()");
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int addr_len = sizeof(addr);
+
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR || ::listen(listener, 1) == SOCKET_ERROR ||
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len) == SOCKET_ERROR) {
+        const int err = WSAGetLastError();
+        close_socket(listener);
+        throw std::system_error(err, std::system_category(), "mep: wake listen()");
+    }
+
+    m_wake_tx = static_cast<socket_t>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (m_wake_tx < 0 || ::connect(m_wake_tx, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+        const int err = WSAGetLastError();
+        if (m_wake_tx >= 0) close_socket(m_wake_tx);
+        close_socket(listener);
+        throw std::system_error(err, std::system_category(), "mep: wake connect()");
+    }
+
+    m_wake_rx = static_cast<socket_t>(::accept(listener, nullptr, nullptr));
+    close_socket(listener);
+    if (m_wake_rx < 0) {
+        const int err = WSAGetLastError();
+        close_socket(m_wake_tx);
+        throw std::system_error(err, std::system_category(), "mep: wake accept()");
+    }
+
+    set_nonblocking(m_wake_rx);
+    set_nonblocking(m_wake_tx);
+    m_fds.push_back({ static_cast<SOCKET>(m_wake_rx), POLLRDNORM, 0 });
+}
+
+server::poller::~poller()
+{
+    close_socket(m_wake_rx);
+    close_socket(m_wake_tx);
+}
+
+void server::poller::add(socket_t fd, unsigned interest)
+{
+    m_fds.push_back({ static_cast<SOCKET>(fd), 0, 0 });
+    modify(fd, interest);
+}
+
+void server::poller::modify(socket_t fd, unsigned interest)
+{
+    for (auto& pfd : m_fds) {
+        if (pfd.fd != static_cast<SOCKET>(fd)) continue;
+        pfd.events = static_cast<SHORT>(((interest & READABLE) ? POLLRDNORM : 0) | ((interest & WRITABLE) ? POLLWRNORM : 0));
+        return;
+    }
+}
+
+void server::poller::remove(socket_t fd)
+{
+    std::erase_if(m_fds, [fd](const WSAPOLLFD& pfd) { return pfd.fd == static_cast<SOCKET>(fd); });
+}
+
+bool server::poller::wait(std::vector<event>& out)
+{
+    out.clear();
+
+    if (::WSAPoll(m_fds.data(), static_cast<ULONG>(m_fds.size()), -1) == SOCKET_ERROR) {
+        return false;
+    }
+
+    for (auto& pfd : m_fds) {
+        if (!pfd.revents) continue;
+
+        if (pfd.fd == static_cast<SOCKET>(m_wake_rx)) {
+            char drain[64];
+            while (::recv(m_wake_rx, drain, sizeof(drain), 0) > 0) {
+            }
+        } else {
+            unsigned flags = 0;
+            if (pfd.revents & POLLRDNORM) flags |= READABLE;
+            if (pfd.revents & POLLWRNORM) flags |= WRITABLE;
+            if (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) flags |= CLOSED;
+            out.push_back({ static_cast<socket_t>(pfd.fd), flags });
+        }
+        pfd.revents = 0;
+    }
+    return true;
+}
+
+void server::poller::wake()
+{
+    const char byte = 1;
+    ::send(m_wake_tx, &byte, 1, 0); /** a full pipe already has a wake-up pending */
+}
+
+#elif defined(__APPLE__)
+
+server::poller::poller()
+{
+    m_kq = ::kqueue();
+    if (m_kq < 0) throw std::system_error(errno, std::generic_category(), "mep: kqueue()");
+    ::fcntl(m_kq, F_SETFD, FD_CLOEXEC);
+
+    struct kevent ev;
+    EV_SET(&ev, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+    if (::kevent(m_kq, &ev, 1, nullptr, 0, nullptr) < 0) {
+        const int err = errno;
+        ::close(m_kq);
+        throw std::system_error(err, std::generic_category(), "mep: kevent(EVFILT_USER)");
+    }
+}
+
+server::poller::~poller()
+{
+    ::close(m_kq);
+}
+
+void server::poller::add(socket_t fd, unsigned interest)
+{
+    modify(fd, interest);
+}
+
+void server::poller::modify(socket_t fd, unsigned interest)
+{
+    struct kevent changes[2];
+    EV_SET(&changes[0], fd, EVFILT_READ, EV_ADD | ((interest & READABLE) ? EV_ENABLE : EV_DISABLE), 0, 0, nullptr);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, EV_ADD | ((interest & WRITABLE) ? EV_ENABLE : EV_DISABLE), 0, 0, nullptr);
+    ::kevent(m_kq, changes, 2, nullptr, 0, nullptr);
+}
+
+void server::poller::remove(socket_t fd)
+{
+    struct kevent changes[2];
+    EV_SET(&changes[0], fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+    ::kevent(m_kq, changes, 2, nullptr, 0, nullptr);
+}
+
+bool server::poller::wait(std::vector<event>& out)
+{
+    out.clear();
+
+    struct kevent events[MAX_EVENTS];
+    const int n = ::kevent(m_kq, nullptr, 0, events, MAX_EVENTS, nullptr);
+    if (n < 0) return errno == EINTR;
+
+    for (int i = 0; i < n; ++i) {
+        if (events[i].filter == EVFILT_USER) continue;
+
+        unsigned flags = events[i].filter == EVFILT_READ ? READABLE : WRITABLE;
+        if (events[i].flags & EV_ERROR) flags |= CLOSED;
+        out.push_back({ static_cast<socket_t>(events[i].ident), flags });
+    }
+    return true;
+}
+
+void server::poller::wake()
+{
+    struct kevent ev;
+    EV_SET(&ev, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+    ::kevent(m_kq, &ev, 1, nullptr, 0, nullptr);
+}
+
+#else
+
+server::poller::poller()
+{
+    m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll_fd < 0) throw std::system_error(errno, std::generic_category(), "mep: epoll_create1()");
+
+    m_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake_fd < 0) {
+        const int err = errno;
+        ::close(m_epoll_fd);
+        throw std::system_error(err, std::generic_category(), "mep: eventfd()");
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_wake_fd;
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &ev);
+}
+
+server::poller::~poller()
+{
+    ::close(m_wake_fd);
+    ::close(m_epoll_fd);
+}
+
+void server::poller::add(socket_t fd, unsigned interest)
+{
+    epoll_event ev{};
+    ev.events = to_epoll_events(interest);
+    ev.data.fd = fd;
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+void server::poller::modify(socket_t fd, unsigned interest)
+{
+    epoll_event ev{};
+    ev.events = to_epoll_events(interest);
+    ev.data.fd = fd;
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void server::poller::remove(socket_t fd)
+{
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+bool server::poller::wait(std::vector<event>& out)
+{
+    out.clear();
+
+    epoll_event events[MAX_EVENTS];
+    const int n = ::epoll_wait(m_epoll_fd, events, MAX_EVENTS, -1);
+    if (n < 0) return errno == EINTR;
+
+    for (int i = 0; i < n; ++i) {
+        if (events[i].data.fd == m_wake_fd) {
+            uint64_t count;
+            [[maybe_unused]] ssize_t _ = ::read(m_wake_fd, &count, sizeof(count));
+            continue;
+        }
+
+        unsigned flags = 0;
+        if (events[i].events & EPOLLIN) flags |= READABLE;
+        if (events[i].events & EPOLLOUT) flags |= WRITABLE;
+        if (events[i].events & (EPOLLHUP | EPOLLERR)) flags |= CLOSED;
+        out.push_back({ events[i].data.fd, flags });
+    }
+    return true;
+}
+
+void server::poller::wake()
+{
+    const uint64_t one = 1;
+    [[maybe_unused]] ssize_t _ = ::write(m_wake_fd, &one, sizeof(one));
+}
+
+#endif
+
+struct server::connection
+{
+    explicit connection(socket_t client_fd) : fd(client_fd)
+    {
+    }
+
+    const socket_t fd;
+    std::shared_ptr<client_subscriptions> subs = std::make_shared<client_subscriptions>();
+    std::shared_ptr<client_context> ctx = std::make_shared<client_context>();
+
+    /** guards everything below that's shared with workers and pushing threads */
+    std::mutex mutex;
+    bool closed = false;
+    bool evicted = false;
+    bool close_after_flush = false;
+
+    /** length-prefixed frames not yet written, starting at outbound_offset */
+    std::vector<uint8_t> outbound;
+    std::size_t outbound_offset = 0;
+
+    /** frames read but not handled yet. one worker at a time drains them, so responses keep request order */
+    std::deque<std::vector<uint8_t>> requests;
+    bool dispatching = false;
+    bool paused = false;
+
+    /** reactor thread only */
+    std::vector<uint8_t> inbound;
+    unsigned interest = 0;
+
+    std::size_t pending_outbound() const
+    {
+        return outbound.size() - outbound_offset;
+    }
+
+    /** write as much pending output as the socket takes without blocking. call with mutex held, false on a socket error */
+    bool flush_locked()
+    {
+        while (pending_outbound() > 0) {
+#ifdef _WIN32
+            int s = ::send(fd, reinterpret_cast<const char*>(outbound.data() + outbound_offset), static_cast<int>(pending_outbound()), 0);
+#else
+            ssize_t s = ::send(fd, outbound.data() + outbound_offset, pending_outbound(), MSG_NOSIGNAL);
+#endif
+            if (s > 0) {
+                outbound_offset += static_cast<std::size_t>(s);
+                continue;
+            }
+            if (s < 0 && would_block()) break;
+            return false;
+        }
+
+        if (outbound_offset == outbound.size()) {
+            outbound.clear();
+            outbound_offset = 0;
+            if (outbound.capacity() > OUTBOUND_KEEP_CAPACITY) outbound.shrink_to_fit();
+        } else if (outbound_offset > outbound.size() / 2) {
+            outbound.erase(outbound.begin(), outbound.begin() + static_cast<std::ptrdiff_t>(outbound_offset));
+            outbound_offset = 0;
+        }
+        return true;
+    }
+};
+
 server::server(router& r, std::string socket_path) : m_router(r), m_socket_path(std::move(socket_path))
 {
 }
@@ -177,8 +553,6 @@ server::server(router& r, std::string socket_path) : m_router(r), m_socket_path(
 server::~server()
 {
     stop();
-
-    if (m_accept_thread.joinable()) m_accept_thread.detach();
 }
 
 void server::start()
@@ -245,28 +619,56 @@ void server::start()
     }
 #endif
 
-    m_accept_thread = std::thread(&server::accept_loop, this);
+    set_nonblocking(m_server_fd);
+
+    try {
+        std::lock_guard<std::mutex> lock(m_dirty_mutex);
+        m_poller = std::make_unique<poller>();
+        m_poller->add(m_server_fd, poller::READABLE);
+    } catch (...) {
+        close_socket(m_server_fd);
+        m_server_fd = -1;
+        m_running = false;
+        throw;
+    }
+
+    /**
+     * at most one task per client is ever queued (see queue_request), so the pool's queue is bounded by the client count.
+     * the per-client bound is MAX_PENDING_REQUESTS, past which we stop reading from that client.
+     */
+    m_workers = std::make_unique<thread_pool>(WORKER_THREADS);
+    m_reactor_thread = std::thread(&server::reactor_loop, this);
 }
 
 void server::stop()
 {
     if (!m_running.exchange(false)) return;
 
+    {
+        std::lock_guard<std::mutex> lock(m_dirty_mutex);
+        if (m_poller) m_poller->wake();
+    }
+
+    /** the reactor closes every client on its way out, then in-flight requests finish against closed connections */
+    if (m_reactor_thread.joinable()) m_reactor_thread.join();
+    m_workers.reset();
+
+    {
+        std::lock_guard<std::mutex> lock(m_dirty_mutex);
+        m_poller.reset();
+        m_dirty.clear();
+    }
+
     if (m_server_fd >= 0) {
-#ifdef _WIN32
-        ::shutdown(m_server_fd, SD_BOTH);
         close_socket(m_server_fd);
+#ifdef _WIN32
         ::DeleteFileA(m_socket_path.c_str());
 #else
-        ::shutdown(m_server_fd, SHUT_RDWR);
-        close_socket(m_server_fd);
         ::unlink(m_socket_path.c_str());
 #endif
         m_server_fd = -1;
     }
 
-    if (m_accept_thread.joinable()) m_accept_thread.join();
-
 #ifdef _WIN32
     WSACleanup();
 #endif
@@ -277,84 +679,313 @@ bool server::is_running() const noexcept
     return m_running.load();
 }
 
-void server::accept_loop()
+void server::reactor_loop()
 {
+    std::vector<poller::event> events;
+    std::vector<std::weak_ptr<connection>> dirty;
+
     while (m_running) {
-        socket_t client_fd = static_cast<socket_t>(::accept(m_server_fd, nullptr, nullptr));
-        if (client_fd < 0) {
-            if (!m_running) break;
-            continue;
+        if (!m_poller->wait(events)) {
+            LOG_ERROR("mep: polling failed, the server stops accepting requests");
+            break;
+        }
+
+        for (const auto& ev : events) {
+            if (ev.fd == m_server_fd) {
+                accept_clients();
+                continue;
+            }
+
+            auto it = m_clients.find(ev.fd);
+            if (it == m_clients.end()) continue;
+            const std::shared_ptr<connection> conn = it->second;
+
+            /** read before acting on a hangup, the peer may have sent a last request before closing */
+            if (ev.flags & poller::READABLE) read_client(conn);
+            if (!m_clients.contains(ev.fd)) continue;
+
+            if (ev.flags & poller::CLOSED) {
+                close_client(conn);
+            } else if (ev.flags & poller::WRITABLE) {
+                flush_client(conn);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_dirty_mutex);
+            dirty.swap(m_dirty);
+        }
+        for (const auto& weak_conn : dirty) {
+            auto conn = weak_conn.lock();
+            if (!conn) continue;
+
+            auto it = m_clients.find(conn->fd);
+            if (it != m_clients.end() && it->second == conn) update_interest(conn);
         }
+        dirty.clear();
+    }
+
+    while (!m_clients.empty()) {
+        const std::shared_ptr<connection> conn = m_clients.begin()->second;
+        close_client(conn);
+    }
+}
+
+void server::accept_clients()
+{
+    while (true) {
+        socket_t client_fd = static_cast<socket_t>(::accept(m_server_fd, nullptr, nullptr));
+        if (client_fd < 0) return;
 
         set_noinherit(client_fd);
+        set_nonblocking(client_fd);
+
+        auto conn = std::make_shared<connection>(client_fd);
+        const std::weak_ptr<connection> weak_conn = conn;
 
-        std::thread([this, client_fd]()
+        conn->ctx->push = [this, weak_conn](const nlohmann::json& event) -> bool
         {
-            handle_client(client_fd);
-            close_socket(client_fd);
-        }).detach();
+            auto c = weak_conn.lock();
+            return c && send_to(c, nlohmann::json::to_msgpack(event));
+        };
+        conn->ctx->subscribe = [subs = conn->subs, client_fd](std::function<void()> cancel_fn) -> std::string
+        {
+            return subs->subscribe(std::move(cancel_fn), client_fd);
+        };
+        conn->ctx->unsubscribe = [subs = conn->subs](const std::string& id) -> bool
+        {
+            return subs->unsubscribe(id);
+        };
+
+        m_clients[client_fd] = conn;
+        conn->interest = poller::READABLE;
+        m_poller->add(client_fd, conn->interest);
     }
 }
 
-void server::handle_client(socket_t fd)
+void server::read_client(const std::shared_ptr<connection>& conn)
 {
-    auto subs = std::make_shared<client_subscriptions>();
-    auto ctx = std::make_shared<client_context>();
+    auto& in = conn->inbound;
 
-    ctx->push = [this, fd](const nlohmann::json& event) -> bool
+    /** one chunk per readiness event keeps a flooding client from starving the others, the poller reports it again */
+    const std::size_t old_size = in.size();
+    in.resize(old_size + READ_CHUNK);
+#ifdef _WIN32
+    const int n = ::recv(conn->fd, reinterpret_cast<char*>(in.data() + old_size), static_cast<int>(READ_CHUNK), 0);
+#else
+    const ssize_t n = ::recv(conn->fd, in.data() + old_size, READ_CHUNK, 0);
+#endif
+    if (n <= 0) {
+        in.resize(old_size);
+        if (n < 0 && would_block()) return;
+        close_client(conn);
+        return;
+    }
+    in.resize(old_size + static_cast<std::size_t>(n));
+
+    std::size_t pos = 0;
+    while (in.size() - pos >= sizeof(uint32_t)) {
+        uint32_t len_le;
+        std::memcpy(&len_le, in.data() + pos, sizeof(len_le));
+
+        const uint32_t len = le32toh_compat(len_le);
+        if (len == 0 || len > MAX_MESSAGE_SIZE) {
+            close_client(conn);
+            return;
+        }
+        if (in.size() - pos - sizeof(uint32_t) < len) break;
+
+        const auto first = in.begin() + static_cast<std::ptrdiff_t>(pos + sizeof(uint32_t));
+        queue_request(conn, std::vector<uint8_t>(first, first + len));
+        pos += sizeof(uint32_t) + len;
+
+        if (!m_clients.contains(conn->fd)) return;
+    }
+    in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(pos));
+}
+
+void server::flush_client(const std::shared_ptr<connection>& conn)
+{
     {
-        return write_frame(fd, nlohmann::json::to_msgpack(event));
-    };
-    ctx->subscribe = [subs, fd](std::function<void()> cancel_fn) -> std::string
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (!conn->flush_locked()) conn->evicted = true;
+    }
+    update_interest(conn);
+}
+
+void server::update_interest(const std::shared_ptr<connection>& conn)
+{
+    unsigned interest = 0;
+    bool close_now = false;
+    std::size_t pending = 0;
+    bool evicted = false;
     {
-        return subs->subscribe(std::move(cancel_fn), fd);
-    };
-    ctx->unsubscribe = [subs](const std::string& id) -> bool
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        pending = conn->pending_outbound();
+        evicted = conn->evicted;
+        close_now = evicted || (conn->close_after_flush && pending == 0);
+        interest = (conn->paused ? 0u : unsigned{ poller::READABLE }) | (pending > 0 ? unsigned{ poller::WRITABLE } : 0u);
+    }
+
+    if (close_now) {
+        if (evicted && pending > 0) logger.warn("mep: evicting client {}, it stopped reading with {} bytes pending", conn->fd, pending);
+        close_client(conn);
+        return;
+    }
+
+    if (interest != conn->interest) {
+        m_poller->modify(conn->fd, interest);
+        conn->interest = interest;
+    }
+}
+
+void server::close_client(const std::shared_ptr<connection>& conn)
+{
+    auto it = m_clients.find(conn->fd);
+    if (it == m_clients.end() || it->second != conn) return;
+
+    m_clients.erase(it);
+    m_poller->remove(conn->fd);
+
     {
-        return subs->unsubscribe(id);
-    };
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        conn->closed = true;
+        conn->requests.clear();
+        conn->outbound.clear();
+        close_socket(conn->fd);
+    }
 
-    std::vector<uint8_t> payload;
-    while (m_running) {
-        if (!read_frame(fd, payload)) break;
+    conn->subs->cancel_all();
+}
 
-        nlohmann::json j;
-        try {
-            j = nlohmann::json::from_msgpack(payload);
-        } catch (...) {
-            write_frame(fd, nlohmann::json::to_msgpack(response_t::err("", "invalid msgpack").to_json()));
-            break;
+void server::queue_request(const std::shared_ptr<connection>& conn, std::vector<uint8_t> payload)
+{
+    bool start_worker = false;
+    bool pause = false;
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed || conn->close_after_flush) return;
+
+        conn->requests.push_back(std::move(payload));
+        if (conn->requests.size() >= MAX_PENDING_REQUESTS && !conn->paused) {
+            conn->paused = true;
+            pause = true;
+        }
+        if (!conn->dispatching) {
+            conn->dispatching = true;
+            start_worker = true;
         }
+    }
 
-        auto maybe_req = request_t::from_json(j);
-        if (!maybe_req) {
-            write_frame(fd, nlohmann::json::to_msgpack(response_t::err("", "malformed request").to_json()));
-            break;
+    if (pause) update_interest(conn);
+    if (start_worker) m_workers->enqueue([this, conn] { run_next_request(conn); });
+}
+
+void server::run_next_request(const std::shared_ptr<connection>& conn)
+{
+    std::vector<uint8_t> payload;
+    bool resume = false;
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed || conn->requests.empty()) {
+            conn->dispatching = false;
+            return;
         }
+        payload = std::move(conn->requests.front());
+        conn->requests.pop_front();
 
-        const response_t resp = m_router.dispatch(*maybe_req, ctx);
-        if (!write_frame(fd, nlohmann::json::to_msgpack(resp.to_json()))) break;
+        if (conn->paused && conn->requests.size() <= MAX_PENDING_REQUESTS / 2) {
+            conn->paused = false;
+            resume = true;
+        }
     }
 
-    subs->cancel_all();
+    if (resume) mark_dirty(conn);
+    handle_request(conn, payload);
+
+    /** requeue instead of looping so a busy client takes turns with the others */
+    bool more;
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        more = !conn->closed && !conn->requests.empty();
+        if (!more) conn->dispatching = false;
+    }
+    if (more) m_workers->enqueue([this, conn] { run_next_request(conn); });
 }
 
-bool server::read_frame(socket_t fd, std::vector<uint8_t>& out) const
+void server::handle_request(const std::shared_ptr<connection>& conn, const std::vector<uint8_t>& payload)
 {
-    uint32_t len_le = 0;
-    if (!recv_all(fd, &len_le, sizeof(len_le))) return false;
+    auto reject_and_close = [&](const char* message)
+    {
+        send_to(conn, nlohmann::json::to_msgpack(response_t::err("", message).to_json()));
+        {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            conn->close_after_flush = true;
+            conn->requests.clear();
+        }
+        mark_dirty(conn);
+    };
+
+    nlohmann::json j;
+    try {
+        j = nlohmann::json::from_msgpack(payload);
+    } catch (...) {
+        reject_and_close("invalid msgpack");
+        return;
+    }
+
+    auto maybe_req = request_t::from_json(j);
+    if (!maybe_req) {
+        reject_and_close("malformed request");
+        return;
+    }
+
+    const response_t resp = m_router.dispatch(*maybe_req, conn->ctx);
+    send_to(conn, nlohmann::json::to_msgpack(resp.to_json()));
+}
 
-    const uint32_t len = le32toh_compat(len_le);
-    if (len == 0 || len > MAX_MESSAGE_SIZE) return false;
+bool server::send_to(const std::shared_ptr<connection>& conn, const std::vector<uint8_t>& payload)
+{
+    bool queued = false;
+    bool needs_reactor = false;
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed || conn->evicted) return false;
+
+        const std::size_t was_pending = conn->pending_outbound();
+        if (was_pending + sizeof(uint32_t) + payload.size() > MAX_OUTBOUND_BYTES) {
+            /** a consumer this far behind isn't going to catch up, drop it rather than buffer forever */
+            conn->evicted = true;
+            needs_reactor = true;
+        } else {
+            const uint32_t len_le = htole32_compat(static_cast<uint32_t>(payload.size()));
+            const auto* len_bytes = reinterpret_cast<const uint8_t*>(&len_le);
+            conn->outbound.insert(conn->outbound.end(), len_bytes, len_bytes + sizeof(len_le));
+            conn->outbound.insert(conn->outbound.end(), payload.begin(), payload.end());
+            queued = true;
+
+            /** if output is already backed up the reactor is waiting for the socket, this frame just joins the batch */
+            if (was_pending == 0) {
+                if (!conn->flush_locked()) {
+                    conn->evicted = true;
+                    queued = false;
+                }
+                needs_reactor = conn->evicted || conn->pending_outbound() > 0;
+            }
+        }
+    }
 
-    out.resize(len);
-    return recv_all(fd, out.data(), len);
+    if (needs_reactor) mark_dirty(conn);
+    return queued;
 }
 
-bool server::write_frame(socket_t fd, const std::vector<uint8_t>& payload) const
+void server::mark_dirty(const std::shared_ptr<connection>& conn)
 {
-    const uint32_t len_le = htole32_compat(static_cast<uint32_t>(payload.size()));
-    return send_all(fd, &len_le, sizeof(len_le)) && send_all(fd, payload.data(), payload.size());
+    std::lock_guard<std::mutex> lock(m_dirty_mutex);
+    if (!m_poller) return;
+
+    m_dirty.push_back(conn);
+    m_poller->wake();
 }
 
 } // namespace mep
@@ -111,4 +111,7 @@ void millennium::entry()
     /** shutdown Millennium */
     m_plugin_loader->shutdown();
     m_mep_server.stop();
+
+    /** config changes are written behind, don't lose the last ones */
+    CONFIG.flush();
 }
@@ -32,10 +32,12 @@
 #include "shared/crash_handler_core.h"
 #include "shared/crash_report.h"
 #include "shared/crash_timestamp.h"
+#include "millennium/log_writer.h"
 #ifdef _WIN32
 #include "millennium/filesystem.h"
 #endif
 
+#include <chrono>
 #include <csignal>
 #include <cstdlib>
 #include <filesystem>
@@ -60,6 +62,12 @@ static std::string compute_crash_dump_base()
 #endif
 }
 
+/* the LOG_ERROR explaining a crash is usually still queued, and nothing else flushes the writer before we die */
+static void flush_logs()
+{
+    log_writer::instance().flush_for_crash(std::chrono::seconds(2));
+}
+
 static std::string make_crash_dir()
 {
     std::string dir = s_crash_dump_base + "/millennium-" + format_crash_timestamp();
@@ -165,6 +173,7 @@ void install_millennium_crash_handler()
     s_ctx.write_shm_fields = nullptr;
     s_ctx.fallback_write = millennium_fallback_write;
     s_ctx.terminate_after_crash = false;
+    s_ctx.flush_logs = flush_logs;
 
     crash_handler_core_install(&s_ctx);
 }
@@ -184,6 +193,7 @@ void install_millennium_crash_handler()
     s_signal_ctx.info = &s_info;
     s_signal_ctx.make_crash_dir = make_crash_dir;
     s_signal_ctx.chain_to_previous = true;
+    s_signal_ctx.flush_logs = flush_logs;
 
     static const int signals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
     crash_handler_core_install_signals(&s_signal_ctx, signals, 5);
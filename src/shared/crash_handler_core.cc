@@ -77,6 +77,8 @@ static LONG WINAPI crash_exception_handler(EXCEPTION_POINTERS* ep)
     if (!crash_report_is_fatal(code)) return EXCEPTION_CONTINUE_SEARCH;
     if (s_crash_in_progress.exchange(true)) return EXCEPTION_CONTINUE_SEARCH;
 
+    if (s_ctx->flush_logs) s_ctx->flush_logs();
+
     if (s_ctx->is_watchdog_available()) {
         if (code == EXCEPTION_STACK_OVERFLOW) {
             HANDLE t = CreateThread(nullptr, 0, [](LPVOID param) -> DWORD
@@ -106,6 +108,8 @@ static LONG WINAPI crash_exception_handler(EXCEPTION_POINTERS* ep)
 static void on_terminate()
 {
     if (!s_crash_in_progress.exchange(true)) {
+        if (s_ctx->flush_logs) s_ctx->flush_logs();
+
         if (s_ctx->is_watchdog_available()) {
             do_signal_watchdog(nullptr);
         } else {
@@ -140,6 +144,9 @@ static struct sigaction s_prev_handlers[32];
 
 static void crash_signal_handler(int sig)
 {
+    /* the child only has this thread, so anything that needs the rest of the process has to happen here */
+    if (s_signal_ctx->flush_logs) s_signal_ctx->flush_logs();
+
     pid_t pid = fork();
 
     if (pid == 0) {
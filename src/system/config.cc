@@ -96,9 +96,10 @@ void config_manager::set(std::initializer_list<std::string> segments, const nloh
 
     if (old_value != value) {
         (*current)[*last] = value;
+        ++_generation;
         if (!skipPropagation) {
             notify_listeners(join_segments(segments), old_value, value);
-            save_to_disk();
+            schedule_save();
         }
     }
 }
@@ -193,16 +194,67 @@ void config_manager::load_from_disk()
     }
 
     merge_default_config(_data, _defaults, "");
+    ++_generation;
+    save_to_disk();
+}
+
+void config_manager::schedule_save()
+{
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        if (_save_pending) {
+            _saves_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _save_pending = true;
+        _save_deadline = std::chrono::steady_clock::now() + SAVE_DELAY;
+    }
+    _pending_cv.notify_one();
+}
+
+void config_manager::save_loop()
+{
+    std::unique_lock<std::mutex> lock(_pending_mutex);
+    while (true) {
+        _pending_cv.wait(lock, [this] { return _stop_saving || _save_pending; });
+        if (_stop_saving) return;
+
+        /** the window is measured from the first change, so a steady stream of changes still gets written */
+        if (_pending_cv.wait_until(lock, _save_deadline, [this] { return _stop_saving; })) return;
+
+        lock.unlock();
+        save_to_disk();
+        lock.lock();
+    }
+}
+
+void config_manager::flush()
+{
     save_to_disk();
 }
 
 void config_manager::save_to_disk()
 {
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        _save_pending = false;
+    }
+
+    /** serialize outside _mutex so readers aren't held up by the dump and the file write */
+    json snapshot;
+    uint64_t generation;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if (_save_disabled) return;
+        snapshot = _data;
+        generation = _generation;
+    }
+
     // Serialize all file I/O operations to prevent concurrent writes
     std::lock_guard<std::mutex> save_lock(_save_mutex);
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
 
-    if (_save_disabled) return;
+    /** a newer (or the same) state has already been written */
+    if (generation <= _written_generation) return;
 
     /**
      * Use atomic write pattern: write to temp file, then rename
@@ -217,7 +269,7 @@ void config_manager::save_to_disk()
             return;
         }
 
-        file << _data.dump(2);
+        file << snapshot.dump(2);
         file.flush();
 
         if (file.fail()) {
@@ -237,7 +289,10 @@ void config_manager::save_to_disk()
     for (int attempt = 0; attempt < 5; ++attempt) {
         ec.clear();
         std::filesystem::rename(tempFilename, _filename, ec);
-        if (!ec) return;
+        if (!ec) {
+            _written_generation = generation;
+            return;
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
@@ -258,13 +313,15 @@ nlohmann::json config_manager::set_all(const nlohmann::json& newConfig, bool ski
         nlohmann::json old_data = _data;
         _data = newConfig;
 
+        ++_generation;
+
         if (!skipPropagation) {
             for (auto& [k, v] : newConfig.items()) {
                 notify_listeners(k, old_data.value(k, nlohmann::json(nullptr)), v);
             }
         }
 
-        save_to_disk();
+        schedule_save();
         return _data;
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to set entire config: {}", e.what());
@@ -298,11 +355,19 @@ config_manager::config_manager()
     }
 
     load_from_disk();
+    _save_thread = std::thread([this] { save_loop(); });
 }
 
 config_manager::~config_manager()
 {
-    save_to_disk();
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        _stop_saving = true;
+    }
+    _pending_cv.notify_one();
+    if (_save_thread.joinable()) _save_thread.join();
+
+    flush();
 }
 
 void config_manager::notify_listeners(const std::string& key, const nlohmann::json& old_value, const nlohmann::json& new_value)
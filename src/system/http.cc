@@ -29,6 +29,7 @@
  */
 
 #include "millennium/http.h"
+#include "millennium/http_engine.h"
 #include "millennium/millennium_lifecycle.h"
 #include "millennium/config.h"
 #include "millennium/crypto.h"
@@ -39,44 +40,24 @@
 #include <stdexcept>
 #include <thread>
 
-static size_t WriteByteCallback(char* ptr, size_t size, size_t nmemb, std::string* data)
-{
-    data->append(ptr, size * nmemb);
-    return size * nmemb;
-}
-
-static size_t WriteFileCallback(void* ptr, size_t size, size_t nmemb, void* userdata)
-{
-    auto* data = static_cast<DownloadData*>(userdata);
-    size_t written = fwrite(ptr, size, nmemb, data->fp);
-    data->downloaded += written * size;
-    if (data->progressCallback) {
-        data->progressCallback(data->downloaded, data->totalSize);
-    }
-    return written;
-}
-
 static std::string get_proxy_url()
 {
     return CONFIG.get({ "network", "proxy" }, "").get<std::string>();
 }
 
-static void apply_proxy(CURL* curl)
+static void apply_proxy(http_engine::request& req)
 {
-    const std::string proxy = get_proxy_url();
-    if (proxy.empty()) {
+    req.proxy = get_proxy_url();
+    if (req.proxy.empty()) {
         return;
     }
 
-    curl_easy_setopt(curl, CURLOPT_PROXY, proxy.c_str());
-
     const std::string username = CONFIG.get({ "network", "proxyUsername" }, "").get<std::string>();
     const std::string stored_pw = CONFIG.get({ "network", "proxyPassword" }, "").get<std::string>();
 
     if (!username.empty()) {
         const std::string password = Crypto::is_encrypted(stored_pw) ? Crypto::decrypt(stored_pw) : stored_pw;
-        const std::string userpwd  = username + ":" + password;
-        curl_easy_setopt(curl, CURLOPT_PROXYUSERPWD, userpwd.c_str());
+        req.proxy_userpwd = username + ":" + password;
     }
 }
 
@@ -85,135 +66,114 @@ namespace Http
 
 std::string Get(const char* url, bool retry, const long timeout)
 {
-    CURL* curl;
-    CURLcode res;
-    std::string response;
-
-    curl = curl_easy_init();
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteByteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, MILLENNIUM_USERAGENT);
-        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
-        apply_proxy(curl);
-
-        while (true) {
-            res = curl_easy_perform(curl);
-            if (res == CURLE_OK) {
-                break;
-            }
-            if (!retry) {
-                curl_easy_cleanup(curl);
-                throw HttpError(std::string("curl GET failed: ") + curl_easy_strerror(res));
-            }
-            if (millennium_lifecycle::get().terminate.flag.load()) {
-                throw HttpError("Thread termination flag is set, aborting HTTP request.");
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    http_engine::request req;
+    req.url = url;
+    req.user_agent = MILLENNIUM_USERAGENT;
+    req.timeout_seconds = timeout;
+    apply_proxy(req);
+
+    while (true) {
+        http_engine::response res = http_engine::instance().perform(req);
+        if (res.ok()) {
+            return std::move(res.body);
+        }
+        if (!retry) {
+            throw HttpError("curl GET failed: " + res.error());
         }
-        curl_easy_cleanup(curl);
+        if (millennium_lifecycle::get().terminate.flag.load()) {
+            throw HttpError("Thread termination flag is set, aborting HTTP request.");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
-    return response;
 }
 
 std::string Post(const char* url, const std::string& postData, bool retry)
 {
-    CURL* curl;
-    CURLcode res;
-    std::string response;
-
-    curl = curl_easy_init();
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postData.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, postData.size());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteByteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, MILLENNIUM_USERAGENT);
-        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-        apply_proxy(curl);
-
-        while (true) {
-            res = curl_easy_perform(curl);
-            if (!retry || res == CURLE_OK) {
-                break;
-            }
-
-            if (millennium_lifecycle::get().terminate.flag.load()) {
-                throw HttpError("Thread termination flag is set, aborting HTTP request.");
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    http_engine::request req;
+    req.url = url;
+    req.method = "POST";
+    req.body = postData;
+    req.user_agent = MILLENNIUM_USERAGENT;
+    req.timeout_seconds = 30;
+    apply_proxy(req);
+
+    while (true) {
+        http_engine::response res = http_engine::instance().perform(req);
+        if (!retry || res.ok()) {
+            return std::move(res.body);
+        }
+
+        if (millennium_lifecycle::get().terminate.flag.load()) {
+            throw HttpError("Thread termination flag is set, aborting HTTP request.");
         }
-        curl_easy_cleanup(curl);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
-    return response;
 }
 
 void DownloadWithProgress(const std::tuple<std::string, size_t>& download_info, const std::filesystem::path& destPath, std::function<void(size_t, size_t)> progressCallback)
 {
     const auto& [url, expectedSize] = download_info;
 
-    CURL* curl = curl_easy_init();
-    if (!curl) throw std::runtime_error("Failed to initialize curl");
-
     FILE* fp = fopen(destPath.string().c_str(), "wb");
     if (!fp) {
-        curl_easy_cleanup(curl);
         throw std::runtime_error("Failed to open file: " + destPath.string());
     }
 
-    CURLcode res;
-    DownloadData downloadData = { fp, 0, progressCallback, expectedSize };
-
-    if (!expectedSize) {
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        apply_proxy(curl);
-
-        res = curl_easy_perform(curl);
-        if (res == CURLE_OK) {
-            curl_off_t contentLength;
-            if (curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength) == CURLE_OK && contentLength > 0) {
-                downloadData.totalSize = static_cast<size_t>(contentLength);
-            }
+    size_t totalSize = expectedSize;
+    if (!totalSize) {
+        http_engine::request head;
+        head.url = url;
+        head.method = "HEAD";
+        head.timeout_seconds = 0;
+        apply_proxy(head);
+
+        const http_engine::response res = http_engine::instance().perform(std::move(head));
+        if (res.ok() && res.content_length > 0) {
+            totalSize = res.content_length;
         }
     }
 
-    curl_easy_setopt(curl, CURLOPT_NOBODY, 0L);
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteFileCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &downloadData);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, MILLENNIUM_USERAGENT);
-    apply_proxy(curl);
-
-    res = curl_easy_perform(curl);
-
-    long response_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    http_engine::request req;
+    req.url = url;
+    req.user_agent = MILLENNIUM_USERAGENT;
+    req.timeout_seconds = 0;
+    apply_proxy(req);
+
+    /** the engine thread only writes the file, progress is reported from here so a slow callback can't stall other transfers */
+    std::atomic<size_t> downloaded{ 0 };
+    req.sink = [fp, &downloaded](const char* data, size_t size)
+    {
+        const size_t written = fwrite(data, 1, size, fp);
+        downloaded.fetch_add(written, std::memory_order_relaxed);
+        return written == size;
+    };
+
+    std::future<http_engine::response> pending = http_engine::instance().submit(std::move(req));
+
+    size_t reported = 0;
+    while (pending.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+        const size_t now = downloaded.load(std::memory_order_relaxed);
+        if (progressCallback && now != reported) {
+            progressCallback(now, totalSize);
+            reported = now;
+        }
+    }
 
+    const http_engine::response res = pending.get();
     fclose(fp);
-    curl_easy_cleanup(curl);
 
-    if (res != CURLE_OK) {
+    if (!res.ok()) {
         std::filesystem::remove(destPath);
-        throw std::runtime_error("Download failed: " + std::string(curl_easy_strerror(res)));
+        throw std::runtime_error("Download failed: " + res.error());
     }
 
-    if (response_code < 200 || response_code >= 300) {
+    if (res.status < 200 || res.status >= 300) {
         std::filesystem::remove(destPath);
-        throw std::runtime_error("Download failed: HTTP " + std::to_string(response_code));
+        throw std::runtime_error("Download failed: HTTP " + std::to_string(res.status));
     }
 
     if (progressCallback) {
-        progressCallback(downloadData.downloaded, downloadData.totalSize);
+        progressCallback(downloaded.load(std::memory_order_relaxed), totalSize);
     }
 }
 
@@ -0,0 +1,323 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/http_engine.h"
+
+#include <cstdlib>
+#include <unordered_set>
+
+struct http_engine::transfer
+{
+    request req;
+    response res;
+    completion on_done;
+
+    CURL* easy = nullptr;
+    curl_slist* headers = nullptr;
+};
+
+std::string http_engine::response::error() const
+{
+    if (body_exceeded) return "response body exceeded the size limit";
+    return curl_easy_strerror(result);
+}
+
+http_engine& http_engine::instance()
+{
+    static http_engine* inst = []
+    {
+        auto* engine = new http_engine();
+        std::atexit([] { http_engine::instance().shutdown(); });
+        return engine;
+    }();
+    return *inst;
+}
+
+http_engine::http_engine() : http_engine(limits{})
+{
+}
+
+http_engine::http_engine(limits limits)
+{
+    m_multi = curl_multi_init();
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, limits.max_host_connections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, limits.max_total_connections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, limits.max_cached_connections);
+
+    /** the multi handle already pools connections, the share adds dns and tls session reuse on top */
+    m_share = curl_share_init();
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    m_thread = std::thread([this] { event_loop(); });
+}
+
+http_engine::~http_engine()
+{
+    shutdown();
+    curl_multi_cleanup(m_multi);
+    curl_share_cleanup(m_share);
+}
+
+void http_engine::submit(request req, completion on_done)
+{
+    auto* t = new transfer{ std::move(req), {}, std::move(on_done) };
+
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (!m_stopped) {
+            m_queue.push_back(t);
+            t = nullptr;
+        }
+    }
+
+    if (t) {
+        /** the engine is gone, fail straight away rather than leaving the caller hanging */
+        t->res.result = CURLE_ABORTED_BY_CALLBACK;
+        if (t->on_done) t->on_done(std::move(t->res));
+        delete t;
+        return;
+    }
+
+    curl_multi_wakeup(m_multi);
+}
+
+std::future<http_engine::response> http_engine::submit(request req)
+{
+    auto promise = std::make_shared<std::promise<response>>();
+    auto future = promise->get_future();
+
+    submit(std::move(req), [promise](response res) { promise->set_value(std::move(res)); });
+    return future;
+}
+
+http_engine::response http_engine::perform(request req)
+{
+    return submit(std::move(req)).get();
+}
+
+void http_engine::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (m_stopped) return;
+        m_stopped = true;
+    }
+
+    m_stop.store(true, std::memory_order_release);
+    curl_multi_wakeup(m_multi);
+
+    if (m_thread.joinable()) m_thread.join();
+}
+
+size_t http_engine::on_body(char* data, size_t size, size_t count, void* userdata)
+{
+    auto* t = static_cast<transfer*>(userdata);
+    const size_t bytes = size * count;
+
+    if (t->req.sink) {
+        if (!t->req.sink(data, bytes)) return 0; /** abort transfer */
+    } else {
+        if (t->req.max_body_bytes && t->res.body.size() + bytes > t->req.max_body_bytes) {
+            t->res.body_exceeded = true;
+            return 0;
+        }
+        t->res.body.append(data, bytes);
+    }
+    t->res.received += bytes;
+
+    if (t->req.progress) {
+        curl_off_t total = 0;
+        curl_easy_getinfo(t->easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &total);
+        t->req.progress(t->res.received, total > 0 ? static_cast<size_t>(total) : 0);
+    }
+    return bytes;
+}
+
+size_t http_engine::on_header(char* data, size_t size, size_t count, void* userdata)
+{
+    auto* t = static_cast<transfer*>(userdata);
+    const size_t len = size * count;
+
+    std::string_view line(data, len);
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+        line.remove_suffix(1);
+    }
+
+    const size_t colon = line.find(':');
+    if (colon != std::string_view::npos) {
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ') {
+            value.remove_prefix(1);
+        }
+        t->res.headers[std::string(line.substr(0, colon))] = std::string(value);
+    }
+    return len;
+}
+
+bool http_engine::start_transfer(transfer* t)
+{
+    t->easy = curl_easy_init();
+    if (!t->easy) {
+        finish_transfer(t, CURLE_FAILED_INIT);
+        return false;
+    }
+
+    const request& req = t->req;
+    CURL* curl = t->easy;
+
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, t);
+    curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+    curl_easy_setopt(curl, CURLOPT_URL, req.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &http_engine::on_body);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, t);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &http_engine::on_header);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, t);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, req.follow_redirects ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, req.verify_ssl ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, req.verify_ssl ? 2L : 0L);
+    /** wait for a connection that can multiplex rather than opening another one */
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+
+    if (req.timeout_seconds > 0) curl_easy_setopt(curl, CURLOPT_TIMEOUT, req.timeout_seconds);
+    if (!req.user_agent.empty()) curl_easy_setopt(curl, CURLOPT_USERAGENT, req.user_agent.c_str());
+
+    for (const auto& header : req.headers) {
+        t->headers = curl_slist_append(t->headers, header.c_str());
+    }
+    if (t->headers) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, t->headers);
+
+    if (req.method == "HEAD") {
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    } else if (req.method == "POST") {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req.body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(req.body.size()));
+    } else if (req.method != "GET") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+        if (!req.body.empty()) {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req.body.c_str());
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(req.body.size()));
+        }
+    }
+
+    if (!req.userpwd.empty()) {
+        curl_easy_setopt(curl, CURLOPT_USERPWD, req.userpwd.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
+    }
+
+    if (!req.proxy.empty()) {
+        curl_easy_setopt(curl, CURLOPT_PROXY, req.proxy.c_str());
+        if (!req.proxy_userpwd.empty()) curl_easy_setopt(curl, CURLOPT_PROXYUSERPWD, req.proxy_userpwd.c_str());
+    }
+
+    if (curl_multi_add_handle(m_multi, curl) != CURLM_OK) {
+        /** never added, so finish_transfer()'s remove is a no-op */
+        finish_transfer(t, CURLE_FAILED_INIT);
+        return false;
+    }
+    return true;
+}
+
+void http_engine::finish_transfer(transfer* t, CURLcode result)
+{
+    if (t->easy) {
+        curl_easy_getinfo(t->easy, CURLINFO_RESPONSE_CODE, &t->res.status);
+
+        curl_off_t length = 0;
+        if (curl_easy_getinfo(t->easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK && length > 0) {
+            t->res.content_length = static_cast<std::size_t>(length);
+        }
+        curl_multi_remove_handle(m_multi, t->easy);
+        curl_easy_cleanup(t->easy);
+    }
+    curl_slist_free_all(t->headers);
+
+    t->res.result = result;
+    if (t->on_done) {
+        try {
+            t->on_done(std::move(t->res));
+        } catch (...) {
+            /** a throwing completion mustn't take the event loop down with it */
+        }
+    }
+    delete t;
+}
+
+void http_engine::event_loop()
+{
+    std::unordered_set<transfer*> active;
+
+    while (true) {
+        std::deque<transfer*> incoming;
+        {
+            std::lock_guard<std::mutex> lock(m_queue_mutex);
+            incoming.swap(m_queue);
+        }
+        for (transfer* t : incoming) {
+            if (start_transfer(t)) active.insert(t);
+        }
+
+        if (m_stop.load(std::memory_order_acquire)) break;
+
+        int running = 0;
+        curl_multi_perform(m_multi, &running);
+
+        int pending = 0;
+        while (CURLMsg* msg = curl_multi_info_read(m_multi, &pending)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+
+            transfer* t = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &t);
+            const CURLcode result = msg->data.result;
+
+            active.erase(t);
+            finish_transfer(t, result);
+        }
+
+        curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+    }
+
+    for (transfer* t : active) {
+        finish_transfer(t, CURLE_ABORTED_BY_CALLBACK);
+    }
+
+    std::deque<transfer*> leftover;
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        leftover.swap(m_queue);
+    }
+    for (transfer* t : leftover) {
+        finish_transfer(t, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
@@ -0,0 +1,289 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/log_writer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+/** lines buffered per batch before they're written out, so a flood doesn't grow the batch without bound */
+static constexpr std::size_t MAX_BATCH = 1024;
+static constexpr std::chrono::milliseconds IDLE_WAIT{ 250 };
+
+log_writer& log_writer::instance()
+{
+    static log_writer* inst = []
+    {
+        auto* writer = new log_writer();
+        std::atexit([] { log_writer::instance().shutdown(); });
+        return writer;
+    }();
+    return *inst;
+}
+
+log_writer::log_writer() : m_head(&m_stub), m_tail(&m_stub)
+{
+    m_sinks[STDOUT_SINK].file = stdout;
+    m_thread = std::thread([this] { writer_loop(); });
+}
+
+void log_writer::push(record* r)
+{
+    r->next.store(nullptr, std::memory_order_relaxed);
+    record* prev = m_head.exchange(r, std::memory_order_acq_rel);
+    prev->next.store(r, std::memory_order_release);
+}
+
+log_writer::record* log_writer::pop()
+{
+    record* tail = m_tail;
+    record* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &m_stub) {
+        if (!next) return nullptr;
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    /** tail is the last record, unless a producer swapped the head but hasn't linked its record yet */
+    if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void log_writer::write(sink_id sink, std::string text)
+{
+    if (m_queued.fetch_add(1, std::memory_order_seq_cst) >= MAX_QUEUED) {
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto* r = new record();
+    r->sink = sink;
+    r->text = std::move(text);
+    push(r);
+
+    if (m_synchronous.load(std::memory_order_acquire)) {
+        drain_synchronously();
+        return;
+    }
+
+    if (m_sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_wake_cv.notify_one();
+    }
+}
+
+log_writer::sink_id log_writer::open_file(const std::string& path)
+{
+    const sink_id id = m_next_sink.fetch_add(1, std::memory_order_relaxed);
+
+    auto* r = new record();
+    r->kind = record_kind::open;
+    r->sink = id;
+    r->text = path;
+
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    push(r);
+    return id;
+}
+
+void log_writer::close(sink_id sink)
+{
+    auto* r = new record();
+    r->kind = record_kind::close;
+    r->sink = sink;
+
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    push(r);
+}
+
+void log_writer::flush()
+{
+    if (m_synchronous.load(std::memory_order_acquire)) {
+        drain_synchronously();
+        return;
+    }
+
+    std::atomic<bool> done{ false };
+    auto* r = new record();
+    r->kind = record_kind::flush;
+    r->done = &done;
+
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    push(r);
+
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    m_wake_cv.notify_one();
+    m_flushed_cv.wait(lock, [&] { return done.load(std::memory_order_acquire); });
+}
+
+bool log_writer::flush_for_crash(std::chrono::milliseconds timeout)
+{
+    if (m_crash_flush_used.exchange(true)) return false;
+    /** after shutdown() every write is already synchronous */
+    if (m_synchronous.load(std::memory_order_acquire)) return true;
+
+    m_crash_flush.kind = record_kind::flush;
+    m_crash_flush.done = &m_crash_flushed;
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    push(&m_crash_flush);
+
+    /** no notify, that would take m_wake_mutex. a sleeping writer rechecks the queue within IDLE_WAIT */
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!m_crash_flushed.load(std::memory_order_acquire)) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+void log_writer::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        if (m_stop) return;
+        m_stop = true;
+    }
+    m_wake_cv.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+
+    m_synchronous.store(true, std::memory_order_release);
+    flush();
+}
+
+void log_writer::drain_synchronously()
+{
+    std::lock_guard<std::mutex> lock(m_sync_mutex);
+    while (record* r = pop()) {
+        consume(r);
+    }
+    report_dropped();
+    write_pending();
+}
+
+void log_writer::consume(record* r)
+{
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+    switch (r->kind) {
+        case record_kind::line: {
+            auto it = m_sinks.find(r->sink);
+            if (it != m_sinks.end()) it->second.pending += r->text;
+            break;
+        }
+        case record_kind::open: {
+            m_sinks[r->sink].file = std::fopen(r->text.c_str(), "ab");
+            break;
+        }
+        case record_kind::close: {
+            auto it = m_sinks.find(r->sink);
+            if (it != m_sinks.end()) {
+                if (it->second.file) {
+                    std::fwrite(it->second.pending.data(), 1, it->second.pending.size(), it->second.file);
+                    std::fclose(it->second.file);
+                }
+                m_sinks.erase(it);
+            }
+            break;
+        }
+        case record_kind::flush: {
+            write_pending();
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            r->done->store(true, std::memory_order_release);
+            m_flushed_cv.notify_all();
+            break;
+        }
+    }
+
+    if (r != &m_crash_flush) delete r;
+}
+
+void log_writer::write_pending()
+{
+    for (auto& [id, sink] : m_sinks) {
+        if (sink.pending.empty()) continue;
+
+        if (sink.file) {
+            std::fwrite(sink.pending.data(), 1, sink.pending.size(), sink.file);
+            std::fflush(sink.file);
+        }
+        sink.pending.clear();
+    }
+}
+
+void log_writer::report_dropped()
+{
+    const std::size_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_reported_dropped) return;
+
+    m_sinks[STDOUT_SINK].pending += "[log_writer] dropped " + std::to_string(dropped - m_reported_dropped) + " lines, the queue was full\n";
+    m_reported_dropped = dropped;
+}
+
+void log_writer::writer_loop()
+{
+    while (true) {
+        std::size_t batch = 0;
+        while (record* r = pop()) {
+            consume(r);
+            if (++batch == MAX_BATCH) {
+                write_pending();
+                batch = 0;
+            }
+        }
+        report_dropped();
+        write_pending();
+
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        if (m_stop) break;
+
+        m_sleeping.store(true, std::memory_order_seq_cst);
+        m_wake_cv.wait_for(lock, IDLE_WAIT, [this] { return m_stop || m_queued.load(std::memory_order_seq_cst) > 0; });
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    /** anything that raced in with shutdown() is left for the synchronous drain that follows */
+}
@@ -32,10 +32,10 @@
 #include "millennium/environment.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <fcntl.h>
 #include <iostream>
 #include <filesystem>
-#include <sstream>
 
 #ifdef _WIN32
 #include "millennium/cmdline_api.h"
@@ -57,20 +57,51 @@ void EnableVirtualTerminalProcessing()
 }
 #endif
 
+logger_base::logger_base() : m_buffer_capacity(DEFAULT_BUFFER_CAPACITY)
+{
+    const char* configured = std::getenv("MILLENNIUM_LOG_BUFFER_SIZE");
+    if (configured && configured[0] != '\0') {
+        const auto capacity = std::strtoull(configured, nullptr, 10);
+        if (capacity > 0) m_buffer_capacity = static_cast<std::size_t>(capacity);
+    }
+}
+
+void logger_base::buffer_entry(const log_entry& entry)
+{
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (logBuffer.size() >= m_buffer_capacity) logBuffer.pop_front();
+    logBuffer.push_back(entry);
+}
+
 std::string logger_base::get_local_time(bool withHours)
 {
-    std::stringstream bufferStream;
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    /** localtime() and strftime() only change their answer once a second, so each thread keeps the last prefix */
+    struct cached_prefix
+    {
+        std::time_t second = -1;
+        bool with_hours = false;
+        char text[16]{};
+        std::size_t length = 0;
+    };
+    thread_local cached_prefix cache;
+
+    const auto now = std::chrono::system_clock::now();
+    const std::time_t second = std::chrono::system_clock::to_time_t(now);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
 
-    if (withHours) {
-        bufferStream << std::put_time(std::localtime(&time), "%H:%M:%S");
-    } else {
-        bufferStream << std::put_time(std::localtime(&time), "%M:%S");
+    if (cache.second != second || cache.with_hours != withHours) {
+        struct tm t{};
+#ifdef _WIN32
+        localtime_s(&t, &second);
+#else
+        localtime_r(&second, &t);
+#endif
+        cache.length = std::strftime(cache.text, sizeof(cache.text), withHours ? "%H:%M:%S" : "%M:%S", &t);
+        cache.second = second;
+        cache.with_hours = withHours;
     }
-    bufferStream << std::format(".{:03}", ms.count());
-    return std::format("[{}]", bufferStream.str());
+
+    return std::format("[{}.{:03}]", std::string_view(cache.text, cache.length), ms.count());
 }
 
 std::string logger_base::get_local_date_str()
@@ -92,15 +123,14 @@ std::string logger_base::get_local_date_str()
 plugin_logger::plugin_logger(const std::string& pluginName) : pluginName(pluginName)
 {
     this->filename = (std::filesystem::path(platform::environment::get("MILLENNIUM__LOGS_PATH")) / std::format("{}_log.log", pluginName)).generic_string();
-    file.open(filename, std::ios::app);
+    m_sink = log_writer::instance().open_file(filename);
 
-    file << std::format("\n\n\n--------------------------------- [{}] ---------------------------------\n", get_local_date_str());
-    file.flush();
+    log_writer::instance().write(m_sink, std::format("\n\n\n--------------------------------- [{}] ---------------------------------\n", get_local_date_str()));
 }
 
 plugin_logger::~plugin_logger()
 {
-    file.close();
+    log_writer::instance().close(m_sink);
 }
 
 void plugin_logger::notify_listeners(const log_entry& entry)
@@ -140,13 +170,13 @@ void plugin_logger::log(const std::string& message, bool onlyBuffer, uint64_t ti
     std::string formatted = std::format("{} ", get_plugin_name());
 
     if (!onlyBuffer) {
-        std::cout << std::format("{} \033[1m\033[34m{}\033[0m\033[0m", get_local_time(), formatted) << message << "\n";
-        file << formatted << message << "\n";
-        file.flush();
+        auto& writer = log_writer::instance();
+        writer.write(log_writer::STDOUT_SINK, std::format("{} \033[1m\033[34m{}\033[0m\033[0m{}\n", get_local_time(), formatted, message));
+        writer.write(m_sink, std::format("{}{}\n", formatted, message));
     }
 
     const log_entry entry{ message, log_level::info, timestamp_us ? timestamp_us : now_us(), std::move(src_file), src_line };
-    logBuffer.push_back(entry);
+    buffer_entry(entry);
     notify_listeners(entry);
 }
 
@@ -154,13 +184,13 @@ void plugin_logger::warn(const std::string& message, bool onlyBuffer, uint64_t t
 {
     const std::string formatted = std::format("{}{}{}", get_local_time(), std::format(" {} ", get_plugin_name()), message.c_str());
     if (!onlyBuffer) {
-        std::cout << COL_YELLOW << formatted << COL_RESET << '\n';
-        file << formatted;
-        file.flush();
+        auto& writer = log_writer::instance();
+        writer.write(log_writer::STDOUT_SINK, std::format("{}{}{}\n", COL_YELLOW, formatted, COL_RESET));
+        writer.write(m_sink, formatted + '\n');
     }
 
     const log_entry entry{ message, log_level::warn, timestamp_us ? timestamp_us : now_us(), std::move(src_file), src_line };
-    logBuffer.push_back(entry);
+    buffer_entry(entry);
     notify_listeners(entry);
 }
 
@@ -168,29 +198,29 @@ void plugin_logger::error(const std::string& message, bool onlyBuffer, uint64_t
 {
     const std::string formatted = std::format("{}{}{}", get_local_time(), std::format(" {} ", get_plugin_name()), message.c_str());
     if (!onlyBuffer) {
-        std::cout << COL_RED << formatted << COL_RESET << '\n';
-        file << formatted;
-        file.flush();
+        auto& writer = log_writer::instance();
+        writer.write(log_writer::STDOUT_SINK, std::format("{}{}{}\n", COL_RED, formatted, COL_RESET));
+        writer.write(m_sink, formatted + '\n');
     }
 
     const log_entry entry{ message, log_level::error, timestamp_us ? timestamp_us : now_us(), std::move(src_file), src_line };
-    logBuffer.push_back(entry);
+    buffer_entry(entry);
     notify_listeners(entry);
 }
 
 void plugin_logger::print(const std::string& message)
 {
-    file << message;
-    file.flush();
+    log_writer::instance().write(m_sink, message);
 
     const log_entry entry{ message, log_level::info, now_us(), "", 0 };
-    logBuffer.push_back(entry);
+    buffer_entry(entry);
     notify_listeners(entry);
 }
 
 std::vector<logger_base::log_entry> plugin_logger::collect_logs()
 {
-    return logBuffer;
+    std::lock_guard<std::mutex> lock(log_mutex);
+    return { logBuffer.begin(), logBuffer.end() };
 }
 
 std::string plugin_logger::get_plugin_name(bool upperCase)
@@ -209,20 +239,12 @@ millennium_logger& logger = millennium_logger::get_instance();
 
 std::string millennium_logger::get_local_time_stamp()
 {
-    std::stringstream bufferStream;
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-
-    bufferStream << std::put_time(std::localtime(&time), "%M:%S");
-    bufferStream << std::format(".{:03}", ms.count());
-    return std::format("[{}]", bufferStream.str());
+    return get_local_time();
 }
 
 void millennium_logger::print(std::string type, const std::string& message, std::string color)
 {
-    std::lock_guard<std::mutex> lock(log_mutex);
-    std::cout << std::format("{}\033[1m{}{}{}\033[0m{}\n", get_local_time_stamp(), color, type, COL_RESET, message);
+    log_writer::instance().write(log_writer::STDOUT_SINK, std::format("{}\033[1m{}{}{}\033[0m{}\n", get_local_time_stamp(), color, type, COL_RESET, message));
 }
 
 millennium_logger::millennium_logger()
@@ -249,7 +271,6 @@ millennium_logger::millennium_logger()
 
 void millennium_logger::log_plugin_message(std::string pluginName, std::string strMessage)
 {
-    std::lock_guard<std::mutex> lock(log_mutex);
     const auto toUpper = [](const std::string& str)
     {
         std::string result = str;
@@ -257,6 +278,6 @@ void millennium_logger::log_plugin_message(std::string pluginName, std::string s
         return result;
     };
 
-    std::string message = std::format("{} \033[1m\033[34m{} \033[0m\033[0m{}\n", get_local_time_stamp(), toUpper(pluginName), strMessage);
-    std::cout << message;
+    log_writer::instance().write(log_writer::STDOUT_SINK,
+                                 std::format("{} \033[1m\033[34m{} \033[0m\033[0m{}\n", get_local_time_stamp(), toUpper(pluginName), strMessage));
 }
@@ -0,0 +1,453 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/base64.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+/** lets gcc/clang emit avx2/ssse3 code in individual functions without raising the baseline for the whole binary */
+#if defined(__GNUC__) || defined(__clang__)
+#define BASE64_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BASE64_TARGET(isa)
+#endif
+
+namespace
+{
+constexpr char k_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/** simd loops may write up to this many bytes past the real end of their output */
+constexpr size_t k_output_slack = 32;
+
+constexpr std::array<uint8_t, 256> make_decode_table()
+{
+    std::array<uint8_t, 256> table{};
+    table.fill(0xFF);
+    for (uint8_t i = 0; i < 64; ++i) {
+        table[static_cast<unsigned char>(k_alphabet[i])] = i;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> k_decode_table = make_decode_table();
+
+/**
+ * each backend converts as many whole blocks as it can and returns how much input it consumed
+ * (a multiple of 3 bytes for encode, 4 characters for decode). decode stops in front of the first
+ * block holding a character outside the alphabet, the scalar code finishes from there.
+ */
+struct codec
+{
+    const char* name;
+    size_t (*encode)(const uint8_t* src, size_t len, char* dst);
+    size_t (*decode)(const char* src, size_t len, uint8_t* dst);
+};
+
+size_t encode_scalar(const uint8_t* src, size_t len, char* dst)
+{
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3, dst += 4) {
+        const uint32_t triple = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8) | src[i + 2];
+        dst[0] = k_alphabet[(triple >> 18) & 0x3F];
+        dst[1] = k_alphabet[(triple >> 12) & 0x3F];
+        dst[2] = k_alphabet[(triple >> 6) & 0x3F];
+        dst[3] = k_alphabet[triple & 0x3F];
+    }
+    return i;
+}
+
+size_t decode_scalar(const char* src, size_t len, uint8_t* dst)
+{
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4, dst += 3) {
+        const uint8_t a = k_decode_table[static_cast<unsigned char>(src[i])];
+        const uint8_t b = k_decode_table[static_cast<unsigned char>(src[i + 1])];
+        const uint8_t c = k_decode_table[static_cast<unsigned char>(src[i + 2])];
+        const uint8_t d = k_decode_table[static_cast<unsigned char>(src[i + 3])];
+        if ((a | b | c | d) & 0xC0) break;
+
+        const uint32_t triple = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+        dst[0] = static_cast<uint8_t>(triple >> 16);
+        dst[1] = static_cast<uint8_t>(triple >> 8);
+        dst[2] = static_cast<uint8_t>(triple);
+    }
+    return i;
+}
+
+#ifdef BASE64_X86
+/**
+ * x86 kernels follow Wojciech Muła's layout: a shuffle spreads each 3-byte group over a 32-bit lane,
+ * multiplies move the four 6-bit fields into their own bytes, and a few range compares map them to ascii.
+ * decode runs the same steps backwards with pmaddubsw/pmaddwd doing the repacking.
+ */
+BASE64_TARGET("ssse3") inline __m128i encode_indices_ssse3(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    const __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(hi, lo);
+}
+
+/** 'A' + i, then step the offset at 26 ('a'), 52 ('0'), 62 ('+') and 63 ('/') */
+BASE64_TARGET("ssse3") inline __m128i indices_to_ascii_ssse3(__m128i indices)
+{
+    __m128i offset = _mm_set1_epi8('A');
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+    offset = _mm_sub_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(51)), _mm_set1_epi8(75)));
+    offset = _mm_sub_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(61)), _mm_set1_epi8(15)));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(62)), _mm_set1_epi8(3)));
+    return _mm_add_epi8(indices, offset);
+}
+
+/** ascii to 6-bit values. returns false if any byte is outside the alphabet */
+BASE64_TARGET("ssse3") inline bool ascii_to_values_ssse3(__m128i in, __m128i& values)
+{
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+    const __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) return false;
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+    shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+    shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+    values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+/** 16 values to 12 bytes, packed into the low 12 bytes of the result */
+BASE64_TARGET("ssse3") inline __m128i pack_values_ssse3(__m128i values)
+{
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+BASE64_TARGET("ssse3") size_t encode_ssse3(const uint8_t* src, size_t len, char* dst)
+{
+    size_t i = 0;
+    /** each step reads 16 bytes but only consumes 12 */
+    for (; i + 16 <= len; i += 12, dst += 16) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), indices_to_ascii_ssse3(encode_indices_ssse3(in)));
+    }
+    return i;
+}
+
+BASE64_TARGET("ssse3") size_t decode_ssse3(const char* src, size_t len, uint8_t* dst)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16, dst += 12) {
+        __m128i values;
+        if (!ascii_to_values_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), values)) break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), pack_values_ssse3(values));
+    }
+    return i;
+}
+
+BASE64_TARGET("avx2") size_t encode_avx2(const uint8_t* src, size_t len, char* dst)
+{
+    const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+    size_t i = 0;
+    /** each step reads 12 bytes into each 128-bit lane (28 bytes in total) and consumes 24 */
+    for (; i + 28 <= len; i += 24, dst += 32) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, spread);
+        const __m256i idx_hi = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+        const __m256i idx_lo = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(idx_hi, idx_lo);
+
+        __m256i offset = _mm256_set1_epi8('A');
+        offset = _mm256_add_epi8(offset, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)), _mm256_set1_epi8(6)));
+        offset = _mm256_sub_epi8(offset, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(51)), _mm256_set1_epi8(75)));
+        offset = _mm256_sub_epi8(offset, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(61)), _mm256_set1_epi8(15)));
+        offset = _mm256_add_epi8(offset, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(62)), _mm256_set1_epi8(3)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_add_epi8(indices, offset));
+    }
+    return i;
+}
+
+BASE64_TARGET("avx2") size_t decode_avx2(const char* src, size_t len, uint8_t* dst)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32, dst += 24) {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+        const __m256i plus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+        if (_mm256_movemask_epi8(valid) != -1) break;
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        const __m256i values = _mm256_add_epi8(in, shift);
+
+        const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        packed = _mm256_shuffle_epi8(packed, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        /** close the 4-byte gap between the two lanes, leaving 24 contiguous bytes */
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), packed);
+    }
+    return i;
+}
+
+bool cpu_supports(const char* isa)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool ssse3 = regs[2] & (1 << 9);
+    const bool osxsave = regs[2] & (1 << 27);
+    const bool avx = regs[2] & (1 << 28);
+
+    if (std::string_view(isa) == "ssse3") return ssse3;
+
+    /** avx2 also needs the os to save ymm state across context switches */
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(regs, 7, 0);
+    return regs[1] & (1 << 5);
+#else
+    __builtin_cpu_init();
+    return std::string_view(isa) == "avx2" ? __builtin_cpu_supports("avx2") : __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif
+
+#ifdef BASE64_NEON
+/** arm64 has de-interleaving loads/stores and 64-byte table lookups, so neither direction needs shuffles */
+size_t encode_neon(const uint8_t* src, size_t len, char* dst)
+{
+    const uint8x16x4_t alphabet = vld1q_u8_x4(reinterpret_cast<const uint8_t*>(k_alphabet));
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+    size_t i = 0;
+    for (; i + 48 <= len; i += 48, dst += 64) {
+        const uint8x16x3_t in = vld3q_u8(src + i);
+
+        uint8x16x4_t out;
+        out.val[0] = vqtbl4q_u8(alphabet, vshrq_n_u8(in.val[0], 2));
+        out.val[1] = vqtbl4q_u8(alphabet, vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask));
+        out.val[2] = vqtbl4q_u8(alphabet, vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask));
+        out.val[3] = vqtbl4q_u8(alphabet, vandq_u8(in.val[2], mask));
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst), out);
+    }
+    return i;
+}
+
+size_t decode_neon(const char* src, size_t len, uint8_t* dst)
+{
+    const uint8x16x4_t table_lo = vld1q_u8_x4(k_decode_table.data());
+    const uint8x16x4_t table_hi = vld1q_u8_x4(k_decode_table.data() + 64);
+    const uint8x16_t sixty_four = vdupq_n_u8(64);
+
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64, dst += 48) {
+        const uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+
+        /** bytes 0-63 come from the first lookup, 64-127 from the second, anything above 127 is forced invalid */
+        uint8x16x4_t values;
+        uint8x16_t invalid = vdupq_n_u8(0);
+        for (int k = 0; k < 4; ++k) {
+            values.val[k] = vqtbx4q_u8(vqtbl4q_u8(table_lo, in.val[k]), table_hi, vsubq_u8(in.val[k], sixty_four));
+            invalid = vorrq_u8(invalid, vorrq_u8(values.val[k], vcgeq_u8(in.val[k], vdupq_n_u8(128))));
+        }
+        if (vmaxvq_u8(invalid) > 0x3F) break;
+
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+        vst3q_u8(dst, out);
+    }
+    return i;
+}
+#endif
+
+constexpr codec k_codecs[] = {
+#ifdef BASE64_X86
+    { "avx2",   encode_avx2,   decode_avx2   },
+    { "ssse3",  encode_ssse3,  decode_ssse3  },
+#endif
+#ifdef BASE64_NEON
+    { "neon",   encode_neon,   decode_neon   },
+#endif
+    { "scalar", encode_scalar, decode_scalar },
+};
+
+bool codec_available(const codec& candidate)
+{
+#ifdef BASE64_X86
+    const std::string_view name = candidate.name;
+    if (name == "avx2" || name == "ssse3") return cpu_supports(candidate.name);
+#endif
+    (void)candidate;
+    return true;
+}
+
+const codec* pick_best_codec()
+{
+    for (const codec& candidate : k_codecs) {
+        if (codec_available(candidate)) return &candidate;
+    }
+    return &k_codecs[std::size(k_codecs) - 1];
+}
+
+std::atomic<const codec*>& active_codec()
+{
+    static std::atomic<const codec*> active{ pick_best_codec() };
+    return active;
+}
+} // namespace
+
+void base64::encode_append(std::string_view in, std::string& out)
+{
+    const codec& impl = *active_codec().load(std::memory_order_relaxed);
+    const auto* src = reinterpret_cast<const uint8_t*>(in.data());
+
+    out.resize_and_overwrite(out.size() + encoded_size(in.size()) + k_output_slack, [&, start = out.size()](char* buffer, size_t)
+    {
+        char* dst = buffer + start;
+
+        size_t done = impl.encode(src, in.size(), dst);
+        done += encode_scalar(src + done, in.size() - done, dst + done / 3 * 4);
+        dst += done / 3 * 4;
+
+        if (const size_t rest = in.size() - done) {
+            const uint32_t triple = (uint32_t(src[done]) << 16) | (rest == 2 ? uint32_t(src[done + 1]) << 8 : 0);
+            dst[0] = k_alphabet[(triple >> 18) & 0x3F];
+            dst[1] = k_alphabet[(triple >> 12) & 0x3F];
+            dst[2] = rest == 2 ? k_alphabet[(triple >> 6) & 0x3F] : '=';
+            dst[3] = '=';
+            dst += 4;
+        }
+        return static_cast<size_t>(dst - buffer);
+    });
+}
+
+std::string base64::encode(std::string_view in)
+{
+    std::string out;
+    encode_append(in, out);
+    return out;
+}
+
+size_t base64::decode_append(std::string_view in, std::string& out)
+{
+    const codec& impl = *active_codec().load(std::memory_order_relaxed);
+    size_t consumed = 0;
+
+    out.resize_and_overwrite(out.size() + in.size() / 4 * 3 + 3 + k_output_slack, [&, start = out.size()](char* buffer, size_t)
+    {
+        auto* dst = reinterpret_cast<uint8_t*>(buffer + start);
+
+        consumed = impl.decode(in.data(), in.size(), dst);
+        consumed += decode_scalar(in.data() + consumed, in.size() - consumed, dst + consumed / 4 * 3);
+        dst += consumed / 4 * 3;
+
+        /** a trailing partial quartet (or the one holding the first bad character) still yields its whole bytes */
+        uint32_t bits = 0;
+        size_t count = 0;
+        while (consumed + count < in.size() && count < 4) {
+            const uint8_t value = k_decode_table[static_cast<unsigned char>(in[consumed + count])];
+            if (value & 0xC0) break;
+            bits = (bits << 6) | value;
+            ++count;
+        }
+        if (count >= 2) *dst++ = static_cast<uint8_t>(bits >> (count * 6 - 8));
+        if (count >= 3) *dst++ = static_cast<uint8_t>(bits >> (count * 6 - 16));
+        consumed += count;
+
+        return static_cast<size_t>(reinterpret_cast<char*>(dst) - buffer);
+    });
+    return consumed;
+}
+
+std::string base64::decode(std::string_view in)
+{
+    std::string out;
+    decode_append(in, out);
+    return out;
+}
+
+const char* base64::backend()
+{
+    return active_codec().load(std::memory_order_relaxed)->name;
+}
+
+std::vector<std::string_view> base64::available_backends()
+{
+    std::vector<std::string_view> names;
+    for (const codec& candidate : k_codecs) {
+        if (codec_available(candidate)) names.push_back(candidate.name);
+    }
+    return names;
+}
+
+bool base64::select_backend(std::string_view name)
+{
+    for (const codec& candidate : k_codecs) {
+        if (candidate.name == name && codec_available(candidate)) {
+            active_codec().store(&candidate, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,204 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/star_decompress.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+/** reused buffers above this are released instead of kept around for the next call */
+constexpr size_t k_retained_capacity = 8u * 1024u * 1024u;
+
+/** wild copies may write up to this many bytes past the declared end of the output */
+constexpr size_t k_output_slack = 32;
+
+inline void copy8(uint8_t* dst, const uint8_t* src)
+{
+    std::memcpy(dst, src, 8);
+}
+
+inline void copy16(uint8_t* dst, const uint8_t* src)
+{
+    std::memcpy(dst, src, 16);
+}
+
+/** copy [src, src + (end - dst)) in 8 byte strides, may overrun end by up to 7 bytes. src must trail dst by >= 8 */
+inline void wild_copy8(uint8_t* dst, const uint8_t* src, uint8_t* end)
+{
+    do {
+        copy8(dst, src);
+        dst += 8;
+        src += 8;
+    } while (dst < end);
+}
+
+/** same with 16 byte strides, may overrun end by up to 15 bytes. src must trail dst by >= 16 (or not overlap at all) */
+inline void wild_copy16(uint8_t* dst, const uint8_t* src, uint8_t* end)
+{
+    do {
+        copy16(dst, src);
+        dst += 16;
+        src += 16;
+    } while (dst < end);
+}
+
+/**
+ * for matches closer than 8 bytes: replicate the first 8 bytes of the pattern so that what follows can be copied
+ * with 8 byte strides. afterwards dst has advanced by 8 and src trails it by a multiple of offset that is >= 8.
+ */
+inline void expand_short_offset(uint8_t*& dst, const uint8_t*& src, size_t offset)
+{
+    static constexpr uint8_t inc[8] = { 0, 1, 2, 1, 0, 4, 4, 4 };
+    static constexpr int dec[8] = { 0, 0, 0, -1, -4, 1, 2, 3 };
+
+    dst[0] = src[0];
+    dst[1] = src[1];
+    dst[2] = src[2];
+    dst[3] = src[3];
+    src += inc[offset];
+    std::memcpy(dst + 4, src, 4);
+    src -= dec[offset];
+    dst += 8;
+}
+
+/** read an lz4 style length extension. returns false if it runs past limit */
+inline bool read_length(const uint8_t*& ip, const uint8_t* ip_end, size_t& length, size_t limit)
+{
+    while (ip < ip_end) {
+        const uint8_t b = *ip++;
+        length += b;
+
+        /** bail if accumulator exceeds output buffer size, preventing 32bit size_t overflow. */
+        if (length > limit) return false;
+        if (b != 255) break;
+    }
+    return true;
+}
+
+/**
+ * decode sequences from [ip, ip_end) into base, which must be writable up to op_end + k_output_slack.
+ * returns an error message, or nullptr with op set to the end of the decoded data.
+ */
+const char* decode_block(const uint8_t* ip, const uint8_t* const ip_end, uint8_t* const base, uint8_t* const op_end, uint8_t*& op)
+{
+    op = base;
+
+    while (ip < ip_end) {
+        const uint8_t token = *ip++;
+
+        size_t lit_len = static_cast<size_t>(token >> 4);
+        if (lit_len == 15 && !read_length(ip, ip_end, lit_len, static_cast<size_t>(op_end - op))) return "literal overflow";
+        if (lit_len > static_cast<size_t>(op_end - op) || lit_len > static_cast<size_t>(ip_end - ip)) return "literal overflow";
+
+        if (lit_len != 0) {
+            /** stride copy while the input has room for the overrun, exact copy for the last literals */
+            if (static_cast<size_t>(ip_end - ip) >= lit_len + 16) {
+                wild_copy16(op, ip, op + lit_len);
+            } else {
+                std::memcpy(op, ip, lit_len);
+            }
+            op += lit_len;
+            ip += lit_len;
+        }
+
+        if (ip >= ip_end) break;
+
+        if (ip_end - ip < 2) return "truncated match offset";
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0) return "zero match offset";
+
+        size_t match_len = static_cast<size_t>(token & 0xFu) + 4u;
+        if ((token & 0xFu) == 15u && !read_length(ip, ip_end, match_len, static_cast<size_t>(op_end - op))) return "match overflow";
+        if (match_len > static_cast<size_t>(op_end - op)) return "match overflow";
+        if (offset > static_cast<size_t>(op - base)) return "invalid match offset";
+
+        uint8_t* const match_end = op + match_len;
+        const uint8_t* match = op - offset;
+
+        if (offset >= 16) {
+            wild_copy16(op, match, match_end);
+        } else {
+            if (offset < 8) {
+                expand_short_offset(op, match, offset);
+            } else {
+                copy8(op, match);
+                op += 8;
+                match += 8;
+            }
+            if (op < match_end) wild_copy8(op, match, match_end);
+        }
+        op = match_end;
+    }
+
+    return nullptr;
+}
+} // namespace
+
+uint32_t star_decompressed_size(const uint8_t* src, size_t src_len)
+{
+    if (src_len < 4) throw std::runtime_error("star_decompress: input too short");
+
+    const uint32_t orig_size = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8) | (static_cast<uint32_t>(src[2]) << 16) | (static_cast<uint32_t>(src[3]) << 24);
+    if (orig_size > STAR_DECOMPRESS_MAX) throw std::runtime_error("star_decompress: decompressed size exceeds 64 MB limit");
+
+    return orig_size;
+}
+
+void star_decompress_into(const uint8_t* src, size_t src_len, std::string& out)
+{
+    const size_t orig_size = star_decompressed_size(src, src_len);
+    const char* error = nullptr;
+
+    /** the slack is only written by overrunning copies, never returned, so it doesn't need zeroing */
+    out.resize_and_overwrite(orig_size + k_output_slack, [&](char* buf, size_t)
+    {
+        uint8_t* const base = reinterpret_cast<uint8_t*>(buf);
+        uint8_t* op = base;
+        error = decode_block(src + 4, src + src_len, base, base + orig_size, op);
+        return error ? 0 : static_cast<size_t>(op - base);
+    });
+
+    if (error) throw std::runtime_error(std::string("star_decompress: ") + error);
+}
+
+std::string star_decompress(const uint8_t* src, size_t src_len)
+{
+    std::string out;
+    star_decompress_into(src, src_len, out);
+    return out;
+}
+
+void star_decompress_trim(std::string& buffer)
+{
+    if (buffer.capacity() > k_retained_capacity) std::string().swap(buffer);
+}
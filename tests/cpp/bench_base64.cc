@@ -0,0 +1,142 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * base64 throughput benchmark.
+ *
+ * compares every codec backend this cpu supports with the implementation encoding.h used before the
+ * simd rewrite, on payload sizes typical of a small script, a stylesheet/image and a full store page.
+ * not part of ctest; run it by hand on a release build.
+ */
+#include "millennium/base64.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+/** the byte-at-a-time codec encoding.h shipped before, kept verbatim as the baseline */
+std::string legacy_encode(const std::string& in)
+{
+    std::string out;
+
+    int val = 0, valb = -6;
+    for (unsigned char c : in) {
+        val = (val << 8) + c;
+        valb += 8;
+        while (valb >= 0) {
+            out.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(val >> valb) & 0x3F]);
+            valb -= 6;
+        }
+    }
+    if (valb > -6) out.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[((val << 8) >> (valb + 8)) & 0x3F]);
+    while (out.size() % 4)
+        out.push_back('=');
+    return out;
+}
+
+std::string legacy_decode(const std::string& in)
+{
+    std::string out;
+    std::vector<int> T(256, -1);
+    for (int i = 0; i < 64; i++)
+        T["ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i]] = i;
+
+    int val = 0, valb = -8;
+    for (unsigned char c : in) {
+        if (T[c] == -1) break;
+        val = (val << 6) + T[c];
+        valb += 6;
+        if (valb >= 0) {
+            out.push_back(char((val >> valb) & 0xFF));
+            valb -= 8;
+        }
+    }
+    return out;
+}
+
+/** MB/s of payload processed, over enough iterations to move ~256 MB */
+double measure(size_t payload_size, const std::function<size_t()>& run)
+{
+    const size_t iterations = std::max<size_t>(1, (256u << 20) / payload_size);
+    size_t sink = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        sink += run();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (sink == 0) std::println("(empty output)");
+    return static_cast<double>(payload_size) * static_cast<double>(iterations) / elapsed.count() / (1024.0 * 1024.0);
+}
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(1234);
+    const std::vector<std::pair<const char*, size_t>> sizes = {
+        { "1 KB",  1024            },
+        { "64 KB", 64 * 1024       },
+        { "4 MB",  4 * 1024 * 1024 },
+    };
+
+    std::println("{:<8} {:<8} {:>14} {:>14}", "size", "codec", "encode MB/s", "decode MB/s");
+
+    for (const auto& [label, size] : sizes) {
+        std::string payload(size, '\0');
+        for (auto& c : payload) {
+            c = static_cast<char>(rng());
+        }
+        const std::string encoded = legacy_encode(payload);
+
+        const double legacy_enc = measure(size, [&] { return legacy_encode(payload).size(); });
+        const double legacy_dec = measure(size, [&] { return legacy_decode(encoded).size(); });
+        std::println("{:<8} {:<8} {:>14.1f} {:>14.1f}", label, "legacy", legacy_enc, legacy_dec);
+
+        for (std::string_view backend : base64::available_backends()) {
+            base64::select_backend(backend);
+            if (base64::encode(payload) != encoded || base64::decode(encoded) != payload) {
+                std::println("{} produced wrong output, aborting", backend);
+                return 1;
+            }
+
+            const double enc = measure(size, [&] { return base64::encode(payload).size(); });
+            const double dec = measure(size, [&] { return base64::decode(encoded).size(); });
+            std::println("{:<8} {:<8} {:>14.1f} {:>14.1f}", label, backend, enc, dec);
+        }
+    }
+    return 0;
+}
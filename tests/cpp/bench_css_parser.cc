@@ -0,0 +1,219 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * :root property extraction benchmark.
+ *
+ * compares css_parser::parse_root_properties with the std::regex extraction it replaced.
+ * pass theme files or directories (e.g. your steam/millennium/themes folder) to measure real corpora,
+ * otherwise a generated RootColors file and a generated full theme stylesheet are used.
+ * not part of ctest; run it by hand on a release build.
+ */
+#include "head/css_parser.h"
+
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <print>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using property_values = std::map<std::string, std::string>;
+using property_docs = std::map<std::string, std::pair<std::string, std::string>>;
+
+/** the extraction css_parser used before, kept verbatim for comparison */
+namespace legacy
+{
+std::string extract_root_block(const std::string& fileContent)
+{
+    std::regex rootRegex(R"(:root\s*\{([\s\S]*)\})", std::regex::ECMAScript);
+    std::smatch match;
+    if (std::regex_search(fileContent, match, rootRegex)) return match[1].str();
+    return "";
+}
+
+void parse_properties(const std::string& block, property_values& properties, property_docs& propertyMap)
+{
+    std::istringstream ss(block);
+    std::string line;
+    std::string lastComment;
+    bool inComment = false;
+
+    while (std::getline(ss, line)) {
+        line = head::css_parser::trim(line);
+        if (line.empty()) continue;
+
+        if (line.rfind("/*", 0) == 0) {
+            lastComment.clear();
+            inComment = true;
+        }
+
+        if (inComment) {
+            lastComment += line + "\n";
+            if (line.find("*/") != std::string::npos) inComment = false;
+            continue;
+        }
+
+        std::regex propRegex(R"(([\w-]+)\s*:\s*([^;]+);)");
+        std::smatch match;
+        if (std::regex_match(line, match, propRegex)) {
+            std::string propName = match[1].str();
+            std::string propValue = head::css_parser::trim(match[2].str());
+            properties[propName] = propValue;
+
+            std::string name, description;
+            if (!lastComment.empty()) {
+                std::regex nameRegex(R"(@name\s+([^\*]+))");
+                std::regex descRegex(R"(@description\s+([^\*]+))");
+                std::smatch nameMatch, descMatch;
+                if (std::regex_search(lastComment, nameMatch, nameRegex)) name = head::css_parser::trim(nameMatch[1].str());
+                if (std::regex_search(lastComment, descMatch, descRegex)) description = head::css_parser::trim(descMatch[1].str());
+                lastComment.clear();
+            }
+
+            propertyMap[propName] = { name, description };
+        }
+    }
+}
+} // namespace legacy
+
+/** the regex recurses per character and overflows the stack on big stylesheets, so it only runs on small ones */
+constexpr size_t LEGACY_MAX_BYTES = 16u << 10;
+
+/** microseconds per parse, over ~200 ms of iterations. run returns the property count, which must stay at expected */
+double measure(size_t expected, const std::function<size_t()>& run)
+{
+    size_t sink = 0;
+    size_t iterations = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        sink += run();
+        ++iterations;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < std::chrono::milliseconds(200));
+
+    if (sink != expected * iterations) std::println("(inconsistent results between iterations)");
+    return elapsed.count() * 1e6 / static_cast<double>(iterations);
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+std::string generated_root_colors()
+{
+    std::string css = "/* generated RootColors file */\n:root {\n";
+    for (int i = 0; i < 48; ++i) {
+        css += std::format("    /**\n     * @name Color {}\n     * @description Used for panel {} backgrounds\n     */\n    --theme-color-{}: #{:06x};\n\n", i, i, i,
+                           (i * 2654435761u) & 0xffffff);
+    }
+    return css + "}\n";
+}
+
+std::string generated_theme()
+{
+    std::string css = generated_root_colors();
+    for (int i = 0; css.size() < (1u << 20); ++i) {
+        css += std::format(".library_{0} .panel_{0}:hover > div {{\n    background: rgba(var(--theme-color-{1}), 0.8);\n    font-family: \"Motiva Sans\", sans-serif;\n"
+                           "    /* keep the steam layout */\n    margin: 0 calc(100% - {0}px);\n}}\n",
+                           i, i % 48);
+    }
+    return css;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::pair<std::string, std::string>> corpus;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::filesystem::path root(argv[i]);
+        if (std::filesystem::is_directory(root)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".css") corpus.emplace_back(entry.path().filename().string(), read_file(entry.path()));
+            }
+        } else if (std::filesystem::is_regular_file(root)) {
+            corpus.emplace_back(root.filename().string(), read_file(root));
+        }
+    }
+    if (corpus.empty()) {
+        corpus.emplace_back("root_colors", generated_root_colors());
+        corpus.emplace_back("full_theme", generated_theme());
+    }
+
+    std::println("{:<32} {:>10} {:>6} {:>12} {:>12} {:>8}", "file", "bytes", "props", "regex us", "scan us", "speedup");
+
+    for (const auto& [label, css] : corpus) {
+        property_values values;
+        property_docs docs;
+        head::css_parser::parse_root_properties(css, values, docs);
+
+        const double scan = measure(values.size(), [&]
+        {
+            property_values v;
+            property_docs d;
+            head::css_parser::parse_root_properties(css, v, d);
+            return v.size();
+        });
+
+        if (css.size() > LEGACY_MAX_BYTES) {
+            std::println("{:<32} {:>10} {:>6} {:>12} {:>12.1f} {:>8}", label.substr(0, 32), css.size(), values.size(), "-", scan, "-");
+            continue;
+        }
+
+        property_values legacy_values;
+        property_docs legacy_docs;
+        legacy::parse_properties(legacy::extract_root_block(css), legacy_values, legacy_docs);
+        if (legacy_values != values) std::println("{}: note, the regex extraction found {} properties", label, legacy_values.size());
+
+        const double regex = measure(legacy_values.size(), [&]
+        {
+            property_values v;
+            property_docs d;
+            legacy::parse_properties(legacy::extract_root_block(css), v, d);
+            return v.size();
+        });
+
+        std::println("{:<32} {:>10} {:>6} {:>12.1f} {:>12.1f} {:>7.1f}x", label.substr(0, 32), css.size(), values.size(), regex, scan, regex / scan);
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * frontend -> backend plugin call benchmark.
+ *
+ * runs a call to a no-op plugin method through everything the parent does for it, once the way the generic
+ * path does (payload dom, request dom, to_msgpack, result dom, ordered reply dom) and once through ffi_fast_path.
+ * the child is simulated in-process by decoding the frame and packing an empty result, identically for both,
+ * so the difference is the parent's share. not part of ctest; run it by hand on a release build.
+ */
+#include "millennium/ffi_fast_path.h"
+#include "millennium/plugin_ipc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <print>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr size_t ITERATIONS = 200000;
+
+/** stand-in for the child's evaluate handler: decode the request, answer a no-op method */
+std::vector<uint8_t> child_round_trip(const std::vector<uint8_t>& frame)
+{
+    const auto request = nlohmann::json::from_msgpack(frame);
+    if (request["params"]["methodName"].get_ref<const std::string&>().empty()) return {};
+
+    return nlohmann::json::to_msgpack(nlohmann::json{
+        { "success", true    },
+        { "value",   nullptr }
+    });
+}
+
+size_t generic_call(const std::string& payload)
+{
+    const nlohmann::json parsed = nlohmann::json::parse(payload);
+    const nlohmann::json call = parsed; /** process_message() takes the payload by value */
+    const auto& data = call["data"];
+    const std::string plugin = data["pluginName"];
+
+    const nlohmann::json req = {
+        { "type",   plugin_ipc::TYPE_REQUEST             },
+        { "id",     1                                    },
+        { "method", plugin_ipc::parent_method::EVALUATE },
+        { "params", data                                 }
+    };
+    const auto result = nlohmann::json::from_msgpack(child_round_trip(nlohmann::json::to_msgpack(req)));
+
+    nlohmann::ordered_json response{
+        { "success",    result["success"].get<bool>() },
+        { "pluginName", plugin                        }
+    };
+    response["returnJson"] = result["value"].is_null() ? nlohmann::ordered_json(nullptr) : nlohmann::ordered_json(result["value"]);
+
+    /** the recorder's copy of the arguments and result, then the reply itself */
+    const std::string args = data.dump();
+    const std::string recorded = response.dump();
+    return args.size() + recorded.size() + response.dump().size() + static_cast<size_t>(call["call_id"].get<int>());
+}
+
+size_t fast_call(const std::string& payload)
+{
+    thread_local ffi_fast_path::call call;
+    thread_local std::vector<uint8_t> params;
+    thread_local std::vector<uint8_t> frame;
+    thread_local std::string response;
+
+    if (!ffi_fast_path::parse(payload, call)) return 0;
+
+    ffi_fast_path::pack_evaluate_params(call, params);
+    plugin_ipc::pack_request(frame, 1, plugin_ipc::parent_method::EVALUATE, params);
+    ffi_fast_path::write_response(response, call.plugin, nlohmann::json::from_msgpack(child_round_trip(frame)));
+
+    std::string args;
+    ffi_fast_path::write_arguments_json(call, args);
+    const std::string recorded = response;
+    return args.size() + recorded.size() + response.size() + static_cast<size_t>(call.call_id);
+}
+
+struct run_stats
+{
+    double calls_per_sec;
+    double p50_us;
+    double p99_us;
+};
+
+run_stats measure(const std::string& payload, const std::function<size_t(const std::string&)>& run)
+{
+    std::vector<double> samples;
+    samples.reserve(ITERATIONS);
+    size_t sink = 0;
+
+    for (size_t i = 0; i < ITERATIONS / 10; ++i)
+        sink += run(payload);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        sink += run(payload);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (sink == 0) std::println("(no output)");
+    std::sort(samples.begin(), samples.end());
+    return { static_cast<double>(ITERATIONS) / elapsed.count(), samples[samples.size() / 2], samples[samples.size() * 99 / 100] };
+}
+} // namespace
+
+int main()
+{
+    const std::vector<std::pair<const char*, std::string>> payloads = {
+        { "no args",
+         R"({"id":0,"call_id":17,"caller":"index.tsx:42","data":{"pluginName":"bench","methodName":"noop"}})" },
+        { "scalars",
+         R"({"id":0,"call_id":17,"caller":"index.tsx:42","data":{"pluginName":"bench","methodName":"noop","argumentList":{"app_id":730,"name":"Counter-Strike 2","enabled":true,"volume":0.75}}})" },
+    };
+
+    std::println("{:<8} {:>14} {:>10} {:>10} {:>14} {:>10} {:>10} {:>8}", "payload", "generic/s", "p50 us", "p99 us", "fast/s", "p50 us", "p99 us", "speedup");
+
+    for (const auto& [label, payload] : payloads) {
+        const run_stats generic = measure(payload, generic_call);
+        const run_stats fast = measure(payload, fast_call);
+        std::println("{:<8} {:>14.0f} {:>10.2f} {:>10.2f} {:>14.0f} {:>10.2f} {:>10.2f} {:>7.2f}x", label, generic.calls_per_sec, generic.p50_us, generic.p99_us, fast.calls_per_sec,
+                     fast.p50_us, fast.p99_us, fast.calls_per_sec / generic.calls_per_sec);
+    }
+    return 0;
+}
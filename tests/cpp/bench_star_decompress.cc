@@ -0,0 +1,112 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * star lz decoder throughput benchmark.
+ *
+ * compares the wildcopy decoder with the byte-at-a-time one star_parser.h used before, on a script bundle
+ * (long literal runs, short matches), a run-heavy asset (overlapping matches) and incompressible data.
+ * not part of ctest; run it by hand on a release build.
+ */
+#include "millennium/star_decompress.h"
+#include "star_lz_reference.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+/** MB/s of decompressed output, over enough iterations to produce ~512 MB */
+double measure(size_t output_size, const std::function<size_t()>& run)
+{
+    const size_t iterations = std::max<size_t>(1, (512u << 20) / output_size);
+    size_t sink = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        sink += run();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (sink == 0) std::println("(empty output)");
+    return static_cast<double>(output_size) * static_cast<double>(iterations) / elapsed.count() / (1024.0 * 1024.0);
+}
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(1234);
+    std::vector<std::pair<const char*, std::string>> payloads;
+
+    std::string bundle;
+    while (bundle.size() < (4u << 20))
+        bundle += "export const c" + std::to_string(rng() % 5000) + " = (e) => e.props.children.map((x) => x * " + std::to_string(rng() % 100) + ");\n";
+    payloads.emplace_back("bundle", std::move(bundle));
+
+    std::string runs;
+    while (runs.size() < (4u << 20))
+        runs.append(1 + rng() % 64, static_cast<char>("\x00\xff\x7f"[rng() % 3])).append("\x12\x34\x56", 1 + rng() % 3);
+    payloads.emplace_back("runs", std::move(runs));
+
+    std::string noise(1u << 20, '\0');
+    for (auto& c : noise)
+        c = static_cast<char>(rng());
+    payloads.emplace_back("random", std::move(noise));
+
+    std::println("{:<8} {:>10} {:>14} {:>14} {:>8}", "payload", "ratio", "legacy MB/s", "wild MB/s", "speedup");
+
+    for (const auto& [label, payload] : payloads) {
+        const std::string block = star_lz::compress(payload);
+        const auto* src = reinterpret_cast<const uint8_t*>(block.data());
+
+        if (star_decompress(src, block.size()) != payload) {
+            std::println("{}: wrong output, aborting", label);
+            return 1;
+        }
+
+        std::string buffer;
+        const double legacy = measure(payload.size(), [&] { return star_lz::legacy_decompress(src, block.size()).size(); });
+        const double wild = measure(payload.size(), [&]
+        {
+            star_decompress_into(src, block.size(), buffer);
+            return buffer.size();
+        });
+
+        const double ratio = static_cast<double>(payload.size()) / static_cast<double>(block.size());
+        std::println("{:<8} {:>10.2f} {:>14.1f} {:>14.1f} {:>7.2f}x", label, ratio, legacy, wild, wild / legacy);
+    }
+    return 0;
+}
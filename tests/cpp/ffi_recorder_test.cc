@@ -32,8 +32,11 @@
 #include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
+#include <cmath>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace mep;
 
@@ -58,6 +61,11 @@ ffi_call_entry make_entry(std::string plugin, std::string method = "test_method"
         .caller = "",
     };
 }
+
+bool within_percent(double actual, double expected, double percent)
+{
+    return std::abs(actual - expected) <= expected * percent / 100.0;
+}
 } // namespace
 
 TEST_CASE("ffi_recorder: records entries and retrieves them in chronological order", "[ffi_recorder]")
@@ -150,3 +158,123 @@ TEST_CASE("ffi_recorder: tolerates listener exceptions without crashing", "[ffi_
     rec.remove_listener(throwing);
     rec.remove_listener(after);
 }
+
+TEST_CASE("ffi_recorder: reports call latency percentiles per plugin", "[ffi_recorder]")
+{
+    auto& rec = ffi_recorder::instance();
+    const auto plugin = unique_plugin("latency");
+
+    CHECK(rec.get_latency(plugin).samples == 0);
+
+    for (int ms = 1; ms <= 100; ++ms) {
+        auto entry = make_entry(plugin);
+        entry.duration_ms = static_cast<double>(ms);
+        rec.record(entry);
+    }
+
+    const auto stats = rec.get_latency(plugin);
+    CHECK(stats.samples == 100);
+    CHECK(stats.p50_ms == 50.0);
+    CHECK(stats.p90_ms == 90.0);
+    CHECK(stats.p99_ms == 99.0);
+    CHECK(stats.max_ms == 100.0);
+
+    CHECK(rec.get_latency("").samples >= 100);
+}
+
+TEST_CASE("ffi_recorder: histogram percentiles stay within a few percent", "[ffi_recorder]")
+{
+    latency_histogram histogram;
+    CHECK(histogram.percentile(0.5) == 0.0);
+
+    /** 0.001ms .. 10ms in 1us steps */
+    for (int us = 1; us <= 10000; ++us) {
+        histogram.record(us / 1000.0);
+    }
+
+    CHECK(histogram.count() == 10000);
+    CHECK(within_percent(histogram.percentile(0.50), 5.0, 3.0));
+    CHECK(within_percent(histogram.percentile(0.90), 9.0, 3.0));
+    CHECK(within_percent(histogram.percentile(0.99), 9.9, 3.0));
+    CHECK(histogram.max() == 10.0);
+
+    latency_histogram tiny;
+    tiny.record(0.004);
+    CHECK(tiny.percentile(0.5) == 0.004);
+}
+
+TEST_CASE("ffi_recorder: reports latency per method", "[ffi_recorder]")
+{
+    auto& rec = ffi_recorder::instance();
+    const auto plugin = unique_plugin("methods");
+
+    CHECK(rec.get_method_latency(plugin).empty());
+
+    for (int i = 0; i < 10; ++i) {
+        auto fast = make_entry(plugin, "fast");
+        fast.duration_ms = 2.0;
+        rec.record(fast);
+    }
+    auto slow = make_entry(plugin, "slow");
+    slow.duration_ms = 250.0;
+    rec.record(slow);
+
+    const auto methods = rec.get_method_latency(plugin);
+    REQUIRE(methods.size() == 2);
+    CHECK(methods[0].method == "fast");
+    CHECK(methods[0].direction == "fe_to_be");
+    CHECK(methods[0].stats.samples == 10);
+    CHECK(within_percent(methods[0].stats.p50_ms, 2.0, 3.0));
+    CHECK(methods[1].method == "slow");
+    CHECK(methods[1].stats.samples == 1);
+    CHECK(methods[1].stats.max_ms == 250.0);
+}
+
+TEST_CASE("ffi_recorder: truncates oversized payloads", "[ffi_recorder]")
+{
+    auto& rec = ffi_recorder::instance();
+    const auto plugin = unique_plugin("truncate");
+
+    const std::string big(ffi_recorder::MAX_PAYLOAD_BYTES * 4, 'x');
+    rec.record(ffi_call_sample{ plugin, "m", "be_to_fe", big, "{}", 1.0, std::chrono::system_clock::now(), "main.lua:1" });
+
+    const auto recent = rec.get_recent(plugin);
+    REQUIRE(recent.size() == 1);
+    CHECK(recent[0].args.size() == ffi_recorder::MAX_PAYLOAD_BYTES + 3);
+    CHECK(recent[0].args.ends_with("x..."));
+    CHECK(recent[0].result == "{}");
+    CHECK(recent[0].direction == "be_to_fe");
+    CHECK(recent[0].caller == "main.lua:1");
+}
+
+TEST_CASE("ffi_recorder: collects calls recorded from many threads", "[ffi_recorder]")
+{
+    auto& rec = ffi_recorder::instance();
+    const auto plugin = unique_plugin("threads");
+    const std::size_t dropped_before = rec.dropped();
+
+    constexpr int THREADS = 4;
+    constexpr int CALLS = 100;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&rec, &plugin, t]
+        {
+            for (int i = 0; i < CALLS; ++i) {
+                rec.record(make_entry(plugin, "thread_" + std::to_string(t)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const std::size_t lost = rec.dropped() - dropped_before;
+    CHECK(rec.get_recent(plugin, THREADS * CALLS).size() + lost == THREADS * CALLS);
+
+    std::size_t counted = 0;
+    for (const auto& m : rec.get_method_latency(plugin)) {
+        counted += m.stats.samples;
+    }
+    CHECK(counted + lost == THREADS * CALLS);
+}
@@ -0,0 +1,65 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * libFuzzer target for the star lz decoder.
+ *
+ * every input is decoded by both the production decoder and the old byte-at-a-time one, which must agree on
+ * the output or on rejecting it. build with clang and -DMILLENNIUM_BUILD_FUZZERS=ON, run with asan/ubsan:
+ *   ./star_decompress_fuzz -max_len=65536 corpus/
+ */
+#include "millennium/star_decompress.h"
+#include "star_lz_reference.h"
+#include <cstdlib>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    std::string ours, ours_error;
+    std::vector<uint8_t> theirs;
+    std::string theirs_error;
+
+    try {
+        star_decompress_into(data, size, ours);
+    } catch (const std::exception& e) {
+        ours_error = e.what();
+    }
+
+    try {
+        theirs = star_lz::legacy_decompress(data, size);
+    } catch (const std::exception& e) {
+        theirs_error = e.what();
+    }
+
+    if (ours_error != theirs_error) std::abort();
+    if (ours_error.empty() && ours != std::string(theirs.begin(), theirs.end())) std::abort();
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * helpers shared by the star lz decoder test, fuzz target and benchmark: the byte-at-a-time decoder
+ * star_parser.h shipped before, kept verbatim as an oracle, and a small greedy encoder to produce blocks.
+ */
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace star_lz
+{
+inline std::vector<uint8_t> legacy_decompress(const uint8_t* src, size_t src_len)
+{
+    if (src_len < 4) throw std::runtime_error("star_decompress: input too short");
+
+    const uint32_t orig_size = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8) | (static_cast<uint32_t>(src[2]) << 16) | (static_cast<uint32_t>(src[3]) << 24);
+
+    static constexpr uint32_t STAR_DECOMPRESS_MAX = 64u * 1024u * 1024u;
+    if (orig_size > STAR_DECOMPRESS_MAX) throw std::runtime_error("star_decompress: decompressed size exceeds 64 MB limit");
+
+    std::vector<uint8_t> out(orig_size);
+
+    const uint8_t* ip = src + 4;
+    const uint8_t* ip_end = src + src_len;
+    uint8_t* op = out.data();
+    uint8_t* const op_end = out.data() + orig_size;
+
+    while (ip < ip_end) {
+        const uint8_t token = *ip++;
+
+        size_t lit_len = static_cast<size_t>(token >> 4);
+        if (lit_len == 15) {
+            const size_t max_lit_len = static_cast<size_t>(op_end - op);
+            while (ip < ip_end) {
+                const uint8_t b = *ip++;
+                lit_len += b;
+                if (lit_len > max_lit_len) throw std::runtime_error("star_decompress: literal overflow");
+                if (b != 255) break;
+            }
+        }
+        if (op + lit_len > op_end || ip + lit_len > ip_end) throw std::runtime_error("star_decompress: literal overflow");
+        std::memcpy(op, ip, lit_len);
+        op += lit_len;
+        ip += lit_len;
+
+        if (ip >= ip_end) break;
+
+        if (ip + 2 > ip_end) throw std::runtime_error("star_decompress: truncated match offset");
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0) throw std::runtime_error("star_decompress: zero match offset");
+
+        size_t match_len = static_cast<size_t>(token & 0xFu) + 4u;
+        if ((token & 0xFu) == 15u) {
+            const size_t max_match_len = static_cast<size_t>(op_end - op);
+            while (ip < ip_end) {
+                const uint8_t b = *ip++;
+                match_len += b;
+                if (match_len > max_match_len) throw std::runtime_error("star_decompress: match overflow");
+                if (b != 255) break;
+            }
+        }
+        if (op + match_len > op_end) throw std::runtime_error("star_decompress: match overflow");
+
+        const uint8_t* match_src = op - offset;
+        if (match_src < out.data()) throw std::runtime_error("star_decompress: invalid match offset");
+
+        for (size_t i = 0; i < match_len; ++i)
+            op[i] = match_src[i];
+        op += match_len;
+    }
+
+    out.resize(static_cast<size_t>(op - out.data()));
+    return out;
+}
+
+inline void put_length(std::string& out, size_t extra)
+{
+    while (extra >= 255) {
+        out.push_back(static_cast<char>(255));
+        extra -= 255;
+    }
+    out.push_back(static_cast<char>(extra));
+}
+
+/** greedy single-probe encoder, good enough to produce realistic blocks (long literals, near and far matches) */
+inline std::string compress(std::string_view in)
+{
+    std::string out;
+    const uint32_t size = static_cast<uint32_t>(in.size());
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+
+    const auto* p = reinterpret_cast<const uint8_t*>(in.data());
+    std::vector<int64_t> table(1 << 16, -1);
+    auto hash = [&](size_t i)
+    {
+        uint32_t v;
+        std::memcpy(&v, p + i, 4);
+        return (v * 2654435761u) >> 16;
+    };
+
+    size_t anchor = 0, i = 0;
+    auto emit = [&](size_t lit_end, size_t offset, size_t match_len)
+    {
+        const size_t lit_len = lit_end - anchor;
+        const size_t ml = match_len ? match_len - 4 : 0;
+        out.push_back(static_cast<char>(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15)));
+        if (lit_len >= 15) put_length(out, lit_len - 15);
+        out.append(in.substr(anchor, lit_len));
+        if (!match_len) return;
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (ml >= 15) put_length(out, ml - 15);
+    };
+
+    while (i + 4 <= in.size()) {
+        const uint32_t h = hash(i);
+        const int64_t candidate = table[h];
+        table[h] = static_cast<int64_t>(i);
+
+        if (candidate >= 0 && i - static_cast<size_t>(candidate) <= 0xFFFF && std::memcmp(p + candidate, p + i, 4) == 0) {
+            size_t len = 4;
+            while (i + len < in.size() && p[candidate + static_cast<int64_t>(len)] == p[i + len])
+                ++len;
+            emit(i, i - static_cast<size_t>(candidate), len);
+            i += len;
+            anchor = i;
+        } else {
+            ++i;
+        }
+    }
+
+    if (anchor < in.size() || in.empty()) emit(in.size(), 0, 0);
+    return out;
+}
+} // namespace star_lz
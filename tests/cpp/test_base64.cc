@@ -0,0 +1,146 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/base64.h"
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <string>
+
+namespace
+{
+/** bit-at-a-time reference, deliberately nothing like the real codec */
+std::string reference_encode(const std::string& in)
+{
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    int val = 0, bits = -6;
+    for (unsigned char c : in) {
+        val = (val << 8) + c;
+        bits += 8;
+        while (bits >= 0) {
+            out.push_back(alphabet[(val >> bits) & 0x3F]);
+            bits -= 6;
+        }
+    }
+    if (bits > -6) out.push_back(alphabet[((val << 8) >> (bits + 8)) & 0x3F]);
+    while (out.size() % 4)
+        out.push_back('=');
+    return out;
+}
+
+std::string random_bytes(std::mt19937& rng, size_t size)
+{
+    std::string bytes(size, '\0');
+    for (auto& c : bytes) {
+        c = static_cast<char>(rng());
+    }
+    return bytes;
+}
+
+/** runs the body once per implementation this cpu supports, restoring the default afterwards */
+template <typename Fn> void for_each_backend(Fn&& fn)
+{
+    const std::string original = base64::backend();
+    for (std::string_view name : base64::available_backends()) {
+        REQUIRE(base64::select_backend(name));
+        INFO("backend " << name);
+        fn();
+    }
+    base64::select_backend(original);
+}
+} // namespace
+
+TEST_CASE("base64: known vectors", "[base64]")
+{
+    for_each_backend([]
+    {
+        REQUIRE(base64::encode("") == "");
+        REQUIRE(base64::encode("f") == "Zg==");
+        REQUIRE(base64::encode("fo") == "Zm8=");
+        REQUIRE(base64::encode("foo") == "Zm9v");
+        REQUIRE(base64::encode("foobar") == "Zm9vYmFy");
+        REQUIRE(base64::decode("Zm9vYmE=") == "fooba");
+        REQUIRE(base64::decode("Zm9vYg==") == "foob");
+    });
+}
+
+TEST_CASE("base64: round trips every length across block boundaries", "[base64]")
+{
+    std::mt19937 rng(42);
+    for_each_backend([&]
+    {
+        for (size_t size = 0; size < 300; ++size) {
+            const std::string bytes = random_bytes(rng, size);
+            const std::string encoded = base64::encode(bytes);
+            REQUIRE(encoded == reference_encode(bytes));
+            REQUIRE(encoded.size() == base64::encoded_size(size));
+            REQUIRE(base64::decode(encoded) == bytes);
+        }
+
+        const std::string large = random_bytes(rng, 1 << 20);
+        REQUIRE(base64::decode(base64::encode(large)) == large);
+    });
+}
+
+TEST_CASE("base64: decoding stops at the first character outside the alphabet", "[base64]")
+{
+    std::mt19937 rng(7);
+    for_each_backend([&]
+    {
+        const std::string bytes = random_bytes(rng, 150);
+        const std::string encoded = base64::encode(bytes);
+
+        /** a bad character anywhere, including inside a simd block, keeps everything decoded in front of it */
+        for (size_t pos : { 0, 1, 5, 17, 33, 64, 100, 199 }) {
+            std::string corrupted = encoded;
+            corrupted[pos] = '!';
+
+            std::string out;
+            REQUIRE(base64::decode_append(corrupted, out) == pos);
+            REQUIRE(out == bytes.substr(0, pos * 6 / 8));
+        }
+
+        /** unpadded input still yields every whole byte */
+        REQUIRE(base64::decode("Zm9vYg") == "foob");
+
+        std::string out = "prefix";
+        REQUIRE(base64::decode_append("Zm9v\nYmFy", out) == 4);
+        REQUIRE(out == "prefixfoo");
+    });
+}
+
+TEST_CASE("base64: backend selection", "[base64]")
+{
+    const auto backends = base64::available_backends();
+    REQUIRE_FALSE(backends.empty());
+    REQUIRE(backends.back() == "scalar");
+    REQUIRE(std::string_view(base64::backend()) == backends.front());
+    REQUIRE_FALSE(base64::select_backend("sse9000"));
+}
@@ -0,0 +1,87 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/cdp_envelope.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+TEST_CASE("cdp_scan_envelope: extracts response id and raw result", "[cdp_envelope]")
+{
+    cdp_envelope env;
+    REQUIRE(cdp_scan_envelope(R"({"id":42,"result":{"value":"}{\"]","nested":[1,{"a":2}]}})", env));
+
+    REQUIRE(env.id.has_value());
+    CHECK(*env.id == 42);
+    CHECK(env.result == R"({"value":"}{\"]","nested":[1,{"a":2}]})");
+    CHECK(env.method.empty());
+    CHECK(env.error.empty());
+}
+
+TEST_CASE("cdp_scan_envelope: finds sessionId after a large params object", "[cdp_envelope]")
+{
+    const std::string body(256 * 1024, 'A');
+    const std::string payload = R"({"method":"Network.dataReceived","params":{"body":")" + body + R"(","n":[1,2,3]},"sessionId":"ABC123"})";
+
+    cdp_envelope env;
+    REQUIRE(cdp_scan_envelope(payload, env));
+    CHECK_FALSE(env.id.has_value());
+    CHECK(env.method == "Network.dataReceived");
+    CHECK(env.session_id == "ABC123");
+    CHECK(env.params.front() == '{');
+    CHECK(env.params.back() == '}');
+    CHECK(env.params.size() == body.size() + std::string(R"({"body":"","n":[1,2,3]})").size());
+}
+
+TEST_CASE("cdp_scan_envelope: handles whitespace and error responses", "[cdp_envelope]")
+{
+    cdp_envelope env;
+    REQUIRE(cdp_scan_envelope(" { \"id\" : 7 ,\n \"error\" : { \"code\": -32000, \"message\": \"nope\" } } ", env));
+    CHECK(*env.id == 7);
+    CHECK(env.error == R"({ "code": -32000, "message": "nope" })");
+}
+
+TEST_CASE("cdp_scan_envelope: ignores non-integer ids", "[cdp_envelope]")
+{
+    cdp_envelope env;
+    REQUIRE(cdp_scan_envelope(R"({"id":1.5,"method":"Page.loadEventFired"})", env));
+    CHECK_FALSE(env.id.has_value());
+    CHECK(env.method == "Page.loadEventFired");
+}
+
+TEST_CASE("cdp_scan_envelope: rejects input that needs a full parse", "[cdp_envelope]")
+{
+    cdp_envelope env;
+    CHECK_FALSE(cdp_scan_envelope("", env));
+    CHECK_FALSE(cdp_scan_envelope("[1,2]", env));
+    CHECK_FALSE(cdp_scan_envelope(R"({"id":1,"result":{"a":1})", env));
+    CHECK_FALSE(cdp_scan_envelope(R"({"id":1 "result":{}})", env));
+    CHECK_FALSE(cdp_scan_envelope(R"({"method":"Page.frame\u004eavigated"})", env));
+}
@@ -0,0 +1,184 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/cdp_event_batcher.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+/** records every batch and lets the test decide when the page "finishes" evaluating it */
+struct fake_page
+{
+    struct sent_batch
+    {
+        cdp_event_batcher::target dest;
+        json events;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<sent_batch> batches;
+    std::vector<std::promise<json>> acks;
+    bool auto_ack = true;
+
+    cdp_event_batcher::send_fn sender()
+    {
+        return [this](const cdp_event_batcher::target& dest, const std::string& expression)
+        {
+            /** pull the event array back out of the expression */
+            const auto start = expression.find("([");
+            json events = json::parse(expression.substr(start + 1, expression.size() - start - 2));
+
+            std::promise<json> ack;
+            auto future = ack.get_future();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto_ack) {
+                ack.set_value(json::object());
+            } else {
+                acks.push_back(std::move(ack));
+            }
+            batches.push_back({ dest, std::move(events) });
+            cv.notify_all();
+            return future;
+        };
+    }
+
+    bool wait_for_batches(size_t n)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, 2s, [&] { return batches.size() >= n; });
+    }
+};
+
+cdp_event_batcher::options fast_options()
+{
+    cdp_event_batcher::options opts;
+    opts.window = 5ms;
+    return opts;
+}
+} // namespace
+
+TEST_CASE("cdp_event_batcher: events in one window go out as a single evaluate", "[cdp_event_batcher]")
+{
+    fake_page page;
+    cdp_event_batcher batcher(page.sender(), fast_options());
+
+    const std::vector<cdp_event_batcher::target> targets = {
+        { 1, "session-a" },
+        { 2, "session-b" }
+    };
+    for (int i = 0; i < 50; ++i)
+        batcher.push("Network.dataReceived", { { "n", i } }, targets);
+
+    REQUIRE(page.wait_for_batches(2));
+    std::this_thread::sleep_for(30ms);
+
+    std::lock_guard<std::mutex> lock(page.mutex);
+    REQUIRE(page.batches.size() == 2);
+    for (const auto& batch : page.batches) {
+        REQUIRE(batch.events.size() == 50);
+        for (int i = 0; i < 50; ++i) {
+            REQUIRE(batch.events[i]["method"] == "Network.dataReceived");
+            REQUIRE(batch.events[i]["params"]["n"] == i);
+        }
+    }
+}
+
+TEST_CASE("cdp_event_batcher: waits for the previous batch and drops the oldest events", "[cdp_event_batcher]")
+{
+    fake_page page;
+    page.auto_ack = false;
+
+    size_t reported = 0;
+    auto opts = fast_options();
+    opts.max_queued_events = 10;
+    opts.on_overflow = [&](const cdp_event_batcher::target&, size_t dropped) { reported += dropped; };
+
+    cdp_event_batcher batcher(page.sender(), opts);
+    const std::vector<cdp_event_batcher::target> targets = {
+        { 7, "s" }
+    };
+
+    batcher.push("Page.screencastFrame", { { "n", -1 } }, targets);
+    REQUIRE(page.wait_for_batches(1));
+
+    /** first batch is still unacknowledged, so these pile up behind it */
+    for (int i = 0; i < 25; ++i)
+        batcher.push("Page.screencastFrame", { { "n", i } }, targets);
+    std::this_thread::sleep_for(40ms);
+
+    {
+        std::lock_guard<std::mutex> lock(page.mutex);
+        REQUIRE(page.batches.size() == 1);
+        page.acks.front().set_value(json::object());
+    }
+
+    REQUIRE(page.wait_for_batches(2));
+    std::lock_guard<std::mutex> lock(page.mutex);
+    const auto& second = page.batches[1].events;
+    REQUIRE(second.size() == 10);
+    REQUIRE(second.front()["params"]["n"] == 15);
+    REQUIRE(second.back()["params"]["n"] == 24);
+    REQUIRE(batcher.dropped() == 15);
+    REQUIRE(reported == 15);
+}
+
+TEST_CASE("cdp_event_batcher: forgotten contexts receive nothing", "[cdp_event_batcher]")
+{
+    fake_page page;
+    auto opts = fast_options();
+    opts.window = 50ms;
+    cdp_event_batcher batcher(page.sender(), opts);
+
+    batcher.push("Network.requestWillBeSent", json::object(), { { 3, "s" }, { 4, "s" } });
+    batcher.forget(3);
+
+    REQUIRE(page.wait_for_batches(1));
+    std::this_thread::sleep_for(80ms);
+
+    std::lock_guard<std::mutex> lock(page.mutex);
+    REQUIRE(page.batches.size() == 1);
+    REQUIRE(page.batches[0].dest.ctx_id == 4);
+}
+
+TEST_CASE("cdp_event_batcher: expression feeds each event through the sdk hook in order", "[cdp_event_batcher]")
+{
+    const std::vector<std::shared_ptr<const std::string>> events = {
+        std::make_shared<const std::string>(R"({"method":"A"})"),
+        std::make_shared<const std::string>(R"({"method":"B"})"),
+    };
+    REQUIRE(cdp_event_batcher::build_expression(events) == R"((e=>{for(const d of e)window.__millennium_cdp_event__(d)})([{"method":"A"},{"method":"B"}]))");
+}
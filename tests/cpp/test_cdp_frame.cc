@@ -0,0 +1,119 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/cdp_frame.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+/** feed raw bytes through the reader in reads of at most `chunk` bytes */
+std::vector<cdp_frame> feed(cdp_frame_reader& reader, const std::string& bytes, size_t chunk)
+{
+    std::vector<cdp_frame> frames;
+    cdp_frame frame;
+
+    for (size_t off = 0; off < bytes.size();) {
+        auto region = reader.prepare();
+        const size_t n = std::min({ chunk, region.size(), bytes.size() - off });
+        std::memcpy(region.data(), bytes.data() + off, n);
+        reader.commit(n);
+        off += n;
+
+        while (reader.next_frame(frame)) {
+            frames.push_back(frame);
+        }
+    }
+    return frames;
+}
+} // namespace
+
+TEST_CASE("cdp_frame_reader: splits NUL-delimited messages", "[cdp_frame]")
+{
+    cdp_frame_reader reader;
+    const std::string wire = std::string("{\"id\":1}") + '\0' + "{\"id\":2}" + '\0' + "{\"id\":3";
+
+    const auto frames = feed(reader, wire, 4096);
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[0].data == "{\"id\":1}");
+    CHECK(frames[1].data == "{\"id\":2}");
+    CHECK(reader.pending() == std::strlen("{\"id\":3"));
+}
+
+TEST_CASE("cdp_frame_reader: reassembles messages split across reads", "[cdp_frame]")
+{
+    cdp_frame_reader reader;
+    std::string wire;
+    for (int i = 0; i < 200; ++i) {
+        wire += "{\"method\":\"Network.dataReceived\",\"params\":{\"n\":" + std::to_string(i) + "}}";
+        wire.push_back('\0');
+    }
+
+    const auto frames = feed(reader, wire, 7);
+    REQUIRE(frames.size() == 200);
+    CHECK(frames[0].data == "{\"method\":\"Network.dataReceived\",\"params\":{\"n\":0}}");
+    CHECK(frames[199].data == "{\"method\":\"Network.dataReceived\",\"params\":{\"n\":199}}");
+    CHECK(reader.pending() == 0);
+}
+
+TEST_CASE("cdp_frame_reader: frames stay valid after the reader moves on", "[cdp_frame]")
+{
+    cdp_frame_reader reader(cdp_frame_reader::min_read_size);
+
+    /** several multi-slab messages force the reader to grow and reallocate while earlier frames are held */
+    std::string wire;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 4; ++i) {
+        expected.push_back(std::string(1024 * 1024 + i, static_cast<char>('a' + i)));
+        wire += expected.back();
+        wire.push_back('\0');
+    }
+
+    const auto frames = feed(reader, wire, 4096);
+    REQUIRE(frames.size() == expected.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        CHECK(frames[i].data == expected[i]);
+    }
+}
+
+TEST_CASE("cdp_frame_reader: passes empty frames through to the caller", "[cdp_frame]")
+{
+    cdp_frame_reader reader;
+    const std::string wire = std::string(1, '\0') + "x" + '\0';
+
+    const auto frames = feed(reader, wire, 4096);
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[0].data.empty());
+    CHECK(frames[1].data == "x");
+}
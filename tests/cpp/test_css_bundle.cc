@@ -0,0 +1,226 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/css_bundle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <string>
+#include <thread>
+
+static const char* base_url = "https://millennium.host/v1/themes/";
+
+TEST_CASE("css_concatenate: keeps sheet order and rebases relative urls", "[css_bundle]")
+{
+    const std::vector<css_bundle_source> sources = {
+        { "Theme/a.css",       ".a { background: url(img/bg.png); }"                                         },
+        { "Theme/sub/b.css",   ".b { background: url(\"../icons/x.svg?v=2#frag\"); mask: URL( 'm.png' ); }" },
+        { "Theme/sub/c d.css", ".c { background: url(data:image/png;base64,AAAA); cursor: url(/abs.cur); }"  },
+    };
+
+    const std::string css = css_concatenate(sources, base_url);
+
+    REQUIRE(css.find("url(https://millennium.host/v1/themes/Theme/img/bg.png)") != std::string::npos);
+    REQUIRE(css.find("url(\"https://millennium.host/v1/themes/Theme/icons/x.svg?v=2#frag\")") != std::string::npos);
+    REQUIRE(css.find("URL( 'https://millennium.host/v1/themes/Theme/sub/m.png' )") != std::string::npos);
+    REQUIRE(css.find("url(data:image/png;base64,AAAA)") != std::string::npos);
+    REQUIRE(css.find("url(/abs.cur)") != std::string::npos);
+
+    REQUIRE(css.find(".a {") < css.find(".b {"));
+    REQUIRE(css.find(".b {") < css.find(".c {"));
+}
+
+TEST_CASE("css_concatenate: hoists the first sheet's @import and drops @charset", "[css_bundle]")
+{
+    const std::vector<css_bundle_source> sources = {
+        { "Theme/parts/a.css", "/* header */\n@import \"fonts.css\" screen;\n@import url(https://fonts.example/x.css);\n.a { color: red; }" },
+        { "Theme/b.css", "@charset \"utf-8\";\n.b { color: blue; }" },
+    };
+
+    const std::string css = css_concatenate(sources, base_url);
+
+    REQUIRE(css.find("@charset") == std::string::npos);
+    REQUIRE(css.rfind("@import \"https://millennium.host/v1/themes/Theme/parts/fonts.css\" screen;", 0) == 0);
+    REQUIRE(css.find("@import url(https://fonts.example/x.css);") < css.find("/* Theme/parts/a.css */"));
+    REQUIRE(css.find(".a {") < css.find(".b {"));
+}
+
+TEST_CASE("css_concatenate: a later sheet's @import doesn't jump ahead of the sheets before it", "[css_bundle]")
+{
+    const std::vector<css_bundle_source> sources = {
+        { "Theme/a.css", ".a { color: red; }" },
+        { "Theme/b.css", "@import url(https://fonts.example/x.css);\n.b { color: blue; }" },
+    };
+
+    const std::string css = css_concatenate(sources, base_url);
+
+    REQUIRE(css.find(".a {") < css.find("@import url(https://fonts.example/x.css);"));
+    REQUIRE(css.find("@import url(https://fonts.example/x.css);") < css.find(".b {"));
+}
+
+TEST_CASE("css_has_import: only looks at the top of the sheet", "[css_bundle]")
+{
+    CHECK(css_has_import("@import \"a.css\";"));
+    CHECK(css_has_import("@charset \"utf-8\";\n/* hi */\n  @IMPORT url(a.css);"));
+    CHECK_FALSE(css_has_import(""));
+    CHECK_FALSE(css_has_import(".a { color: red; }\n@import \"a.css\";"));
+    CHECK_FALSE(css_has_import("@imports { }"));
+    CHECK_FALSE(css_has_import("/* never closed @import \"a.css\";"));
+}
+
+TEST_CASE("css_concatenate: leaves strings and comments alone", "[css_bundle]")
+{
+    const std::vector<css_bundle_source> sources = {
+        { "Theme/a.css", "/* url(not/me.png) */ .a::before { content: \"url(nor/me.png)\"; } .b { --x: myurl(keep.png); }" },
+    };
+
+    const std::string css = css_concatenate(sources, base_url);
+    REQUIRE(css.find("/* url(not/me.png) */") != std::string::npos);
+    REQUIRE(css.find("\"url(nor/me.png)\"") != std::string::npos);
+    REQUIRE(css.find("myurl(keep.png)") != std::string::npos);
+}
+
+TEST_CASE("css_concatenate: a truncated sheet can't swallow the next one", "[css_bundle]")
+{
+    const std::vector<css_bundle_source> sources = {
+        { "Theme/a.css", ".a { color: red;" },
+        { "Theme/b.css", ".b { color: blue; } /* unterminated" },
+        { "Theme/c.css", ".c { color: green; }" },
+    };
+
+    const std::string css = css_concatenate(sources, base_url);
+    const size_t a = css.find(".a {");
+    const size_t b = css.find(".b {");
+    REQUIRE(css.find('}', a) < b);
+    REQUIRE(css.find("*/", b) < css.find(".c {"));
+}
+
+TEST_CASE("css_bundler: names bundles by content and rebuilds on change", "[css_bundle]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "millennium_css_bundle_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "Theme");
+
+    std::ofstream(root / "Theme" / "a.css") << ".a { color: red; }";
+    std::ofstream(root / "Theme" / "b.css") << ".b { color: blue; }";
+
+    int builds = 0;
+    css_bundler bundler(root, base_url, [&builds](std::string css)
+    {
+        ++builds;
+        return std::make_shared<const vfs_response>(vfs_response{ std::move(css), nullptr });
+    });
+
+    const std::string name = bundler.add({ "Theme/a.css", "Theme/b.css" });
+    REQUIRE(name == bundler.add({ "Theme/a.css", "Theme/b.css" }));
+    REQUIRE(name != bundler.add({ "Theme/b.css", "Theme/a.css" }));
+
+    REQUIRE(bundler.find("0000000000000000") == nullptr);
+
+    const auto first = bundler.find(name);
+    REQUIRE(first != nullptr);
+    REQUIRE(first->body.find(".a { color: red; }") < first->body.find(".b { color: blue; }"));
+    REQUIRE(bundler.find(name) == first);
+    REQUIRE(builds == 1);
+
+    std::ofstream(root / "Theme" / "b.css", std::ios::trunc) << ".b { color: purple; }";
+    std::filesystem::last_write_time(root / "Theme" / "b.css", std::filesystem::last_write_time(root / "Theme" / "b.css") + std::chrono::seconds(5));
+
+    const auto second = bundler.find(name);
+    REQUIRE(second != first);
+    REQUIRE(second->body.find(".b { color: purple; }") != std::string::npos);
+    REQUIRE(builds == 2);
+
+    std::filesystem::remove(root / "Theme" / "a.css");
+    const auto third = bundler.find(name);
+    REQUIRE(third->body.find(".a {") == std::string::npos);
+    REQUIRE(third->body.find(".b {") != std::string::npos);
+
+    bundler.clear();
+    REQUIRE(bundler.find(name) == nullptr);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("css_bundler: a sheet with @import starts a new bundle", "[css_bundle]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "millennium_css_bundle_split_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "Theme");
+
+    std::ofstream(root / "Theme" / "a.css") << "@import \"base.css\";\n.a { color: red; }";
+    std::ofstream(root / "Theme" / "b.css") << ".b { color: blue; }";
+    std::ofstream(root / "Theme" / "c.css") << "/* fonts */\n@import url(https://fonts.example/x.css);\n.c { color: green; }";
+    std::ofstream(root / "Theme" / "d.css") << ".d { color: black; }";
+
+    css_bundler bundler(root, base_url, [](std::string css) { return std::make_shared<const vfs_response>(vfs_response{ std::move(css), nullptr }); });
+
+    using runs = std::vector<std::vector<std::string>>;
+    REQUIRE(bundler.split({ "Theme/a.css", "Theme/b.css", "Theme/c.css", "Theme/d.css" }) == runs{ { "Theme/a.css", "Theme/b.css" }, { "Theme/c.css", "Theme/d.css" } });
+    REQUIRE(bundler.split({ "Theme/b.css", "Theme/d.css" }) == runs{ { "Theme/b.css", "Theme/d.css" } });
+    REQUIRE(bundler.split({ "Theme/missing.css", "Theme/c.css" }) == runs{ { "Theme/missing.css" }, { "Theme/c.css" } });
+    REQUIRE(bundler.split({}).empty());
+
+    /** picks up a sheet that gains an @import */
+    std::ofstream(root / "Theme" / "d.css", std::ios::trunc) << "@import \"more.css\";\n.d { color: black; }";
+    std::filesystem::last_write_time(root / "Theme" / "d.css", std::filesystem::last_write_time(root / "Theme" / "d.css") + std::chrono::seconds(5));
+    REQUIRE(bundler.split({ "Theme/b.css", "Theme/d.css" }) == runs{ { "Theme/b.css" }, { "Theme/d.css" } });
+
+    const auto second = bundler.find(bundler.add({ "Theme/c.css", "Theme/d.css" }));
+    REQUIRE(second != nullptr);
+    REQUIRE(second->body.find("@import url(https://fonts.example/x.css);") < second->body.find(".c {"));
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("css_bundler: evicts the least recently used bundle", "[css_bundle]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "millennium_css_bundle_lru_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    css_bundler bundler(root, base_url, [](std::string css) { return std::make_shared<const vfs_response>(vfs_response{ std::move(css), nullptr }); });
+
+    const std::string kept = bundler.add({ "kept.css" });
+    const std::string evicted = bundler.add({ "evicted.css" });
+
+    /** 62 more fill the cache to its limit of 64, touching kept leaves evicted as the oldest */
+    for (int i = 0; i < 62; ++i) {
+        bundler.add({ "filler" + std::to_string(i) + ".css" });
+    }
+    REQUIRE(bundler.find(kept) != nullptr);
+
+    const std::string newest = bundler.add({ "newest.css" });
+    CHECK(bundler.find(evicted) == nullptr);
+    CHECK(bundler.find(kept) != nullptr);
+    CHECK(bundler.find(newest) != nullptr);
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,154 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "head/css_parser.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using head::css_parser::parse_root_properties;
+
+using property_values = std::map<std::string, std::string>;
+using property_docs = std::map<std::string, std::pair<std::string, std::string>>;
+
+TEST_CASE("css_parser: reads :root properties and their doc comments", "[css_parser]")
+{
+    const std::string css = R"(
+/* theme colors */
+:root {
+    /**
+     * @name Accent
+     * @description The main accent color
+     */
+    --accent: #ff8800;
+
+    /* @name Background */
+    --bg:   rgb(10, 20, 30) ;
+    --plain: 255, 255, 255;
+}
+)";
+
+    property_values values;
+    property_docs docs;
+    parse_root_properties(css, values, docs);
+
+    REQUIRE(values.size() == 3);
+    CHECK(values["--accent"] == "#ff8800");
+    CHECK(values["--bg"] == "rgb(10, 20, 30)");
+    CHECK(values["--plain"] == "255, 255, 255");
+
+    CHECK(docs["--accent"] == std::pair<std::string, std::string>{ "Accent", "The main accent color" });
+    CHECK(docs["--bg"] == std::pair<std::string, std::string>{ "Background", "" });
+    CHECK(docs["--plain"] == std::pair<std::string, std::string>{ "", "" });
+
+    const auto metadata = head::css_parser::generate_color_metadata(values, docs);
+    REQUIRE(metadata.size() == 3);
+    CHECK(metadata[0]["color"] == "--accent");
+    CHECK(metadata[0]["name"] == "Accent");
+    CHECK(metadata[0]["type"] == static_cast<int>(head::color_type::Hex));
+    CHECK(metadata[1]["defaultColor"] == "#0a141e");
+    CHECK(metadata[2]["name"].is_null());
+}
+
+TEST_CASE("css_parser: only reads top-level :root rules", "[css_parser]")
+{
+    const std::string css = R"(
+body { --not-root: #000; }
+:root { --a: #111; --b: #222 }
+.panel { color: #333; }
+@media (min-width: 10px) { :root { --in-media: #444; } }
+:root, html {
+    --c: #555;
+    .nested { --nested: #666; }
+    --d: #777;
+}
+:root > div { --child: #888; }
+)";
+
+    property_values values;
+    property_docs docs;
+    parse_root_properties(css, values, docs);
+
+    CHECK(values == property_values{
+                        { "--a", "#111" },
+                        { "--b", "#222" },
+                        { "--c", "#555" },
+                        { "--d", "#777" },
+    });
+}
+
+TEST_CASE("css_parser: skips strings, functions and comments inside values", "[css_parser]")
+{
+    const std::string css = R"(:root {
+    --font: "a;b}c";
+    --image: url(data:image/png;base64,AAAA);
+    --shadow: 0 0 2px /* not a doc comment */ #000;
+    /* @namespace nope */
+    --tagged: #abc;
+    not a declaration;
+    --after: #def;
+})";
+
+    property_values values;
+    property_docs docs;
+    parse_root_properties(css, values, docs);
+
+    CHECK(values["--font"] == "\"a;b}c\"");
+    CHECK(values["--image"] == "url(data:image/png;base64,AAAA)");
+    CHECK(values["--shadow"] == "0 0 2px /* not a doc comment */ #000");
+    CHECK(values["--after"] == "#def");
+    CHECK(values.count("not a declaration") == 0);
+    CHECK(docs["--tagged"] == std::pair<std::string, std::string>{ "", "" });
+}
+
+TEST_CASE("css_parser: handles large and malformed stylesheets", "[css_parser]")
+{
+    std::string css = ":root {\n";
+    for (int i = 0; i < 20000; ++i) {
+        css += "    /* @name Color " + std::to_string(i) + " */\n    --color-" + std::to_string(i) + ": #123456;\n";
+    }
+    css += "}\n";
+    for (int i = 0; i < 20000; ++i) {
+        css += ".rule-" + std::to_string(i) + " { color: var(--color-1); background: url(\"x.png\"); }\n";
+    }
+
+    property_values values;
+    property_docs docs;
+    parse_root_properties(css, values, docs);
+    CHECK(values.size() == 20000);
+    CHECK(docs["--color-19999"].first == "Color 19999");
+
+    /** unterminated comments, strings and blocks just end the scan */
+    for (const std::string bad : { ":root { --a: #111; /* open", ":root { --a: #111; --b: \"open", ":root { --a: #111", "}}} :root { --a: #111; }" }) {
+        property_values v;
+        property_docs d;
+        parse_root_properties(bad, v, d);
+        CHECK(v["--a"] == "#111");
+    }
+}
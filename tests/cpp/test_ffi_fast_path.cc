@@ -0,0 +1,171 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/ffi_fast_path.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+/** the generic path: what ipc_main::lua_evaluate() + call_server_method() build from a child's result */
+std::string generic_response(const std::string& plugin, const nlohmann::json& result)
+{
+    nlohmann::ordered_json response{
+        { "success",    false  },
+        { "pluginName", plugin }
+    };
+
+    if (result.contains("success") && result["success"].is_boolean() && result["success"].get<bool>()) {
+        response["success"] = true;
+        response["returnJson"] = nullptr;
+
+        const auto& val = result.contains("value") ? result["value"] : nlohmann::json(nullptr);
+        if (val.is_string()) {
+            auto parsed = nlohmann::ordered_json::parse(val.get<std::string>(), nullptr, false);
+            response["returnJson"] = parsed.is_discarded() ? nlohmann::ordered_json(val.get<std::string>()) : parsed;
+        } else if (val.is_boolean()) {
+            response["returnJson"] = val.get<bool>();
+        } else if (val.is_number_float()) {
+            response["returnJson"] = val.get<double>();
+        } else if (val.is_number_integer()) {
+            response["returnJson"] = val.get<int64_t>();
+        }
+    } else {
+        response["returnJson"] = result.value("error", "unknown error from child process");
+    }
+    return response.dump();
+}
+} // namespace
+
+TEST_CASE("ffi fast path decodes common call shapes", "[ffi_fast_path]")
+{
+    ffi_fast_path::call call;
+
+    SECTION("named scalar arguments")
+    {
+        REQUIRE(ffi_fast_path::parse(
+            R"({"id":0,"call_id":7,"caller":"index.tsx:12","data":{"pluginName":"demo","methodName":"greet","argumentList":{"name":"bob","n":-3,"big":18446744073709551615,"f":0.5,"b":true,"z":null}}})",
+            call));
+        REQUIRE(call.ipc_id == 0);
+        REQUIRE(call.call_id == 7);
+        REQUIRE(call.caller == "index.tsx:12");
+        REQUIRE(call.plugin == "demo");
+        REQUIRE(call.method == "greet");
+        REQUIRE(call.has_arguments);
+        REQUIRE(call.named_arguments);
+        REQUIRE(call.arg_names == std::vector<std::string>{ "name", "n", "big", "f", "b", "z" });
+        REQUIRE(std::get<std::string>(call.args[0]) == "bob");
+        REQUIRE(std::get<int64_t>(call.args[1]) == -3);
+        REQUIRE(std::get<uint64_t>(call.args[2]) == UINT64_MAX);
+        REQUIRE(std::get<double>(call.args[3]) == 0.5);
+        REQUIRE(std::get<bool>(call.args[4]));
+        REQUIRE(std::holds_alternative<std::monostate>(call.args[5]));
+    }
+
+    SECTION("positional and missing arguments, unknown payload fields are skipped")
+    {
+        REQUIRE(ffi_fast_path::parse(R"({"extra":{"a":[1,{"b":2}]},"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m","argumentList":[1,"two"]}})", call));
+        REQUIRE_FALSE(call.named_arguments);
+        REQUIRE(call.args.size() == 2);
+        REQUIRE(call.caller.empty());
+
+        REQUIRE(ffi_fast_path::parse(R"({"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m"}})", call));
+        REQUIRE_FALSE(call.has_arguments);
+        REQUIRE(call.args.empty());
+    }
+
+    SECTION("anything else falls back to the generic path")
+    {
+        auto payload = GENERATE(as<std::string>{},
+                                R"({"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m","argumentList":{"a":{"nested":1}}}})",
+                                R"({"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m","argumentList":[[1]]}})",
+                                R"({"id":3,"call_id":1,"data":{"pluginName":"p","methodName":2}})",
+                                R"({"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m","extra":1}})",
+                                R"({"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m","argumentList":{"a":1,"a":2}}})",
+                                R"({"id":0,"call_id":1.5,"data":{"pluginName":"p","methodName":"m"}})",
+                                R"({"id":0,"data":{"pluginName":"p","methodName":"m"}})",
+                                R"({"id":0,"call_id":1,"data":{"methodName":"m"}})",
+                                R"({"id":0,"call_id":1,"caller":5,"data":{"pluginName":"p","methodName":"m"}})",
+                                R"([{"id":0}])",
+                                R"({"id":0,"call_id":1,"data":{"pluginName":"p","methodName":"m"}} trailing)",
+                                R"({"id":0,"call_id":1,"data":{"pluginName":"p")");
+
+        INFO(payload);
+        REQUIRE_FALSE(ffi_fast_path::parse(payload, call));
+    }
+}
+
+TEST_CASE("ffi fast path encodes like the json dom it replaces", "[ffi_fast_path]")
+{
+    auto payload = GENERATE(as<std::string>{},
+                            R"({"id":0,"call_id":1,"data":{"pluginName":"demo","methodName":"noop"}})",
+                            R"({"id":0,"call_id":1,"data":{"pluginName":"demo","methodName":"greet","argumentList":{"zeta":1,"alpha":"x","Mid":-200000,"f":1.5,"d":0.1}}})",
+                            R"({"id":0,"call_id":1,"data":{"pluginName":"d\"e\\mo","methodName":"m\n\u0001é","argumentList":["a\tb",300,-1,-40000,1e300,4294967296,false,null]}})",
+                            R"({"id":0,"call_id":1,"data":{"pluginName":"demo","methodName":"long","argumentList":{"s":"0123456789012345678901234567890123456789","t":""}}})");
+
+    INFO(payload);
+    const auto dom = nlohmann::json::parse(payload);
+
+    ffi_fast_path::call call;
+    REQUIRE(ffi_fast_path::parse(payload, call));
+
+    std::vector<uint8_t> packed;
+    ffi_fast_path::pack_evaluate_params(call, packed);
+    REQUIRE(packed == nlohmann::json::to_msgpack(dom["data"]));
+
+    std::string arguments;
+    ffi_fast_path::write_arguments_json(call, arguments);
+    REQUIRE(nlohmann::json::parse(arguments) == dom["data"]);
+}
+
+TEST_CASE("ffi fast path writes the same reply as call_server_method", "[ffi_fast_path]")
+{
+    auto result = GENERATE(nlohmann::json{ { "success", true }, { "value", nullptr } },
+                           nlohmann::json{ { "success", true } },
+                           nlohmann::json{ { "success", true }, { "value", true } },
+                           nlohmann::json{ { "success", true }, { "value", 42 } },
+                           nlohmann::json{ { "success", true }, { "value", -42 } },
+                           nlohmann::json{ { "success", true }, { "value", 2.5 } },
+                           nlohmann::json{ { "success", true }, { "value", 3.0 } },
+                           nlohmann::json{ { "success", true }, { "value", "plain \"text\"\n" } },
+                           nlohmann::json{ { "success", true }, { "value", R"({"b":[1,2,{"c":null}],"a":"x"})" } },
+                           nlohmann::json{ { "success", true }, { "value", "123" } },
+                           nlohmann::json{ { "success", true }, { "value", nlohmann::json::array({ 1 }) } },
+                           nlohmann::json{ { "success", false }, { "error", "boom" } },
+                           nlohmann::json{ { "success", false } },
+                           nlohmann::json{ { "success", "yes" }, { "value", 1 } });
+
+    INFO(result.dump());
+    std::string response;
+    ffi_fast_path::write_response(response, "demo", result);
+    REQUIRE(nlohmann::ordered_json::parse(response) == nlohmann::ordered_json::parse(generic_response("demo", result)));
+}
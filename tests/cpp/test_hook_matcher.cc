@@ -0,0 +1,92 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/http_hooks.h"
+#include "millennium/target_url.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using hook_matcher = network_hook_ctl::hook_matcher;
+
+static network_hook_ctl::hook_item make_hook(unsigned long long id, const std::string& pattern, network_hook_ctl::TagTypes type, bool with_source = true)
+{
+    return { { "theme/" + std::to_string(id), std::make_shared<const std::regex>(pattern), type, with_source ? pattern : std::string() }, id };
+}
+
+TEST_CASE("hook_matcher: returns every matching hook in registration order", "[hook_matcher]")
+{
+    hook_matcher matcher({
+        make_hook(1, ".*store\\.steampowered\\.com.*", network_hook_ctl::TagTypes::STYLESHEET),
+        make_hook(2, ".*steamcommunity\\.com.*", network_hook_ctl::TagTypes::STYLESHEET),
+        make_hook(3, ".*store\\.steampowered\\.com.*", network_hook_ctl::TagTypes::JAVASCRIPT),
+        make_hook(4, "https://.*", network_hook_ctl::TagTypes::JAVASCRIPT, false),
+    });
+
+    auto store = matcher.match("https://store.steampowered.com/app/10");
+    REQUIRE(*store == std::vector<size_t>{ 0, 2, 3 });
+
+    auto community = matcher.match("https://steamcommunity.com/id/someone");
+    REQUIRE(*community == std::vector<size_t>{ 1, 3 });
+
+    REQUIRE(matcher.match("http://example.com/")->empty());
+    REQUIRE_FALSE(matcher.any_match("http://example.com/"));
+}
+
+TEST_CASE("hook_matcher: repeated urls are served from the cache", "[hook_matcher]")
+{
+    hook_matcher matcher({ make_hook(1, ".*discord\\.com.*", network_hook_ctl::TagTypes::STYLESHEET) });
+
+    auto first = matcher.match("https://discord.com/app");
+    auto second = matcher.match("https://discord.com/app");
+    REQUIRE(first == second);
+    REQUIRE(*first == std::vector<size_t>{ 0 });
+
+    /** the cache is bounded, overflowing it must not change results */
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(matcher.match("https://discord.com/channels/" + std::to_string(i))->size() == 1);
+    }
+    REQUIRE(*matcher.match("https://discord.com/app") == std::vector<size_t>{ 0 });
+}
+
+TEST_CASE("hook_matcher: an empty matcher matches nothing", "[hook_matcher]")
+{
+    hook_matcher matcher;
+    REQUIRE(matcher.hooks().empty());
+    REQUIRE(matcher.match("https://store.steampowered.com/")->empty());
+}
+
+TEST_CASE("hook_matcher: drives third-party webkit injection", "[hook_matcher][webkit]")
+{
+    hook_matcher matcher({ make_hook(1, ".*discord\\.com.*", network_hook_ctl::TagTypes::STYLESHEET) });
+
+    REQUIRE(target_url("https://www.discord.com/app").allows_webkit_injection(matcher));
+    REQUIRE_FALSE(target_url("https://www.google.com/").allows_webkit_injection(matcher));
+    REQUIRE_FALSE(target_url("https://steamloopback.host/index.html").allows_webkit_injection(matcher));
+}
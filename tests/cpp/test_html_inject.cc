@@ -0,0 +1,100 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/encoding.h"
+#include "millennium/html_inject.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+static std::string trim_trailing_newlines_before_head(std::string html)
+{
+    const size_t head = html.find("</head>");
+    size_t start = head;
+    while (start > 0 && html[start - 1] == '\n') {
+        --start;
+    }
+    return html.erase(start, head - start);
+}
+
+TEST_CASE("html_inject_head: splices in front of the first </head>", "[html_inject]")
+{
+    auto patched = html_inject_head("<html><head><title>x</title></head><body></head></body></html>", "<style></style>");
+    REQUIRE(patched.has_value());
+    REQUIRE(*patched == "<html><head><title>x</title><style></style></head><body></head></body></html>");
+
+    REQUIRE_FALSE(html_inject_head("<html><body></body></html>", "<style></style>").has_value());
+    REQUIRE(html_find_head_close("</hea</head>") == 5);
+}
+
+TEST_CASE("html_inject_head_base64: matches decode, splice and re-encode", "[html_inject]")
+{
+    const std::string content = "<link rel=\"stylesheet\" href=\"https://millennium.host/v1/themes/a.css\">";
+
+    /** cover every alignment of </head> and of the document length, and documents spanning several decode blocks */
+    for (size_t lead : { 0, 1, 2, 3, 4, 5, 5000, 9001 }) {
+        for (size_t trail : { 0, 1, 2, 3, 20000 }) {
+            for (size_t extra : { 0, 1, 2 }) {
+                const std::string html = "<head>" + std::string(lead, 'a') + "</head><body>" + std::string(trail, 'b') + "</body>";
+                const std::string injected = content + std::string(extra, ' ');
+
+                auto patched = html_inject_head_base64(Base64Encode(html), injected);
+                REQUIRE(patched.has_value());
+                REQUIRE(patched->size() % 4 == 0);
+
+                const std::string decoded = Base64Decode(*patched);
+                INFO("lead " << lead << " trail " << trail << " extra " << extra);
+                REQUIRE(trim_trailing_newlines_before_head(decoded) == *html_inject_head(html, injected));
+            }
+        }
+    }
+}
+
+TEST_CASE("html_inject_head_base64: rejects documents it can't patch", "[html_inject]")
+{
+    REQUIRE_FALSE(html_inject_head_base64("", "x").has_value());
+    REQUIRE_FALSE(html_inject_head_base64(Base64Encode("<html><body></body></html>"), "x").has_value());
+    REQUIRE_FALSE(html_inject_head_base64("PGhlYWQ+PC9oZWFkPg", "x").has_value());    // not a multiple of 4
+    REQUIRE_FALSE(html_inject_head_base64("PGhl!WQ+PC9oZWFkPg==", "x").has_value()); // invalid character
+}
+
+TEST_CASE("html_inject_head_base64: tells a bad encoding from a missing </head>", "[html_inject]")
+{
+    html_inject_failure failure = html_inject_failure::no_head;
+    REQUIRE_FALSE(html_inject_head_base64("PGhl!WQ+PC9oZWFkPg==", "x", &failure).has_value());
+    CHECK(failure == html_inject_failure::bad_encoding);
+
+    failure = html_inject_failure::no_head;
+    REQUIRE_FALSE(html_inject_head_base64("PGhlYWQ+PC9oZWFkPg", "x", &failure).has_value());
+    CHECK(failure == html_inject_failure::bad_encoding);
+
+    failure = html_inject_failure::bad_encoding;
+    REQUIRE_FALSE(html_inject_head_base64(Base64Encode("<html><body></body></html>"), "x", &failure).has_value());
+    CHECK(failure == html_inject_failure::no_head);
+}
@@ -0,0 +1,389 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _WIN32
+
+#include "millennium/http_engine.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/**
+ * just enough of an http/1.1 server to exercise the engine: keep-alive connections, Content-Length bodies,
+ * and a few routes. counts the connections it accepts and how many were open at once.
+ */
+class local_http_server
+{
+  public:
+    local_http_server()
+    {
+        m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        const int one = 1;
+        setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(m_listen_fd, 64);
+
+        socklen_t len = sizeof(addr);
+        getsockname(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+
+        m_accept_thread = std::thread([this] { accept_loop(); });
+    }
+
+    ~local_http_server()
+    {
+        m_stop = true;
+        ::shutdown(m_listen_fd, SHUT_RDWR);
+        close(m_listen_fd);
+        m_accept_thread.join();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int fd : m_client_fds) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& thread : m_client_threads) {
+            thread.join();
+        }
+    }
+
+    std::string url(const std::string& path) const
+    {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    int accepted() const
+    {
+        return m_accepted.load();
+    }
+
+    int max_concurrent() const
+    {
+        return m_max_open.load();
+    }
+
+  private:
+    void accept_loop()
+    {
+        while (!m_stop) {
+            const int fd = accept(m_listen_fd, nullptr, nullptr);
+            if (fd < 0) break;
+
+            ++m_accepted;
+            const int open = ++m_open;
+            int seen = m_max_open.load();
+            while (open > seen && !m_max_open.compare_exchange_weak(seen, open)) {
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_client_fds.push_back(fd);
+            m_client_threads.emplace_back([this, fd] {
+                serve(fd);
+                --m_open;
+            });
+        }
+    }
+
+    static bool send_all(int fd, const std::string& data)
+    {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void serve(int fd)
+    {
+        std::string buffer;
+        char chunk[4096];
+
+        while (true) {
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+
+            const std::string head = buffer.substr(0, header_end);
+            buffer.erase(0, header_end + 4);
+
+            const std::string method = head.substr(0, head.find(' '));
+            const size_t path_start = head.find(' ') + 1;
+            const std::string path = head.substr(path_start, head.find(' ', path_start) - path_start);
+
+            size_t content_length = 0;
+            std::string lowered = head;
+            std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (auto pos = lowered.find("content-length:"); pos != std::string::npos) {
+                content_length = std::stoul(head.substr(pos + 15));
+            }
+            std::string test_header;
+            if (auto pos = lowered.find("x-test:"); pos != std::string::npos) {
+                const size_t start = head.find_first_not_of(' ', pos + 7);
+                test_header = head.substr(start, head.find("\r\n", start) - start);
+            }
+
+            while (buffer.size() < content_length) {
+                const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            const std::string body = buffer.substr(0, content_length);
+            buffer.erase(0, content_length);
+
+            std::string status = "200 OK";
+            std::string extra_headers;
+            std::string payload;
+
+            if (path == "/hello") {
+                payload = "hello";
+            } else if (path == "/echo") {
+                payload = method + ":" + body + ":" + test_header;
+                extra_headers = "X-Echo-Method: " + method + "\r\n";
+            } else if (path == "/big") {
+                payload.assign(256 * 1024, 'x');
+            } else if (path == "/slow") {
+                std::this_thread::sleep_for(std::chrono::milliseconds(150));
+                payload = "slow";
+            } else if (path == "/redirect") {
+                status = "302 Found";
+                extra_headers = "Location: /hello\r\n";
+            } else {
+                status = "404 Not Found";
+                payload = "missing";
+            }
+
+            std::string response = "HTTP/1.1 " + status + "\r\nContent-Length: " + std::to_string(payload.size()) + "\r\n" + extra_headers + "\r\n";
+            if (method != "HEAD") response += payload;
+            if (!send_all(fd, response)) {
+                close(fd);
+                return;
+            }
+        }
+    }
+
+    int m_listen_fd = -1;
+    uint16_t m_port = 0;
+    std::atomic<bool> m_stop{ false };
+    std::atomic<int> m_accepted{ 0 };
+    std::atomic<int> m_open{ 0 };
+    std::atomic<int> m_max_open{ 0 };
+    std::thread m_accept_thread;
+
+    std::mutex m_mutex;
+    std::vector<int> m_client_fds;
+    std::vector<std::thread> m_client_threads;
+};
+
+http_engine::request get(const std::string& url)
+{
+    http_engine::request req;
+    req.url = url;
+    req.timeout_seconds = 10;
+    return req;
+}
+} // namespace
+
+TEST_CASE("http_engine: reuses one connection for sequential requests", "[http_engine]")
+{
+    local_http_server server;
+    http_engine engine;
+
+    for (int i = 0; i < 5; ++i) {
+        const auto res = engine.perform(get(server.url("/hello")));
+        REQUIRE(res.ok());
+        REQUIRE(res.status == 200);
+        REQUIRE(res.body == "hello");
+        REQUIRE(res.content_length == 5);
+    }
+
+    REQUIRE(server.accepted() == 1);
+}
+
+TEST_CASE("http_engine: methods, bodies and headers", "[http_engine]")
+{
+    local_http_server server;
+    http_engine engine;
+
+    auto post = get(server.url("/echo"));
+    post.method = "POST";
+    post.body = "payload";
+    post.headers = { "X-Test: yes" };
+    auto res = engine.perform(post);
+    REQUIRE(res.ok());
+    REQUIRE(res.body == "POST:payload:yes");
+    REQUIRE(res.headers["X-Echo-Method"] == "POST");
+
+    auto empty_post = get(server.url("/echo"));
+    empty_post.method = "POST";
+    REQUIRE(engine.perform(empty_post).body == "POST::");
+
+    auto put = get(server.url("/echo"));
+    put.method = "PUT";
+    put.body = "data";
+    REQUIRE(engine.perform(put).body == "PUT:data:");
+
+    auto head = get(server.url("/echo"));
+    head.method = "HEAD";
+    res = engine.perform(head);
+    REQUIRE(res.ok());
+    REQUIRE(res.body.empty());
+    REQUIRE(res.headers["X-Echo-Method"] == "HEAD");
+
+    res = engine.perform(get(server.url("/nope")));
+    REQUIRE(res.ok());
+    REQUIRE(res.status == 404);
+}
+
+TEST_CASE("http_engine: redirects", "[http_engine]")
+{
+    local_http_server server;
+    http_engine engine;
+
+    auto res = engine.perform(get(server.url("/redirect")));
+    REQUIRE(res.status == 200);
+    REQUIRE(res.body == "hello");
+
+    auto no_follow = get(server.url("/redirect"));
+    no_follow.follow_redirects = false;
+    res = engine.perform(no_follow);
+    REQUIRE(res.status == 302);
+    REQUIRE(res.headers["Location"] == "/hello");
+}
+
+TEST_CASE("http_engine: body limits and streaming sinks", "[http_engine]")
+{
+    local_http_server server;
+    http_engine engine;
+
+    auto limited = get(server.url("/big"));
+    limited.max_body_bytes = 1024;
+    auto res = engine.perform(limited);
+    REQUIRE_FALSE(res.ok());
+    REQUIRE(res.body_exceeded);
+
+    size_t streamed = 0;
+    size_t last_progress = 0;
+    size_t reported_total = 0;
+    auto streaming = get(server.url("/big"));
+    streaming.sink = [&streamed](const char* data, size_t size)
+    {
+        streamed += static_cast<size_t>(std::count(data, data + size, 'x'));
+        return true;
+    };
+    streaming.progress = [&last_progress, &reported_total](size_t received, size_t total)
+    {
+        last_progress = received;
+        reported_total = total;
+    };
+    res = engine.perform(streaming);
+    REQUIRE(res.ok());
+    REQUIRE(res.body.empty());
+    REQUIRE(streamed == 256 * 1024);
+    REQUIRE(res.received == streamed);
+    REQUIRE(last_progress == streamed);
+    REQUIRE(reported_total == 256 * 1024);
+
+    auto aborted = get(server.url("/big"));
+    aborted.sink = [](const char*, size_t) { return false; };
+    res = engine.perform(aborted);
+    REQUIRE_FALSE(res.ok());
+    REQUIRE(res.result == CURLE_WRITE_ERROR);
+}
+
+TEST_CASE("http_engine: caps connections per host", "[http_engine]")
+{
+    local_http_server server;
+    http_engine::limits limits;
+    limits.max_host_connections = 2;
+    http_engine engine(limits);
+
+    std::vector<std::future<http_engine::response>> pending;
+    for (int i = 0; i < 6; ++i) {
+        pending.push_back(engine.submit(get(server.url("/slow"))));
+    }
+    for (auto& future : pending) {
+        const auto res = future.get();
+        REQUIRE(res.ok());
+        REQUIRE(res.body == "slow");
+    }
+
+    REQUIRE(server.max_concurrent() <= 2);
+    REQUIRE(server.accepted() <= 2);
+}
+
+TEST_CASE("http_engine: failures and shutdown", "[http_engine]")
+{
+    http_engine engine;
+
+    int port = 0;
+    {
+        local_http_server server;
+        port = std::stoi(server.url("").substr(std::string("http://127.0.0.1:").size()));
+    }
+
+    auto res = engine.perform(get("http://127.0.0.1:" + std::to_string(port) + "/hello"));
+    REQUIRE_FALSE(res.ok());
+    REQUIRE_FALSE(res.error().empty());
+
+    engine.shutdown();
+    res = engine.perform(get("http://127.0.0.1:1/"));
+    REQUIRE(res.result == CURLE_ABORTED_BY_CALLBACK);
+}
+
+#endif
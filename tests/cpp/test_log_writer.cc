@@ -0,0 +1,142 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/log_writer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+TEST_CASE("log_writer: writes queued lines to a file sink in order", "[log_writer]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "millennium_log_writer_order.log";
+    std::filesystem::remove(path);
+
+    auto& writer = log_writer::instance();
+    const auto sink = writer.open_file(path.string());
+    for (int i = 0; i < 100; ++i) {
+        writer.write(sink, std::to_string(i) + "\n");
+    }
+    writer.flush();
+
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        expected += std::to_string(i) + "\n";
+    }
+    CHECK(read_file(path) == expected);
+
+    /** lines queued right before close() still make it out */
+    writer.write(sink, "last\n");
+    writer.close(sink);
+    writer.flush();
+    CHECK(read_file(path) == expected + "last\n");
+
+    /** and nothing is written once the sink is closed */
+    writer.write(sink, "ignored\n");
+    writer.flush();
+    CHECK(read_file(path) == expected + "last\n");
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("log_writer: keeps each producer's lines in order across threads", "[log_writer]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "millennium_log_writer_threads.log";
+    std::filesystem::remove(path);
+
+    auto& writer = log_writer::instance();
+    const auto sink = writer.open_file(path.string());
+
+    constexpr int THREADS = 4;
+    constexpr int LINES = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&writer, sink, t]
+        {
+            for (int i = 0; i < LINES; ++i) {
+                writer.write(sink, std::to_string(t) + " " + std::to_string(i) + "\n");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    writer.close(sink);
+    writer.flush();
+
+    std::vector<int> next(THREADS, 0);
+    std::istringstream lines(read_file(path));
+    int t = 0, i = 0, total = 0;
+    bool ordered = true;
+    while (lines >> t >> i) {
+        ordered &= (t >= 0 && t < THREADS && next[t] == i);
+        if (t >= 0 && t < THREADS) next[t] = i + 1;
+        ++total;
+    }
+
+    CHECK(ordered);
+    CHECK(static_cast<std::size_t>(total) + writer.dropped() >= THREADS * LINES);
+    CHECK(total <= THREADS * LINES);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("log_writer: flush_for_crash writes out what's queued, once", "[log_writer]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "millennium_log_writer_crash.log";
+    std::filesystem::remove(path);
+
+    auto& writer = log_writer::instance();
+    const auto sink = writer.open_file(path.string());
+    writer.write(sink, "before the crash\n");
+
+    REQUIRE(writer.flush_for_crash(std::chrono::seconds(5)));
+    CHECK(read_file(path) == "before the crash\n");
+
+    /** the crash flush record is single use */
+    CHECK_FALSE(writer.flush_for_crash(std::chrono::seconds(5)));
+
+    writer.close(sink);
+    writer.flush();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,428 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "mep/mep_server.h"
+#include <catch2/catch_test_macros.hpp>
+
+#ifndef _WIN32
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+std::string socket_path()
+{
+    static std::atomic<int> counter{ 0 };
+    return (std::filesystem::temp_directory_path() / ("millennium-mep-test-" + std::to_string(::getpid()) + "-" + std::to_string(++counter) + ".sock")).string();
+}
+
+std::vector<uint8_t> frame(const std::string& id, const std::string& method, nlohmann::json params = nullptr)
+{
+    const auto payload = nlohmann::json::to_msgpack(mep::request_t{ id, method, std::move(params) }.to_json());
+    std::vector<uint8_t> out(sizeof(uint32_t));
+    const uint32_t len = static_cast<uint32_t>(payload.size());
+    std::memcpy(out.data(), &len, sizeof(len)); /** little endian like the server, every platform we test on is */
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+/** wait until pred holds, false if it still doesn't after timeout */
+template <typename Pred> bool wait_for(Pred pred, std::chrono::milliseconds timeout = 5s)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+/** a blocking mep client over the server's unix socket */
+struct test_client
+{
+    int fd = -1;
+    std::vector<uint8_t> inbound;
+
+    explicit test_client(const std::string& path)
+    {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        REQUIRE(fd >= 0);
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    }
+
+    ~test_client()
+    {
+        close();
+    }
+
+    void close()
+    {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    void send_all(const std::vector<uint8_t>& bytes)
+    {
+        size_t sent = 0;
+        while (sent < bytes.size()) {
+            const ssize_t n = ::send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+            REQUIRE(n > 0);
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    void request(const std::string& id, const std::string& method, nlohmann::json params = nullptr)
+    {
+        send_all(frame(id, method, std::move(params)));
+    }
+
+    /** next frame from the server, nullopt on timeout or once the server has closed the connection */
+    std::optional<nlohmann::json> read(std::chrono::milliseconds timeout = 5s)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            if (inbound.size() >= sizeof(uint32_t)) {
+                uint32_t len;
+                std::memcpy(&len, inbound.data(), sizeof(len));
+                if (inbound.size() - sizeof(uint32_t) >= len) {
+                    auto j = nlohmann::json::from_msgpack(inbound.begin() + sizeof(uint32_t), inbound.begin() + sizeof(uint32_t) + len);
+                    inbound.erase(inbound.begin(), inbound.begin() + sizeof(uint32_t) + len);
+                    return j;
+                }
+            }
+
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            pollfd pfd{ fd, POLLIN, 0 };
+            if (left.count() <= 0 || ::poll(&pfd, 1, static_cast<int>(left.count())) <= 0) return std::nullopt;
+
+            uint8_t buf[64 * 1024];
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return std::nullopt;
+            inbound.insert(inbound.end(), buf, buf + n);
+        }
+    }
+
+    /** read and discard until the server closes the connection, returns the byte count. nullopt if it never closes */
+    std::optional<size_t> drain_until_closed(std::chrono::milliseconds timeout = 10s)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        size_t total = inbound.size();
+        inbound.clear();
+        while (std::chrono::steady_clock::now() < deadline) {
+            pollfd pfd{ fd, POLLIN, 0 };
+            if (::poll(&pfd, 1, 100) <= 0) continue;
+
+            uint8_t buf[64 * 1024];
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return total;
+            total += static_cast<size_t>(n);
+        }
+        return std::nullopt;
+    }
+};
+
+/** records the subscriptions a server hands out and which of them got cancelled */
+struct subscription_log
+{
+    std::mutex mutex;
+    std::shared_ptr<mep::client_context> ctx;
+    std::atomic<int> cancelled{ 0 };
+
+    void install(mep::router& r)
+    {
+        r.register_handler("subscribe", [this](const mep::request_t& req, const std::shared_ptr<mep::client_context>& client)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ctx = client;
+            }
+            return mep::response_t::ok(req.id, client->subscribe([this] { ++cancelled; }));
+        });
+        r.register_handler("unsubscribe", [](const mep::request_t& req, const std::shared_ptr<mep::client_context>& client)
+        {
+            return mep::response_t::ok(req.id, client->unsubscribe(req.params.get<std::string>()));
+        });
+    }
+};
+} // namespace
+
+TEST_CASE("mep_server: answers each client in request order while clients run in parallel", "[mep_server]")
+{
+    mep::router router;
+
+    /** both clients have to be inside this handler at once for it to succeed */
+    std::atomic<int> meeting{ 0 };
+    router.register_handler("meet", [&meeting](const mep::request_t& req, const std::shared_ptr<mep::client_context>&)
+    {
+        ++meeting;
+        return mep::response_t::ok(req.id, wait_for([&meeting] { return meeting.load() >= 2; }));
+    });
+    router.register_handler("echo", [](const mep::request_t& req, const std::shared_ptr<mep::client_context>&)
+    {
+        /** uneven handling times, so responses would come back shuffled if a client's requests overlapped */
+        std::this_thread::sleep_for(std::chrono::microseconds((std::hash<std::string>{}(req.id) % 7) * 100));
+        return mep::response_t::ok(req.id, req.params);
+    });
+
+    const std::string path = socket_path();
+    mep::server server(router, path);
+    server.start();
+    REQUIRE(server.is_running());
+
+    test_client a(path), b(path);
+    a.request("m", "meet");
+    b.request("m", "meet");
+    const auto met_a = a.read(), met_b = b.read();
+    REQUIRE(met_a.has_value());
+    REQUIRE(met_b.has_value());
+    CHECK(met_a->at("result") == true);
+    CHECK(met_b->at("result") == true);
+
+    constexpr int count = 200;
+    std::vector<uint8_t> burst_a, burst_b;
+    for (int i = 0; i < count; ++i) {
+        const auto fa = frame("a" + std::to_string(i), "echo", i);
+        const auto fb = frame("b" + std::to_string(i), "echo", -i);
+        burst_a.insert(burst_a.end(), fa.begin(), fa.end());
+        burst_b.insert(burst_b.end(), fb.begin(), fb.end());
+    }
+    a.send_all(burst_a);
+    b.send_all(burst_b);
+
+    for (int i = 0; i < count; ++i) {
+        const auto ra = a.read(), rb = b.read();
+        REQUIRE(ra.has_value());
+        REQUIRE(rb.has_value());
+        REQUIRE(ra->at("id") == "a" + std::to_string(i));
+        REQUIRE(ra->at("result") == i);
+        REQUIRE(rb->at("id") == "b" + std::to_string(i));
+        REQUIRE(rb->at("result") == -i);
+    }
+
+    /** unknown methods and undecodable frames get an error, the latter also closes the connection */
+    a.request("x", "no.such.method");
+    const auto unknown = a.read();
+    REQUIRE(unknown.has_value());
+    CHECK(unknown->at("error") == "unknown method: no.such.method");
+
+    const std::vector<uint8_t> garbage = { 1, 0, 0, 0, 0xc1 };
+    b.send_all(garbage);
+    const auto rejected = b.read();
+    REQUIRE(rejected.has_value());
+    CHECK(rejected->at("error") == "invalid msgpack");
+    CHECK_FALSE(b.read(1s).has_value());
+
+    server.stop();
+    CHECK_FALSE(server.is_running());
+    CHECK_FALSE(std::filesystem::exists(path));
+}
+
+TEST_CASE("mep_server: stops reading from a client with MAX_PENDING_REQUESTS queued", "[mep_server]")
+{
+    mep::router router;
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> handled{ 0 };
+
+    router.register_handler("gate", [released, &handled](const mep::request_t& req, const std::shared_ptr<mep::client_context>&)
+    {
+        released.wait();
+        ++handled;
+        return mep::response_t::ok(req.id, nullptr);
+    });
+    router.register_handler("size", [&handled](const mep::request_t& req, const std::shared_ptr<mep::client_context>&)
+    {
+        ++handled;
+        return mep::response_t::ok(req.id, req.params.get<std::string>().size());
+    });
+
+    const std::string path = socket_path();
+    mep::server server(router, path);
+    server.start();
+
+    test_client client(path);
+    client.request("gate", "gate");
+
+    /** big frames so the socket buffers hold only a few of them, whatever else got through the server has read */
+    constexpr int count = 400;
+    const std::string body(64 * 1024, 'x');
+    const size_t frame_size = frame("0", "size", body).size();
+
+    std::vector<uint8_t> burst;
+    for (int i = 0; i < count; ++i) {
+        const auto f = frame(std::to_string(i), "size", body);
+        burst.insert(burst.end(), f.begin(), f.end());
+    }
+
+    /** send without blocking until the server has stopped taking more */
+    size_t sent = 0;
+    auto last_progress = std::chrono::steady_clock::now();
+    while (sent < burst.size() && std::chrono::steady_clock::now() - last_progress < 500ms) {
+        const ssize_t n = ::send(client.fd, burst.data() + sent, burst.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            last_progress = std::chrono::steady_clock::now();
+        } else {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    /** everything before the pause was read, but not much more than the socket buffers hold */
+    CHECK(sent / frame_size >= mep::MAX_PENDING_REQUESTS);
+    CHECK(sent / frame_size < mep::MAX_PENDING_REQUESTS * 2);
+    CHECK(handled == 0);
+
+    /** once the worker catches up the server reads again and every request gets its answer, in order */
+    release.set_value();
+    std::thread sender([&] { client.send_all(std::vector<uint8_t>(burst.begin() + static_cast<std::ptrdiff_t>(sent), burst.end())); });
+
+    const auto gate = client.read();
+    REQUIRE(gate.has_value());
+    CHECK(gate->at("id") == "gate");
+    for (int i = 0; i < count; ++i) {
+        const auto r = client.read();
+        REQUIRE(r.has_value());
+        REQUIRE(r->at("id") == std::to_string(i));
+        REQUIRE(r->at("result") == body.size());
+    }
+    sender.join();
+    CHECK(handled == count + 1);
+}
+
+TEST_CASE("mep_server: evicts a client that stops reading past MAX_OUTBOUND_BYTES", "[mep_server]")
+{
+    mep::router router;
+    subscription_log subs;
+    subs.install(router);
+
+    const std::string big(1024 * 1024, 'x');
+    router.register_handler("big", [&big](const mep::request_t& req, const std::shared_ptr<mep::client_context>&)
+    {
+        return mep::response_t::ok(req.id, big);
+    });
+    router.register_handler("ping", [](const mep::request_t& req, const std::shared_ptr<mep::client_context>&)
+    {
+        return mep::response_t::ok(req.id, "pong");
+    });
+
+    const std::string path = socket_path();
+    mep::server server(router, path);
+    server.start();
+
+    /** twice the limit in responses, none of it read until the server gives up on the client */
+    constexpr size_t count = 2 * mep::MAX_OUTBOUND_BYTES / (1024 * 1024);
+    test_client slow(path);
+    slow.request("s", "subscribe");
+    for (size_t i = 0; i < count; ++i) {
+        slow.request(std::to_string(i), "big");
+    }
+
+    /** closing the client is what cancels its subscription */
+    REQUIRE(wait_for([&subs] { return subs.cancelled.load() == 1; }, 10s));
+
+    const auto received = slow.drain_until_closed();
+    REQUIRE(received.has_value());
+    CHECK(*received < count * big.size());
+
+    /** nobody else is affected */
+    test_client other(path);
+    other.request("p", "ping");
+    const auto pong = other.read();
+    REQUIRE(pong.has_value());
+    CHECK(pong->at("result") == "pong");
+}
+
+TEST_CASE("mep_server: closing a client cancels its subscriptions", "[mep_server]")
+{
+    mep::router router;
+    subscription_log subs;
+    subs.install(router);
+
+    const std::string path = socket_path();
+    mep::server server(router, path);
+    server.start();
+
+    test_client client(path);
+    client.request("1", "subscribe");
+    client.request("2", "subscribe");
+    const auto first = client.read(), second = client.read();
+    REQUIRE(first.has_value());
+    REQUIRE(second.has_value());
+    const std::string first_id = first->at("result");
+    CHECK(first_id != second->at("result").get<std::string>());
+
+    std::shared_ptr<mep::client_context> ctx;
+    {
+        std::lock_guard<std::mutex> lock(subs.mutex);
+        ctx = subs.ctx;
+    }
+
+    /** events pushed from any thread reach the client */
+    std::thread([&ctx] { CHECK(ctx->push({ { "event", "tick" } })); }).join();
+    const auto event = client.read();
+    REQUIRE(event.has_value());
+    CHECK(event->at("event") == "tick");
+
+    client.request("3", "unsubscribe", first_id);
+    const auto unsubscribed = client.read();
+    REQUIRE(unsubscribed.has_value());
+    CHECK(unsubscribed->at("result") == true);
+    CHECK(subs.cancelled == 1);
+
+    client.close();
+    REQUIRE(wait_for([&subs] { return subs.cancelled.load() == 2; }));
+    CHECK_FALSE(ctx->unsubscribe(first_id));
+
+    /** a closed client takes no more events */
+    CHECK(wait_for([&ctx] { return !ctx->push({ { "event", "tick" } }); }));
+    std::this_thread::sleep_for(50ms);
+    CHECK(subs.cancelled == 2);
+}
+
+#endif
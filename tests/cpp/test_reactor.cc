@@ -0,0 +1,238 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "reactor.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono_literals;
+
+TEST_CASE("reactor: timers expire in due order", "[reactor]")
+{
+    reactor r;
+    const auto now = reactor::clock::now();
+    r.schedule(3, now + 30ms);
+    r.schedule(1, now + 10ms);
+    r.schedule(2, now + 20ms);
+
+    std::vector<reactor::fd_event> events;
+    std::vector<uint64_t> expired;
+
+    /** nothing is due yet, a zero timeout returns straight away */
+    REQUIRE(r.wait(events, expired, 0));
+    CHECK(expired.empty());
+
+    /** with nothing to watch, an unbounded wait still wakes for the earliest timer */
+    std::vector<uint64_t> order;
+    while (order.size() < 3) {
+        REQUIRE(r.wait(events, expired, -1));
+        CHECK(events.empty());
+        order.insert(order.end(), expired.begin(), expired.end());
+    }
+    CHECK(order == std::vector<uint64_t>{ 1, 2, 3 });
+    CHECK(reactor::clock::now() - now >= 30ms);
+
+    /** every timer fires exactly once */
+    REQUIRE(r.wait(events, expired, 0));
+    CHECK(expired.empty());
+}
+
+#ifndef _WIN32
+
+namespace
+{
+struct socket_pair
+{
+    int a = -1;
+    int b = -1;
+
+    socket_pair()
+    {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        a = fds[0];
+        b = fds[1];
+    }
+
+    ~socket_pair()
+    {
+        if (a >= 0) ::close(a);
+        if (b >= 0) ::close(b);
+    }
+};
+
+bool reported(const std::vector<reactor::fd_event>& events, int fd, bool reactor::fd_event::* flag)
+{
+    for (const auto& ev : events) {
+        if (ev.fd == static_cast<reactor::native_fd>(fd) && ev.*flag) return true;
+    }
+    return false;
+}
+
+void ignore_signal(int)
+{
+}
+} // namespace
+
+TEST_CASE("reactor: a one-shot watch reports once until it is re-armed", "[reactor]")
+{
+    reactor r;
+    socket_pair sp;
+    std::vector<reactor::fd_event> events;
+    std::vector<uint64_t> expired;
+
+    REQUIRE(r.watch(sp.a, true) == reactor::watch_status::watching);
+    REQUIRE(::write(sp.b, "x", 1) == 1);
+
+    REQUIRE(r.wait(events, expired, 1000));
+    CHECK(reported(events, sp.a, &reactor::fd_event::readable));
+
+    /** the byte is still unread, but the watch has fired and stays quiet */
+    REQUIRE(r.wait(events, expired, 0));
+    CHECK(events.empty());
+
+    /** watching it again re-arms it */
+    REQUIRE(r.watch(sp.a, true) == reactor::watch_status::watching);
+    REQUIRE(r.wait(events, expired, 1000));
+    CHECK(reported(events, sp.a, &reactor::fd_event::readable));
+}
+
+TEST_CASE("reactor: a persistent watch keeps reporting while the fd is readable", "[reactor]")
+{
+    reactor r;
+    socket_pair sp;
+    std::vector<reactor::fd_event> events;
+    std::vector<uint64_t> expired;
+
+    REQUIRE(r.watch(sp.a, false) == reactor::watch_status::watching);
+
+    REQUIRE(r.wait(events, expired, 0));
+    CHECK(events.empty());
+
+    REQUIRE(::write(sp.b, "x", 1) == 1);
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(r.wait(events, expired, 1000));
+        CHECK(reported(events, sp.a, &reactor::fd_event::readable));
+    }
+
+    char byte;
+    REQUIRE(::read(sp.a, &byte, 1) == 1);
+    REQUIRE(r.wait(events, expired, 0));
+    CHECK(events.empty());
+}
+
+TEST_CASE("reactor: a closed peer is reported as a hangup", "[reactor]")
+{
+    reactor r;
+    socket_pair sp;
+    std::vector<reactor::fd_event> events;
+    std::vector<uint64_t> expired;
+
+    REQUIRE(r.watch(sp.a, false) == reactor::watch_status::watching);
+    ::close(sp.b);
+    sp.b = -1;
+
+    REQUIRE(r.wait(events, expired, 1000));
+    CHECK(reported(events, sp.a, &reactor::fd_event::hangup));
+}
+
+TEST_CASE("reactor: fds that can't be waited on are told apart", "[reactor]")
+{
+    reactor r;
+
+    /** a closed fd is an error the caller has to surface */
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    ::close(fds[0]);
+    ::close(fds[1]);
+    CHECK(r.watch(fds[0], true) == reactor::watch_status::failed);
+
+#if defined(__linux__)
+    /** epoll refuses regular files, which are always readable anyway */
+    int file = ::open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+    REQUIRE(file >= 0);
+    CHECK(r.watch(file, true) == reactor::watch_status::always_ready);
+    ::close(file);
+#endif
+}
+
+TEST_CASE("reactor: a signal interrupting the wait is not a failure", "[reactor]")
+{
+    /** no SA_RESTART, so the signal breaks the wait with EINTR */
+    struct sigaction sa{};
+    struct sigaction previous{};
+    sa.sa_handler = ignore_signal;
+    sigemptyset(&sa.sa_mask);
+    REQUIRE(::sigaction(SIGUSR1, &sa, &previous) == 0);
+
+    reactor r;
+    socket_pair sp;
+    REQUIRE(r.watch(sp.a, false) == reactor::watch_status::watching);
+    r.schedule(1, reactor::clock::now() + 10s);
+
+    /** keeps signalling until the wait returns, in case one lands before it starts */
+    const pthread_t waiter = ::pthread_self();
+    std::atomic<bool> done{ false };
+    std::thread interrupter([waiter, &done]
+    {
+        while (!done.load()) {
+            std::this_thread::sleep_for(50ms);
+            ::pthread_kill(waiter, SIGUSR1);
+        }
+    });
+
+    std::vector<reactor::fd_event> events;
+    std::vector<uint64_t> expired;
+    const auto start = reactor::clock::now();
+    CHECK(r.wait(events, expired, -1));
+    done.store(true);
+    interrupter.join();
+
+    CHECK(reactor::clock::now() - start < 10s);
+    CHECK(events.empty());
+    CHECK(expired.empty());
+
+    ::sigaction(SIGUSR1, &previous, nullptr);
+}
+
+#endif
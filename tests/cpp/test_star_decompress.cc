@@ -0,0 +1,175 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/star_decompress.h"
+#include "star_lz_reference.h"
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <string>
+
+namespace
+{
+std::string decompress(const std::string& block)
+{
+    return star_decompress(reinterpret_cast<const uint8_t*>(block.data()), block.size());
+}
+
+/** what the old decoder makes of a block: its output, or its error message */
+std::string legacy_outcome(const std::string& block)
+{
+    try {
+        auto out = star_lz::legacy_decompress(reinterpret_cast<const uint8_t*>(block.data()), block.size());
+        return "ok:" + std::string(out.begin(), out.end());
+    } catch (const std::exception& e) {
+        return std::string("error:") + e.what();
+    }
+}
+
+std::string outcome(const std::string& block)
+{
+    try {
+        return "ok:" + decompress(block);
+    } catch (const std::exception& e) {
+        return std::string("error:") + e.what();
+    }
+}
+
+std::string header(uint32_t size)
+{
+    std::string out;
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+    return out;
+}
+} // namespace
+
+TEST_CASE("star_decompress: round trips compressible and random data", "[star_decompress]")
+{
+    std::mt19937 rng(42);
+
+    for (size_t size : { 0u, 1u, 3u, 15u, 16u, 17u, 64u, 255u, 256u, 4096u, 70000u, 1u << 20 }) {
+        std::string text;
+        while (text.size() < size)
+            text += "function f" + std::to_string(rng() % 97) + "() { return this.value; }\n";
+        text.resize(size);
+
+        std::string noise(size, '\0');
+        for (auto& c : noise)
+            c = static_cast<char>(rng());
+
+        CAPTURE(size);
+        REQUIRE(decompress(star_lz::compress(text)) == text);
+        REQUIRE(decompress(star_lz::compress(noise)) == noise);
+    }
+}
+
+TEST_CASE("star_decompress: overlapping matches at every short offset", "[star_decompress]")
+{
+    for (size_t offset = 1; offset <= 20; ++offset) {
+        for (size_t match_len : { 4u, 5u, 7u, 8u, 9u, 15u, 16u, 17u, 18u, 33u, 300u }) {
+            /** offset literal bytes, then one match repeating them */
+            std::string block = header(static_cast<uint32_t>(offset + match_len));
+            const size_t ml = match_len - 4;
+            block.push_back(static_cast<char>(((offset < 15 ? offset : 15) << 4) | (ml < 15 ? ml : 15)));
+            if (offset >= 15) block.push_back(static_cast<char>(offset - 15));
+            for (size_t i = 0; i < offset; ++i)
+                block.push_back(static_cast<char>('a' + i));
+            block.push_back(static_cast<char>(offset));
+            block.push_back(0);
+            if (ml >= 15) star_lz::put_length(block, ml - 15);
+
+            CAPTURE(offset, match_len);
+            REQUIRE(outcome(block) == legacy_outcome(block));
+        }
+    }
+}
+
+TEST_CASE("star_decompress: rejects malformed blocks like the old decoder", "[star_decompress]")
+{
+    const std::string good = star_lz::compress("the quick brown fox jumps over the quick brown fox jumps over the lazy dog");
+
+    REQUIRE(outcome("") == legacy_outcome(""));
+    REQUIRE(outcome(header(STAR_DECOMPRESS_MAX + 1)) == legacy_outcome(header(STAR_DECOMPRESS_MAX + 1)));
+    REQUIRE_THROWS(decompress(header(1) + std::string("\x10", 1)));
+
+    /** zero and out of range offsets */
+    REQUIRE(outcome(header(8) + std::string("\x10x\x00\x00", 4)) == "error:star_decompress: zero match offset");
+    REQUIRE(outcome(header(8) + std::string("\x10x\x02\x00", 4)) == "error:star_decompress: invalid match offset");
+
+    /** declared size smaller than the data */
+    std::string shrunk = good;
+    shrunk[0] = 10;
+    REQUIRE(outcome(shrunk) == legacy_outcome(shrunk));
+
+    /** every truncation point */
+    for (size_t n = 0; n <= good.size(); ++n) {
+        const std::string block = good.substr(0, n);
+        CAPTURE(n);
+        REQUIRE(outcome(block) == legacy_outcome(block));
+    }
+}
+
+TEST_CASE("star_decompress: random mutations agree with the old decoder", "[star_decompress]")
+{
+    std::mt19937 rng(7);
+    std::string text;
+    while (text.size() < 8192)
+        text += "body { color: #" + std::to_string(rng() % 1000) + "; } aaaaaaaabababab\n";
+    const std::string base = star_lz::compress(text);
+
+    for (int round = 0; round < 5000; ++round) {
+        std::string block = base;
+        const int edits = 1 + static_cast<int>(rng() % 4);
+        for (int i = 0; i < edits; ++i)
+            block[4 + rng() % (block.size() - 4)] = static_cast<char>(rng());
+
+        CAPTURE(round);
+        REQUIRE(outcome(block) == legacy_outcome(block));
+    }
+}
+
+TEST_CASE("star_decompress: reused buffer is fully replaced", "[star_decompress]")
+{
+    const std::string large(100000, 'x');
+    const std::string small = "tiny";
+
+    std::string buffer;
+    const auto compressed_large = star_lz::compress(large);
+    const auto compressed_small = star_lz::compress(small);
+
+    star_decompress_into(reinterpret_cast<const uint8_t*>(compressed_large.data()), compressed_large.size(), buffer);
+    REQUIRE(buffer == large);
+    star_decompress_into(reinterpret_cast<const uint8_t*>(compressed_small.data()), compressed_small.size(), buffer);
+    REQUIRE(buffer == small);
+
+    REQUIRE_THROWS(star_decompress_into(reinterpret_cast<const uint8_t*>("\x08\0\0\0\x10x\0\0"), 8, buffer));
+    REQUIRE(buffer.empty());
+}
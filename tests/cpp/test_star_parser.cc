@@ -0,0 +1,303 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "millennium/star_parser.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+/** a raw (unencoded, unsigned) section to lay out in a hand-built archive */
+struct test_section
+{
+    uint8_t id;
+    std::string body;
+    uint32_t meta_flags = 0;
+};
+
+void put_u16(std::string& out, size_t at, uint16_t v)
+{
+    for (int i = 0; i < 2; ++i)
+        out[at + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+void put_u32(std::string& out, size_t at, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        out[at + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+void put_u64(std::string& out, size_t at, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i)
+        out[at + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+uint32_t fnv1a(const std::string& bytes)
+{
+    uint32_t h = 0x811c9dc5u;
+    for (const unsigned char c : bytes)
+        h = (h ^ c) * 0x01000193u;
+    return h;
+}
+
+/** header, section table and bodies, optionally behind a length-prefixed shim */
+std::string build_star(const std::vector<test_section>& sections, const std::string& shim = {})
+{
+    constexpr size_t HEADER = 12;
+    constexpr size_t ENTRY = 256;
+
+    std::string star(HEADER + sections.size() * ENTRY, '\0');
+    star.replace(0, 4, "STAR");
+    star[4] = 2; /* format version */
+    star[6] = static_cast<char>(sections.size());
+    if (!shim.empty()) put_u32(star, 8, fnv1a(shim));
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const size_t entry = HEADER + i * ENTRY;
+        star[entry] = static_cast<char>(sections[i].id);
+        put_u32(star, entry + 4, sections[i].meta_flags);
+        put_u64(star, entry + 8, star.size());
+        put_u64(star, entry + 16, sections[i].body.size());
+        star += sections[i].body;
+    }
+
+    if (shim.empty()) return star;
+
+    std::string prefixed(4, '\0');
+    put_u32(prefixed, 0, static_cast<uint32_t>(shim.size()));
+    return prefixed + shim + star;
+}
+
+/** the sub-entry table sections pack their files in: count, then name_len/data_len/name/data per entry */
+std::string build_entries(const std::vector<std::pair<std::string, std::string>>& entries)
+{
+    std::string out(4, '\0');
+    put_u32(out, 0, static_cast<uint32_t>(entries.size()));
+    for (const auto& [name, data] : entries) {
+        std::string header(6, '\0');
+        put_u16(header, 0, static_cast<uint16_t>(name.size()));
+        put_u32(header, 2, static_cast<uint32_t>(data.size()));
+        out += header + name + data;
+    }
+    return out;
+}
+
+struct scratch_file
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "millennium_star_parser_test.star";
+
+    explicit scratch_file(const std::string& content)
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+    }
+    ~scratch_file()
+    {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+std::unique_ptr<star_archive> open_bytes(const std::string& content)
+{
+    scratch_file file(content);
+    return star_archive::open(file.path);
+}
+} // namespace
+
+TEST_CASE("star_archive: opens a well-formed unsigned archive", "[star_parser]")
+{
+    const std::string star = build_star({
+        { 0x01, "meta" },
+        { 0x04, "webkit" },
+    });
+
+    const auto archive = open_bytes(star);
+    REQUIRE(archive != nullptr);
+    CHECK(archive->has_section(star_section::metadata));
+    CHECK(archive->has_section(star_section::webkit));
+    CHECK_FALSE(archive->has_section(star_section::backend));
+    CHECK(archive->section(star_section::metadata) == "meta");
+    CHECK(archive->section(star_section::webkit) == "webkit");
+    CHECK(archive->section(star_section::frontend).empty());
+    CHECK_FALSE(archive->is_trusted());
+}
+
+TEST_CASE("star_archive: rejects files that aren't loadable archives", "[star_parser]")
+{
+    const std::string good = build_star({ { 0x01, "meta" } });
+
+    CHECK(open_bytes("STAR") == nullptr); /* shorter than any header */
+    CHECK(open_bytes(std::string("STAX") + good.substr(4)) == nullptr);
+
+    std::string wrong_version = good;
+    wrong_version[4] = 3;
+    CHECK(open_bytes(wrong_version) == nullptr);
+
+    /* the section table claims more entries than the file holds */
+    std::string short_table = good;
+    short_table[6] = 4;
+    CHECK(open_bytes(short_table) == nullptr);
+
+    /* too many sections to be a real archive */
+    std::string too_many = good;
+    too_many[6] = static_cast<char>(33);
+    CHECK(open_bytes(too_many) == nullptr);
+
+    /* an unknown section marked required */
+    CHECK(open_bytes(build_star({ { 0x01, "meta" }, { 0x7f, "future", 0x0002 } })) == nullptr);
+    /* while an unknown optional one is just carried along */
+    CHECK(open_bytes(build_star({ { 0x01, "meta" }, { 0x7f, "future" } })) != nullptr);
+
+    CHECK(star_archive::open(std::filesystem::temp_directory_path() / "millennium_star_parser_missing.star") == nullptr);
+}
+
+TEST_CASE("star_archive: checks the shim in front of the archive", "[star_parser]")
+{
+    const std::string star = build_star({ { 0x01, "meta" } }, "#!/bin/sh\nexit 0\n");
+
+    const auto archive = open_bytes(star);
+    REQUIRE(archive != nullptr);
+    CHECK(archive->section(star_section::metadata) == "meta"); /* offsets are relative to the archive, not the file */
+
+    /* a shim that no longer matches the hash in the header */
+    std::string tampered = star;
+    tampered[5] = 'B';
+    CHECK(open_bytes(tampered) == nullptr);
+
+    /* a shim length pointing past the end of the file */
+    std::string overlong = star;
+    put_u32(overlong, 0, static_cast<uint32_t>(star.size()));
+    CHECK(open_bytes(overlong) == nullptr);
+
+    /* and one over the shim size limit */
+    std::string oversized = star;
+    put_u32(oversized, 0, 4u * 1024u * 1024u + 1u);
+    CHECK(open_bytes(oversized) == nullptr);
+}
+
+TEST_CASE("star_archive: a section extending past the file throws on read", "[star_parser]")
+{
+    std::string star = build_star({ { 0x01, "meta" } });
+    put_u64(star, 12 + 16, 4096); /* length of the first section */
+
+    const auto archive = open_bytes(star);
+    REQUIRE(archive != nullptr);
+    CHECK_THROWS_AS(archive->section(star_section::metadata), std::runtime_error);
+}
+
+TEST_CASE("star_archive: entries() reads the sub-entry table", "[star_parser]")
+{
+    const auto archive = open_bytes(build_star({
+        { 0x03, build_entries({ { "dist/", "" }, { "bundle.js", "console.log(1)" } }) },
+    }));
+    REQUIRE(archive != nullptr);
+
+    const auto entries = archive->entries(star_section::frontend);
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0].name == "dist/");
+    CHECK(entries[0].data.empty());
+    CHECK(entries[1].name == "bundle.js");
+    CHECK(entries[1].data == "console.log(1)");
+}
+
+TEST_CASE("star_archive: entries() rejects truncated tables", "[star_parser]")
+{
+    const std::string table = build_entries({ { "bundle.js", "console.log(1)" } });
+
+    auto entries_of = [](const std::string& body)
+    {
+        const auto archive = open_bytes(build_star({ { 0x03, body } }));
+        REQUIRE(archive != nullptr);
+        return archive->entries(star_section::frontend);
+    };
+
+    CHECK_THROWS_AS(entries_of("\x01\x00"), std::runtime_error);                    /* no room for the count */
+    CHECK_THROWS_AS(entries_of(table.substr(0, 8)), std::runtime_error);            /* entry header cut short */
+    CHECK_THROWS_AS(entries_of(table.substr(0, 4 + 6 + 4)), std::runtime_error);    /* name cut short */
+    CHECK_THROWS_AS(entries_of(table.substr(0, table.size() - 1)), std::runtime_error); /* data cut short */
+
+    /* a count larger than the entries present */
+    std::string overcounted = table;
+    put_u32(overcounted, 0, 2);
+    CHECK_THROWS_AS(entries_of(overcounted), std::runtime_error);
+
+    CHECK(entries_of(table).size() == 1);
+}
+
+TEST_CASE("star_archive: asset_index() points at assets in the file", "[star_parser]")
+{
+    /* asset bodies start with their uncompressed size */
+    std::string logo(4, '\0');
+    put_u32(logo, 0, 1234);
+    logo += "lz4 bytes";
+
+    const std::string shim = "shim";
+    const std::string assets = build_entries({ { "img/logo.png", logo }, { "tiny", "ab" } });
+    const std::string star = build_star({ { 0x01, "meta" }, { 0x05, assets, 0x0001 } }, shim);
+
+    const auto archive = open_bytes(star);
+    REQUIRE(archive != nullptr);
+
+    const auto index = archive->asset_index();
+    REQUIRE(index.size() == 2);
+
+    const AssetEntry& entry = index.at("img/logo.png");
+    CHECK(entry.compressed_length == logo.size());
+    CHECK(entry.uncompressed_length == 1234);
+    /* file offsets, so the backend can read the asset straight out of the .star */
+    CHECK(star.substr(entry.file_offset, entry.compressed_length) == logo);
+
+    /* too short to carry a size */
+    CHECK(index.at("tiny").uncompressed_length == 0);
+    CHECK(index.at("tiny").compressed_length == 2);
+}
+
+TEST_CASE("star_archive: asset_index() keeps what it read before a truncated entry", "[star_parser]")
+{
+    const std::string assets = build_entries({ { "a.png", "aaaa" }, { "b.png", "bbbbbbbb" } });
+    const auto archive = open_bytes(build_star({ { 0x05, assets.substr(0, assets.size() - 3) } }));
+    REQUIRE(archive != nullptr);
+
+    const auto index = archive->asset_index();
+    CHECK(index.size() == 1);
+    CHECK(index.contains("a.png"));
+
+    /* and an archive without assets has an empty index */
+    const auto bare = open_bytes(build_star({ { 0x01, "meta" } }));
+    REQUIRE(bare != nullptr);
+    CHECK(bare->asset_index().empty());
+}
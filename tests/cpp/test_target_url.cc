@@ -89,7 +89,7 @@ TEST_CASE("WebKit Target URL Validation", "[webkit]")
     SECTION("Third-Party Domains (Allowed if explicitly hooked)") {
         std::vector<network_hook_ctl::hook_item> active_hooks;
         network_hook_ctl::hook_item hook;
-        hook.hook.url_pattern = std::regex(".*discord\\.com.*");
+        hook.hook.url_pattern = std::make_shared<const std::regex>(".*discord\\.com.*");
         active_hooks.push_back(hook);
 
         target_url valid_hook("https://www.discord.com/app");
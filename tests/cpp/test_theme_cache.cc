@@ -0,0 +1,189 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "head/theme_cache.h"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using head::theme_metadata_cache;
+
+namespace
+{
+struct scratch_dir
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "millennium_theme_cache_test";
+
+    scratch_dir()
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~scratch_dir()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+void write_file(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+} // namespace
+
+TEST_CASE("theme_metadata_cache: parses skin.json once per fingerprint", "[theme_cache]")
+{
+    scratch_dir dir;
+    const auto skin = dir.path / "skin.json";
+    write_file(skin, R"({"name":"Test","b":1,"a":2})");
+
+    theme_metadata_cache cache(dir.path / "cache.json");
+
+    auto first = cache.skin(skin);
+    REQUIRE(first.has_value());
+    REQUIRE((*first)["name"] == "Test");
+    REQUIRE(first->begin().key() == "name"); /** insertion order survives */
+    REQUIRE(cache.misses() == 1);
+
+    auto second = cache.skin(skin);
+    REQUIRE(second == first);
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 1);
+
+    write_file(skin, R"({"name":"Changed theme"})");
+    auto third = cache.skin(skin);
+    REQUIRE(third.has_value());
+    REQUIRE((*third)["name"] == "Changed theme");
+    REQUIRE(cache.misses() == 2);
+}
+
+TEST_CASE("theme_metadata_cache: invalid and missing skins", "[theme_cache]")
+{
+    scratch_dir dir;
+    const auto skin = dir.path / "skin.json";
+    write_file(skin, "{ not json");
+
+    theme_metadata_cache cache(dir.path / "cache.json");
+    REQUIRE_FALSE(cache.skin(skin).has_value());
+    REQUIRE_FALSE(cache.skin(skin).has_value());
+    REQUIRE(cache.hits() == 1); /** the parse failure is cached too */
+
+    REQUIRE_FALSE(cache.skin(dir.path / "missing.json").has_value());
+    REQUIRE(cache.root_colors(dir.path / "missing.css").is_array());
+    REQUIRE(cache.root_colors(dir.path / "missing.css").empty());
+}
+
+TEST_CASE("theme_metadata_cache: persists entries across instances", "[theme_cache]")
+{
+    scratch_dir dir;
+    const auto skin = dir.path / "skin.json";
+    const auto colors = dir.path / "colors.css";
+    write_file(skin, R"({"name":"Persisted","RootColors":"colors.css"})");
+    write_file(colors, ":root {\n  /* @name Accent */\n  --accent: #ff8800;\n}\n");
+
+    nlohmann::json parsed_colors;
+    {
+        theme_metadata_cache cache(dir.path / "cache.json");
+        REQUIRE(cache.skin(skin).has_value());
+        parsed_colors = cache.root_colors(colors);
+        REQUIRE(parsed_colors.size() == 1);
+        REQUIRE(parsed_colors[0]["color"] == "--accent");
+        REQUIRE(parsed_colors[0]["name"] == "Accent");
+        REQUIRE(cache.save());
+    }
+
+    REQUIRE(std::filesystem::exists(dir.path / "cache.json"));
+    REQUIRE_FALSE(std::filesystem::exists(dir.path / "cache.json.tmp"));
+
+    theme_metadata_cache reloaded(dir.path / "cache.json");
+    auto skin_data = reloaded.skin(skin);
+    REQUIRE(skin_data.has_value());
+    REQUIRE((*skin_data)["name"] == "Persisted");
+    REQUIRE(reloaded.root_colors(colors) == parsed_colors);
+    REQUIRE(reloaded.hits() == 2);
+    REQUIRE(reloaded.misses() == 0);
+}
+
+TEST_CASE("theme_metadata_cache: saves metadata that isn't valid utf-8", "[theme_cache]")
+{
+    scratch_dir dir;
+    const auto colors = dir.path / "colors.css";
+    write_file(colors, ":root {\n  /* @name Caf\xe9 */\n  --accent: #ff8800;\n}\n");
+
+    {
+        theme_metadata_cache cache(dir.path / "cache.json");
+        REQUIRE(cache.root_colors(colors).size() == 1);
+        REQUIRE(cache.save());
+    }
+
+    theme_metadata_cache reloaded(dir.path / "cache.json");
+    const auto parsed = reloaded.root_colors(colors);
+    REQUIRE(parsed.size() == 1);
+    REQUIRE(parsed[0]["name"] == "Caf\xef\xbf\xbd"); /** the stray byte comes back as U+FFFD */
+    REQUIRE(reloaded.misses() == 0);
+}
+
+TEST_CASE("theme_metadata_cache: a touched but unchanged file is not reparsed", "[theme_cache]")
+{
+    scratch_dir dir;
+    const auto skin = dir.path / "skin.json";
+    write_file(skin, R"({"name":"Touched"})");
+
+    theme_metadata_cache cache(dir.path / "cache.json");
+    REQUIRE(cache.skin(skin).has_value());
+
+    std::filesystem::last_write_time(skin, std::filesystem::last_write_time(skin) + std::chrono::hours(1));
+
+    REQUIRE(cache.skin(skin).has_value());
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 1);
+}
+
+TEST_CASE("theme_metadata_cache: ignores corrupt cache files and drops deleted entries", "[theme_cache]")
+{
+    scratch_dir dir;
+    write_file(dir.path / "cache.json", "garbage");
+
+    const auto skin = dir.path / "skin.json";
+    write_file(skin, R"({"name":"Gone"})");
+    {
+        theme_metadata_cache cache(dir.path / "cache.json");
+        REQUIRE(cache.skin(skin).has_value());
+        std::filesystem::remove(skin);
+        REQUIRE(cache.save());
+    }
+
+    std::ifstream file(dir.path / "cache.json");
+    const auto data = nlohmann::json::parse(file);
+    REQUIRE(data["entries"].empty());
+}
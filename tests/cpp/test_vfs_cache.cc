@@ -0,0 +1,121 @@
+/**
+ * ==================================================
+ *   _____ _ _ _             _
+ *  |     |_| | |___ ___ ___|_|_ _ _____
+ *  | | | | | | | -_|   |   | | | |     |
+ *  |_|_|_|_|_|_|___|_|_|_|_|_|___|_|_|_|
+ *
+ * ==================================================
+ *
+ * Copyright (c) 2026 Project Millennium
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "millennium/vfs_cache.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <fstream>
+
+static std::shared_ptr<const vfs_response> make_response(std::string body)
+{
+    return std::make_shared<const vfs_response>(vfs_response{ std::move(body), nlohmann::json::array() });
+}
+
+TEST_CASE("vfs_response_cache: hits only while the stamp matches", "[vfs_cache]")
+{
+    vfs_response_cache cache;
+    const vfs_file_stamp stamp{ std::filesystem::file_time_type::clock::now(), 10 };
+
+    REQUIRE(cache.find("a.css", stamp) == nullptr);
+
+    auto response = make_response("Ym9keQ==");
+    cache.store("a.css", stamp, response);
+    REQUIRE(cache.find("a.css", stamp) == response);
+
+    /** a different size or mtime means the file changed, and the entry is dropped */
+    vfs_file_stamp resized = stamp;
+    resized.size = 11;
+    REQUIRE(cache.find("a.css", resized) == nullptr);
+    REQUIRE(cache.find("a.css", stamp) == nullptr);
+    REQUIRE(cache.size_bytes() == 0);
+}
+
+TEST_CASE("vfs_response_cache: invalidate and clear drop entries", "[vfs_cache]")
+{
+    vfs_response_cache cache;
+    cache.store("bundle.js", {}, make_response("abcd"));
+    cache.store("webkit.js", {}, make_response("efgh"));
+    REQUIRE(cache.size_bytes() == 8);
+
+    cache.invalidate("bundle.js");
+    REQUIRE(cache.find("bundle.js", {}) == nullptr);
+    REQUIRE(cache.find("webkit.js", {}) != nullptr);
+
+    cache.clear();
+    REQUIRE(cache.find("webkit.js", {}) == nullptr);
+    REQUIRE(cache.size_bytes() == 0);
+}
+
+TEST_CASE("vfs_response_cache: evicts least recently used entries over budget", "[vfs_cache]")
+{
+    vfs_response_cache cache(16);
+    cache.store("a", {}, make_response("1234"));
+    cache.store("b", {}, make_response("1234"));
+    cache.store("c", {}, make_response("1234"));
+
+    /** touch a so b is the oldest */
+    REQUIRE(cache.find("a", {}) != nullptr);
+    cache.store("d", {}, make_response("1234"));
+    cache.store("e", {}, make_response("1234"));
+
+    REQUIRE(cache.find("b", {}) == nullptr);
+    REQUIRE(cache.find("a", {}) != nullptr);
+    REQUIRE(cache.find("e", {}) != nullptr);
+    REQUIRE(cache.size_bytes() <= 16);
+
+    /** entries bigger than a quarter of the budget are never cached */
+    cache.store("huge", {}, make_response("123456789"));
+    REQUIRE(cache.find("huge", {}) == nullptr);
+}
+
+TEST_CASE("vfs_file_stamp: tracks size and mtime of a file", "[vfs_cache]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "millennium_vfs_cache_test.css";
+    {
+        std::ofstream(path) << "body{}";
+    }
+
+    auto first = vfs_file_stamp::of(path);
+    REQUIRE(first.has_value());
+    REQUIRE(first->size == 6);
+
+    {
+        std::ofstream(path) << "body{color:red}";
+    }
+    std::filesystem::last_write_time(path, first->mtime + std::chrono::seconds(1));
+
+    auto second = vfs_file_stamp::of(path);
+    REQUIRE(second.has_value());
+    REQUIRE_FALSE(*second == *first);
+
+    std::filesystem::remove(path);
+    REQUIRE_FALSE(vfs_file_stamp::of(path).has_value());
+    REQUIRE_FALSE(vfs_file_stamp::of(std::filesystem::temp_directory_path()).has_value());
+}